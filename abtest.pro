@@ -0,0 +1,17 @@
+QT += widgets concurrent
+QMAKE_CXXFLAGS += -std=c++17
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += . tools
+
+SOURCES += \
+    tools/abtest.cpp \
+    tools/sprt.cpp
+
+HEADERS += \
+    tools/sprt.h
+
+include(robotarena.pri)
+
+TARGET = robot_arena_abtest
\ No newline at end of file
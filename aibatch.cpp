@@ -0,0 +1,69 @@
+#include "aibatch.h"
+#include "game.h"
+#include "robot.h"
+#include "robotai.h"
+
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace {
+
+/// Takes chunks of requests until none are left, deciding on a copy of each position
+void decideChunks(const std::vector<BatchRequest>& requests, int chunkSize,
+                  std::atomic<int>& nextChunk, std::vector<Command>& commands) {
+    const Game* source = nullptr;
+    std::unique_ptr<Game> copy;
+    const int count = static_cast<int>(requests.size());
+    for (int start = nextChunk.fetch_add(1) * chunkSize; start < count;
+         start = nextChunk.fetch_add(1) * chunkSize) {
+        for (int i = start; i < std::min(count, start + chunkSize); ++i) {
+            const BatchRequest& request = requests[i];
+            if (request.game != source) {
+                source = request.game;
+                copy = source->clone();
+            }
+            Robot* ai = copy->robotInSlot(request.slot);
+            Robot* opponent = copy->robotInSlot(copy->opponentSlot(request.slot));
+            commands[i] = request.ai->calculateMove(copy.get(), ai, opponent);
+        }
+    }
+}
+
+} // namespace
+
+int AIBatch::threadCount() {
+    return std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+}
+
+std::vector<Command> AIBatch::decideAll(const std::vector<BatchRequest>& requests, int chunkSize) {
+    std::vector<Command> commands(requests.size(), Command::None);
+    const int count = static_cast<int>(requests.size());
+    if (count == 0) {
+        return commands;
+    }
+
+    int threads = threadCount();
+    if (chunkSize <= 0) {
+        chunkSize = std::max(1, count / (threads * CHUNKS_PER_THREAD));
+    }
+    int chunks = (count + chunkSize - 1) / chunkSize;
+    int tasks = std::min(threads, chunks);
+
+    // One task per thread, each pulling chunks until the counter runs past the end
+    std::atomic<int> nextChunk(0);
+    std::vector<QFuture<void>> workers;
+    for (int t = 1; t < tasks; ++t) {
+        workers.push_back(QtConcurrent::run([&]() {
+            decideChunks(requests, chunkSize, nextChunk, commands);
+        }));
+    }
+    decideChunks(requests, chunkSize, nextChunk, commands);
+    for (QFuture<void>& worker : workers) {
+        worker.waitForFinished();
+    }
+    return commands;
+}
@@ -0,0 +1,55 @@
+#ifndef AIBATCH_H
+#define AIBATCH_H
+
+#include <QtGlobal>
+#include <vector>
+
+class Game;
+class RobotAI;
+enum class Command;
+
+/// @brief One AI robot to decide for in a batch
+/// @author Group 17
+struct BatchRequest {
+    /// The position to decide in, only read
+    const Game* game = nullptr;
+    /// The AI deciding, must not appear in any other request of the same batch
+    RobotAI* ai = nullptr;
+    /// The robot to move: 0 for player 1, 1 for player 2, 2 for the AI robot
+    int slot = 2;
+};
+
+/**
+ * @brief Decides the next command of many AI robots at once, on every thread of the global pool.
+ *
+ * Every decision only reads its position, so the requests are independent and can be decided in
+ * any order. The AIs do keep caches in the game they are given though, so each worker decides on
+ * its own copy of the position. The copy is reused for the requests after it as long as they are
+ * on the same position, which keeps the caches warm: requests on the same position should be next
+ * to each other.
+ *
+ * Scripted AIs decide in microseconds, far less than it costs to hand a task to a thread. So the
+ * requests are not handed out one by one but in chunks: one task per thread pulls the next chunk
+ * from a shared counter until none are left. Chunks are small enough that a thread given slow
+ * requests does not hold up the others. The calling thread works on chunks as well.
+ *
+ * The commands are returned for the caller to resolve, for example one per robot of a tick.
+ *
+ * @author Group 17
+ */
+class AIBatch {
+public:
+    /// Chunks handed to each thread when the chunk size is picked by the batch
+    static const int CHUNKS_PER_THREAD = 4;
+
+    /// @brief Decides every request
+    /// @param requests - the robots to decide for
+    /// @param chunkSize - requests decided by a thread before it takes the next ones, 0 to spread
+    /// the requests over CHUNKS_PER_THREAD chunks per thread
+    /// @return The command of every request, in the order of the requests
+    static std::vector<Command> decideAll(const std::vector<BatchRequest>& requests, int chunkSize = 0);
+    /// @return the number of threads a batch is decided on, the calling one included
+    static int threadCount();
+};
+
+#endif // AIBATCH_H
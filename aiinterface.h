@@ -1,14 +1,178 @@
 #ifndef AIINTERFACE_H
 #define AIINTERFACE_H
 
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QtGlobal>
+#include <atomic>
+#include <vector>
+
 class Game;
 class Robot;
-enum class Command;
+/// Commands a robot can be given, defined here so decisions can default to None
+enum class Command { MoveForward, TurnLeft, TurnRight, Attack, None };
 enum class Direction;
 enum class CellType;
 enum class RobotType;
 enum class GameDifficulty;
 
+/// @brief Limits of a single AI decision: the time it must be made by and a flag to stop it early
+/// @author Group 17
+struct DecisionBudget {
+    /// When the decision is due, Forever for no time limit
+    QDeadlineTimer deadline = QDeadlineTimer(QDeadlineTimer::Forever);
+    /// Set from any thread to make the AI return its best command so far, may be null
+    const std::atomic<bool>* interrupt = nullptr;
+
+    /// @brief Creates a budget that ends the given time from now
+    /// @param milliseconds - the time budget, 0 or less for no limit
+    /// @param interrupt - optional flag that stops the decision early
+    static DecisionBudget fromNow(qint64 milliseconds, const std::atomic<bool>* interrupt = nullptr) {
+        DecisionBudget budget;
+        if (milliseconds > 0) {
+            budget.deadline = QDeadlineTimer(milliseconds);
+        }
+        budget.interrupt = interrupt;
+        return budget;
+    }
+    /// @return TRUE once the deadline has passed or the decision was interrupted, FALSE otherwise
+    bool isExhausted() const {
+        return (interrupt && interrupt->load(std::memory_order_relaxed)) || deadline.hasExpired();
+    }
+    /// @return TRUE if the decision was interrupted, FALSE otherwise
+    bool isInterrupted() const { return interrupt && interrupt->load(std::memory_order_relaxed); }
+    /// @return the nanoseconds left until the deadline, -1 for no time limit
+    qint64 remainingNs() const { return deadline.isForever() ? -1 : deadline.remainingTimeNSecs(); }
+};
+
+/// @brief The command an AI decided on, together with how much of its budget it used
+/// @author Group 17
+struct Decision {
+    /// The command to execute, Command::None when nothing was decided
+    Command command = Command::None;
+    /// Wall-clock time the decision took, in nanoseconds
+    qint64 usedNs = 0;
+    /// Time the decision was given, in nanoseconds, -1 for no limit
+    qint64 budgetNs = -1;
+    /// FALSE if the deadline or an interrupt cut the search short and a best-so-far command was returned
+    bool complete = true;
+    /// TRUE if the command was replayed from a plan made earlier in the turn
+    bool fromPlan = false;
+    /// TRUE if the plan was made while the opponent was still thinking
+    bool pondered = false;
+    /// TRUE if the command was taken from the decisions shared between matches
+    bool cached = false;
+
+    /// @return TRUE if the decision took longer than its budget, FALSE otherwise
+    bool isOverBudget() const { return budgetNs >= 0 && usedNs > budgetNs; }
+};
+
+/// @brief Random numbers for an AI's choices between equally good moves.
+///
+/// The whole state is one number, so it can be copied, hashed and restored together with the rest
+/// of what an AI remembers, and a decision taken from a cache draws exactly what it drew when it
+/// was made (SplitMix64).
+/// @author Group 17
+struct AIRandom {
+    quint64 state = 0;
+
+    AIRandom() = default;
+    /// @param seed - the seed, the same seed gives the same numbers
+    explicit AIRandom(quint64 seed) : state(seed) {}
+
+    /// @param bound - the number of possible values, at least 1
+    /// @return a number from 0 up to bound - 1
+    int bounded(int bound) {
+        state += 0x9E3779B97F4A7C15ULL;
+        quint64 z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        return static_cast<int>(((z >> 32) * static_cast<quint64>(bound)) >> 32);
+    }
+};
+
+/// @brief Running totals over many decisions, to keep an eye on fairness and tail latency
+/// @author Group 17
+struct DecisionStats {
+    qint64 decisions = 0;
+    qint64 totalNs = 0;
+    qint64 maxNs = 0;
+    /// Decisions cut short by their deadline or an interrupt
+    qint64 cutShort = 0;
+    /// Decisions that took longer than their budget. A search stopped at its deadline still runs
+    /// over by the time between two looks at the clock, an AI that cannot be stopped by far more
+    qint64 overBudget = 0;
+    /// Decisions replayed from a plan instead of being searched for
+    qint64 fromPlan = 0;
+    /// Turns answered with a plan made while the opponent was still thinking
+    qint64 pondered = 0;
+    /// Decisions taken from the decisions shared between matches
+    qint64 cached = 0;
+
+    /// @brief Adds a decision to the totals
+    void record(const Decision& decision) {
+        decisions++;
+        totalNs += decision.usedNs;
+        maxNs = qMax(maxNs, decision.usedNs);
+        if (!decision.complete) cutShort++;
+        if (decision.isOverBudget()) overBudget++;
+        if (decision.fromPlan) fromPlan++;
+        if (decision.pondered) pondered++;
+        if (decision.cached) cached++;
+    }
+};
+
+/// @brief The commands an AI means to play for the rest of its turn.
+///
+/// Every command is stored with the state it is meant for, so the plan is only followed while the
+/// game goes the way it was predicted. Once the state differs, for example because the arena
+/// changed, the plan is dropped and the AI decides again.
+/// @author Group 17
+struct TurnPlan {
+    /// One planned command
+    struct Step {
+        /// Game::stateHash() of the state the command is meant for
+        quint64 expectedHash;
+        Command command;
+    };
+
+    std::vector<Step> steps;
+    /// Index of the next command to play
+    int next = 0;
+
+    /// @brief Appends a command to the plan
+    void add(quint64 expectedHash, Command command) { steps.push_back(Step{ expectedHash, command }); }
+    /// @brief Forgets every planned command
+    void clear() { steps.clear(); next = 0; }
+    /// @param stateHash - Game::stateHash() of the current state
+    /// @return TRUE if the next planned command is meant for this state, FALSE otherwise
+    bool follows(quint64 stateHash) const {
+        return next < static_cast<int>(steps.size()) && steps[next].expectedHash == stateHash;
+    }
+};
+
+/// @brief Times a call to calculateMove() on any AI, the decision of AIs that do not search.
+///
+/// Called on the concrete type of the AI, so when the class is final the call to calculateMove()
+/// is direct and can be inlined.
+/// @param ai The AI to ask
+/// @param game Pointer to the current game state
+/// @param robot Pointer to the robot to move
+/// @param player Pointer to the opponent robot
+/// @param budget The deadline and interrupt flag of this decision, only its length is recorded
+/// @return The command together with the time it took
+template<class AI>
+Decision timedDecision(AI& ai, Game* game, Robot* robot, Robot* player, const DecisionBudget& budget) {
+    QElapsedTimer timer;
+    timer.start();
+    Decision decision;
+    decision.budgetNs = budget.remainingNs();
+    decision.command = ai.calculateMove(game, robot, player);
+    decision.usedNs = timer.nsecsElapsed();
+    return decision;
+}
+
 /// Simple interface for all robotAI, this will be implemented wherever a robotAI is being used
 /// @author Group 17
 class AIInterface
@@ -18,6 +182,84 @@ public:
     virtual ~AIInterface() = default;
     /// @brief calculate what move the AI should do based on it's behaviorial patterns
     virtual Command calculateMove(Game* game, Robot* ai, Robot* player) = 0;
+    /// @brief Forgets everything remembered about the current match, so the instance can be reused
+    /// for another one. The default is for AIs that remember nothing between decisions.
+    virtual void reset() {}
+    /// @brief Decides on a command within a time budget.
+    ///
+    /// Searching AIs override this to stop at the deadline or the interrupt and return their best
+    /// command so far. The default is for AIs that decide quickly: it calls calculateMove() and
+    /// only measures the time it took.
+    /// @param game Pointer to the current game state
+    /// @param ai Pointer to the robot to move
+    /// @param player Pointer to the opponent robot
+    /// @param budget The deadline and interrupt flag of this decision
+    /// @return The command together with the time it took
+    virtual Decision decide(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget) {
+        return timedDecision(*this, game, ai, player, budget);
+    }
+    /// @brief Plans the rest of the turn from a single search.
+    ///
+    /// Searching AIs that already look at whole turns override this to keep the line they found.
+    /// The default returns FALSE, RobotAI then plans the turn by asking decide() for one command
+    /// after another on a copy of the game.
+    /// @param game Pointer to the current game state, not modified
+    /// @param ai Pointer to the robot to move
+    /// @param player Pointer to the opponent robot
+    /// @param budget The deadline and interrupt flag of the whole plan
+    /// @param plan Filled with the commands, starting with the one to play now
+    /// @param decision Set to the first command, with the time the whole plan took
+    /// @return TRUE if the plan was made, FALSE if the AI cannot plan on its own
+    virtual bool planTurn(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget,
+                          TurnPlan& plan, Decision& decision) {
+        Q_UNUSED(game);
+        Q_UNUSED(ai);
+        Q_UNUSED(player);
+        Q_UNUSED(budget);
+        Q_UNUSED(plan);
+        Q_UNUSED(decision);
+        return false;
+    }
+    /// @brief Starts a decision that is made a slice at a time on the calling thread.
+    ///
+    /// Call step() with short budgets, for example once per frame of the event loop, until it
+    /// returns TRUE, then take the command from result(). This needs no other thread, so the
+    /// search can be interleaved with animations where worker threads are not available.
+    /// The default is for AIs that decide quickly: the whole decide() runs in the first step().
+    /// @param game Pointer to the current game state, must stay valid until result()
+    /// @param ai Pointer to the robot to move
+    /// @param player Pointer to the opponent robot
+    virtual void begin(Game* game, Robot* ai, Robot* player) {
+        steppedCall = SteppedCall{ game, ai, player, Decision(), false };
+    }
+    /// @brief Goes on with the decision started by begin() until the slice ends
+    /// @param slice The deadline and interrupt flag of this slice
+    /// @return TRUE once the decision is made, FALSE if it needs more slices
+    virtual bool step(const DecisionBudget& slice) {
+        if (!steppedCall.done && steppedCall.game) {
+            steppedCall.decision = decide(steppedCall.game, steppedCall.ai, steppedCall.player, slice);
+            steppedCall.done = true;
+        }
+        return true;
+    }
+    /// @brief Ends the decision started by begin(), best-so-far if step() has not returned TRUE yet
+    /// @return The command, with the time spent in step()
+    virtual Decision result() {
+        step(DecisionBudget());
+        steppedCall.game = nullptr;
+        return steppedCall.decision;
+    }
+
+private:
+    /// The call started by the default begin(), made at once by the first step()
+    struct SteppedCall {
+        Game* game = nullptr;
+        Robot* ai = nullptr;
+        Robot* player = nullptr;
+        Decision decision;
+        bool done = true;
+    };
+    SteppedCall steppedCall;
 };
 
 #endif // AIINTERFACE_H
@@ -0,0 +1,178 @@
+#include "aiparameters.h"
+#include "difficultyselector.h"
+#include "game.h"
+
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStringList>
+#include <QTextStream>
+
+namespace {
+
+const char* const DIFFICULTY_NAMES[] = {"easy", "medium", "hard"};
+
+template<class P>
+void writeFields(QTextStream& out, const char* difficulty, const char* robot, const P& parameters) {
+    for (const ParameterField<P>& field : P::fields()) {
+        out << difficulty << ' ' << robot << ' ' << field.name << ' ' << parameters.*field.member << '\n';
+    }
+}
+
+// FALSE if the struct has no field of that name
+template<class P>
+bool readField(P& parameters, const QString& name, int value) {
+    for (const ParameterField<P>& field : P::fields()) {
+        if (name == QString(field.name)) {
+            parameters.*field.member = qBound(field.minimum, value, field.maximum);
+            return true;
+        }
+    }
+    return false;
+}
+
+struct DefaultSets {
+    QMutex mutex;
+    AIParameterSets sets;
+};
+
+DefaultSets& defaultSets() {
+    static DefaultSets defaults;
+    return defaults;
+}
+
+} // namespace
+
+const std::vector<ParameterField<ScoutParameters>>& ScoutParameters::fields() {
+    static const std::vector<ParameterField<ScoutParameters>> FIELDS = {
+        {"healthSeekPercent", &ScoutParameters::healthSeekPercent, 10, 90},
+        {"criticalHealthPercent", &ScoutParameters::criticalHealthPercent, 5, 80},
+        {"pickupSearchRadius", &ScoutParameters::pickupSearchRadius, 1, 12},
+        {"stuckLimit", &ScoutParameters::stuckLimit, 1, 10},
+        {"cycleLimit", &ScoutParameters::cycleLimit, 1, 10},
+        {"turnLimit", &ScoutParameters::turnLimit, 1, 10},
+        {"killRangeVsScout", &ScoutParameters::killRangeVsScout, 1, 10},
+        {"killRangeVsSniper", &ScoutParameters::killRangeVsSniper, 1, 10},
+        {"strikeRangeMinVsTank", &ScoutParameters::strikeRangeMinVsTank, 1, 6},
+        {"strikeRangeMaxVsTank", &ScoutParameters::strikeRangeMaxVsTank, 2, 12, &ScoutParameters::strikeRangeMinVsTank},
+        {"randomMovePercent", &ScoutParameters::randomMovePercent, 0, 100},
+    };
+    return FIELDS;
+}
+
+const std::vector<ParameterField<TankParameters>>& TankParameters::fields() {
+    static const std::vector<ParameterField<TankParameters>> FIELDS = {
+        {"healthSeekPercent", &TankParameters::healthSeekPercent, 10, 90},
+        {"criticalHealthPercent", &TankParameters::criticalHealthPercent, 5, 80},
+        {"pickupSearchRadius", &TankParameters::pickupSearchRadius, 1, 12},
+        {"stuckLimit", &TankParameters::stuckLimit, 1, 10},
+        {"stuckAttackRange", &TankParameters::stuckAttackRange, 1, 8},
+        {"strikeRangeMin", &TankParameters::strikeRangeMin, 1, 6},
+        {"strikeRangeMax", &TankParameters::strikeRangeMax, 2, 12, &TankParameters::strikeRangeMin},
+        {"randomMovePercent", &TankParameters::randomMovePercent, 0, 100},
+    };
+    return FIELDS;
+}
+
+const std::vector<ParameterField<SniperParameters>>& SniperParameters::fields() {
+    static const std::vector<ParameterField<SniperParameters>> FIELDS = {
+        {"healthSeekPercent", &SniperParameters::healthSeekPercent, 10, 90},
+        {"criticalHealthPercent", &SniperParameters::criticalHealthPercent, 5, 80},
+        {"pickupSearchRadius", &SniperParameters::pickupSearchRadius, 1, 12},
+        {"criticalPickupRadius", &SniperParameters::criticalPickupRadius, 1, 12},
+        {"stuckLimit", &SniperParameters::stuckLimit, 1, 10},
+        {"stuckAttackRange", &SniperParameters::stuckAttackRange, 1, 8},
+        {"directAttackRange", &SniperParameters::directAttackRange, 1, 8},
+        {"strikeRangeVsTank", &SniperParameters::strikeRangeVsTank, 2, 14},
+        {"strikeRangeMinVsSniper", &SniperParameters::strikeRangeMinVsSniper, 1, 8},
+        {"strikeRangeMaxVsSniper", &SniperParameters::strikeRangeMaxVsSniper, 2, 14,
+         &SniperParameters::strikeRangeMinVsSniper},
+        {"preferredRangeVsScout", &SniperParameters::preferredRangeVsScout, 2, 12},
+        {"randomMovePercent", &SniperParameters::randomMovePercent, 0, 100},
+    };
+    return FIELDS;
+}
+
+AIParameterSets::AIParameterSets() {
+    for (GameDifficulty difficulty : {GameDifficulty::Easy, GameDifficulty::Medium, GameDifficulty::Hard}) {
+        AIParameterSet& set = at(difficulty);
+        int percent = qRound(100 * Game::randomMoveChanceFor(difficulty));
+        set.scout.randomMovePercent = percent;
+        set.tank.randomMovePercent = percent;
+        set.sniper.randomMovePercent = percent;
+    }
+}
+
+bool AIParameterSets::save(const QString& path) const {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream out(&file);
+    out << "# difficulty robot parameter value\n";
+    for (int i = 0; i < 3; ++i) {
+        writeFields(out, DIFFICULTY_NAMES[i], "scout", sets[i].scout);
+        writeFields(out, DIFFICULTY_NAMES[i], "tank", sets[i].tank);
+        writeFields(out, DIFFICULTY_NAMES[i], "sniper", sets[i].sniper);
+    }
+    out.flush();
+    return file.commit();
+}
+
+bool AIParameterSets::load(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith("#")) {
+            continue;
+        }
+        QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+        bool isNumber = false;
+        int value = parts.size() == 4 ? parts[3].toInt(&isNumber) : 0;
+        int difficulty = -1;
+        for (int i = 0; i < 3; ++i) {
+            if (parts.size() == 4 && parts[0] == QString(DIFFICULTY_NAMES[i])) {
+                difficulty = i;
+            }
+        }
+        if (!isNumber || difficulty < 0) {
+            return false;
+        }
+
+        AIParameterSet& set = sets[difficulty];
+        bool known = false;
+        if (parts[1] == "scout") {
+            known = readField(set.scout, parts[2], value);
+        } else if (parts[1] == "tank") {
+            known = readField(set.tank, parts[2], value);
+        } else if (parts[1] == "sniper") {
+            known = readField(set.sniper, parts[2], value);
+        }
+        if (!known) {
+            return false;
+        }
+    }
+    for (AIParameterSet& set : sets) {
+        orderParameterRanges(set.scout);
+        orderParameterRanges(set.tank);
+        orderParameterRanges(set.sniper);
+    }
+    return true;
+}
+
+AIParameterSets AIParameterSets::defaults() {
+    DefaultSets& defaults = defaultSets();
+    QMutexLocker locker(&defaults.mutex);
+    return defaults.sets;
+}
+
+void AIParameterSets::setDefaults(const AIParameterSets& sets) {
+    DefaultSets& defaults = defaultSets();
+    QMutexLocker locker(&defaults.mutex);
+    defaults.sets = sets;
+}
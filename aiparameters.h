@@ -0,0 +1,205 @@
+#ifndef AIPARAMETERS_H
+#define AIPARAMETERS_H
+
+#include <QString>
+#include <QtGlobal>
+#include <utility>
+#include <vector>
+
+enum class GameDifficulty;
+
+/// @brief One tunable threshold of a parameter struct: its name, where it is stored and the
+/// range a tuner may try
+/// @tparam P - the parameter struct
+template<class P>
+struct ParameterField {
+    const char* name;
+    int P::* member;
+    int minimum;
+    int maximum;
+    /// For the upper end of a range of distances, the field of its lower end, nullptr otherwise
+    int P::* lowerEnd = nullptr;
+};
+
+/// @brief The thresholds ScoutAI decides by
+/// @author Group 17
+struct ScoutParameters {
+    /// Below this share of its maximum health, in percent, the Scout looks for health pickups
+    int healthSeekPercent = 50;
+    /// Below this share, next to the opponent, it goes for a nearby health pickup instead of attacking
+    int criticalHealthPercent = 40;
+    /// Pickups further away than this many cells are not looked for
+    int pickupSearchRadius = 5;
+    /// Decisions in a row without moving before the Scout breaks out whatever it takes
+    int stuckLimit = 5;
+    /// Decisions in a row without moving, next to the opponent, before it breaks out of a turn cycle
+    int cycleLimit = 3;
+    /// Turns in a row on the way to safety before it forces a move
+    int turnLimit = 3;
+    /// Distance up to which it closes in on a Scout it can kill with one attack
+    int killRangeVsScout = 3;
+    /// Distance up to which it closes in on a Sniper it can kill with one attack
+    int killRangeVsSniper = 4;
+    /// Distances at which it strikes at a Tank instead of going for power-ups
+    int strikeRangeMinVsTank = 2;
+    int strikeRangeMaxVsTank = 5;
+    /// Share of its moves, in percent, that are random instead, the way the difficulty weakens it.
+    /// AIParameterSets start it from Game::randomMoveChanceFor().
+    int randomMovePercent = 20;
+
+    /// @return every field with its name and range
+    static const std::vector<ParameterField<ScoutParameters>>& fields();
+};
+
+/// @brief The thresholds TankAI decides by
+/// @author Group 17
+struct TankParameters {
+    /// Below this share of its maximum health, in percent, the Tank looks for health pickups
+    int healthSeekPercent = 50;
+    /// Below this share, next to the opponent, it goes for a nearby health pickup instead of attacking
+    int criticalHealthPercent = 30;
+    /// Pickups further away than this many cells are not looked for
+    int pickupSearchRadius = 5;
+    /// Decisions in a row without moving before the Tank tries to break out
+    int stuckLimit = 5;
+    /// Distance up to which it attacks an opponent in front while breaking out
+    int stuckAttackRange = 3;
+    /// Distances at which it closes in instead of going for power-ups
+    int strikeRangeMin = 2;
+    int strikeRangeMax = 5;
+    /// Share of its moves, in percent, that are random instead
+    int randomMovePercent = 20;
+
+    /// @return every field with its name and range
+    static const std::vector<ParameterField<TankParameters>>& fields();
+};
+
+/// @brief The thresholds SniperAI decides by
+/// @author Group 17
+struct SniperParameters {
+    /// Below this share of its maximum health, in percent, the Sniper looks for health pickups
+    int healthSeekPercent = 50;
+    /// Below this share, in line with the opponent, it goes for a nearby health pickup instead of attacking
+    int criticalHealthPercent = 50;
+    /// Pickups further away than this many cells are not looked for
+    int pickupSearchRadius = 6;
+    /// Health pickups further away than this many cells are not run for at critical health
+    int criticalPickupRadius = 5;
+    /// Decisions in a row without moving before the Sniper tries to break out
+    int stuckLimit = 5;
+    /// Distance up to which it attacks an opponent in front while breaking out
+    int stuckAttackRange = 3;
+    /// Distance up to which it attacks an opponent in line straight away
+    int directAttackRange = 3;
+    /// Distance up to which it closes in on a Tank that cannot reach it yet
+    int strikeRangeVsTank = 7;
+    /// Distances at which it closes in on a Sniper instead of going for power-ups
+    int strikeRangeMinVsSniper = 4;
+    int strikeRangeMaxVsSniper = 7;
+    /// Walking distance to a Scout that positions beyond are scored down for
+    int preferredRangeVsScout = 6;
+    /// Share of its moves, in percent, that are random instead
+    int randomMovePercent = 20;
+
+    /// @return every field with its name and range
+    static const std::vector<ParameterField<SniperParameters>>& fields();
+};
+
+/// @return the values of a parameter struct, in the order of its fields()
+template<class P>
+std::vector<int> parameterValues(const P& parameters) {
+    std::vector<int> values;
+    for (const ParameterField<P>& field : P::fields()) {
+        values.push_back(parameters.*field.member);
+    }
+    return values;
+}
+
+/// @brief Swaps the ends of every range of distances that is the wrong way round, which would
+/// switch off the behaviour the range is for
+/// @param parameters - the struct to fix
+template<class P>
+void orderParameterRanges(P& parameters) {
+    for (const ParameterField<P>& field : P::fields()) {
+        if (field.lowerEnd && parameters.*field.member < parameters.*field.lowerEnd) {
+            std::swap(parameters.*field.member, parameters.*field.lowerEnd);
+        }
+    }
+}
+
+/// @brief Sets a parameter struct from values in the order of its fields(), each kept within its
+/// range and with the ends of ranges of distances in order
+/// @param parameters - the struct to set
+/// @param values - the new values, missing ones are left alone
+template<class P>
+void setParameterValues(P& parameters, const std::vector<int>& values) {
+    const std::vector<ParameterField<P>>& fields = P::fields();
+    for (size_t i = 0; i < fields.size() && i < values.size(); ++i) {
+        parameters.*fields[i].member = qBound(fields[i].minimum, values[i], fields[i].maximum);
+    }
+    orderParameterRanges(parameters);
+}
+
+/// @return a 64-bit hash of the values of a parameter struct
+template<class P>
+quint64 hashParameters(const P& parameters) {
+    quint64 hash = 14695981039346656037ULL;
+    for (int value : parameterValues(parameters)) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            hash ^= static_cast<quint8>(value >> shift);
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+/// @brief The parameters of every scripted AI at one difficulty
+/// @author Group 17
+struct AIParameterSet {
+    ScoutParameters scout;
+    TankParameters tank;
+    SniperParameters sniper;
+};
+
+/**
+ * @brief Parameter sets of the scripted AIs for every difficulty, as written by the tuner.
+ *
+ * The file is plain text with one value per line: difficulty, robot type, field name and value,
+ * for example "medium tank healthSeekPercent 45". Empty lines and lines starting with # are
+ * skipped.
+ *
+ * The sets set with setDefaults() are the ones every scripted AI built afterwards starts with,
+ * so tuned sets loaded at start-up reach every match.
+ *
+ * @author Group 17
+ */
+class AIParameterSets {
+public:
+    /// @brief Sets with the default thresholds and the random moves of each difficulty
+    AIParameterSets();
+
+    /// @param difficulty - a difficulty
+    /// @return the parameters of the difficulty
+    AIParameterSet& at(GameDifficulty difficulty) { return sets[static_cast<int>(difficulty)]; }
+    const AIParameterSet& at(GameDifficulty difficulty) const { return sets[static_cast<int>(difficulty)]; }
+
+    /// @brief Writes every value to a file
+    /// @param path - the file, replaced once it is written completely
+    /// @return TRUE if the file was written, FALSE otherwise
+    bool save(const QString& path) const;
+    /// @brief Reads values from a file written by save()
+    /// @param path - the file
+    /// @return TRUE if the file was read, FALSE if it could not be opened or has a malformed or
+    /// unknown entry. Values read before the bad entry are kept, values not in the file too.
+    bool load(const QString& path);
+
+    /// @return the sets scripted AIs start with, safe to call from any thread
+    static AIParameterSets defaults();
+    /// @brief Sets the sets scripted AIs built from now on start with, safe to call from any thread
+    static void setDefaults(const AIParameterSets& defaults);
+
+private:
+    AIParameterSet sets[3];
+};
+
+#endif // AIPARAMETERS_H
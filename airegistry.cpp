@@ -0,0 +1,124 @@
+#include "airegistry.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template<class AI>
+void emplaceBuiltin(AIStrategy& strategy) {
+    strategy.emplace<AI>();
+}
+
+/// A built-in strategy and how to build it in place
+struct BuiltinStrategy {
+    const char* name;
+    void (*emplace)(AIStrategy&);
+};
+
+const BuiltinStrategy BUILTIN_STRATEGIES[] = {
+    {"scout", &emplaceBuiltin<ScoutAI>},
+    {"tank", &emplaceBuiltin<TankAI>},
+    {"sniper", &emplaceBuiltin<SniperAI>},
+    {"mcts", &emplaceBuiltin<MctsAI>},
+    {"alphabeta", &emplaceBuiltin<AlphaBetaAI>},
+};
+
+const BuiltinStrategy* findBuiltin(const QString& name) {
+    for (const BuiltinStrategy& builtin : BUILTIN_STRATEGIES) {
+        if (name == QString(builtin.name)) {
+            return &builtin;
+        }
+    }
+    return nullptr;
+}
+
+/// Strategies added with registerStrategy(), in the order they were added
+struct ExternalStrategies {
+    QMutex mutex;
+    std::vector<std::pair<QString, AIRegistry::Factory>> factories;
+};
+
+ExternalStrategies& externalStrategies() {
+    static ExternalStrategies strategies;
+    return strategies;
+}
+
+} // namespace
+
+QStringList AIRegistry::names() {
+    QStringList result;
+    for (const BuiltinStrategy& builtin : BUILTIN_STRATEGIES) {
+        result.append(QString(builtin.name));
+    }
+
+    ExternalStrategies& external = externalStrategies();
+    QMutexLocker locker(&external.mutex);
+    for (const auto& entry : external.factories) {
+        result.append(entry.first);
+    }
+    return result;
+}
+
+bool AIRegistry::contains(const QString& name) {
+    if (findBuiltin(name)) {
+        return true;
+    }
+
+    ExternalStrategies& external = externalStrategies();
+    QMutexLocker locker(&external.mutex);
+    for (const auto& entry : external.factories) {
+        if (entry.first == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AIRegistry::create(const QString& name, AIStrategy& strategy) {
+    if (const BuiltinStrategy* builtin = findBuiltin(name)) {
+        builtin->emplace(strategy);
+        return true;
+    }
+
+    Factory factory;
+    {
+        ExternalStrategies& external = externalStrategies();
+        QMutexLocker locker(&external.mutex);
+        for (const auto& entry : external.factories) {
+            if (entry.first == name) {
+                factory = entry.second;
+                break;
+            }
+        }
+    }
+    if (!factory) {
+        return false;
+    }
+
+    // Build outside the lock, a factory may take a while
+    std::unique_ptr<AIInterface> ai = factory();
+    if (!ai) {
+        return false;
+    }
+    strategy.emplace<std::unique_ptr<AIInterface>>(std::move(ai));
+    return true;
+}
+
+bool AIRegistry::registerStrategy(const QString& name, Factory factory) {
+    if (!factory || name.isEmpty() || findBuiltin(name)) {
+        return false;
+    }
+
+    ExternalStrategies& external = externalStrategies();
+    QMutexLocker locker(&external.mutex);
+    for (const auto& entry : external.factories) {
+        if (entry.first == name) {
+            return false;
+        }
+    }
+    external.factories.emplace_back(name, std::move(factory));
+    return true;
+}
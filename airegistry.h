@@ -0,0 +1,56 @@
+#ifndef AIREGISTRY_H
+#define AIREGISTRY_H
+
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <memory>
+#include <variant>
+#include "aiinterface.h"
+#include "scoutai.h"
+#include "tankai.h"
+#include "sniperai.h"
+#include "mctsai.h"
+#include "alphabetaai.h"
+
+/// @brief One AI strategy, either a built-in AI held by value or an AI supplied from outside.
+///
+/// The built-in AIs are final classes held by their own type, so calls to them are resolved at
+/// compile time through std::visit. AIs registered with AIRegistry::registerStrategy() are only
+/// known through AIInterface and are called through it.
+using AIStrategy = std::variant<ScoutAI, TankAI, SniperAI, MctsAI, AlphaBetaAI,
+                                std::unique_ptr<AIInterface>>;
+
+/**
+ * @brief Names of every AI strategy that can play a robot.
+ *
+ * The built-in strategies are "scout", "tank", "sniper", "mcts" and "alphabeta". More can be added
+ * at run time with registerStrategy(), so a harness can pick the strategy of each robot by name
+ * without a rebuild. All functions are safe to call from any thread.
+ *
+ * @see RobotAI::setStrategy()
+ * @author Group 17
+ */
+class AIRegistry {
+public:
+    /// Builds a new instance of an externally supplied strategy
+    using Factory = std::function<std::unique_ptr<AIInterface>()>;
+
+    /// @return the names of every strategy, the built-in ones first
+    static QStringList names();
+    /// @param name - a strategy name
+    /// @return TRUE if a strategy of that name exists, FALSE otherwise
+    static bool contains(const QString& name);
+    /// @brief Builds a new instance of a strategy in place
+    /// @param name - the strategy to build
+    /// @param strategy - replaced by the new instance, left alone if the name is unknown
+    /// @return TRUE if the strategy was built, FALSE if the name is unknown or its factory failed
+    static bool create(const QString& name, AIStrategy& strategy);
+    /// @brief Adds an externally supplied strategy
+    /// @param name - the name to select it by, must not be taken yet
+    /// @param factory - builds a new instance each time the strategy is selected
+    /// @return TRUE if it was added, FALSE if the name is taken or the factory is empty
+    static bool registerStrategy(const QString& name, Factory factory);
+};
+
+#endif // AIREGISTRY_H
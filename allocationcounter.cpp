@@ -0,0 +1,82 @@
+#include "allocationcounter.h"
+
+#ifdef ROBOTARENA_COUNT_ALLOCATIONS
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local quint64 allocationCount = 0;
+thread_local quint64 allocatedBytes = 0;
+
+void* countedAlloc(std::size_t size) {
+    ++allocationCount;
+    allocatedBytes += size;
+    return std::malloc(size == 0 ? 1 : size);
+}
+}
+
+void* operator new(std::size_t size) {
+    if (void* ptr = countedAlloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* ptr = countedAlloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+bool AllocationCounter::isEnabled() {
+    return true;
+}
+
+quint64 AllocationCounter::getAllocations() {
+    return allocationCount;
+}
+
+quint64 AllocationCounter::getAllocatedBytes() {
+    return allocatedBytes;
+}
+
+void AllocationCounter::reset() {
+    allocationCount = 0;
+    allocatedBytes = 0;
+}
+
+#else
+
+bool AllocationCounter::isEnabled() {
+    return false;
+}
+
+quint64 AllocationCounter::getAllocations() {
+    return 0;
+}
+
+quint64 AllocationCounter::getAllocatedBytes() {
+    return 0;
+}
+
+void AllocationCounter::reset() {
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Counts heap allocations made by the calling thread.
+ *
+ * Counting is only compiled in when ROBOTARENA_COUNT_ALLOCATIONS is defined (see RobotArena.pro,
+ * enginetests.pro defines it), in which case the global operator new is replaced. Otherwise every
+ * function returns 0 and costs nothing. Used to check that playing a turn does not allocate:
+ *
+ * @code
+ * quint64 before = AllocationCounter::getAllocations();
+ * game->executeAiTurn();
+ * quint64 allocations = AllocationCounter::getAllocations() - before;
+ * @endcode
+ *
+ * @author Group 17
+ */
+class AllocationCounter {
+public:
+    /// @return TRUE if allocations are being counted in this build, FALSE otherwise
+    static bool isEnabled();
+    /// @return the number of allocations made by the calling thread so far
+    static quint64 getAllocations();
+    /// @return the number of bytes requested by the calling thread so far
+    static quint64 getAllocatedBytes();
+    /// @brief Sets both counters of the calling thread back to 0
+    static void reset();
+};
+
+#endif // ALLOCATIONCOUNTER_H
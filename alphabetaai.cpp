@@ -0,0 +1,464 @@
+#include "alphabetaai.h"
+#include "game.h"
+#include "robot.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+/// Score of a won position, less the number of plies it takes so that quicker wins are preferred
+const int WIN_SCORE = 1000000;
+/// Scores beyond this are wins or losses
+const int WIN_THRESHOLD = WIN_SCORE - 1000;
+const int INFINITE_SCORE = WIN_SCORE + 1;
+/// Value of a point of health
+const int HEALTH_WEIGHT = 16;
+/// Value of holding a laser, missile or bomb
+const int POWER_UP_BONUS = 160;
+/// Cost of each cell between a hurt robot and the nearest health pickup
+const int PICKUP_DISTANCE_WEIGHT = 4;
+/// Cost of each cell of distance for the robot ahead on health, which wants to close in
+const int CLOSE_IN_WEIGHT = 6;
+/// The clock is only read every this many positions
+const int NODES_PER_CLOCK_CHECK = 256;
+
+Direction turnedLeft(Direction dir) {
+    switch (dir) {
+        case Direction::North: return Direction::West;
+        case Direction::West:  return Direction::South;
+        case Direction::South: return Direction::East;
+        case Direction::East:  return Direction::North;
+    }
+    return dir;
+}
+
+Direction turnedRight(Direction dir) {
+    return turnedLeft(turnedLeft(turnedLeft(dir)));
+}
+
+QPoint stepInDirection(const QPoint& pos, Direction dir) {
+    switch (dir) {
+        case Direction::North: return QPoint(pos.x(), pos.y() - 1);
+        case Direction::East:  return QPoint(pos.x() + 1, pos.y());
+        case Direction::South: return QPoint(pos.x(), pos.y() + 1);
+        case Direction::West:  return QPoint(pos.x() - 1, pos.y());
+    }
+    return pos;
+}
+
+// TRUE if the action ends by stepping onto a health pickup or a power-up
+bool grabsPickup(Game* game, Robot* robot, const Action& action) {
+    if (action.commands[action.count - 1] != Command::MoveForward) {
+        return false;
+    }
+    Direction dir = robot->getDirection();
+    for (int i = 0; i < action.count - 1; ++i) {
+        dir = (action.commands[i] == Command::TurnLeft) ? turnedLeft(dir) : turnedRight(dir);
+    }
+    QPoint target = stepInDirection(robot->getPosition(), dir);
+    if (!game->isValidPosition(target)) {
+        return false;
+    }
+    CellType cell = game->getCellType(target);
+    return cell != CellType::Empty && cell != CellType::Wall;
+}
+
+int manhattan(const QPoint& a, const QPoint& b) {
+    return std::abs(a.x() - b.x()) + std::abs(a.y() - b.y());
+}
+
+// Penalty for a robot that could use health being far from the nearest health pickup
+int pickupDistanceCost(Game* game, const Robot* robot) {
+    if (robot->getMaxHealth() - robot->getHealth() < Game::HEALTH_PICKUP_AMOUNT) {
+        return 0;
+    }
+    int nearest = -1;
+    for (const QPoint& pickup : game->getPickups(CellType::HealthPickup)) {
+        int distance = manhattan(robot->getPosition(), pickup);
+        if (nearest < 0 || distance < nearest) {
+            nearest = distance;
+        }
+    }
+    return nearest < 0 ? 0 : PICKUP_DISTANCE_WEIGHT * nearest;
+}
+
+// Win scores are stored relative to the position they were found in, so that they stay right
+// when the same position is reached at another ply
+int toTable(int value, int ply) {
+    if (value > WIN_THRESHOLD) return value + ply;
+    if (value < -WIN_THRESHOLD) return value - ply;
+    return value;
+}
+
+int fromTable(int value, int ply) {
+    if (value > WIN_THRESHOLD) return value - ply;
+    if (value < -WIN_THRESHOLD) return value + ply;
+    return value;
+}
+}
+
+AlphaBetaAI::AlphaBetaAI(QObject* parent)
+    : QObject(parent),
+      maxDepth(0),
+      timeLimitMs(DEFAULT_TIME_LIMIT_MS),
+      interrupt(nullptr),
+      aborted(false),
+      rootBest(0),
+      lastBest(-1),
+      lastSearched(false),
+      lastDepth(0),
+      lastNodes(0),
+      tableGeneration(0)
+{
+    setTableBits(DEFAULT_TABLE_BITS);
+}
+
+AlphaBetaAI::~AlphaBetaAI() {
+}
+
+void AlphaBetaAI::setTableBits(int bits) {
+    table.assign(static_cast<size_t>(1) << qBound(8, bits, 26), TableEntry());
+}
+
+Game* AlphaBetaAI::positionAt(int ply) {
+    while (static_cast<int>(positions.size()) <= ply) {
+        positions.push_back(positions.front()->clone());
+    }
+    return positions[ply].get();
+}
+
+Command AlphaBetaAI::calculateMove(Game* game, Robot* ai, Robot* player) {
+    return decide(game, ai, player, DecisionBudget()).command;
+}
+
+Decision AlphaBetaAI::decide(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget) {
+    Q_UNUSED(ai);
+    Q_UNUSED(player);
+    QElapsedTimer timer;
+    timer.start();
+    Decision decision;
+    decision.budgetNs = budget.remainingNs();
+    lastDepth = 0;
+    lastNodes = 0;
+    lastSearched = false;
+
+    MoveList rootMoves = game->generateMoves();
+    if (rootMoves.isEmpty()) {
+        AI_LOG("AlphaBetaAI: No meaningful action. Command: Attack.");
+        lastBest = -1;
+        decision.command = Command::Attack;
+        decision.usedNs = timer.nsecsElapsed();
+        return decision;
+    }
+    if (rootMoves.size() == 1) {
+        lastBest = 0;
+        decision.command = rootMoves[0].first();
+        decision.usedNs = timer.nsecsElapsed();
+        return decision;
+    }
+
+    // The search plays on its own copies, so the real game is never touched
+    if (positions.empty()) {
+        positions.push_back(game->clone());
+    } else {
+        positions.front()->copyStateFrom(*game);
+    }
+    // Entries of earlier searches stay for move ordering and cutoffs, but make room for this one
+    ++tableGeneration;
+
+    int depthLimit = maxDepth > 0 ? maxDepth : game->getAiSearchDepth();
+    deadline = timeLimitMs > 0 ? QDeadlineTimer(timeLimitMs) : QDeadlineTimer(QDeadlineTimer::Forever);
+    if (budget.deadline < deadline) {
+        deadline = budget.deadline;
+    }
+    interrupt = budget.interrupt;
+    aborted = false;
+
+    // Fallback for a search that runs out of time before its first depth is done
+    int order[MoveList::MAX_ACTIONS];
+    orderMoves(positions.front().get(), rootMoves, -1, order);
+    int best = order[0];
+    int bestScore = 0;
+
+    for (int depth = 1; depth <= depthLimit; ++depth) {
+        int score = search(0, depth, -INFINITE_SCORE, INFINITE_SCORE);
+        if (aborted) {
+            break;
+        }
+        best = rootBest;
+        bestScore = score;
+        lastDepth = depth;
+        // A forced win or loss does not change with more depth
+        if (std::abs(score) > WIN_THRESHOLD) {
+            break;
+        }
+    }
+
+    AI_LOG(QString("AlphaBetaAI: depth %1 of %2, %3 positions, score %4")
+                .arg(lastDepth).arg(depthLimit).arg(lastNodes).arg(bestScore));
+    interrupt = nullptr;
+    // Only the caller's budget makes the decision incomplete, the own time limit is expected
+    decision.complete = !aborted || !budget.isExhausted();
+    lastBest = best;
+    lastSearched = true;
+    decision.command = rootMoves[best].first();
+    decision.usedNs = timer.nsecsElapsed();
+    return decision;
+}
+
+bool AlphaBetaAI::planTurn(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget,
+                           TurnPlan& plan, Decision& decision) {
+    QElapsedTimer timer;
+    timer.start();
+    decision = decide(game, ai, player, budget);
+    plan.clear();
+
+    // Follow the best action, then whatever the table says is best while it is still our turn
+    if (positions.empty()) {
+        positions.push_back(game->clone());
+    }
+    Game* line = positionAt(1);
+    line->copyStateFrom(*game);
+    int mover = line->slotToMove();
+    MoveList moves = line->generateMoves();
+    if (lastBest < 0) {
+        plan.add(line->stateHash(), decision.command);
+    }
+    int next = lastBest;
+    while (next >= 0) {
+        Action action = moves[next];
+        quint64 before = line->stateHash();
+        for (int i = 0; i < action.count; ++i) {
+            plan.add(line->stateHash(), action.commands[i]);
+            line->playCommand(action.commands[i]);
+        }
+        if (!lastSearched || line->slotToMove() != mover || line->stateHash() == before) {
+            break;
+        }
+
+        const TableEntry& entry = table[line->stateHash() & (table.size() - 1)];
+        moves = line->generateMoves();
+        if (entry.key != line->stateHash() || entry.bestAction >= moves.size()) {
+            break;  // Not searched, RobotAI asks again once the plan runs out
+        }
+        next = entry.bestAction;
+    }
+
+    decision.usedNs = timer.nsecsElapsed();
+    return true;
+}
+
+void AlphaBetaAI::begin(Game* game, Robot* ai, Robot* player) {
+    Q_UNUSED(ai);
+    Q_UNUSED(player);
+    lastDepth = 0;
+    lastNodes = 0;
+    lastSearched = false;
+    stepped = SteppedSearch();
+
+    MoveList rootMoves = game->generateMoves();
+    for (const Action& action : rootMoves) {
+        stepped.firstCommands.push_back(action.first());
+    }
+    if (rootMoves.size() < 2) {
+        return;
+    }
+
+    if (positions.empty()) {
+        positions.push_back(game->clone());
+    } else {
+        positions.front()->copyStateFrom(*game);
+    }
+    ++tableGeneration;
+
+    stepped.depthLimit = maxDepth > 0 ? maxDepth : game->getAiSearchDepth();
+    stepped.deadline = timeLimitMs > 0 ? QDeadlineTimer(timeLimitMs) : QDeadlineTimer(QDeadlineTimer::Forever);
+    int order[MoveList::MAX_ACTIONS];
+    orderMoves(positions.front().get(), rootMoves, -1, order);
+    stepped.best = order[0];
+    stepped.done = false;
+}
+
+bool AlphaBetaAI::step(const DecisionBudget& slice) {
+    if (stepped.done) {
+        return true;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    deadline = stepped.deadline;
+    if (slice.deadline < deadline) {
+        deadline = slice.deadline;
+    }
+    interrupt = slice.interrupt;
+    aborted = false;
+
+    // A depth cut short by the end of the slice starts over in the next one. Whole subtrees it
+    // finished are in the table by then, so every slice gets further than the one before.
+    while (!slice.isExhausted()) {
+        int score = search(0, stepped.nextDepth, -INFINITE_SCORE, INFINITE_SCORE);
+        if (aborted) {
+            break;
+        }
+        stepped.best = rootBest;
+        stepped.bestScore = score;
+        lastDepth = stepped.nextDepth++;
+        if (std::abs(score) > WIN_THRESHOLD || stepped.nextDepth > stepped.depthLimit) {
+            stepped.done = true;
+            break;
+        }
+    }
+    if (stepped.deadline.hasExpired()) {
+        stepped.done = true;
+    }
+
+    interrupt = nullptr;
+    stepped.usedNs += timer.nsecsElapsed();
+    return stepped.done;
+}
+
+Decision AlphaBetaAI::result() {
+    Decision decision;
+    decision.usedNs = stepped.usedNs;
+    if (stepped.firstCommands.empty()) {
+        AI_LOG("AlphaBetaAI: No meaningful action. Command: Attack.");
+        lastBest = -1;
+        decision.command = Command::Attack;
+        return decision;
+    }
+
+    if (stepped.firstCommands.size() > 1) {
+        AI_LOG(QString("AlphaBetaAI: depth %1 of %2 in slices, %3 positions, score %4")
+                    .arg(lastDepth).arg(stepped.depthLimit).arg(lastNodes).arg(stepped.bestScore));
+        lastSearched = true;
+    }
+    lastBest = stepped.best;
+    decision.command = stepped.firstCommands[stepped.best];
+    stepped.done = true;
+    return decision;
+}
+
+int AlphaBetaAI::search(int ply, int depth, int alpha, int beta) {
+    Game* game = positionAt(ply);
+    if (++lastNodes % NODES_PER_CLOCK_CHECK == 0 &&
+        (deadline.hasExpired() || (interrupt && interrupt->load(std::memory_order_relaxed)))) {
+        aborted = true;
+    }
+    if (aborted) {
+        return 0;
+    }
+
+    int mover = game->slotToMove();
+    if (depth == 0) {
+        return evaluate(game, mover);
+    }
+
+    quint64 key = game->stateHash();
+    TableEntry& entry = table[key & (table.size() - 1)];
+    int tableAction = -1;
+    if (entry.key == key) {
+        tableAction = entry.bestAction;
+        if (entry.depth >= depth && ply > 0) {
+            int value = fromTable(entry.value, ply);
+            if (entry.bound == Exact ||
+                (entry.bound == Lower && value >= beta) ||
+                (entry.bound == Upper && value <= alpha)) {
+                return value;
+            }
+        }
+    }
+
+    MoveList moves = game->generateMoves();
+    int order[MoveList::MAX_ACTIONS];
+    orderMoves(game, moves, tableAction, order);
+
+    int alphaStart = alpha;
+    int best = -INFINITE_SCORE;
+    int bestAction = order[0];
+    for (int i = 0; i < moves.size(); ++i) {
+        Game* child = positionAt(ply + 1);
+        child->copyStateFrom(*game);
+        child->playAction(moves[order[i]]);
+
+        int value;
+        Robot* self = child->robotInSlot(mover);
+        Robot* opponent = child->robotInSlot(child->opponentSlot(mover));
+        if (opponent->isDead()) {
+            value = WIN_SCORE - (ply + 1);
+        } else if (self->isDead() || child->getState() == GameState::GameOver) {
+            value = -(WIN_SCORE - (ply + 1));
+        } else if (child->slotToMove() == mover) {
+            // Still the same turn, the same robot keeps choosing
+            value = search(ply + 1, depth, alpha, beta);
+        } else {
+            value = -search(ply + 1, depth - 1, -beta, -alpha);
+        }
+        if (aborted) {
+            return 0;
+        }
+
+        if (value > best) {
+            best = value;
+            bestAction = order[i];
+        }
+        alpha = std::max(alpha, value);
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    if (ply == 0) {
+        rootBest = bestAction;
+    }
+    // A deeper result of the current search is kept over a shallower one, anything an earlier
+    // search left is replaced
+    if (entry.key != key && entry.generation == tableGeneration && entry.depth > depth) {
+        return best;
+    }
+    entry.key = key;
+    entry.generation = tableGeneration;
+    entry.value = toTable(best, ply);
+    entry.depth = static_cast<qint8>(depth);
+    entry.bound = best <= alphaStart ? Upper : (best >= beta ? Lower : Exact);
+    entry.bestAction = static_cast<qint8>(bestAction);
+    return best;
+}
+
+int AlphaBetaAI::evaluate(Game* game, int mover) const {
+    const Robot* self = game->robotInSlot(mover);
+    const Robot* opponent = game->robotInSlot(game->opponentSlot(mover));
+
+    int score = HEALTH_WEIGHT * (self->getHealth() - opponent->getHealth());
+    score += POWER_UP_BONUS * ((self->getPowerUp() != RobotPowerUp::None) -
+                               (opponent->getPowerUp() != RobotPowerUp::None));
+    score -= pickupDistanceCost(game, self) - pickupDistanceCost(game, opponent);
+
+    // The robot ahead on health wants a fight, the one behind wants to keep away
+    int distance = manhattan(self->getPosition(), opponent->getPosition());
+    if (self->getHealth() > opponent->getHealth()) {
+        score -= CLOSE_IN_WEIGHT * distance;
+    } else if (self->getHealth() < opponent->getHealth()) {
+        score += CLOSE_IN_WEIGHT * distance;
+    }
+    return score;
+}
+
+void AlphaBetaAI::orderMoves(Game* game, const MoveList& moves, int tableAction, int* order) const {
+    // Best action of an earlier search first, then attacks, then pickup grabs, then the rest
+    Robot* robot = game->robotInSlot(game->slotToMove());
+    int rank[MoveList::MAX_ACTIONS];
+    for (int i = 0; i < moves.size(); ++i) {
+        order[i] = i;
+        const Action& action = moves[i];
+        if (i == tableAction) {
+            rank[i] = 0;
+        } else if (action.commands[action.count - 1] == Command::Attack) {
+            rank[i] = 1;
+        } else if (grabsPickup(game, robot, action)) {
+            rank[i] = 2;
+        } else {
+            rank[i] = 3;
+        }
+    }
+    std::stable_sort(order, order + moves.size(), [&rank](int a, int b) { return rank[a] < rank[b]; });
+}
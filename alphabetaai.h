@@ -0,0 +1,163 @@
+#ifndef ALPHABETAAI_H
+#define ALPHABETAAI_H
+
+#include <QDeadlineTimer>
+#include <QObject>
+#include <QtGlobal>
+#include <memory>
+#include <vector>
+#include "aiinterface.h"
+
+class Game;
+class Robot;
+class MoveList;
+enum class Command;
+
+/**
+ * @brief AI that looks ahead over whole turns with alpha-beta search.
+ *
+ * A turn is the sequence of actions (from Game::generateMoves()) a robot plays until its moves
+ * run out, so the search depth is counted in full turns: depth 1 plays out the rest of the own
+ * turn, depth 2 also the reply of the opponent, and so on. The depth comes from
+ * Game::getAiSearchDepth(), which is how the difficulty scales the strength of this AI.
+ *
+ * The search deepens one turn at a time until the depth or the time limit is reached, and the
+ * result of the last completed depth is played. Positions already searched, reached through
+ * another order of the same commands or in an earlier depth, are looked up in a transposition
+ * table keyed by Game::stateHash(). Attacks and pickup grabs are tried first so that good moves
+ * cut off the rest early.
+ *
+ * It can also search a slice at a time with begin(), step() and result(). Each slice goes on
+ * deepening from the last completed depth, so the table carries the work over between slices.
+ *
+ * The table is kept from one search to the next, since a position an earlier search got to is
+ * likely to come up again. Entries of earlier searches are the first to be replaced.
+ *
+ * Unlike MctsAI it is deterministic: the same positions searched in the same order always give
+ * the same commands as long as the time limit is not what stops the search.
+ *
+ * Can be used for any robot type through RobotAI::setStrategy(), under the name "alphabeta".
+ *
+ * @author Group 17
+ */
+class AlphaBetaAI final : public QObject, public AIInterface
+{
+    Q_OBJECT
+public:
+    /// Default time limit in milliseconds
+    static const int DEFAULT_TIME_LIMIT_MS = 300;
+    /// Default number of transposition table entries, as a power of two
+    static const int DEFAULT_TABLE_BITS = 16;
+
+    /// @brief Creates the AI with the default time limit and table size
+    /// @param parent - QObject parent of the AI
+    explicit AlphaBetaAI(QObject* parent = nullptr);
+    /// @brief Deletes the AI together with its search positions
+    ~AlphaBetaAI();
+
+    /// @brief Searches for the best command of the robot whose turn it is
+    /// @param game Pointer to the current game state, not modified
+    /// @param ai Pointer to the robot to move
+    /// @param player Pointer to the opponent robot
+    /// @return Command to execute
+    Command calculateMove(Game* game, Robot* ai, Robot* player) override;
+    /// @brief Searches within the own time limit and the given budget, whichever ends first
+    /// @param game Pointer to the current game state, not modified
+    /// @param ai Pointer to the robot to move
+    /// @param player Pointer to the opponent robot
+    /// @param budget The deadline and interrupt flag of this decision
+    /// @return The command of the deepest completed search, together with the time it took
+    Decision decide(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget) override;
+    /// @brief Searches once and plans the rest of the turn from the best line found
+    /// @param game Pointer to the current game state, not modified
+    /// @param ai Pointer to the robot to move
+    /// @param player Pointer to the opponent robot
+    /// @param budget The deadline and interrupt flag of the whole plan
+    /// @param plan Filled with the best action and the actions the table holds after it this turn
+    /// @param decision Set to the first command, with the time the search took
+    /// @return TRUE, the AI always plans on its own
+    bool planTurn(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget,
+                  TurnPlan& plan, Decision& decision) override;
+    /// @brief Starts a search that deepens a slice at a time
+    /// @param game Pointer to the current game state, not modified
+    /// @param ai Pointer to the robot to move
+    /// @param player Pointer to the opponent robot
+    void begin(Game* game, Robot* ai, Robot* player) override;
+    /// @brief Deepens the search until the slice ends
+    /// @param slice The deadline and interrupt flag of this slice
+    /// @return TRUE once the depth or the own time limit, counted from begin(), is reached
+    bool step(const DecisionBudget& slice) override;
+    /// @return The command of the deepest completed search, with the time spent in step()
+    Decision result() override;
+
+    /// @brief Sets how many full turns are searched
+    /// @param turns - the depth, 0 to follow the difficulty of the game
+    void setMaxDepth(int turns) { maxDepth = turns; }
+    /// @brief Sets the time after which the search stops, whatever depth it is at
+    /// @param milliseconds - the limit, 0 for no limit
+    void setTimeLimit(int milliseconds) { timeLimitMs = milliseconds; }
+    /// @brief Resizes the transposition table and clears it
+    /// @param bits - the table holds 2^bits entries
+    void setTableBits(int bits);
+
+    int getMaxDepth() const { return maxDepth; }
+    int getTimeLimit() const { return timeLimitMs; }
+    /// @return the deepest search completed for the last move, in full turns
+    int getLastDepth() const { return lastDepth; }
+    /// @return the number of positions visited for the last move
+    quint64 getLastNodes() const { return lastNodes; }
+
+private:
+    enum Bound : quint8 { Exact, Lower, Upper };
+
+    /// A searched position: its value for the robot to move and the best action found
+    struct TableEntry {
+        quint64 key = 0;
+        int value = 0;
+        qint8 depth = -1;
+        quint8 bound = Exact;
+        qint8 bestAction = -1;
+        /// The search that stored the entry, see tableGeneration
+        quint8 generation = 0;
+    };
+
+    /// A search made a slice at a time, alive from begin() to result()
+    struct SteppedSearch {
+        /// First command of every root action, in the order of Game::generateMoves()
+        std::vector<Command> firstCommands;
+        int depthLimit = 0;
+        int nextDepth = 1;
+        int best = 0;
+        int bestScore = 0;
+        /// The own time limit, counted from begin() and not only while stepping
+        QDeadlineTimer deadline;
+        qint64 usedNs = 0;
+        bool done = true;
+    };
+
+    int search(int ply, int depth, int alpha, int beta);
+    int evaluate(Game* game, int mover) const;
+    void orderMoves(Game* game, const MoveList& moves, int tableAction, int* order) const;
+    Game* positionAt(int ply);
+
+    int maxDepth;
+    int timeLimitMs;
+    std::vector<TableEntry> table;
+    /// One copy of the game per ply, reused from move to move
+    std::vector<std::unique_ptr<Game>> positions;
+    QDeadlineTimer deadline;
+    const std::atomic<bool>* interrupt;
+    bool aborted;
+    int rootBest;
+    /// Index of the best action in Game::generateMoves() of the last position, -1 if it had none
+    int lastBest;
+    /// Set when the last decision ran a search, so the table holds the rest of its line
+    bool lastSearched;
+    int lastDepth;
+    quint64 lastNodes;
+    /// Counts the searches, wrapping around, so entries of earlier ones are replaced first
+    quint8 tableGeneration;
+    SteppedSearch stepped;
+};
+
+#endif // ALPHABETAAI_H
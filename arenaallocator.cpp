@@ -0,0 +1,44 @@
+#include "arenaallocator.h"
+#include <algorithm>
+#include <cstdint>
+
+ArenaAllocator::ArenaAllocator(std::size_t size)
+    : buffer(new unsigned char[size]),
+      capacity(size),
+      offset(0),
+      used(0),
+      highWaterMark(0) {
+}
+
+void* ArenaAllocator::allocate(std::size_t size, std::size_t alignment) {
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(buffer.get());
+    std::uintptr_t aligned = (base + offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    std::size_t newOffset = static_cast<std::size_t>(aligned - base) + size;
+
+    if (newOffset <= capacity) {
+        used += newOffset - offset;
+        offset = newOffset;
+        highWaterMark = std::max(highWaterMark, used);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Main buffer is full: fall back to a dedicated block, reset() will grow the buffer
+    overflowBlocks.emplace_back(new unsigned char[size + alignment]);
+    std::uintptr_t block = reinterpret_cast<std::uintptr_t>(overflowBlocks.back().get());
+    used += size + alignment;
+    highWaterMark = std::max(highWaterMark, used);
+    return reinterpret_cast<void*>((block + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1));
+}
+
+void ArenaAllocator::reset() {
+    if (!overflowBlocks.empty()) {
+        overflowBlocks.clear();
+        // Grow once so the same workload fits in the main buffer from now on
+        if (highWaterMark > capacity) {
+            capacity = highWaterMark;
+            buffer.reset(new unsigned char[capacity]);
+        }
+    }
+    offset = 0;
+    used = 0;
+}
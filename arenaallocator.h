@@ -0,0 +1,64 @@
+#ifndef ARENAALLOCATOR_H
+#define ARENAALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Bump allocator for short-lived scratch memory, such as the work lists of an AI search.
+ *
+ * Allocation only moves an offset forward and reset() releases everything at once. When a
+ * request does not fit, an extra block is taken from the heap; the next reset() then grows the
+ * main buffer to the highest amount ever used, so after a few turns a match stops touching the
+ * heap altogether.
+ *
+ * Objects placed in the arena are never destroyed, so only trivially destructible types should
+ * be stored in it.
+ *
+ * @author Group 17
+ */
+class ArenaAllocator {
+public:
+    /// @brief Creates an arena
+    /// @param capacity - the initial size of the main buffer in bytes
+    explicit ArenaAllocator(std::size_t capacity = 16 * 1024);
+
+    ArenaAllocator(const ArenaAllocator&) = delete;
+    ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+    /// @brief Reserves a block of memory that stays valid until the next reset()
+    /// @param size - the number of bytes needed
+    /// @param alignment - the required alignment, must be a power of two
+    /// @return pointer to uninitialised memory
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    /// @brief Reserves room for count objects of type T
+    /// @param count - the number of objects
+    /// @return pointer to uninitialised memory for the objects
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /// @brief Releases every allocation made since the last reset
+    void reset();
+
+    /// @return the number of bytes handed out since the last reset
+    std::size_t getUsed() const { return used; }
+    /// @return the size of the main buffer in bytes
+    std::size_t getCapacity() const { return capacity; }
+    /// @return the highest number of bytes handed out between two resets
+    std::size_t getHighWaterMark() const { return highWaterMark; }
+
+private:
+    std::unique_ptr<unsigned char[]> buffer;
+    std::size_t capacity;
+    std::size_t offset;
+    std::size_t used;
+    std::size_t highWaterMark;
+    /// Blocks taken from the heap because the main buffer was full, freed on reset
+    std::vector<std::unique_ptr<unsigned char[]>> overflowBlocks;
+};
+
+#endif // ARENAALLOCATOR_H
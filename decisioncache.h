@@ -0,0 +1,167 @@
+#ifndef DECISIONCACHE_H
+#define DECISIONCACHE_H
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtGlobal>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/// @brief Counters of a DecisionCache, summed over all its shards
+/// @author Group 17
+struct DecisionCacheStats {
+    quint64 hits = 0;
+    quint64 misses = 0;
+    quint64 insertions = 0;
+    /// Entries pushed out by newer ones because their bucket was full
+    quint64 evictions = 0;
+
+    /// @return the share of lookups that were hits, 0 before the first lookup
+    double hitRate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+};
+
+/**
+ * @brief Bounded map from a 64-bit position key to a cached decision, safe to share between threads.
+ *
+ * The entries are split over a power-of-two number of shards, each behind its own mutex, so
+ * threads looking up different positions rarely wait for each other. Within a shard a key can
+ * only live in one bucket of WAYS entries. When the bucket is full, the entry used least
+ * recently is evicted, so memory never grows past the capacity given at construction.
+ *
+ * Keys are trusted to identify the position completely, a key of 0 is never stored.
+ *
+ * @tparam Value - what is cached for a position, copied in and out
+ * @author Group 17
+ */
+template<class Value>
+class DecisionCache {
+public:
+    /// Entries per bucket
+    static const int WAYS = 4;
+
+    /// @brief Creates an empty cache
+    /// @param entryBits - the cache holds 2^entryBits entries in total
+    /// @param shardBits - the entries are split over 2^shardBits shards
+    explicit DecisionCache(int entryBits = 16, int shardBits = 4)
+        : shardBits(qBound(0, shardBits, 8)) {
+        int perShardBits = qMax(2, qBound(4, entryBits, 26) - this->shardBits);
+        shards.reserve(static_cast<size_t>(1) << this->shardBits);
+        for (int i = 0; i < (1 << this->shardBits); ++i) {
+            shards.push_back(std::make_unique<Shard>(static_cast<size_t>(1) << perShardBits));
+        }
+    }
+
+    /// @brief Looks up a position
+    /// @param key - the position key, 0 always misses
+    /// @param value - set to the cached value on a hit, left alone on a miss
+    /// @return TRUE on a hit, FALSE on a miss
+    bool find(quint64 key, Value& value) {
+        // Empty slots have key 0
+        if (key == 0) {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        Shard& shard = shardFor(key);
+        QMutexLocker locker(&shard.mutex);
+        Entry* bucket = bucketFor(shard, key);
+        for (int i = 0; i < WAYS; ++i) {
+            if (bucket[i].key == key) {
+                bucket[i].lastUse = ++shard.clock;
+                value = bucket[i].value;
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /// @brief Stores the value of a position, replacing an older value of the same key
+    /// @param key - the position key, 0 is ignored
+    /// @param value - the value to cache
+    void insert(quint64 key, const Value& value) {
+        if (key == 0) {
+            return;
+        }
+        Shard& shard = shardFor(key);
+        QMutexLocker locker(&shard.mutex);
+        Entry* bucket = bucketFor(shard, key);
+        Entry* target = &bucket[0];
+        for (int i = 0; i < WAYS; ++i) {
+            if (bucket[i].key == key || bucket[i].key == 0) {
+                target = &bucket[i];
+                break;
+            }
+            if (bucket[i].lastUse < target->lastUse) {
+                target = &bucket[i];
+            }
+        }
+        if (target->key != 0 && target->key != key) {
+            evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        target->key = key;
+        target->value = value;
+        target->lastUse = ++shard.clock;
+        insertions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Empties the cache and starts the counters over
+    void clear() {
+        for (const std::unique_ptr<Shard>& shard : shards) {
+            QMutexLocker locker(&shard->mutex);
+            std::fill(shard->entries.begin(), shard->entries.end(), Entry());
+            shard->clock = 0;
+        }
+        hits.store(0);
+        misses.store(0);
+        insertions.store(0);
+        evictions.store(0);
+    }
+
+    /// @return the counters so far
+    DecisionCacheStats stats() const {
+        DecisionCacheStats result;
+        result.hits = hits.load(std::memory_order_relaxed);
+        result.misses = misses.load(std::memory_order_relaxed);
+        result.insertions = insertions.load(std::memory_order_relaxed);
+        result.evictions = evictions.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    /// @return the number of entries the cache can hold
+    int capacity() const { return static_cast<int>(shards.size() * shards.front()->entries.size()); }
+
+private:
+    struct Entry {
+        quint64 key = 0;
+        quint64 lastUse = 0;
+        Value value = Value();
+    };
+
+    struct Shard {
+        explicit Shard(size_t size) : entries(size) {}
+
+        QMutex mutex;
+        std::vector<Entry> entries;
+        /// Counts uses, for finding the least recently used entry of a bucket
+        quint64 clock = 0;
+    };
+
+    // The low bits pick the shard, the next ones the bucket
+    Shard& shardFor(quint64 key) { return *shards[key & ((static_cast<quint64>(1) << shardBits) - 1)]; }
+    Entry* bucketFor(Shard& shard, quint64 key) {
+        quint64 buckets = shard.entries.size() / WAYS;
+        return &shard.entries[((key >> shardBits) & (buckets - 1)) * WAYS];
+    }
+
+    int shardBits;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<quint64> hits{0};
+    std::atomic<quint64> misses{0};
+    std::atomic<quint64> insertions{0};
+    std::atomic<quint64> evictions{0};
+};
+
+#endif // DECISIONCACHE_H
@@ -0,0 +1,115 @@
+#include "distancematrix.h"
+#include "terrain.h"
+#include <algorithm>
+
+namespace {
+const int DX[4] = { 0, 1, 0, -1 };
+const int DY[4] = { -1, 0, 1, 0 };
+}
+
+DistanceMatrix::DistanceMatrix(const Terrain& terrain)
+    : terrain(terrain), gridSize(0), cellCount(0), builtWallVersion(0), built(false) {
+}
+
+bool DistanceMatrix::isSupported() const {
+    return terrain.getGridSize() <= MAX_GRID_SIZE;
+}
+
+void DistanceMatrix::ensureCurrent() {
+    if (!built || gridSize != terrain.getGridSize() || builtWallVersion != terrain.getWallVersion()) {
+        rebuild();
+    }
+}
+
+quint8 DistanceMatrix::distance(const QPoint& from, const QPoint& to) {
+    ensureCurrent();
+    return distances[(from.y() * gridSize + from.x()) * cellCount + to.y() * gridSize + to.x()];
+}
+
+void DistanceMatrix::reserve() {
+    if (!isSupported()) {
+        return;
+    }
+    int cells = terrain.getGridSize() * terrain.getGridSize();
+    distances.reserve(cells * cells);
+    queue.reserve(cells);
+}
+
+void DistanceMatrix::rebuild() {
+    gridSize = terrain.getGridSize();
+    cellCount = gridSize * gridSize;
+    distances.assign(cellCount * cellCount, UNREACHABLE);
+    queue.resize(cellCount);
+
+    for (int source = 0; source < cellCount; ++source) {
+        if (terrain.cellAt(source % gridSize, source / gridSize) == CellType::Wall) continue;
+
+        quint8* row = &distances[source * cellCount];
+        int head = 0;
+        int tail = 0;
+        row[source] = 0;
+        queue[tail++] = source;
+        while (head < tail) {
+            int cell = queue[head++];
+            int x = cell % gridSize;
+            int y = cell / gridSize;
+            quint8 next = static_cast<quint8>(std::min(row[cell] + 1, UNREACHABLE - 1));
+            for (int d = 0; d < 4; ++d) {
+                int nx = x + DX[d];
+                int ny = y + DY[d];
+                if (nx < 0 || ny < 0 || nx >= gridSize || ny >= gridSize) continue;
+                int neighbour = ny * gridSize + nx;
+                if (row[neighbour] != UNREACHABLE || terrain.cellAt(nx, ny) == CellType::Wall) continue;
+                row[neighbour] = next;
+                queue[tail++] = neighbour;
+            }
+        }
+    }
+
+    builtWallVersion = terrain.getWallVersion();
+    built = true;
+}
+
+void DistanceMatrix::wallDestroyed(const QPoint& pos) {
+    // Only a matrix that was current before this single change can be patched
+    if (!built || gridSize != terrain.getGridSize() || builtWallVersion + 1 != terrain.getWallVersion()) {
+        return;
+    }
+
+    int opened = pos.y() * gridSize + pos.x();
+    quint8* viaRow = &distances[opened * cellCount];
+
+    // A shortest path to the opened cell arrives from one of its neighbours, and reaching that
+    // neighbour never needed the opened cell, so the old entries give the new distances to it
+    viaRow[opened] = 0;
+    for (int cell = 0; cell < cellCount; ++cell) {
+        if (cell == opened) continue;
+        int best = UNREACHABLE;
+        for (int d = 0; d < 4; ++d) {
+            int nx = pos.x() + DX[d];
+            int ny = pos.y() + DY[d];
+            if (nx < 0 || ny < 0 || nx >= gridSize || ny >= gridSize) continue;
+            int dist = distances[cell * cellCount + ny * gridSize + nx];
+            if (dist != UNREACHABLE) best = std::min(best, dist + 1);
+        }
+        quint8 value = static_cast<quint8>(std::min(best, UNREACHABLE - 1));
+        if (best == UNREACHABLE) value = UNREACHABLE;
+        viaRow[cell] = value;
+        distances[cell * cellCount + opened] = value;
+    }
+
+    // Every other pair may now be shorter through the opened cell
+    for (int a = 0; a < cellCount; ++a) {
+        int toOpened = viaRow[a];
+        if (toOpened == UNREACHABLE || a == opened) continue;
+        quint8* row = &distances[a * cellCount];
+        for (int b = 0; b < cellCount; ++b) {
+            int fromOpened = viaRow[b];
+            if (fromOpened == UNREACHABLE) continue;
+            int through = std::min(toOpened + fromOpened, UNREACHABLE - 1);
+            if (through < row[b]) row[b] = static_cast<quint8>(through);
+        }
+    }
+
+    builtWallVersion = terrain.getWallVersion();
+}
@@ -0,0 +1,63 @@
+#ifndef DISTANCEMATRIX_H
+#define DISTANCEMATRIX_H
+
+#include <QPoint>
+#include <QtGlobal>
+#include <vector>
+
+class Terrain;
+
+/**
+ * @brief Walking distance between every pair of cells of a small arena, one byte per pair.
+ *
+ * Built once with a breadth-first search from every cell, after which a distance is a single
+ * table read. Destroying a wall can only shorten paths, so instead of rebuilding, the matrix is
+ * patched by routing every pair through the newly opened cell.
+ *
+ * @author Group 17
+ */
+class DistanceMatrix {
+public:
+    /// Largest grid the matrix is kept for: 256 cells, 64 KiB
+    static const int MAX_GRID_SIZE = 16;
+    /// Stored for pairs with no path between them (and for walls)
+    static constexpr quint8 UNREACHABLE = 0xFF;
+
+    /// @brief Creates an empty matrix, it is built on first use
+    /// @param terrain - the terrain of the match
+    explicit DistanceMatrix(const Terrain& terrain);
+
+    /// @return TRUE if the terrain is small enough for a matrix, FALSE otherwise
+    bool isSupported() const;
+
+    /// @brief Number of moves between two cells, walking around walls
+    /// @param from - the start cell, must be inside the grid
+    /// @param to - the target cell, must be inside the grid
+    /// @return the distance, or UNREACHABLE
+    quint8 distance(const QPoint& from, const QPoint& to);
+
+    /// @brief Patches the matrix after a wall was destroyed
+    /// @param pos - the cell that used to be a wall
+    void wallDestroyed(const QPoint& pos);
+
+    /// @brief Recomputes every entry from the terrain
+    void rebuild();
+    /// @brief Forces a rebuild on the next use, for when the terrain was replaced as a whole
+    void invalidate() { built = false; }
+    /// @brief Sets aside the memory of the matrix for the current grid, when it is supported, so
+    /// that building it later does not allocate
+    void reserve();
+
+private:
+    void ensureCurrent();
+
+    const Terrain& terrain;
+    int gridSize;
+    int cellCount;
+    quint32 builtWallVersion;
+    bool built;
+    std::vector<quint8> distances;  ///< cellCount * cellCount entries
+    std::vector<int> queue;
+};
+
+#endif // DISTANCEMATRIX_H
@@ -0,0 +1,37 @@
+QT += testlib
+QT += widgets concurrent
+QMAKE_CXXFLAGS += -std=c++17
+CONFIG += console
+CONFIG -= app_bundle
+
+# The tests check that steady turns do not allocate
+DEFINES += ROBOTARENA_COUNT_ALLOCATIONS
+
+INCLUDEPATH += . tools
+
+SOURCES += tests/enginetests.cpp
+
+SOURCES += \
+    tests/test_allocations.cpp \
+    tests/test_distancematrix.cpp \
+    tests/test_pathfinding.cpp \
+    tests/test_ratings.cpp \
+    tests/test_sprt.cpp \
+    tools/ratings.cpp \
+    tools/sprt.cpp \
+    tools/tournament.cpp
+
+HEADERS += \
+    tests/test_allocations.h \
+    tests/test_distancematrix.h \
+    tests/test_pathfinding.h \
+    tests/test_ratings.h \
+    tests/test_sprt.h \
+    tests/testmaps.h \
+    tools/ratings.h \
+    tools/sprt.h \
+    tools/tournament.h
+
+include(robotarena.pri)
+
+TARGET = robot_arena_engine_tests
@@ -1,43 +1,130 @@
 #include "game.h"
 #include <QRandomGenerator>
+#include <QtConcurrent>
+#include <algorithm>
+#include <climits>
 #include "robotai.h"
 
-Game::Game(int size, QObject *parent) 
-    : QObject(parent), state(GameState::PlayerTurn), gridSize(size), 
+namespace {
+
+/// Copies a vector into one that is kept, growing its room geometrically rather than to an exact
+/// fit that the next push would outgrow
+template<class T>
+void assignGrowing(std::vector<T>& target, const std::vector<T>& source) {
+    if (target.capacity() < source.size()) {
+        target.reserve(std::max(source.size(), 2 * target.capacity()));
+    }
+    target = source;
+}
+
+} // namespace
+
+Game::Game(int size, QObject *parent, std::unique_ptr<RobotAI> ai, bool withArena) 
+    : QObject(parent), robotAI(std::move(ai)), state(GameState::PlayerTurn), gridSize(size), 
+      pathfinding(terrain, turnArena),
       difficulty(GameDifficulty::Medium), mapType(MapType::Random),
-      multiplayerMode(false),
-      aiHealthModifier(1.0f), aiDamageModifier(1.0f), aiRandomMoveChance(0.2f) {
+      multiplayerMode(false), random(QRandomGenerator::global()->generate()),
+      lastCommand(Command::None), consecutiveTurns(0),
+      aiHealthModifier(1.0f), aiDamageModifier(1.0f), aiRandomMoveChance(0.2f), aiSearchDepth(2),
+      aiTimeBudgetMs(DEFAULT_AI_TIME_BUDGET_MS), aiInterrupt(false), aiSnapshotHash(0), aiStepping(false),
+      ponderingEnabled(false), ponderInterrupt(false) {
     
     playerRobot = std::make_unique<Robot>();
     player2Robot = std::make_unique<Robot>();
     aiRobot = std::make_unique<Robot>();
-    robotAI = std::make_unique<RobotAI>();
-    arena.resize(gridSize, std::vector<CellType>(gridSize, CellType::Empty));
-    wallHealth.resize(gridSize, std::vector<int>(gridSize, 0));
+    if (!robotAI) {
+        robotAI = std::make_unique<RobotAI>();
+    }
+    terrain.reset(gridSize);
 
-    initializeArena(playerRobot->getRobotType(), aiRobot->getRobotType(), difficulty, mapType);
+    if (withArena) {
+        initializeArena(playerRobot->getRobotType(), aiRobot->getRobotType(), difficulty, mapType);
+    }
+}
+
+Game::Game(const Game& source, QObject *parent)
+    : QObject(parent), state(source.state), gridSize(source.gridSize),
+      pathfinding(terrain, turnArena),
+      difficulty(source.difficulty), mapType(source.mapType),
+      multiplayerMode(source.multiplayerMode), random(source.random),
+      lastCommand(Command::None), consecutiveTurns(0),
+      aiHealthModifier(1.0f), aiDamageModifier(1.0f), aiRandomMoveChance(0.2f), aiSearchDepth(2),
+      aiTimeBudgetMs(DEFAULT_AI_TIME_BUDGET_MS), aiInterrupt(false), aiSnapshotHash(0), aiStepping(false),
+      ponderingEnabled(false), ponderInterrupt(false) {
+
+    playerRobot = std::make_unique<Robot>();
+    player2Robot = std::make_unique<Robot>();
+    aiRobot = std::make_unique<Robot>();
+    // No AI: a copy is only ever played through playCommand()
+    copyStateFrom(source);
+}
+
+std::unique_ptr<Game> Game::clone() const {
+    return std::unique_ptr<Game>(new Game(*this, nullptr));
+}
+
+void Game::copyStateFrom(const Game& source) {
+    // A copy that is played on alongside the source usually still has the same walls, its
+    // caches then still hold and are kept together with its own terrain
+    bool sameTerrain = terrain.getBaseMap() && terrain.getBaseMap() == source.terrain.getBaseMap() &&
+                       terrain.hashOverlay() == source.terrain.hashOverlay();
+    state = source.state;
+    gridSize = source.gridSize;
+    if (!sameTerrain) {
+        terrain = source.terrain;
+    }
+    playerRobot->copyStateFrom(*source.playerRobot);
+    player2Robot->copyStateFrom(*source.player2Robot);
+    aiRobot->copyStateFrom(*source.aiRobot);
+    for (int i = 0; i < 4; ++i) {
+        assignGrowing(pickupIndex[i], source.pickupIndex[i]);
+    }
+    difficulty = source.difficulty;
+    mapType = source.mapType;
+    multiplayerMode = source.multiplayerMode;
+    random = source.random;
+    lastCommand = source.lastCommand;
+    consecutiveTurns = source.consecutiveTurns;
+    aiHealthModifier = source.aiHealthModifier;
+    aiDamageModifier = source.aiDamageModifier;
+    aiRandomMoveChance = source.aiRandomMoveChance;
+    aiSearchDepth = source.aiSearchDepth;
+    aiTimeBudgetMs = source.aiTimeBudgetMs;
+    turnArena.reset();
+    if (sameTerrain) {
+        return;
+    }
+
+    // The caches are keyed on wall versions, which the two terrains may share for different
+    // walls, so they are all dropped
+    mapAnalysis = source.mapAnalysis;
+    mapAnalysis.setTerrain(terrain);
+    pathfinding.invalidate();
+    reserveCaches();
+    for (ThreatMap& map : threatMaps) {
+        map.invalidate();
+    }
+    influence.reset(gridSize);
 }
 
 Game::~Game() {
-    // Clean up resources if needed
+    // The worker thread must be done with the AI before it is deleted
+    cancelAiTurn();
 }
 
 void Game::initializeArena(const RobotType& playerType, const RobotType& aiType, 
                            GameDifficulty diff, MapType map) {
+    resetAi();
+
     // Set difficulty and map type
     difficulty = diff;
     mapType = map;
     multiplayerMode = false;
     
-    // Clear arena
-    for (auto& row : arena) {
-        std::fill(row.begin(), row.end(), CellType::Empty);
-    }
-    
-    // Clear wall health
-    for (auto& row : wallHealth) {
-        std::fill(row.begin(), row.end(), 0);
-    }
+    // Start from an empty map, generation below is recorded on top of it
+    terrain.reset(gridSize);
+    rebuildPickupIndex();
+    reserveCaches();
 
     // Generate map based on selected type
     switch (mapType) {
@@ -55,9 +142,9 @@ void Game::initializeArena(const RobotType& playerType, const RobotType& aiType,
             break;
     }
 
-    // Create robots based on the types passed in
-    playerRobot = std::make_unique<Robot>(playerType);
-    aiRobot = std::make_unique<Robot>(aiType);
+    // Reuse the robots, set up for the types passed in
+    playerRobot->reset(playerType);
+    aiRobot->reset(aiType);
     
     // Apply difficulty settings
     applyDifficultySettings();
@@ -67,8 +154,8 @@ void Game::initializeArena(const RobotType& playerType, const RobotType& aiType,
     aiRobot->setPosition(QPoint(gridSize - 1, 0));
 
     // Ensure starting positions are clear
-    arena[gridSize - 1][0] = CellType::Empty;
-    arena[0][gridSize - 1] = CellType::Empty;
+    setCell(0, gridSize - 1, CellType::Empty);
+    setCell(gridSize - 1, 0, CellType::Empty);
 
     // Place health pickups randomly on the map
     placeHealthPickups();
@@ -76,27 +163,64 @@ void Game::initializeArena(const RobotType& playerType, const RobotType& aiType,
     // Place powerups randomly
     placeSpecialPickups();
 
+    // Bake the generated layout into an immutable map that other matches can share
+    terrain.freeze();
+    mapAnalysis.loadOrAnalyse(terrain);
+
     // Set initial state
     state = GameState::PlayerTurn;
+    lastCommand = Command::None;
+    consecutiveTurns = 0;
     
     emit arenaInitialized();
+    startPondering();
+}
+
+void Game::initializeArena(std::shared_ptr<const TerrainMap> baseMap, const RobotType& playerType,
+                           const RobotType& aiType, GameDifficulty diff) {
+    resetAi();
+    difficulty = diff;
+    multiplayerMode = false;
+
+    // Play on the shared layout, only the changes made during this match are stored from now on
+    terrain.reset(std::move(baseMap));
+    gridSize = terrain.getGridSize();
+    rebuildPickupIndex();
+    reserveCaches();
+    mapAnalysis.loadOrAnalyse(terrain);
+
+    // Reuse the robots, set up for the types passed in
+    playerRobot->reset(playerType);
+    aiRobot->reset(aiType);
+
+    // Apply difficulty settings
+    applyDifficultySettings();
+
+    // Position robots at opposite corners, the shared map already keeps these clear
+    playerRobot->setPosition(QPoint(0, gridSize - 1));
+    aiRobot->setPosition(QPoint(gridSize - 1, 0));
+
+    // Set initial state
+    state = GameState::PlayerTurn;
+    lastCommand = Command::None;
+    consecutiveTurns = 0;
+
+    emit arenaInitialized();
+    startPondering();
 }
 
 void Game::initializeMultiplayerArena(const RobotType& player1Type, const RobotType& player2Type, 
                                      MapType map) {
+    resetAi();
+
     // Set map type and enable multiplayer mode
     mapType = map;
     multiplayerMode = true;
     
-    // Clear arena
-    for (auto& row : arena) {
-        std::fill(row.begin(), row.end(), CellType::Empty);
-    }
-    
-    // Clear wall health
-    for (auto& row : wallHealth) {
-        std::fill(row.begin(), row.end(), 0);
-    }
+    // Start from an empty map, generation below is recorded on top of it
+    terrain.reset(gridSize);
+    rebuildPickupIndex();
+    reserveCaches();
 
     // Generate map based on selected type
     switch (mapType) {
@@ -114,17 +238,17 @@ void Game::initializeMultiplayerArena(const RobotType& player1Type, const RobotT
             break;
     }
 
-    // Create robots based on the types passed in
-    playerRobot = std::make_unique<Robot>(player1Type);
-    player2Robot = std::make_unique<Robot>(player2Type);
+    // Reuse the robots, set up for the types passed in
+    playerRobot->reset(player1Type);
+    player2Robot->reset(player2Type);
     
     // Position robots at opposite corners with clear paths
     playerRobot->setPosition(QPoint(0, gridSize - 1));
     player2Robot->setPosition(QPoint(gridSize - 1, 0));
 
     // Ensure starting positions are clear
-    arena[gridSize - 1][0] = CellType::Empty;
-    arena[0][gridSize - 1] = CellType::Empty;
+    setCell(0, gridSize - 1, CellType::Empty);
+    setCell(gridSize - 1, 0, CellType::Empty);
 
     // Place health pickups randomly on the map
     placeHealthPickups();
@@ -132,10 +256,17 @@ void Game::initializeMultiplayerArena(const RobotType& player1Type, const RobotT
     // Place powerups randomly
     placeSpecialPickups();
 
+    // Bake the generated layout into an immutable map that other matches can share
+    terrain.freeze();
+    mapAnalysis.loadOrAnalyse(terrain);
+
     // Set initial state
     state = GameState::PlayerTurn;
+    lastCommand = Command::None;
+    consecutiveTurns = 0;
     
     emit arenaInitialized();
+    startPondering();
 }
 
 void Game::setMapType(MapType map) {
@@ -152,27 +283,40 @@ void Game::applyDifficultySettings() {
         case GameDifficulty::Easy:
             aiHealthModifier = 0.7f;  // 70% of normal health
             aiDamageModifier = 0.7f;  // 70% of normal damage
-            aiRandomMoveChance = 0.5f; // 50% chance of random move
+            aiSearchDepth = 1;        // Only looks at its own turn
             break;
             
         case GameDifficulty::Medium:
             aiHealthModifier = 1.0f;  // Normal health
             aiDamageModifier = 1.0f;  // Normal damage
-            aiRandomMoveChance = 0.2f; // 20% chance of random move
+            aiSearchDepth = 2;        // Also sees the reply of the opponent
             break;
             
         case GameDifficulty::Hard:
             aiHealthModifier = 1.3f;  // 130% of normal health
             aiDamageModifier = 1.3f;  // 130% of normal damage
-            aiRandomMoveChance = 0.05f; // Only 5% chance of random move
+            aiSearchDepth = 4;        // Looks two full rounds ahead
             break;
     }
+    aiRandomMoveChance = randomMoveChanceFor(difficulty);
     
     // Apply health modifier to AI robot
     int newHealth = static_cast<int>(aiRobot->getMaxHealth() * aiHealthModifier);
     aiRobot->setHealth(newHealth);
 }
 
+float Game::randomMoveChanceFor(GameDifficulty difficulty) {
+    switch (difficulty) {
+        case GameDifficulty::Easy:
+            return 0.5f;   // Half of its moves are random
+        case GameDifficulty::Hard:
+            return 0.05f;  // Hardly ever random
+        case GameDifficulty::Medium:
+        default:
+            return 0.2f;
+    }
+}
+
 void Game::setDifficulty(GameDifficulty diff) {
     difficulty = diff;
     applyDifficultySettings();
@@ -182,11 +326,10 @@ void Game::generateObstacles() {
     // Add walls (25% of grid)
     int numWalls = (gridSize * gridSize) / 4;
     for (int i = 0; i < numWalls; ++i) {
-        int x = QRandomGenerator::global()->bounded(gridSize);
-        int y = QRandomGenerator::global()->bounded(gridSize);
-        if (arena[y][x] == CellType::Empty) {
-            arena[y][x] = CellType::Wall;
-            wallHealth[y][x] = INITIAL_WALL_HEALTH;
+        int x = random.bounded(gridSize);
+        int y = random.bounded(gridSize);
+        if (terrain.cellAt(x, y) == CellType::Empty) {
+            setCell(x, y, CellType::Wall, INITIAL_WALL_HEALTH);
         }
     }
 }
@@ -201,16 +344,15 @@ void Game::generateOpenMap() {
     int radius = gridSize / 4;
     
     for (int i = 0; i < numWalls; ++i) {
-        int x = centerX + QRandomGenerator::global()->bounded(radius * 2) - radius;
-        int y = centerY + QRandomGenerator::global()->bounded(radius * 2) - radius;
+        int x = centerX + random.bounded(radius * 2) - radius;
+        int y = centerY + random.bounded(radius * 2) - radius;
         
         // Ensure x and y are within bounds
         x = qBound(0, x, gridSize - 1);
         y = qBound(0, y, gridSize - 1);
         
-        if (arena[y][x] == CellType::Empty) {
-            arena[y][x] = CellType::Wall;
-            wallHealth[y][x] = INITIAL_WALL_HEALTH;
+        if (terrain.cellAt(x, y) == CellType::Empty) {
+            setCell(x, y, CellType::Wall, INITIAL_WALL_HEALTH);
         }
     }
 }
@@ -223,8 +365,7 @@ void Game::generateMazeMap() {
         for (int x = 0; x < gridSize; x++) {
             if ((x % 2 == 0 && y % 2 == 0) || 
                 (x % 2 == 1 && y % 2 == 1)) {
-                arena[y][x] = CellType::Wall;
-                wallHealth[y][x] = INITIAL_WALL_HEALTH;
+                setCell(x, y, CellType::Wall, INITIAL_WALL_HEALTH);
             }
         }
     }
@@ -232,17 +373,16 @@ void Game::generateMazeMap() {
     // Add some random walls to make it more maze-like
     int numExtraWalls = gridSize * 2;
     for (int i = 0; i < numExtraWalls; ++i) {
-        int x = QRandomGenerator::global()->bounded(gridSize);
-        int y = QRandomGenerator::global()->bounded(gridSize);
+        int x = random.bounded(gridSize);
+        int y = random.bounded(gridSize);
         
         // Don't block the corners where robots start
         if ((x == 0 && y == gridSize - 1) || (x == gridSize - 1 && y == 0)) {
             continue;
         }
         
-        if (arena[y][x] == CellType::Empty) {
-            arena[y][x] = CellType::Wall;
-            wallHealth[y][x] = INITIAL_WALL_HEALTH;
+        if (terrain.cellAt(x, y) == CellType::Empty) {
+            setCell(x, y, CellType::Wall, INITIAL_WALL_HEALTH);
         }
     }
     
@@ -251,11 +391,11 @@ void Game::generateMazeMap() {
     for (int i = 1; i < gridSize - 1; i++) {
         // Create a zigzag path
         if (i % 2 == 0) {
-            arena[i][i] = CellType::Empty;
-            arena[i][i+1] = CellType::Empty;
+            setCell(i, i, CellType::Empty);
+            setCell(i+1, i, CellType::Empty);
         } else {
-            arena[i][i] = CellType::Empty;
-            arena[i+1][i] = CellType::Empty;
+            setCell(i, i, CellType::Empty);
+            setCell(i, i+1, CellType::Empty);
         }
     }
 }
@@ -273,24 +413,22 @@ void Game::generateFortressMap() {
         for (int x = 1; x < gridSize - 1; x++) {
             // Create perimeter walls
             if (x == 1 || x == gridSize - 2 || y == 1 || y == gridSize - 2) {
-                arena[y][x] = CellType::Wall;
-                wallHealth[y][x] = INITIAL_WALL_HEALTH;
+                setCell(x, y, CellType::Wall, INITIAL_WALL_HEALTH);
             }
             
             // Create fortress in the center
             if (abs(x - centerX) < fortressSize/2 && abs(y - centerY) < fortressSize/2) {
-                arena[y][x] = CellType::Wall;
-                wallHealth[y][x] = INITIAL_WALL_HEALTH;
+                setCell(x, y, CellType::Wall, INITIAL_WALL_HEALTH);
             }
         }
     }
     
     // Create entrances in the perimeter walls
     int entrancePos = gridSize / 2;
-    arena[1][entrancePos] = CellType::Empty; // Top entrance
-    arena[gridSize - 2][entrancePos] = CellType::Empty; // Bottom entrance
-    arena[entrancePos][1] = CellType::Empty; // Left entrance
-    arena[entrancePos][gridSize - 2] = CellType::Empty; // Right entrance
+    setCell(entrancePos, 1, CellType::Empty); // Top entrance
+    setCell(entrancePos, gridSize - 2, CellType::Empty); // Bottom entrance
+    setCell(1, entrancePos, CellType::Empty); // Left entrance
+    setCell(gridSize - 2, entrancePos, CellType::Empty); // Right entrance
 }
 
 void Game::setPlayerRobotType(RobotType type) {
@@ -351,26 +489,151 @@ void Game::setAiRobotType(RobotType type) {
 }
 
 bool Game::attackWall(const QPoint& pos, int damage) {
-    if (!isValidPosition(pos) || arena[pos.y()][pos.x()] != CellType::Wall) {
+    if (!isValidPosition(pos) || terrain.cellAt(pos) != CellType::Wall) {
         return false;
     }
 
-    wallHealth[pos.y()][pos.x()] -= damage;
+    int remainingHealth = terrain.wallHealthAt(pos) - damage;
     
-    if (wallHealth[pos.y()][pos.x()] <= 0) {
-        arena[pos.y()][pos.x()] = CellType::Empty;
-        wallHealth[pos.y()][pos.x()] = 0;
+    if (remainingHealth <= 0) {
+        setCell(pos, CellType::Empty);
+        pathfinding.wallDamaged(pos);
+        mapAnalysis.wallDestroyed(pos);
         emit wallDestroyed(pos);
         return true;
     }
+    setCell(pos, CellType::Wall, remainingHealth);
+    pathfinding.wallDamaged(pos);
     return false;
 }
 
+namespace {
+// Slot of a pickup type in the pickup index, -1 for cells that are not pickups
+int pickupSlot(CellType type) {
+    switch (type) {
+        case CellType::HealthPickup:   return 0;
+        case CellType::LaserPowerUp:   return 1;
+        case CellType::MissilePowerUp: return 2;
+        case CellType::BombPowerUp:    return 3;
+        default:                       return -1;
+    }
+}
+}
+
+void Game::setCell(int x, int y, CellType type, int health) {
+    // Keep the pickup index in step with every change to the terrain
+    int oldSlot = pickupSlot(terrain.cellAt(x, y));
+    if (oldSlot != -1) {
+        std::vector<QPoint>& list = pickupIndex[oldSlot];
+        auto it = std::find(list.begin(), list.end(), QPoint(x, y));
+        if (it != list.end()) {
+            *it = list.back();
+            list.pop_back();
+        }
+    }
+
+    terrain.setCell(x, y, type, health);
+    influence.markDirty(y);
+
+    int newSlot = pickupSlot(type);
+    if (newSlot != -1) {
+        pickupIndex[newSlot].push_back(QPoint(x, y));
+    }
+}
+
+void Game::rebuildPickupIndex() {
+    for (std::vector<QPoint>& list : pickupIndex) {
+        list.clear();
+    }
+    influence.reset(gridSize);
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            int slot = pickupSlot(terrain.cellAt(x, y));
+            if (slot != -1) {
+                pickupIndex[slot].push_back(QPoint(x, y));
+            }
+        }
+    }
+}
+
+void Game::reserveCaches() {
+    pathfinding.reserve();
+    mapAnalysis.reserve();
+    for (ThreatMap& map : threatMaps) {
+        map.reserve(gridSize);
+    }
+}
+
+const std::vector<QPoint>& Game::getPickups(CellType type) const {
+    static const std::vector<QPoint> none;
+    int slot = pickupSlot(type);
+    return slot == -1 ? none : pickupIndex[slot];
+}
+
+QPoint Game::findNearestPickup(const QPoint& from, CellType type, int searchRadius) {
+    QPoint best(-1, -1);
+    int bestRank = INT_MAX;
+    for (const QPoint& pos : getPickups(type)) {
+        if (std::abs(pos.x() - from.x()) > searchRadius || std::abs(pos.y() - from.y()) > searchRadius) {
+            continue;
+        }
+        // Rank by walking distance, pickups behind walls still count but after the reachable ones
+        int rank = pathfinding.distance(from, pos);
+        if (rank == PathfindingService::UNREACHABLE) {
+            rank = PathfindingService::UNREACHABLE + std::abs(pos.x() - from.x()) + std::abs(pos.y() - from.y());
+        }
+        if (rank < bestRank) {
+            bestRank = rank;
+            best = pos;
+        }
+    }
+    return best;
+}
+
+QPoint Game::findNearestPowerUp(const QPoint& from, int searchRadius) {
+    QPoint best(-1, -1);
+    int bestDist = INT_MAX;
+    const CellType types[] = { CellType::LaserPowerUp, CellType::MissilePowerUp, CellType::BombPowerUp };
+    for (CellType type : types) {
+        QPoint pos = findNearestPickup(from, type, searchRadius);
+        if (pos.x() == -1) continue;
+        int dist = pathfinding.distance(from, pos);
+        if (dist == PathfindingService::UNREACHABLE) {
+            dist = PathfindingService::UNREACHABLE + std::abs(pos.x() - from.x()) + std::abs(pos.y() - from.y());
+        }
+        if (dist < bestDist) {
+            bestDist = dist;
+            best = pos;
+        }
+    }
+    return best;
+}
+
+const ThreatMap& Game::getThreatMap(const Robot* robot) {
+    int slot = (robot == playerRobot.get()) ? 0 : (robot == player2Robot.get() ? 1 : 2);
+    threatMaps[slot].update(*robot, terrain, pathfinding);
+    return threatMaps[slot];
+}
+
+const InfluenceMap& Game::getInfluenceMap(const Robot* opponent) {
+    influence.update(terrain, getThreatMap(opponent));
+    return influence;
+}
+
+int Game::getWallDamage(const Robot* robot) const {
+    switch (robot->getType()) {
+        case RobotType::Tank:   return 3;
+        case RobotType::Sniper: return 2;
+        case RobotType::Scout:  return 1;
+    }
+    return 1;
+}
+
 int Game::getWallHealth(const QPoint& pos) const {
-    if (!isValidPosition(pos) || arena[pos.y()][pos.x()] != CellType::Wall) {
+    if (!isValidPosition(pos) || terrain.cellAt(pos) != CellType::Wall) {
         return 0;
     }
-    return wallHealth[pos.y()][pos.x()];
+    return terrain.wallHealthAt(pos);
 }
 
 void Game::placeHealthPickups() {
@@ -378,16 +641,16 @@ void Game::placeHealthPickups() {
     int pickupsPlaced = 0;
     
     while (pickupsPlaced < NUM_HEALTH_PICKUPS) {
-        int x = QRandomGenerator::global()->bounded(gridSize);
-        int y = QRandomGenerator::global()->bounded(gridSize);
+        int x = random.bounded(gridSize);
+        int y = random.bounded(gridSize);
         
         // Check if the cell is empty and not a robot position
         QPoint pos(x, y);
-        if (arena[y][x] == CellType::Empty && 
+        if (terrain.cellAt(x, y) == CellType::Empty && 
             pos != playerRobot->getPosition() && 
             pos != (multiplayerMode ? player2Robot->getPosition() : aiRobot->getPosition())) {
             
-            arena[y][x] = CellType::HealthPickup;
+            setCell(x, y, CellType::HealthPickup);
             pickupsPlaced++;
         }
     }
@@ -397,8 +660,8 @@ void Game::spawnHealthPickup(int count) {
     // Clear existing health pickups
     for (int y = 0; y < gridSize; ++y) {
         for (int x = 0; x < gridSize; ++x) {
-            if (arena[y][x] == CellType::HealthPickup) {
-                arena[y][x] = CellType::Empty;
+            if (terrain.cellAt(x, y) == CellType::HealthPickup) {
+                setCell(x, y, CellType::Empty);
             }
         }
     }
@@ -407,16 +670,16 @@ void Game::spawnHealthPickup(int count) {
     int pickupsPlaced = 0;
     
     while (pickupsPlaced < count) {
-        int x = QRandomGenerator::global()->bounded(gridSize);
-        int y = QRandomGenerator::global()->bounded(gridSize);
+        int x = random.bounded(gridSize);
+        int y = random.bounded(gridSize);
         
         // Check if the cell is empty and not a robot position
         QPoint pos(x, y);
-        if (arena[y][x] == CellType::Empty && 
+        if (terrain.cellAt(x, y) == CellType::Empty && 
             pos != playerRobot->getPosition() && 
             pos != (multiplayerMode ? player2Robot->getPosition() : aiRobot->getPosition())) {
             
-            arena[y][x] = CellType::HealthPickup;
+            setCell(x, y, CellType::HealthPickup);
             pickupsPlaced++;
         }
     }
@@ -428,11 +691,11 @@ bool Game::placePowerUpAtPosition(const QPoint& pos, CellType powerUpType) {
     }
     
     // Check if the cell is empty or already contains a pickup
-    if (arena[pos.y()][pos.x()] == CellType::Empty || 
-        arena[pos.y()][pos.x()] == CellType::HealthPickup ||
-        arena[pos.y()][pos.x()] == CellType::LaserPowerUp ||
-        arena[pos.y()][pos.x()] == CellType::MissilePowerUp ||
-        arena[pos.y()][pos.x()] == CellType::BombPowerUp) {
+    if (terrain.cellAt(pos) == CellType::Empty || 
+        terrain.cellAt(pos) == CellType::HealthPickup ||
+        terrain.cellAt(pos) == CellType::LaserPowerUp ||
+        terrain.cellAt(pos) == CellType::MissilePowerUp ||
+        terrain.cellAt(pos) == CellType::BombPowerUp) {
         
         // Check that it's not on top of any robot
         if (pos != playerRobot->getPosition() &&
@@ -440,7 +703,7 @@ bool Game::placePowerUpAtPosition(const QPoint& pos, CellType powerUpType) {
              ? (pos != player2Robot->getPosition())
              : (pos != aiRobot->getPosition()))) {
             
-            arena[pos.y()][pos.x()] = powerUpType;
+            setCell(pos, powerUpType);
             return true;
         }
     }
@@ -449,7 +712,7 @@ bool Game::placePowerUpAtPosition(const QPoint& pos, CellType powerUpType) {
 }
 
 void Game::collectHealthPickup(const QPoint& pos, Robot* robot) {
-    if (!isValidPosition(pos) || arena[pos.y()][pos.x()] != CellType::HealthPickup || !robot) {
+    if (!isValidPosition(pos) || terrain.cellAt(pos) != CellType::HealthPickup || !robot) {
         return;
     }
     
@@ -465,7 +728,7 @@ void Game::collectHealthPickup(const QPoint& pos, Robot* robot) {
     robot->setHealth(newHealth);
     
     // Remove the health pickup
-    arena[pos.y()][pos.x()] = CellType::Empty;
+    setCell(pos, CellType::Empty);
     
     // Emit signal that a health pickup was collected
     emit healthPickupCollected(pos);
@@ -486,6 +749,28 @@ void Game::executeCommand(Command cmd) {
         return; // Not a valid state for player commands
     }
 
+    if (cmd == Command::None) {
+        checkGameOver();
+        return;
+    }
+
+    // Only proceed if a command was actually executed
+    if (applyCommand(activeRobot, targetRobot, cmd)) {
+        finishCommand(activeRobot, cmd);
+    }
+}
+
+void Game::playCommand(Command cmd) {
+    Robot* activeRobot = getActiveRobot();
+    if (!activeRobot || activeRobot->getMovesLeft() <= 0) {
+        return;
+    }
+    if (applyCommand(activeRobot, getOpponentOf(activeRobot), cmd)) {
+        finishCommand(activeRobot, cmd);
+    }
+}
+
+bool Game::applyCommand(Robot* activeRobot, Robot* targetRobot, Command cmd) {
     QPoint oldPos = activeRobot->getPosition();
     bool commandExecuted = false;
 
@@ -506,14 +791,14 @@ void Game::executeCommand(Command cmd) {
                 activeRobot->useMove();
                 
                 // Check if the robot moved onto a health pickup
-                if (arena[newPos.y()][newPos.x()] == CellType::HealthPickup) {
+                if (terrain.cellAt(newPos) == CellType::HealthPickup) {
                     collectHealthPickup(newPos, activeRobot);
                 }
                 // Check if robot moved to powerup tile
-                else if (arena[newPos.y()][newPos.x()] == CellType::LaserPowerUp || 
-                    arena[newPos.y()][newPos.x()] == CellType::MissilePowerUp ||
-                    arena[newPos.y()][newPos.x()] == CellType::BombPowerUp) {
-                    collectPowerUp(newPos, activeRobot, arena[newPos.y()][newPos.x()]);
+                else if (terrain.cellAt(newPos) == CellType::LaserPowerUp || 
+                    terrain.cellAt(newPos) == CellType::MissilePowerUp ||
+                    terrain.cellAt(newPos) == CellType::BombPowerUp) {
+                    collectPowerUp(newPos, activeRobot, terrain.cellAt(newPos));
                 }
                 
                 commandExecuted = true;
@@ -552,7 +837,7 @@ void Game::executeCommand(Command cmd) {
                         break;
                     
                     // If there's a wall, mark as a hit
-                    if (arena[nextPos.y()][nextPos.x()] == CellType::Wall) {
+                    if (terrain.cellAt(nextPos) == CellType::Wall) {
                         hitPos = nextPos;
                         actualHit = true;
                         break;
@@ -574,10 +859,8 @@ void Game::executeCommand(Command cmd) {
                 emit projectileFired(startPos, hitPos, activeRobot->getDirection(), actualHit, PowerUpType::Normal);
                 
                 // Then apply damage
-                if (isValidPosition(hitPos) && arena[hitPos.y()][hitPos.x()] == CellType::Wall) {
-                    int wallDamage = (activeRobot->getType() == RobotType::Tank) ? 3 :
-                                        (activeRobot->getType() == RobotType::Sniper ? 2 : 1);
-                    attackWall(hitPos, wallDamage);
+                if (isValidPosition(hitPos) && terrain.cellAt(hitPos) == CellType::Wall) {
+                    attackWall(hitPos, getWallDamage(activeRobot));
                 }
                 else if (hasLineOfSight(activeRobot->getPosition(), targetRobot->getPosition()) &&
                             ((activeRobot->getDirection() == Direction::North && targetRobot->getPosition().y() < activeRobot->getPosition().y()) ||
@@ -609,7 +892,7 @@ void Game::executeCommand(Command cmd) {
                         if (!isValidPosition(cur)) break; // out of bounds
     
                         // If it's a wall, damage by 15
-                        if (arena[cur.y()][cur.x()] == CellType::Wall) {
+                        if (terrain.cellAt(cur) == CellType::Wall) {
                             attackWall(cur, 15);
                         }
                         else {
@@ -666,7 +949,7 @@ void Game::executeCommand(Command cmd) {
                         }
                         hitPos = nextPos;
                         // if we find a wall or robot, break
-                        if (arena[hitPos.y()][hitPos.x()] == CellType::Wall) {
+                        if (terrain.cellAt(hitPos) == CellType::Wall) {
                             // damage wall for 20
                             attackWall(hitPos, 20);
                             hitSomething = true;
@@ -730,7 +1013,7 @@ void Game::executeCommand(Command cmd) {
                         }
                         hitPos = nextPos;
                         // if we find a wall or robot, break
-                        if (arena[hitPos.y()][hitPos.x()] == CellType::Wall) {
+                        if (terrain.cellAt(hitPos) == CellType::Wall) {
                             // we don't do direct damage yet, the bomb AoE will handle that
                             bombDetonated = true;
                             break;
@@ -758,7 +1041,7 @@ void Game::executeCommand(Command cmd) {
                             if (!isValidPosition(areaPos)) continue;
     
                             // If there's a wall, damage it
-                            if (arena[areaPos.y()][areaPos.x()] == CellType::Wall) {
+                            if (terrain.cellAt(areaPos) == CellType::Wall) {
                                 attackWall(areaPos, 30);
                             }
                             else {
@@ -797,356 +1080,474 @@ void Game::executeCommand(Command cmd) {
             break;
         }
         case Command::None:
-            checkGameOver();
+            // Nothing to do
             break;
     }
 
-    // Only proceed if a command was actually executed
-    if (commandExecuted) {
-        // Check if we need to switch turns
-        if (activeRobot->getMovesLeft() <= 0) {
-            checkGameOver();
-            if (state != GameState::GameOver) {
-                switchTurn();
-            }
+    return commandExecuted;
+}
+
+void Game::finishCommand(Robot* activeRobot, Command cmd) {
+    recordCommand(cmd);
+
+    // Check if we need to switch turns
+    if (activeRobot->getMovesLeft() <= 0) {
+        checkGameOver();
+        if (state != GameState::GameOver) {
+            switchTurn();
         }
-        
-        // Always emit turnComplete to update the UI
-        emit turnComplete();
     }
+
+    // Always emit turnComplete to update the UI
+    emit turnComplete();
 }
 
+
 void Game::executeAiTurn() {
-    if (state != GameState::AiTurn) return;
+    // A decision running on a worker thread is using the AI
+    if (state != GameState::AiTurn || !robotAI || aiSnapshot) return;
+    stopPondering();
 
     Robot* ai = aiRobot.get();
     
     if (ai->getMovesLeft() > 0) {
-        // Use the RobotAI class to calculate the next move
-        Command aiMove = robotAI->calculateMove(this, ai, playerRobot.get());
-        QPoint oldPos = ai->getPosition();
-        bool commandExecuted = false;
-
-        switch (aiMove) {
-            case Command::MoveForward: {
-                // Calculate new position before moving
-                QPoint newPos = oldPos;
-                switch (ai->getDirection()) {
-                    case Direction::North: newPos.setY(newPos.y() - 1); break;
-                    case Direction::East:  newPos.setX(newPos.x() + 1); break;
-                    case Direction::South: newPos.setY(newPos.y() + 1); break;
-                    case Direction::West:  newPos.setX(newPos.x() - 1); break;
-                }
-                
-                // Only move if the new position is valid
-                if (isValidMove(newPos)) {
-                    ai->setPosition(newPos);
-                    ai->useMove();
-                    
-                    // Check if the AI moved onto a health pickup
-                    if (arena[newPos.y()][newPos.x()] == CellType::HealthPickup) {
-                        collectHealthPickup(newPos, ai);
-                    }
-                    // Check if AI moved to powerup tile
-                    else if (arena[newPos.y()][newPos.x()] == CellType::LaserPowerUp || 
-                        arena[newPos.y()][newPos.x()] == CellType::MissilePowerUp ||
-                        arena[newPos.y()][newPos.x()] == CellType::BombPowerUp) {
-                        collectPowerUp(newPos, ai, arena[newPos.y()][newPos.x()]);
-                    }
-                    
-                    commandExecuted = true;
-                }
-                break;
-            }
-            case Command::TurnLeft:
-                ai->turnLeft();
-                // No move cost for turning
-                commandExecuted = true;
-                break;
-            case Command::TurnRight:
-                ai->turnRight();
-                // No move cost for turning
-                commandExecuted = true;
-                break;
-            case Command::Attack: {
-                RobotPowerUp powerUp = getRobotPowerUp(ai);
+        // Use the RobotAI class to calculate the next move, within the time budget
+        aiInterrupt.store(false, std::memory_order_relaxed);
+        lastAiDecision = robotAI->decide(this, ai, playerRobot.get(), aiTurnBudget());
+        Command aiMove = lastAiDecision.command;
+        if (applyCommand(ai, playerRobot.get(), aiMove)) {
+            finishCommand(ai, aiMove);
+        }
+    }
+}
 
-                if (powerUp == RobotPowerUp::None) {
-                    int attackRange = (ai->getType() == RobotType::Sniper) ? 3 : 1;
-                    QPoint startPos = ai->getPosition();
-                    QPoint hitPos = startPos;
-                    bool actualHit = false;
-
-                    // Calculate the hit tile along the AI's facing direction
-                    for (int step = 1; step <= attackRange; ++step) {
-                        QPoint nextPos = startPos;
-                        switch (ai->getDirection()) {
-                            case Direction::North: nextPos.setY(startPos.y() - step); break;
-                            case Direction::East:  nextPos.setX(startPos.x() + step); break;
-                            case Direction::South: nextPos.setY(startPos.y() + step); break;
-                            case Direction::West:  nextPos.setX(startPos.x() - step); break;
-                        }
-                        if (!isValidPosition(nextPos))
-                            break;
-                        
-                        // If there's a wall at this tile, mark it as a hit
-                        if (arena[nextPos.y()][nextPos.x()] == CellType::Wall) {
-                            hitPos = nextPos;
-                            actualHit = true;
-                            break;
-                        }
-                        
-                        // If the player's robot is present, mark it as a hit
-                        if (nextPos == playerRobot->getPosition()) {
-                            hitPos = nextPos;
-                            actualHit = true;
-                            break;
-                        }
-                        
-                        // Otherwise, continue
-                        hitPos = nextPos;
-                    }
-                    
-                    // Emit the projectile signal with the hit flag
-                    emit projectileFired(startPos, hitPos, ai->getDirection(), actualHit, PowerUpType::Normal);
-                    
-                    // Then apply the damage
-                    if (isValidPosition(hitPos) && arena[hitPos.y()][hitPos.x()] == CellType::Wall) {
-                        int wallDamage = (ai->getType() == RobotType::Tank) ? 3 :
-                                            (ai->getType() == RobotType::Sniper ? 2 : 1);
-                        attackWall(hitPos, wallDamage);
-                    }
-                    else if (hasLineOfSight(ai->getPosition(), playerRobot->getPosition()) &&
-                                ((ai->getDirection() == Direction::North && playerRobot->getPosition().y() < ai->getPosition().y()) ||
-                                (ai->getDirection() == Direction::South && playerRobot->getPosition().y() > ai->getPosition().y()) ||
-                                (ai->getDirection() == Direction::East  && playerRobot->getPosition().x() > ai->getPosition().x()) ||
-                                (ai->getDirection() == Direction::West  && playerRobot->getPosition().x() < ai->getPosition().x()))) {
-                        attack(ai, playerRobot.get());
-                    }
-                }
-                else {
-                    // Special powerup; use it ONCE, then remove it
-                    switch (powerUp) {
-                    case RobotPowerUp::Laser: {
-                        // Laser: instant line effect, 15 damage to everything in line, no projectile
-                        QPoint startPos = ai->getPosition();
-                        int dx = 0, dy = 0;
-                        switch (ai->getDirection()) {
-                        case Direction::North: dy = -1; break;
-                        case Direction::South: dy = 1;  break;
-                        case Direction::East:  dx = 1;  break;
-                        case Direction::West:  dx = -1; break;
-                        }
-            
-                        // Step until out of bounds
-                        QPoint cur = startPos;
-                        while (true) {
-                            cur.setX(cur.x() + dx);
-                            cur.setY(cur.y() + dy);
-                            if (!isValidPosition(cur)) break; // out of bounds
-            
-                            // If it's a wall, damage by 15
-                            if (arena[cur.y()][cur.x()] == CellType::Wall) {
-                                attackWall(cur, 15);
-                            }
-                            else {
-                                // If there's a robot there (check for multiplayer or AI):
-                                if (multiplayerMode) {
-                                    if (cur == playerRobot->getPosition()) {
-                                        int newHealth = std::max(0, playerRobot->getHealth() - 15);
-                                        playerRobot->setHealth(newHealth);
-                                    }
-                                    if (cur == player2Robot->getPosition()) {
-                                        int newHealth = std::max(0, player2Robot->getHealth() - 15);
-                                        player2Robot->setHealth(newHealth);
-                                    }
-                                }
-                                else {
-                                    if (cur == playerRobot->getPosition()) {
-                                        int newHealth = std::max(0, playerRobot->getHealth() - 15);
-                                        playerRobot->setHealth(newHealth);
-                                    }
-                                    if (cur == aiRobot->getPosition()) {
-                                        int dmg = static_cast<int>(15 * aiDamageModifier);
-                                        int newHealth = std::max(0, aiRobot->getHealth() - dmg);
-                                        aiRobot->setHealth(newHealth);
-                                    }
-                                }
-                            }
-                        }
-                        emit projectileFired(startPos, cur, ai->getDirection(), true, PowerUpType::Laser);
-            
-                        // Clear the powerup
-                        setRobotPowerUp(ai, RobotPowerUp::None);
-                        break;
-                    }
-                    case RobotPowerUp::Missile: {
-                        // Missile: unlimited range, 20 damage, stops on first impact (wall or robot).
-                        QPoint startPos = ai->getPosition();
-                        QPoint hitPos = startPos;
-                        bool hitSomething = false;
-            
-                        int dx = 0, dy = 0;
-                        switch (ai->getDirection()) {
-                        case Direction::North: dy = -1; break;
-                        case Direction::South: dy = 1; break;
-                        case Direction::East:  dx = 1; break;
-                        case Direction::West:  dx = -1; break;
-                        }
-            
-                        while (true) {
-                            QPoint nextPos = QPoint(hitPos.x() + dx, hitPos.y() + dy);
-                            if (!isValidPosition(nextPos)) {
-                                // out of bounds
-                                break;
-                            }
-                            hitPos = nextPos;
-                            // if we find a wall or robot, break
-                            if (arena[hitPos.y()][hitPos.x()] == CellType::Wall) {
-                                // damage wall for 20
-                                attackWall(hitPos, 20);
-                                hitSomething = true;
-                                break;
-                            }
-                            // Check if it's the other robot
-                            if (multiplayerMode) {
-                                if (hitPos == playerRobot->getPosition() || hitPos == player2Robot->getPosition()) {
-                                    // apply 20 damage
-                                    if (hitPos == playerRobot->getPosition()) {
-                                        playerRobot->setHealth(std::max(0, playerRobot->getHealth() - 20));
-                                    } else {
-                                        player2Robot->setHealth(std::max(0, player2Robot->getHealth() - 20));
-                                    }
-                                    hitSomething = true;
-                                    break;
-                                }
-                            }
-                            else {
-                                // single player
-                                if (hitPos == playerRobot->getPosition()) {
-                                    playerRobot->setHealth(std::max(0, playerRobot->getHealth() - 20));
-                                    hitSomething = true;
-                                    break;
-                                }
-                                else if (hitPos == aiRobot->getPosition()) {
-                                    int dmg = static_cast<int>(20 * aiDamageModifier);
-                                    aiRobot->setHealth(std::max(0, aiRobot->getHealth() - dmg));
-                                    hitSomething = true;
-                                    break;
-                                }
-                            }
-                        }
-            
-                        emit projectileFired(startPos, hitPos, ai->getDirection(), hitSomething, PowerUpType::Missile);
-            
-                        // Clear the powerup
-                        setRobotPowerUp(ai, RobotPowerUp::None);
-                        break;
-                    }
-                    case RobotPowerUp::Bomb: {
-                        // Bomb: behaves like the missile (unlimited range), but upon hitting or going out of bounds
-                        // it deals 30 damage in a 3x3 area around the final position (hitPos)
-                        QPoint startPos = ai->getPosition();
-                        QPoint hitPos = startPos;
-                        bool bombDetonated = false;
-            
-                        int dx = 0, dy = 0;
-                        switch (ai->getDirection()) {
-                        case Direction::North: dy = -1; break;
-                        case Direction::South: dy = 1; break;
-                        case Direction::East:  dx = 1; break;
-                        case Direction::West:  dx = -1; break;
-                        }
-            
-                        while (true) {
-                            QPoint nextPos = QPoint(hitPos.x() + dx, hitPos.y() + dy);
-                            if (!isValidPosition(nextPos)) {
-                                // out of bounds -> bomb detonates
-                                break;
-                            }
-                            hitPos = nextPos;
-                            // if we find a wall or robot, break
-                            if (arena[hitPos.y()][hitPos.x()] == CellType::Wall) {
-                                // no direct damage yet, the bomb AoE will handle that
-                                bombDetonated = true;
-                                break;
-                            }
-                            if (multiplayerMode) {
-                                if (hitPos == playerRobot->getPosition() || hitPos == player2Robot->getPosition()) {
-                                    bombDetonated = true;
-                                    break;
-                                }
-                            } else {
-                                if (hitPos == playerRobot->getPosition() || hitPos == aiRobot->getPosition()) {
-                                    bombDetonated = true;
-                                    break;
-                                }
-                            }
-                        }
-            
-                        // Fire a projectile for bomb
-                        emit projectileFired(startPos, hitPos, ai->getDirection(), bombDetonated, PowerUpType::Bomb);
-            
-                        // Now apply 30 damage in a 3x3 around hitPos (include the center)
-                        for (int dy2 = -1; dy2 <= 1; dy2++) {
-                            for (int dx2 = -1; dx2 <= 1; dx2++) {
-                                QPoint areaPos(hitPos.x() + dx2, hitPos.y() + dy2);
-                                if (!isValidPosition(areaPos)) continue;
-            
-                                // If there's a wall, damage it
-                                if (arena[areaPos.y()][areaPos.x()] == CellType::Wall) {
-                                    attackWall(areaPos, 30);
-                                }
-                                else {
-                                    // If a robot is there, do 30
-                                    if (multiplayerMode) {
-                                        if (areaPos == playerRobot->getPosition()) {
-                                            playerRobot->setHealth(std::max(0, playerRobot->getHealth() - 30));
-                                        }
-                                        if (areaPos == player2Robot->getPosition()) {
-                                            player2Robot->setHealth(std::max(0, player2Robot->getHealth() - 30));
-                                        }
-                                    }
-                                    else {
-                                        if (areaPos == playerRobot->getPosition()) {
-                                            playerRobot->setHealth(std::max(0, playerRobot->getHealth() - 30));
-                                        }
-                                        if (areaPos == aiRobot->getPosition()) {
-                                            int dmg = static_cast<int>(30 * aiDamageModifier);
-                                            aiRobot->setHealth(std::max(0, aiRobot->getHealth() - dmg));
-                                        }
-                                    }
-                                }
-                            }
-                        }
-            
-                        // Clear the powerup
-                        setRobotPowerUp(ai, RobotPowerUp::None);
-                        break;
-                    }
-                    default:
-                        break;
-                    }
-                }
-                ai->useMove();
-                commandExecuted = true;
-                break;
+QFuture<Decision> Game::startAiTurn() {
+    if (state != GameState::AiTurn || !robotAI || aiSnapshot || aiRobot->getMovesLeft() <= 0) {
+        return QFuture<Decision>();
+    }
+
+    stopPondering();
+
+    // The worker only ever sees the snapshot, this game stays free for the GUI. The snapshot is
+    // held here as well, so it is never deleted on the worker and serves the next decision too.
+    aiSnapshot = snapshotInto(keptAiSnapshot);
+    aiSnapshotHash = stateHash();
+    aiInterrupt.store(false, std::memory_order_relaxed);
+    std::shared_ptr<Game> snapshot = aiSnapshot;
+    RobotAI* ai = robotAI.get();
+    DecisionBudget budget = aiTurnBudget();
+    pendingAiDecision = QtConcurrent::run([snapshot, ai, budget]() {
+        return ai->decide(snapshot.get(), snapshot->getAiRobot(), snapshot->getPlayerRobot(), budget);
+    });
+    return pendingAiDecision;
+}
+
+bool Game::beginAiTurn() {
+    if (state != GameState::AiTurn || !robotAI || aiSnapshot || aiRobot->getMovesLeft() <= 0) {
+        return false;
+    }
+
+    stopPondering();
+
+    // Stepped on the snapshot so that this game can be played with and drawn between the slices,
+    // just like a decision made on a worker thread
+    aiSnapshot = snapshotInto(keptAiSnapshot);
+    aiSnapshotHash = stateHash();
+    aiInterrupt.store(false, std::memory_order_relaxed);
+    aiStepping = true;
+    robotAI->begin(aiSnapshot.get(), aiSnapshot->getAiRobot(), aiSnapshot->getPlayerRobot(),
+                   aiTurnBudget());
+    return true;
+}
+
+bool Game::stepAiTurn(int sliceMilliseconds, bool* played) {
+    if (played) {
+        *played = false;
+    }
+    if (!aiStepping) {
+        return true;
+    }
+    if (!robotAI->step(DecisionBudget::fromNow(sliceMilliseconds, &aiInterrupt))) {
+        return false;
+    }
+    aiStepping = false;
+    bool applied = applyAiDecision(robotAI->result());
+    if (played) {
+        *played = applied;
+    }
+    return true;
+}
+
+bool Game::applyAiDecision(const Decision& decision) {
+    if (!aiSnapshot) {
+        return false;   // Cancelled
+    }
+    aiSnapshot.reset();
+    pendingAiDecision = QFuture<Decision>();
+
+    // A decision for a position that is gone, for example after the tutorial changed the arena
+    if (state != GameState::AiTurn || stateHash() != aiSnapshotHash) {
+        return false;
+    }
+
+    lastAiDecision = decision;
+    Robot* ai = aiRobot.get();
+    if (applyCommand(ai, playerRobot.get(), decision.command)) {
+        finishCommand(ai, decision.command);
+    }
+    return true;
+}
+
+void Game::cancelAiTurn() {
+    stopPondering();
+    if (!aiSnapshot) {
+        return;
+    }
+    aiInterrupt.store(true, std::memory_order_relaxed);
+    pendingAiDecision.waitForFinished();
+    pendingAiDecision = QFuture<Decision>();
+    aiSnapshot.reset();
+    aiStepping = false;
+}
+
+bool Game::hasAiPlan() {
+    if (!robotAI || aiSnapshot) {
+        return false;
+    }
+    stopPondering();
+    return robotAI->hasPlannedCommand(this);
+}
+
+void Game::setPonderingEnabled(bool enabled) {
+    ponderingEnabled = enabled;
+    if (enabled) {
+        startPondering();
+    } else {
+        stopPondering();
+    }
+}
+
+void Game::startPondering() {
+    if (!ponderingEnabled || !robotAI || multiplayerMode || state != GameState::PlayerTurn ||
+        ponderSnapshot || aiSnapshot) {
+        return;
+    }
+
+    // Like a decision, pondering only ever sees its own snapshot of the game
+    ponderSnapshot = snapshotInto(keptPonderSnapshot);
+    ponderInterrupt.store(false, std::memory_order_relaxed);
+    std::shared_ptr<Game> snapshot = ponderSnapshot;
+    RobotAI* ai = robotAI.get();
+    qint64 turnMilliseconds = static_cast<qint64>(aiTimeBudgetMs) * aiRobot->getMaxMoves();
+    const std::atomic<bool>* interrupt = &ponderInterrupt;
+    pendingPonder = QtConcurrent::run([snapshot, ai, turnMilliseconds, interrupt]() {
+        return ai->ponder(snapshot.get(), snapshot->getAiRobot(), snapshot->getPlayerRobot(),
+                          turnMilliseconds, interrupt);
+    });
+}
+
+void Game::stopPondering() {
+    if (!ponderSnapshot) {
+        return;
+    }
+    ponderInterrupt.store(true, std::memory_order_relaxed);
+    pendingPonder.waitForFinished();
+    pendingPonder = QFuture<int>();
+    ponderSnapshot.reset();
+}
+
+std::shared_ptr<Game> Game::snapshotInto(std::shared_ptr<Game>& kept) const {
+    // Only called once the worker is done with the snapshot, so it can be overwritten
+    if (kept) {
+        kept->copyStateFrom(*this);
+    } else {
+        kept = clone();
+    }
+    return kept;
+}
+
+DecisionBudget Game::aiTurnBudget() {
+    // The AI plans the rest of its turn in one go, so it gets the time of every move it has left
+    return DecisionBudget::fromNow(static_cast<qint64>(aiTimeBudgetMs) * aiRobot->getMovesLeft(),
+                                   &aiInterrupt);
+}
+
+void Game::resetAi() {
+    // A new match: drop a decision still running for the old one, and what the AI remembers of it
+    cancelAiTurn();
+    if (robotAI) {
+        robotAI->reset();
+    }
+}
+
+void Game::setRobotAI(std::unique_ptr<RobotAI> ai) {
+    cancelAiTurn();
+    robotAI = std::move(ai);
+    if (robotAI) {
+        robotAI->reset();
+    }
+}
+
+std::unique_ptr<RobotAI> Game::takeRobotAI() {
+    cancelAiTurn();
+    return std::move(robotAI);
+}
+
+namespace {
+QPoint stepInDirection(const QPoint& pos, Direction dir, int steps = 1) {
+    switch (dir) {
+        case Direction::North: return QPoint(pos.x(), pos.y() - steps);
+        case Direction::East:  return QPoint(pos.x() + steps, pos.y());
+        case Direction::South: return QPoint(pos.x(), pos.y() + steps);
+        case Direction::West:  return QPoint(pos.x() - steps, pos.y());
+    }
+    return pos;
+}
+
+Direction turnedLeft(Direction dir) {
+    switch (dir) {
+        case Direction::North: return Direction::West;
+        case Direction::West:  return Direction::South;
+        case Direction::South: return Direction::East;
+        case Direction::East:  return Direction::North;
+    }
+    return dir;
+}
+
+Direction turnedRight(Direction dir) {
+    switch (dir) {
+        case Direction::North: return Direction::East;
+        case Direction::East:  return Direction::South;
+        case Direction::South: return Direction::West;
+        case Direction::West:  return Direction::North;
+    }
+    return dir;
+}
+}
+
+void MoveList::add(Command a, Command b, Command c) {
+    if (count >= MAX_ACTIONS) return;
+    Action& action = actions[count++];
+    action.commands[0] = a;
+    action.commands[1] = b;
+    action.commands[2] = c;
+    action.count = (c != Command::None) ? 3 : (b != Command::None ? 2 : 1);
+}
+
+bool MoveList::containsFirst(Command cmd) const {
+    for (const Action& action : *this) {
+        if (action.first() == cmd) return true;
+    }
+    return false;
+}
+
+void Game::playAction(const Action& action) {
+    for (int i = 0; i < action.count; ++i) {
+        if (state == GameState::GameOver) return;
+        playCommand(action.commands[i]);
+    }
+}
+
+Robot* Game::robotInSlot(int slot) {
+    switch (slot) {
+        case 0:  return playerRobot.get();
+        case 1:  return player2Robot.get();
+        default: return aiRobot.get();
+    }
+}
+
+const Robot* Game::robotInSlot(int slot) const {
+    return const_cast<Game*>(this)->robotInSlot(slot);
+}
+
+int Game::slotOf(const Robot* robot) const {
+    if (robot == playerRobot.get()) return 0;
+    if (robot == player2Robot.get()) return 1;
+    return 2;
+}
+
+int Game::opponentSlot(int slot) const {
+    if (slot != 0) return 0;
+    return multiplayerMode ? 1 : 2;
+}
+
+int Game::slotToMove() const {
+    switch (state) {
+        case GameState::PlayerTurn:  return 0;
+        case GameState::Player2Turn: return 1;
+        case GameState::AiTurn:      return 2;
+        case GameState::GameOver:    return -1;
+    }
+    return -1;
+}
+
+Robot* Game::getActiveRobot() const {
+    switch (state) {
+        case GameState::PlayerTurn:  return playerRobot.get();
+        case GameState::Player2Turn: return multiplayerMode ? player2Robot.get() : nullptr;
+        case GameState::AiTurn:      return multiplayerMode ? nullptr : aiRobot.get();
+        case GameState::GameOver:    return nullptr;
+    }
+    return nullptr;
+}
+
+Robot* Game::getOpponentOf(const Robot* robot) const {
+    if (robot == playerRobot.get()) {
+        return multiplayerMode ? player2Robot.get() : aiRobot.get();
+    }
+    return playerRobot.get();
+}
+
+bool Game::attackCanHit(const Robot* robot, Direction dir) const {
+    const Robot* opponent = getOpponentOf(robot);
+    QPoint startPos = robot->getPosition();
+    QPoint enemyPos = opponent->getPosition();
+
+    switch (robot->getPowerUp()) {
+        case RobotPowerUp::None: {
+            // Normal shot: first wall or robot within range
+            int attackRange = (robot->getType() == RobotType::Sniper) ? 3 : 1;
+            for (int step = 1; step <= attackRange; ++step) {
+                QPoint pos = stepInDirection(startPos, dir, step);
+                if (!isValidPosition(pos)) return false;
+                if (terrain.cellAt(pos) == CellType::Wall || pos == enemyPos) return true;
             }
-            case Command::None:
-                // Do nothing for None command
-                break;
+            return false;
         }
-
-        if (commandExecuted) {
-            if (ai->getMovesLeft() <= 0) {
-                checkGameOver();
-                if (state != GameState::GameOver) {
-                    switchTurn();
+        case RobotPowerUp::Laser: {
+            // Laser damages everything along the line
+            for (QPoint pos = stepInDirection(startPos, dir); isValidPosition(pos); pos = stepInDirection(pos, dir)) {
+                if (terrain.cellAt(pos) == CellType::Wall || pos == enemyPos) return true;
+            }
+            return false;
+        }
+        case RobotPowerUp::Missile: {
+            // Missile stops on the first wall or robot
+            for (QPoint pos = stepInDirection(startPos, dir); isValidPosition(pos); pos = stepInDirection(pos, dir)) {
+                if (terrain.cellAt(pos) == CellType::Wall || pos == enemyPos) return true;
+            }
+            return false;
+        }
+        case RobotPowerUp::Bomb: {
+            // Bomb always detonates, useful if the 3x3 area around the impact holds a wall or the enemy
+            QPoint hitPos = startPos;
+            for (QPoint pos = stepInDirection(startPos, dir); isValidPosition(pos); pos = stepInDirection(pos, dir)) {
+                hitPos = pos;
+                if (terrain.cellAt(pos) == CellType::Wall || pos == enemyPos) break;
+            }
+            if (hitPos == startPos) return false;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    QPoint areaPos(hitPos.x() + dx, hitPos.y() + dy);
+                    if (!isValidPosition(areaPos)) continue;
+                    if (terrain.cellAt(areaPos) == CellType::Wall || areaPos == enemyPos) return true;
                 }
             }
-            emit turnComplete();
+            return false;
         }
     }
+    return false;
+}
+
+MoveList Game::generateMoves() const {
+    MoveList moves;
+    Robot* robot = getActiveRobot();
+    if (!robot || robot->getMovesLeft() <= 0) {
+        return moves;
+    }
+
+    QPoint pos = robot->getPosition();
+    Direction facing = robot->getDirection();
+    Direction left = turnedLeft(facing);
+    Direction right = turnedRight(facing);
+    Direction back = turnedLeft(left);
+
+    // A turn straight after the opposite turn only undoes it, and a third turn in a row is the
+    // same as a single turn the other way
+    bool canTurnLeft = lastCommand != Command::TurnRight && consecutiveTurns < 2;
+    bool canTurnRight = lastCommand != Command::TurnLeft && consecutiveTurns < 2;
+    bool canTurnAround = consecutiveTurns == 0;
+
+    if (isValidMove(stepInDirection(pos, facing))) {
+        moves.add(Command::MoveForward);
+    }
+    if (attackCanHit(robot, facing)) {
+        moves.add(Command::Attack);
+    }
+    if (canTurnLeft) {
+        if (isValidMove(stepInDirection(pos, left))) moves.add(Command::TurnLeft, Command::MoveForward);
+        if (attackCanHit(robot, left)) moves.add(Command::TurnLeft, Command::Attack);
+    }
+    if (canTurnRight) {
+        if (isValidMove(stepInDirection(pos, right))) moves.add(Command::TurnRight, Command::MoveForward);
+        if (attackCanHit(robot, right)) moves.add(Command::TurnRight, Command::Attack);
+    }
+    if (canTurnAround) {
+        if (isValidMove(stepInDirection(pos, back))) moves.add(Command::TurnLeft, Command::TurnLeft, Command::MoveForward);
+        if (attackCanHit(robot, back)) moves.add(Command::TurnLeft, Command::TurnLeft, Command::Attack);
+    }
+
+    // Plain turns cost no move, they only matter for the facing left at the end of the turn
+    if (canTurnLeft) moves.add(Command::TurnLeft);
+    if (canTurnRight) moves.add(Command::TurnRight);
+
+    // Boxed in with nothing to hit: attacking at least spends the move so the turn can end
+    if (moves.isEmpty()) {
+        moves.add(Command::Attack);
+    }
+    return moves;
+}
+
+quint64 Game::stateHash() const {
+    // FNV-1a over the small part of the state, followed by the hash of the terrain changes
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](int value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            hash ^= static_cast<quint8>(value >> shift);
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(static_cast<int>(state));
+    mix(static_cast<int>(lastCommand));
+    mix(consecutiveTurns);
+    for (const Robot* robot : { playerRobot.get(), player2Robot.get(), aiRobot.get() }) {
+        mix(robot->getPosition().x());
+        mix(robot->getPosition().y());
+        mix(static_cast<int>(robot->getDirection()));
+        mix(robot->getHealth());
+        mix(robot->getMovesLeft());
+        mix(static_cast<int>(robot->getPowerUp()));
+    }
+    quint64 overlay = terrain.hashOverlay();
+    mix(static_cast<int>(overlay));
+    mix(static_cast<int>(overlay >> 32));
+    return hash;
+}
+
+quint64 Game::positionHash() const {
+    quint64 hash = stateHash();
+    auto mix = [&hash](quint64 value) {
+        for (int shift = 0; shift < 64; shift += 8) {
+            hash ^= static_cast<quint8>(value >> shift);
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(terrain.getBaseMap()->getHash());
+    mix(static_cast<quint64>(difficulty));
+    mix(multiplayerMode ? 1 : 0);
+    for (const Robot* robot : { playerRobot.get(), player2Robot.get(), aiRobot.get() }) {
+        mix(static_cast<quint64>(robot->getType()));
+    }
+    return hash;
+}
+
+void Game::recordCommand(Command cmd) {
+    if (cmd == Command::TurnLeft || cmd == Command::TurnRight) {
+        consecutiveTurns++;
+    } else {
+        consecutiveTurns = 0;
+    }
+    lastCommand = cmd;
 }
 
 bool Game::isValidPosition(const QPoint& pos) const {
@@ -1158,7 +1559,7 @@ bool Game::isValidMove(const QPoint& pos) const {
     if (!isValidPosition(pos)) return false;
     
     // Check if the cell is a wall
-    CellType cellType = arena[pos.y()][pos.x()];
+    CellType cellType = terrain.cellAt(pos);
     if (cellType == CellType::Wall) return false;
     
     // Check if the cell is occupied by another robot
@@ -1181,7 +1582,7 @@ bool Game::isValidMove(const QPoint& pos) const {
 
 CellType Game::getCellType(const QPoint& pos) const {
     if (!isValidPosition(pos)) return CellType::Wall;
-    return arena[pos.y()][pos.x()];
+    return terrain.cellAt(pos);
 }
 
 void Game::checkGameOver() {
@@ -1199,6 +1600,11 @@ void Game::checkGameOver() {
 }
 
 void Game::switchTurn() {
+    // Scratch memory of the finished turn is no longer referenced
+    turnArena.reset();
+    lastCommand = Command::None;
+    consecutiveTurns = 0;
+
     if (multiplayerMode) {
         // In multiplayer mode, switch between Player 1 and Player 2
         if (state == GameState::PlayerTurn) {
@@ -1219,6 +1625,13 @@ void Game::switchTurn() {
         }
     }
     emit gameStateChanged(state);
+
+    if (state == GameState::PlayerTurn) {
+        startPondering();
+    } else {
+        // Let pondering wind down, the AI is about to decide
+        ponderInterrupt.store(true, std::memory_order_relaxed);
+    }
 }
 
 bool Game::hasLineOfSight(const QPoint& from, const QPoint& to) const {
@@ -1233,7 +1646,7 @@ bool Game::hasLineOfSight(const QPoint& from, const QPoint& to) const {
         int startY = std::min(from.y(), to.y());
         int endY = std::max(from.y(), to.y());
         for (int y = startY + 1; y < endY; ++y) {
-            if (arena[y][from.x()] == CellType::Wall) {
+            if (terrain.cellAt(from.x(), y) == CellType::Wall) {
                 return false;
             }
         }
@@ -1242,7 +1655,7 @@ bool Game::hasLineOfSight(const QPoint& from, const QPoint& to) const {
         int startX = std::min(from.x(), to.x());
         int endX = std::max(from.x(), to.x());
         for (int x = startX + 1; x < endX; ++x) {
-            if (arena[to.y()][x] == CellType::Wall) {
+            if (terrain.cellAt(x, to.y()) == CellType::Wall) {
                 return false;
             }
         }
@@ -1306,18 +1719,18 @@ void Game::placeSpecialPickups() {
 
 bool Game::placeSinglePowerUp(CellType powerUpType) {
     while (true) {
-        int x = QRandomGenerator::global()->bounded(gridSize);
-        int y = QRandomGenerator::global()->bounded(gridSize);
+        int x = random.bounded(gridSize);
+        int y = random.bounded(gridSize);
         QPoint pos(x, y);
 
         // Must be empty and not on top of any robot
-        if (arena[y][x] == CellType::Empty &&
+        if (terrain.cellAt(x, y) == CellType::Empty &&
             pos != playerRobot->getPosition() &&
             (multiplayerMode
                 ? (pos != player2Robot->getPosition())
                 : (pos != aiRobot->getPosition())))
         {
-            arena[y][x] = powerUpType;
+            setCell(x, y, powerUpType);
             return true;
         }
     }
@@ -1343,5 +1756,5 @@ void Game::collectPowerUp(const QPoint& pos, Robot* robot, CellType cellType) {
     }
 
     // Remove the powerup from the arena
-    arena[pos.y()][pos.x()] = CellType::Empty;
+    setCell(pos, CellType::Empty);
 }
\ No newline at end of file
@@ -1,21 +1,72 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <QFuture>
 #include <QObject>
+#include <QRandomGenerator>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include "robot.h"
 #include "difficultyselector.h"
 #include "mapselector.h"
 #include "robotai.h"
+#include "terrain.h"
+#include "arenaallocator.h"
+#include "pathfinding.h"
+#include "threatmap.h"
+#include "influencemap.h"
+#include "mapanalysis.h"
 
 enum class GameState { PlayerTurn, Player2Turn, AiTurn, GameOver };
-enum class Command { MoveForward, TurnLeft, TurnRight, Attack, None };
-enum class CellType { Empty, Wall, HealthPickup, LaserPowerUp, MissilePowerUp, BombPowerUp };
 enum class PowerUpType { Normal, Laser, Missile, Bomb };
 
 class RobotAI; ///< Forward declaration
 
+/**
+ * @brief One canonical action of the active robot: a short sequence of commands played in order.
+ *
+ * Besides single commands, turning and then moving or attacking is offered as one action so a
+ * lookahead does not have to search through the free turns on their own.
+ *
+ * @author Group 17
+ */
+struct Action {
+    /// Longest sequence: turn around (two turns) and then move or attack
+    static const int MAX_COMMANDS = 3;
+
+    Command commands[MAX_COMMANDS] = { Command::None, Command::None, Command::None };
+    int count = 0;
+
+    /// @return the first command of the action, the one to execute right now
+    Command first() const { return count > 0 ? commands[0] : Command::None; }
+};
+
+/**
+ * @brief Fixed-capacity list of actions produced by Game::generateMoves(), never allocates.
+ * @author Group 17
+ */
+class MoveList {
+public:
+    /// Upper bound on the number of actions a robot can have at once
+    static const int MAX_ACTIONS = 12;
+
+    /// @brief Appends an action made of the given commands, ignored when the list is full
+    void add(Command a, Command b = Command::None, Command c = Command::None);
+    /// @return TRUE if some action starts with the given command, FALSE otherwise
+    bool containsFirst(Command cmd) const;
+
+    int size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    const Action& operator[](int i) const { return actions[i]; }
+    const Action* begin() const { return actions; }
+    const Action* end() const { return actions + count; }
+
+private:
+    Action actions[MAX_ACTIONS];
+    int count = 0;
+};
+
 /**
  * @brief This class manages everything that happens in-game. 
  * 
@@ -38,11 +89,18 @@ public:
     static const int NUM_MISSILE_POWERUPS = 1;
     ///The number of bomb powerups in the game
     static const int NUM_BOMB_POWERUPS = 1;
+    /// Time the AI may take per move by default, in milliseconds
+    static const int DEFAULT_AI_TIME_BUDGET_MS = 1000;
     
     /// Function used to initalise the game
     /// @param gridSize - the size of the grids in the game
     /// @param parent - pointer
-    explicit Game(int gridSize = 8, QObject *parent = nullptr);
+    /// @param ai - the AI to play the AI robot, typically taken from a RobotAIPool. A new one is
+    /// created when none is given
+    /// @param withArena - TRUE to start on a freshly generated random arena, FALSE to leave the
+    /// arena empty until initializeArena() is called, as batch runs that bring their own map do
+    explicit Game(int gridSize = 8, QObject *parent = nullptr, std::unique_ptr<RobotAI> ai = nullptr,
+                  bool withArena = true);
     /// @brief Function used to delete the game object
     ~Game();
 
@@ -50,7 +108,137 @@ public:
     ///@param cmd - the command to be executed
     void executeCommand(Command cmd); 
     ///@brief Simple function for the game AI to execute a turn
+    ///
+    /// The AI gets getAiTimeBudget() to decide. Searching AIs stop at the deadline and play their
+    /// best command so far, getLastAiDecision() tells how much of the budget was used.
     void executeAiTurn(); 
+    ///@brief Starts the AI decision for the next command on a worker thread and returns at once.
+    ///
+    /// The AI plays on a snapshot of the game, so this game can be drawn and animated meanwhile.
+    /// Once the future is finished, pass its result to applyAiDecision() on this game's thread.
+    /// Nothing is started when it is not the AI's turn or a decision is already running.
+    ///@return The future decision, empty if nothing was started
+    QFuture<Decision> startAiTurn();
+    ///@brief Plays a command decided by a decision started with startAiTurn()
+    ///@param decision - the result of the future
+    ///@return TRUE if the command was played, FALSE if the decision was cancelled or the game
+    /// changed since it was started
+    bool applyAiDecision(const Decision& decision);
+    ///@brief Starts the AI decision for the next command, to be made a slice at a time on this
+    /// game's thread with stepAiTurn().
+    ///
+    /// For when no worker thread can be spared: the event loop calls stepAiTurn() between frames,
+    /// so the search is interleaved with animations. Like startAiTurn(), the AI plays on a snapshot
+    /// and nothing is started when it is not the AI's turn or a decision is already running.
+    ///@return TRUE if the decision was started, FALSE otherwise
+    bool beginAiTurn();
+    ///@brief Goes on with the decision started by beginAiTurn() for a slice of time, and plays the
+    /// command once it is decided
+    ///@param sliceMilliseconds - the time the AI may think now
+    ///@param played - if given, set to TRUE if a command was played and FALSE otherwise. A finished
+    /// decision is not played when the game changed since it was started.
+    ///@return TRUE once the decision is over or none is running, FALSE if it needs more slices
+    bool stepAiTurn(int sliceMilliseconds, bool* played = nullptr);
+    ///@return TRUE while a decision started with beginAiTurn() is being made
+    bool isAiStepping() const { return aiStepping; }
+    ///@brief Stops a running AI decision and pondering, and waits for the worker threads to let go
+    /// of the AI.
+    ///
+    /// Called before a match is abandoned, the decision is thrown away once it arrives.
+    void cancelAiTurn();
+    ///@return TRUE while a decision started with startAiTurn() or beginAiTurn() has not been applied
+    /// or cancelled
+    bool isAiThinking() const { return aiSnapshot != nullptr; }
+    ///@return TRUE if the AI has planned its next command already, so executeAiTurn() plays it
+    /// at once without thinking. Stops pondering.
+    bool hasAiPlan();
+    ///@brief Lets the AI think about its answers while the player is thinking.
+    ///
+    /// Whenever the player's turn starts, the AI plans answers to the player's most likely turns
+    /// on a worker thread, see RobotAI::ponder(). If the player plays one of them, the AI answers
+    /// at once. Off by default: where nobody is thinking in between, such as in batch runs, it
+    /// would only compete for the CPU.
+    ///@param enabled - TRUE to ponder from the next player's turn on
+    void setPonderingEnabled(bool enabled);
+    ///@return TRUE if the AI ponders during the player's turns, FALSE otherwise
+    bool isPonderingEnabled() const { return ponderingEnabled; }
+    ///@brief Stops pondering and waits for the worker thread to let go of the AI.
+    ///
+    /// The answers planned so far are kept. Called on its own before the AI decides.
+    void stopPondering();
+    ///@brief Makes a running AI decision stop early and play its best command so far.
+    ///
+    /// Safe to call from any thread, for example from a watchdog of a batch run. Only affects the
+    /// decision in progress.
+    void interruptAiTurn() { aiInterrupt.store(true, std::memory_order_relaxed); }
+    ///@brief Sets the time the AI may take per move.
+    ///
+    /// The AI plans the rest of its turn at once, within the time of all the moves it has left,
+    /// and then plays the plan out without thinking again.
+    ///@param milliseconds - the budget, 0 for no limit
+    void setAiTimeBudget(int milliseconds) { aiTimeBudgetMs = milliseconds; }
+    ///@return The time the AI may take per move in milliseconds, 0 for no limit
+    int getAiTimeBudget() const { return aiTimeBudgetMs; }
+    ///@return The last command the AI decided on, with the time it took and its budget
+    const Decision& getLastAiDecision() const { return lastAiDecision; }
+    ///@brief Plays a command for whichever robot's turn it is, without asking any AI.
+    ///
+    /// Used to play on snapshots made with clone(), the turn switches and the game ends exactly
+    /// as it would for commands entered by the players.
+    ///@param cmd - the command to play
+    void playCommand(Command cmd);
+    ///@brief Plays the commands of an action one after another with playCommand(), stopping
+    /// early if the game ends
+    ///@param action - the action, typically one of generateMoves()
+    void playAction(const Action& action);
+    ///@brief Finds a robot by slot, which names the same robot in every copy of the game: 0 is
+    /// player 1, 1 is player 2 and 2 is the AI
+    ///@param slot - the slot
+    ///@return The robot in the slot
+    Robot* robotInSlot(int slot);
+    const Robot* robotInSlot(int slot) const;
+    ///@param robot - one of the robots of this game
+    ///@return The slot of the robot, see robotInSlot()
+    int slotOf(const Robot* robot) const;
+    ///@param slot - the slot of a robot
+    ///@return The slot of the robot it plays against
+    int opponentSlot(int slot) const;
+    ///@return The slot of the robot whose turn it is, -1 once the game is over
+    int slotToMove() const;
+    ///@brief Creates a copy of the game that can be played on without affecting this one.
+    ///
+    /// The copy shares the base map and has no signal connections, so nothing is shown while it
+    /// is played. It has no AI of its own, so executeAiTurn() does nothing on it. It may be used
+    /// on another thread.
+    ///@return The copy
+    std::unique_ptr<Game> clone() const;
+    ///@brief Overwrites the state of this game with that of another, reusing this game's memory
+    ///@param source - the game to copy, typically the game this one was cloned from
+    void copyStateFrom(const Game& source);
+    ///@brief Lists the meaningful actions of the robot whose turn it is.
+    ///
+    /// Leaves out moves into walls or robots, attacks that cannot hit anything, a turn that undoes
+    /// the previous one and more than two turns in a row.
+    ///@return The actions, empty if the game is over
+    MoveList generateMoves() const;
+    ///@brief Checks whether a command can have any effect for the robot whose turn it is
+    ///@param cmd - the command to check
+    ///@return TRUE if generateMoves() offers an action starting with cmd, FALSE otherwise
+    bool isMeaningfulCommand(Command cmd) const { return generateMoves().containsFirst(cmd); }
+    ///@brief Hashes everything that decides how the match goes on from here.
+    ///
+    /// Covers whose turn it is, the robots, the changes to the terrain and the commands already
+    /// played this turn, so two states with the same hash offer the same moves and lead to the
+    /// same results. Only meaningful between states of the same match and its clones.
+    ///@return A 64-bit hash of the state, used as the key of transposition tables
+    quint64 stateHash() const;
+    ///@brief Hashes the state together with everything fixed for a match: the map, the robot types
+    /// and the difficulty.
+    ///
+    /// Unlike stateHash(), meaningful between different matches, so results worked out for one
+    /// match can be reused in another that reaches the same position.
+    ///@return A 64-bit hash of the position, used as the key of caches shared between matches
+    quint64 positionHash() const;
     ///@brief Simple function to check for position validity
     ///@param pos - current position
     ///@return TRUE if successfully executed, FALSE otherwise
@@ -69,6 +257,10 @@ public:
     ///@param damage - the damage said attack will be doing
     ///@return TRUE if successfully executed, FALSE otherwise
     bool attackWall(const QPoint& pos, int damage);
+    ///@brief Returns the damage a robot deals to a wall with a normal attack
+    ///@param robot - the attacking robot
+    ///@return the wall damage, higher for heavier robots
+    int getWallDamage(const Robot* robot) const;
     ///@brief Simple function in indicate an attack
     ///@param attacker - the attacker this attack is from
     ///@param target  - the target of this attack
@@ -78,6 +270,21 @@ public:
     ///@param pos  - position of the health pickup
     ///@param robot  - the robot we are healing
     void collectHealthPickup(const QPoint& pos, Robot* robot);
+    ///@brief Returns every pickup of one type currently on the map
+    ///@param type - the pickup type, any other cell type gives an empty list
+    ///@return Positions of the pickups, kept up to date as pickups are placed and collected
+    const std::vector<QPoint>& getPickups(CellType type) const;
+    ///@brief Finds the pickup of a type that is quickest to walk to
+    ///@param from - the position to search from
+    ///@param type - the pickup type
+    ///@param searchRadius - only pickups at most this many cells away in x and in y are considered
+    ///@return Position of the pickup, (-1, -1) if there is none
+    QPoint findNearestPickup(const QPoint& from, CellType type, int searchRadius);
+    ///@brief Finds the laser, missile or bomb power-up that is quickest to walk to
+    ///@param from - the position to search from
+    ///@param searchRadius - only power-ups at most this many cells away in x and in y are considered
+    ///@return Position of the power-up, (-1, -1) if there is none
+    QPoint findNearestPowerUp(const QPoint& from, int searchRadius);
     ///@brief Simple function to place health pickup, automatically determines where the health pickup is placed
     void placeHealthPickups();
     
@@ -101,6 +308,15 @@ public:
     /// @brief getter method that returns the AI robot,  should the player choose to play against an AI
     /// @return The robot of the AI
     Robot* getAiRobot() { return aiRobot.get(); }
+    /// @brief Getter method for the AI that plays the AI robot
+    /// @return The AI manager, a custom AI can be set on it per robot type. nullptr for a clone
+    RobotAI* getRobotAI() { return robotAI.get(); }
+    /// @brief Replaces the AI that plays the AI robot, for example with one from a RobotAIPool
+    /// @param ai - the new AI, it is reset before use. nullptr leaves the AI robot without an AI
+    void setRobotAI(std::unique_ptr<RobotAI> ai);
+    /// @brief Takes the AI away from the game, typically to give it back to a RobotAIPool
+    /// @return The AI, the game has none afterwards
+    std::unique_ptr<RobotAI> takeRobotAI();
     /// @brief Getter method that returns the state of the game
     /// @return State of the game
     GameState getState() const { return state; }
@@ -110,9 +326,35 @@ public:
     ///@brief returns the cell type of a given location, for example, it can be a cell for a wall
     ///@param pos - the position of the cell
     CellType getCellType(const QPoint& pos) const;
+    /// @brief Getter method for the immutable map this match was generated on
+    /// @return The shared base map, unaffected by anything that happened during the match
+    std::shared_ptr<const TerrainMap> getBaseMap() const { return terrain.getBaseMap(); }
+    /// @brief Getter method for the terrain of this match
+    /// @return The base map together with the changes made during the match
+    const Terrain& getTerrain() const { return terrain; }
     ///@brief returns the health of a wall in a given location
     ///@param pos - the position of the wall we want to get the health of
     int getWallHealth(const QPoint& pos) const;
+    /// @brief Getter method for the scratch memory of the current turn
+    ///
+    /// AIs and helpers can take temporary buffers from here instead of the heap. Everything in it
+    /// is released when the turn switches.
+    /// @return The arena of the current turn
+    ArenaAllocator& getTurnArena() { return turnArena; }
+    /// @brief Getter method for the shared pathfinding of this match
+    /// @return The pathfinding service, its distance fields follow the current wall layout
+    PathfindingService& getPathfinding() { return pathfinding; }
+    /// @brief Getter method for the cells a robot could hit, brought up to date first
+    /// @param robot - the attacking robot, one of the robots of this game
+    /// @return The threat map of the robot
+    const ThreatMap& getThreatMap(const Robot* robot);
+    /// @brief Getter method for the positional values of the arena as seen against an opponent
+    /// @param opponent - the robot whose threat fills the threat layer, one of the robots of this game
+    /// @return The influence map, brought up to date first
+    const InfluenceMap& getInfluenceMap(const Robot* opponent);
+    /// @brief Getter method for the static analysis of the map: chokepoints, dead ends, vantage
+    /// @return The analysis, loaded from the cache or worked out when the arena was initialised
+    const MapAnalysis& getMapAnalysis() const { return mapAnalysis; }
     /// @brief Set the robot type of player 1
     void setPlayerRobotType(RobotType type);
     /// @brief Set the robot type of player 2
@@ -124,6 +366,21 @@ public:
     void setDifficulty(GameDifficulty difficulty);
     /// @brief Getter function that returns the difficulty level of the game
     GameDifficulty getDifficulty() const { return difficulty; }
+    /// @brief Seeds the randomness of the game: generated maps and pickups. Arenas initialised
+    /// afterwards play out the same for the same seed and the same commands. Games start with a
+    /// random seed. The AIs draw from their own generators (see RobotAI::setSeed()).
+    /// @param seed - the seed
+    void setSeed(quint32 seed) { random.seed(seed); }
+    /// @brief Getter function for how far ahead a searching AI looks at the current difficulty
+    /// @return The number of full turns to search, higher on harder difficulties
+    int getAiSearchDepth() const { return aiSearchDepth; }
+    /// @brief Getter function for the share of the moves of a scripted AI that are random at the current difficulty
+    /// @return The chance from 0 to 1, lower on harder difficulties
+    float getAiRandomMoveChance() const { return aiRandomMoveChance; }
+    /// @param difficulty - a difficulty
+    /// @return The share of the moves of a scripted AI that are random at the difficulty. The
+    /// scripted AIs start from it, see ScoutParameters::randomMovePercent.
+    static float randomMoveChanceFor(GameDifficulty difficulty);
     /// @brief Setter function to change the type of map the game takes place on
     void setMapType(MapType mapType);
     /// @brief Setter function to enable multplayer mode
@@ -140,6 +397,16 @@ public:
     void initializeArena(const RobotType& playerType, const RobotType& aiType, 
                          GameDifficulty difficulty = GameDifficulty::Medium,
                          MapType mapType = MapType::Random);
+    /// @brief **Initalises** the arena on an already generated map, includes 1 player and one AI.
+    ///
+    /// The map is shared rather than copied, so many matches can be played on it at once while
+    /// each one only stores the cells it changes.
+    /// @param baseMap - The map to play on, typically obtained from getBaseMap() of another game
+    /// @param playerType - The type of robot the player is using
+    /// @param aiType - The type of robot the AI is using
+    /// @param difficulty - Difficulty setting of the game
+    void initializeArena(std::shared_ptr<const TerrainMap> baseMap, const RobotType& playerType,
+                         const RobotType& aiType, GameDifficulty difficulty = GameDifficulty::Medium);
     /// @brief **Initalises** the arena of the game, includes two players
     /// @param player1Type - The type of robot player 1 will be using
     /// @param player2Type - The type of robot player 2 will be using
@@ -177,6 +444,14 @@ signals:
     void projectileFired(const QPoint &start, const QPoint &end, Direction direction, bool hit, PowerUpType powerUpUsed);
 
 private:
+    /// Used by clone()
+    Game(const Game& source, QObject* parent);
+
+    bool applyCommand(Robot* activeRobot, Robot* targetRobot, Command cmd);
+    void resetAi();
+    DecisionBudget aiTurnBudget();
+    void startPondering();
+    void finishCommand(Robot* activeRobot, Command cmd);
     void checkGameOver();
     void switchTurn();
     void generateObstacles();
@@ -185,6 +460,17 @@ private:
     void generateFortressMap();
     bool canMoveBetween(const QPoint& from, const QPoint& to) const;
     void applyDifficultySettings();
+    void setCell(int x, int y, CellType type, int health = 0);
+    void setCell(const QPoint& pos, CellType type, int health = 0) { setCell(pos.x(), pos.y(), type, health); }
+    void rebuildPickupIndex();
+    /// Sets aside the memory the caches need on this grid, so that playing does not allocate
+    void reserveCaches();
+    /// Brings a snapshot kept from an earlier decision up to date with this game, or makes one
+    std::shared_ptr<Game> snapshotInto(std::shared_ptr<Game>& kept) const;
+    Robot* getActiveRobot() const;
+    Robot* getOpponentOf(const Robot* robot) const;
+    bool attackCanHit(const Robot* robot, Direction dir) const;
+    void recordCommand(Command cmd);
 
     std::unique_ptr<Robot> playerRobot;
     std::unique_ptr<Robot> player2Robot;
@@ -192,16 +478,54 @@ private:
     std::unique_ptr<RobotAI> robotAI;
     GameState state;
     int gridSize;
-    std::vector<std::vector<CellType>> arena;
-    std::vector<std::vector<int>> wallHealth;
+    Terrain terrain;
+    ArenaAllocator turnArena;
+    PathfindingService pathfinding;
+    /// Pickup positions by type: health, laser, missile, bomb
+    std::vector<QPoint> pickupIndex[4];
+    /// Threat maps of player 1, player 2 and the AI
+    ThreatMap threatMaps[3];
+    /// Threat, pickup and cover values, only rows near changed cells are recomputed
+    InfluenceMap influence;
+    /// Chokepoints, dead ends and vantage of the map, cached on disk per map
+    MapAnalysis mapAnalysis;
     GameDifficulty difficulty;
     MapType mapType;
     bool multiplayerMode;
+    /// Draws maps and pickups
+    QRandomGenerator random;
+
+    // Commands executed by the active robot during the current turn, used to prune dithering
+    Command lastCommand;
+    int consecutiveTurns;
     
     // AI difficulty modifiers
     float aiHealthModifier;
     float aiDamageModifier;
     float aiRandomMoveChance;
+    int aiSearchDepth;
+
+    // Time limit of AI decisions
+    int aiTimeBudgetMs;
+    std::atomic<bool> aiInterrupt;
+    Decision lastAiDecision;
+
+    // Decision running on a worker thread: the future, the snapshot it plays on and the state it
+    // was started from
+    QFuture<Decision> pendingAiDecision;
+    std::shared_ptr<Game> aiSnapshot;
+    /// The snapshot of the last decision, brought up to date for the next one instead of cloning
+    std::shared_ptr<Game> keptAiSnapshot;
+    quint64 aiSnapshotHash;
+    // Set while the decision is made in slices on this thread instead
+    bool aiStepping;
+
+    // Pondering on a worker thread during the player's turn: the future and its snapshot
+    bool ponderingEnabled;
+    std::atomic<bool> ponderInterrupt;
+    QFuture<int> pendingPonder;
+    std::shared_ptr<Game> ponderSnapshot;
+    std::shared_ptr<Game> keptPonderSnapshot;
 };
 
 #endif // GAME_H
@@ -2,6 +2,7 @@
 #include <QVBoxLayout>
 #include <QDebug>
 #include <QTimer>
+#include <QThreadPool>
 #include "robotselector.h"
 #include <QGraphicsPixmapItem>
 #include "projectile.h"
@@ -85,12 +86,19 @@ GameGrid::GameGrid(QWidget *parent) : QWidget(parent) {
     
     // Create game instance with the new grid size
     game = std::make_unique<Game>(GRID_SIZE);
+    // Without a worker thread to spare, the AI thinks in slices between frames instead
+    aiInSlices = QThreadPool::globalInstance()->maxThreadCount() < 2;
+    aiStepTimer.setInterval(0);
+    connect(&aiStepTimer, &QTimer::timeout, this, &GameGrid::handleAiStep);
+    // Nobody waits on the AI while the player thinks, so it may think ahead on a worker thread
+    game->setPonderingEnabled(!aiInSlices);
     
     // Connect signals
     connect(game.get(), &Game::turnComplete, this, &GameGrid::handleTurnComplete);
     connect(game.get(), &Game::gameStateChanged, this, &GameGrid::handleGameStateChanged);
     connect(game.get(), &Game::arenaInitialized, this, &GameGrid::updateGrid);
     connect(game.get(), &Game::projectileFired, this, &GameGrid::spawnProjectile);
+    connect(&aiWatcher, &QFutureWatcher<Decision>::finished, this, &GameGrid::handleAiDecisionReady);
     connect(game.get(), &Game::healthPickupCollected, this, [this](const QPoint& pos) {
         Q_UNUSED(pos); // Parameter provided by signal but not needed in handler
         // Update the status label to show health pickup collected
@@ -145,6 +153,10 @@ void GameGrid::initializeWithRobotType(RobotType playerType, RobotType aiType,
     // Initialize arena with selected robots, difficulty, and map
     game->initializeArena(playerType, aiType, difficulty, mapType);
     
+    // Robots are reused between matches, so drop the connections made for the previous one
+    disconnect(game->getPlayerRobot(), nullptr, this, nullptr);
+    disconnect(game->getAiRobot(), nullptr, this, nullptr);
+
     // Connect to the robots' moves changed signals
     connect(game->getPlayerRobot(), &Robot::movesChanged, this, [this](int) {
         updateStatusLabel();
@@ -179,6 +191,10 @@ void GameGrid::initializeMultiplayer(RobotType player1Type, RobotType player2Typ
     // Initialize arena with selected robots for multiplayer
     game->initializeMultiplayerArena(player1Type, player2Type, mapType);
     
+    // Robots are reused between matches, so drop the connections made for the previous one
+    disconnect(game->getPlayerRobot(), nullptr, this, nullptr);
+    disconnect(game->getPlayer2Robot(), nullptr, this, nullptr);
+
     // Connect to the robots' moves changed signals
     connect(game->getPlayerRobot(), &Robot::movesChanged, this, [this](int) {
         updateStatusLabel();
@@ -262,9 +278,10 @@ void GameGrid::keyPressEvent(QKeyEvent* event) {
 void GameGrid::updateGrid() {
     // Remove all items except those in the feedback group.
     QList<QGraphicsItem*> allItems = scene->items();
+    const QList<QGraphicsItem*> feedbackItems = feedbackGroup->childItems();
     for (QGraphicsItem* item : allItems) {
         // Check if the item is not the feedbackGroup and not a child of it.
-        if (item != feedbackGroup && !feedbackGroup->childItems().contains(item)) {
+        if (item != feedbackGroup && !feedbackItems.contains(item)) {
             scene->removeItem(item);
             delete item;
         }
@@ -549,18 +566,66 @@ void GameGrid::handleTurnComplete() {
     updateGrid(); // Make sure grid updates after each turn
     if (game->getState() == GameState::AiTurn) {
         // Add a short delay before AI's next move
-        QTimer::singleShot(500, [this]() {
-            if (game->getState() == GameState::AiTurn) {
-                game->executeAiTurn();
-                setFocus(); // Maintain focus after AI turn
-            }
-        });
+        QTimer::singleShot(500, this, &GameGrid::startAiTurn);
     } else {
         // For player turns, ensure focus is maintained
         setFocus();
     }
 }
 
+void GameGrid::startAiTurn() {
+    // Replaying a planned command takes no thinking, so there is no need for a worker thread
+    if (game->getState() == GameState::AiTurn && game->hasAiPlan()) {
+        game->executeAiTurn();
+        setFocus();
+        return;
+    }
+    // The AI thinks a slice at a time, the timer fires again once the frame is drawn
+    if (aiInSlices) {
+        if (game->beginAiTurn()) {
+            aiStepTimer.start();
+        }
+        return;
+    }
+    // The AI thinks on a worker thread, the grid keeps drawing and animating meanwhile
+    if (game->getState() == GameState::AiTurn && !game->isAiThinking()) {
+        QFuture<Decision> decision = game->startAiTurn();
+        if (!decision.isCanceled()) {
+            aiWatcher.setFuture(decision);
+        }
+    }
+}
+
+void GameGrid::handleAiDecisionReady() {
+    if (!game->applyAiDecision(aiWatcher.result())) {
+        // The arena changed while the AI was thinking: think again if it is still its turn
+        startAiTurn();
+        return;
+    }
+    setFocus(); // Maintain focus after AI turn
+}
+
+void GameGrid::handleAiStep() {
+    bool played = false;
+    if (!game->stepAiTurn(AI_SLICE_MS, &played)) {
+        return;     // More thinking in the next slice
+    }
+    aiStepTimer.stop();
+    if (!played) {
+        // The arena changed while the AI was thinking: think again if it is still its turn
+        startAiTurn();
+        return;
+    }
+    setFocus();
+}
+
+void GameGrid::cancelAi() {
+    // The match is being abandoned, so the AI is not restarted either
+    disconnect(&aiWatcher, nullptr, this, nullptr);
+    aiStepTimer.stop();
+    game->cancelAiTurn();
+}
+
 void GameGrid::handleGameStateChanged(GameState state) {
     Robot* player1 = game->getPlayerRobot();
     
@@ -11,6 +11,7 @@
 #include <QRandomGenerator>
 #include <QTimer>
 #include <QFrame>
+#include <QFutureWatcher>
 #include <memory>
 #include "game.h"
 #include "difficultyselector.h"
@@ -57,6 +58,9 @@ public:
     ///@brief Make updateGrid accessible to tutorial
     void updateGrid();
 
+    ///@brief Stops the AI if it is thinking, its move is never played. Call before deleting the grid
+    void cancelAi();
+
 signals:
     void gameOver(bool playerWon);
     void keyPressed(int key); // Signal for tutorial to track key presses
@@ -67,6 +71,8 @@ protected:
 
 private slots:
     void handleTurnComplete();
+    void handleAiDecisionReady();
+    void handleAiStep();
     void handleGameStateChanged(GameState state);
     void updateStatusLabel();
 
@@ -80,6 +86,7 @@ private:
     void setupWideScreenLayout();
     void drawRobot(Robot* robot, bool isPlayer);
     void drawCell(int x, int y, CellType cellType);
+    void startAiTurn();
 
     std::unique_ptr<Game> game;
     QGraphicsScene* scene;
@@ -99,8 +106,16 @@ private:
     static const int CELL_SIZE = 60; // Size of each grid cell in pixels (reduced from 64)
     static const int GRID_SIZE = 12; // Size of the grid (increased from 8)
     static const int INFO_PANEL_WIDTH = 400; // Width of the info panel
+    static const int AI_SLICE_MS = 8; // Time the AI may think between two frames when it thinks in slices
 
     QGraphicsItemGroup* feedbackGroup;
+
+    /// Tells when the AI, thinking on a worker thread, has decided
+    QFutureWatcher<Decision> aiWatcher;
+    /// Set when no worker thread can be spared, the AI then thinks in slices on this thread
+    bool aiInSlices;
+    /// Gives the AI its next slice whenever the event loop is idle
+    QTimer aiStepTimer;
 };
 
 #endif // GAMEGRID_H
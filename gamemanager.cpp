@@ -116,6 +116,7 @@ void GameManager::handleMapSelected(MapType mapType) {
     
     if (gameGrid) {
         disconnect(gameGrid, &GameGrid::gameOver, this, &GameManager::handleGameOver);
+        gameGrid->cancelAi(); // The AI may still be thinking on a worker thread
         mainWidget->removeWidget(gameGrid);
         delete gameGrid;
     }
@@ -141,6 +142,7 @@ void GameManager::handleMultiplayerMapSelected(MapType mapType) {
     
     if (gameGrid) {
         disconnect(gameGrid, &GameGrid::gameOver, this, &GameManager::handleGameOver);
+        gameGrid->cancelAi(); // The AI may still be thinking on a worker thread
         mainWidget->removeWidget(gameGrid);
         delete gameGrid;
     }
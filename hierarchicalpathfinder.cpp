@@ -0,0 +1,359 @@
+#include "hierarchicalpathfinder.h"
+#include "terrain.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+const int DX[4] = { 0, 1, 0, -1 };  // North, East, South, West
+const int DY[4] = { -1, 0, 1, 0 };
+const quint16 FAR_AWAY = 0xFFFF;
+const int NO_PATH = 0x3FFFFFFF;
+const int START = -2;
+
+// Long entrances get a transition at each end, short ones a single one in the middle
+const int LONG_ENTRANCE = 6;
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder(const Terrain& terrain, int size)
+    : terrain(terrain), clusterSize(std::max(2, size)), gridSize(0), clustersX(0), clustersY(0),
+      builtWallVersion(0), built(false), searchStamp(0) {
+}
+
+bool HierarchicalPathfinder::isOpen(int x, int y) const {
+    return terrain.cellAt(x, y) != CellType::Wall;
+}
+
+int HierarchicalPathfinder::clusterIndexOf(int x, int y) const {
+    return (y / clusterSize) * clustersX + (x / clusterSize);
+}
+
+int HierarchicalPathfinder::getNodeCount() const {
+    int count = 0;
+    for (const Cluster& cluster : clusters) {
+        count += static_cast<int>(cluster.nodes.size());
+    }
+    return count;
+}
+
+void HierarchicalPathfinder::rebuild() {
+    gridSize = terrain.getGridSize();
+    clustersX = (gridSize + clusterSize - 1) / clusterSize;
+    clustersY = clustersX;
+
+    clusters.assign(clustersX * clustersY, Cluster());
+    horizontalBorders.assign(std::max(0, clustersX - 1) * clustersY, Border());
+    verticalBorders.assign(clustersX * std::max(0, clustersY - 1), Border());
+    nodeSlot.assign(gridSize * gridSize, -1);
+    gScore.assign(gridSize * gridSize, NO_PATH);
+    parent.assign(gridSize * gridSize, -1);
+    visitStamp.assign(gridSize * gridSize, 0);
+    localDistances.assign(clusterSize * clusterSize, FAR_AWAY);
+    searchStamp = 0;
+
+    for (int i = 0; i < static_cast<int>(horizontalBorders.size()); ++i) {
+        computeBorder(i, true);
+    }
+    for (int i = 0; i < static_cast<int>(verticalBorders.size()); ++i) {
+        computeBorder(i, false);
+    }
+    for (int i = 0; i < static_cast<int>(clusters.size()); ++i) {
+        buildCluster(i);
+    }
+
+    builtWallVersion = terrain.getWallVersion();
+    built = true;
+}
+
+void HierarchicalPathfinder::computeBorder(int borderIndex, bool horizontal) {
+    Border& border = horizontal ? horizontalBorders[borderIndex] : verticalBorders[borderIndex];
+    border.transitions.clear();
+
+    // Cells facing each other across the border: a inside the first cluster, b inside the second
+    int cx, cy;
+    if (horizontal) {
+        cx = borderIndex % (clustersX - 1);
+        cy = borderIndex / (clustersX - 1);
+    } else {
+        cx = borderIndex % clustersX;
+        cy = borderIndex / clustersX;
+    }
+    int line = horizontal ? (cx + 1) * clusterSize - 1 : (cy + 1) * clusterSize - 1;
+    int first = horizontal ? cy * clusterSize : cx * clusterSize;
+    int last = std::min(gridSize, first + clusterSize) - 1;
+
+    auto cellA = [&](int i) { return horizontal ? i * gridSize + line : line * gridSize + i; };
+    auto cellB = [&](int i) { return horizontal ? i * gridSize + line + 1 : (line + 1) * gridSize + i; };
+    auto bothOpen = [&](int i) {
+        return horizontal ? (isOpen(line, i) && isOpen(line + 1, i))
+                          : (isOpen(i, line) && isOpen(i, line + 1));
+    };
+
+    int runStart = -1;
+    for (int i = first; i <= last + 1; ++i) {
+        bool open = (i <= last) && bothOpen(i);
+        if (open && runStart == -1) {
+            runStart = i;
+        } else if (!open && runStart != -1) {
+            int runEnd = i - 1;
+            if (runEnd - runStart + 1 >= LONG_ENTRANCE) {
+                border.transitions.emplace_back(cellA(runStart), cellB(runStart));
+                border.transitions.emplace_back(cellA(runEnd), cellB(runEnd));
+            } else {
+                int mid = (runStart + runEnd) / 2;
+                border.transitions.emplace_back(cellA(mid), cellB(mid));
+            }
+            runStart = -1;
+        }
+    }
+}
+
+void HierarchicalPathfinder::buildCluster(int clusterIndex) {
+    Cluster& cluster = clusters[clusterIndex];
+    int cx = clusterIndex % clustersX;
+    int cy = clusterIndex / clustersX;
+    cluster.x0 = cx * clusterSize;
+    cluster.y0 = cy * clusterSize;
+    cluster.x1 = std::min(gridSize, cluster.x0 + clusterSize) - 1;
+    cluster.y1 = std::min(gridSize, cluster.y0 + clusterSize) - 1;
+
+    for (int cell : cluster.nodes) {
+        nodeSlot[cell] = -1;
+    }
+    cluster.nodes.clear();
+    cluster.links.clear();
+
+    // Gather (own cell, cell across) pairs from the four borders of this cluster
+    std::vector<std::pair<int, int>>& pairs = cluster.links;
+    if (cx > 0) {
+        for (const auto& t : horizontalBorders[cy * (clustersX - 1) + cx - 1].transitions) pairs.emplace_back(t.second, t.first);
+    }
+    if (cx < clustersX - 1) {
+        for (const auto& t : horizontalBorders[cy * (clustersX - 1) + cx].transitions) pairs.emplace_back(t.first, t.second);
+    }
+    if (cy > 0) {
+        for (const auto& t : verticalBorders[(cy - 1) * clustersX + cx].transitions) pairs.emplace_back(t.second, t.first);
+    }
+    if (cy < clustersY - 1) {
+        for (const auto& t : verticalBorders[cy * clustersX + cx].transitions) pairs.emplace_back(t.first, t.second);
+    }
+
+    for (const auto& pair : pairs) {
+        cluster.nodes.push_back(pair.first);
+    }
+    std::sort(cluster.nodes.begin(), cluster.nodes.end());
+    cluster.nodes.erase(std::unique(cluster.nodes.begin(), cluster.nodes.end()), cluster.nodes.end());
+    for (int i = 0; i < static_cast<int>(cluster.nodes.size()); ++i) {
+        nodeSlot[cluster.nodes[i]] = i;
+    }
+    // Links now refer to node slots instead of cells
+    for (auto& pair : pairs) {
+        pair.first = nodeSlot[pair.first];
+    }
+
+    int count = static_cast<int>(cluster.nodes.size());
+    cluster.distances.assign(count * count, FAR_AWAY);
+    for (int i = 0; i < count; ++i) {
+        localSearch(cluster, cluster.nodes[i]);
+        for (int j = 0; j < count; ++j) {
+            cluster.distances[i * count + j] = localDistance(cluster, cluster.nodes[j]);
+        }
+    }
+}
+
+void HierarchicalPathfinder::localSearch(const Cluster& cluster, int sourceCell) {
+    // Breadth-first search that never leaves the cluster
+    int width = cluster.x1 - cluster.x0 + 1;
+    std::fill(localDistances.begin(), localDistances.end(), FAR_AWAY);
+    localQueue.clear();
+
+    int sx = sourceCell % gridSize;
+    int sy = sourceCell / gridSize;
+    if (!isOpen(sx, sy)) {
+        return;
+    }
+    localDistances[(sy - cluster.y0) * width + (sx - cluster.x0)] = 0;
+    localQueue.push_back(sourceCell);
+
+    for (size_t head = 0; head < localQueue.size(); ++head) {
+        int cell = localQueue[head];
+        int x = cell % gridSize;
+        int y = cell / gridSize;
+        quint16 next = localDistances[(y - cluster.y0) * width + (x - cluster.x0)] + 1;
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + DX[d];
+            int ny = y + DY[d];
+            if (nx < cluster.x0 || ny < cluster.y0 || nx > cluster.x1 || ny > cluster.y1) continue;
+            quint16& dist = localDistances[(ny - cluster.y0) * width + (nx - cluster.x0)];
+            if (dist != FAR_AWAY || !isOpen(nx, ny)) continue;
+            dist = next;
+            localQueue.push_back(ny * gridSize + nx);
+        }
+    }
+}
+
+quint16 HierarchicalPathfinder::localDistance(const Cluster& cluster, int cell) const {
+    int width = cluster.x1 - cluster.x0 + 1;
+    int x = cell % gridSize;
+    int y = cell / gridSize;
+    return localDistances[(y - cluster.y0) * width + (x - cluster.x0)];
+}
+
+bool HierarchicalPathfinder::stepDownhill(const Cluster& cluster, const QPoint& from, Direction* result) const {
+    // Follow the last local search towards its source
+    quint16 best = localDistance(cluster, from.y() * gridSize + from.x());
+    if (best == FAR_AWAY || best == 0) {
+        return false;
+    }
+    for (int d = 0; d < 4; ++d) {
+        int nx = from.x() + DX[d];
+        int ny = from.y() + DY[d];
+        if (nx < cluster.x0 || ny < cluster.y0 || nx > cluster.x1 || ny > cluster.y1) continue;
+        if (localDistance(cluster, ny * gridSize + nx) < best) {
+            *result = static_cast<Direction>(d);
+            return true;
+        }
+    }
+    return false;
+}
+
+void HierarchicalPathfinder::wallDestroyed(const QPoint& pos) {
+    if (!built || terrain.getGridSize() != gridSize) {
+        return; // Built from scratch on the next query anyway
+    }
+
+    int cx = pos.x() / clusterSize;
+    int cy = pos.y() / clusterSize;
+
+    // The entrances on the four borders of the cluster may have changed...
+    if (cx > 0) computeBorder(cy * (clustersX - 1) + cx - 1, true);
+    if (cx < clustersX - 1) computeBorder(cy * (clustersX - 1) + cx, true);
+    if (cy > 0) computeBorder((cy - 1) * clustersX + cx, false);
+    if (cy < clustersY - 1) computeBorder(cy * clustersX + cx, false);
+
+    // ...which changes the nodes of the cluster and of its neighbours
+    buildCluster(cy * clustersX + cx);
+    if (cx > 0) buildCluster(cy * clustersX + cx - 1);
+    if (cx < clustersX - 1) buildCluster(cy * clustersX + cx + 1);
+    if (cy > 0) buildCluster((cy - 1) * clustersX + cx);
+    if (cy < clustersY - 1) buildCluster((cy + 1) * clustersX + cx);
+
+    // Only in sync if this was the single change since the last build
+    if (builtWallVersion + 1 == terrain.getWallVersion()) {
+        builtWallVersion = terrain.getWallVersion();
+    }
+}
+
+bool HierarchicalPathfinder::nextStepTowards(const QPoint& from, const QPoint& to, Direction* result) {
+    if (!built || builtWallVersion != terrain.getWallVersion() || terrain.getGridSize() != gridSize) {
+        rebuild();
+    }
+    auto inside = [this](const QPoint& p) {
+        return p.x() >= 0 && p.y() >= 0 && p.x() < gridSize && p.y() < gridSize;
+    };
+    if (from == to || !inside(from) || !inside(to) || !isOpen(to.x(), to.y())) {
+        return false;
+    }
+
+    const Cluster& startCluster = clusters[clusterIndexOf(from.x(), from.y())];
+    const Cluster& goalCluster = clusters[clusterIndexOf(to.x(), to.y())];
+    int goalCell = to.y() * gridSize + to.x();
+
+    // Same cluster and connected inside it: no need for the abstract graph
+    localSearch(goalCluster, goalCell);
+    if (&startCluster == &goalCluster && stepDownhill(goalCluster, from, result)) {
+        return true;
+    }
+
+    // Distance from every entrance of the goal cluster to the goal
+    std::vector<quint16> goalLinks(goalCluster.nodes.size());
+    for (size_t i = 0; i < goalCluster.nodes.size(); ++i) {
+        goalLinks[i] = localDistance(goalCluster, goalCluster.nodes[i]);
+    }
+
+    // A* over the entrances, seeded with the entrances reachable from the start
+    if (++searchStamp == 0) {
+        std::fill(visitStamp.begin(), visitStamp.end(), 0);
+        searchStamp = 1;
+    }
+    auto heuristic = [&](int cell) {
+        return std::abs(cell % gridSize - to.x()) + std::abs(cell / gridSize - to.y());
+    };
+    auto later = std::greater<std::pair<int, int>>();
+    openNodes.clear();
+    auto relax = [&](int cell, int cost, int from) {
+        if (visitStamp[cell] != searchStamp || cost < gScore[cell]) {
+            visitStamp[cell] = searchStamp;
+            gScore[cell] = cost;
+            parent[cell] = from;
+            openNodes.emplace_back(cost + heuristic(cell), cell);
+            std::push_heap(openNodes.begin(), openNodes.end(), later);
+        }
+    };
+
+    localSearch(startCluster, from.y() * gridSize + from.x());
+    for (int cell : startCluster.nodes) {
+        quint16 dist = localDistance(startCluster, cell);
+        if (dist != FAR_AWAY) relax(cell, dist, START);
+    }
+
+    int bestTotal = NO_PATH;
+    int bestLast = -1;
+    while (!openNodes.empty()) {
+        std::pop_heap(openNodes.begin(), openNodes.end(), later);
+        std::pair<int, int> top = openNodes.back();
+        openNodes.pop_back();
+        if (top.first >= bestTotal) break;
+
+        int cell = top.second;
+        int cost = gScore[cell];
+        if (top.first > cost + heuristic(cell)) continue; // stale entry
+
+        const Cluster& cluster = clusters[clusterIndexOf(cell % gridSize, cell / gridSize)];
+        int slot = nodeSlot[cell];
+        int count = static_cast<int>(cluster.nodes.size());
+
+        if (&cluster == &goalCluster && goalLinks[slot] != FAR_AWAY && cost + goalLinks[slot] < bestTotal) {
+            bestTotal = cost + goalLinks[slot];
+            bestLast = cell;
+        }
+        for (int j = 0; j < count; ++j) {
+            quint16 dist = cluster.distances[slot * count + j];
+            if (j != slot && dist != FAR_AWAY) relax(cluster.nodes[j], cost + dist, cell);
+        }
+        for (const auto& link : cluster.links) {
+            if (link.first == slot) relax(link.second, cost + 1, cell);
+        }
+    }
+
+    if (bestLast == -1) {
+        return false;
+    }
+
+    // Walk back to the first entrance on the path that is not the start cell itself
+    int first = bestLast;
+    int second = -1;
+    while (parent[first] != START) {
+        second = first;
+        first = parent[first];
+    }
+    int fromCell = from.y() * gridSize + from.x();
+    int waypoint = (first == fromCell) ? second : first;
+    if (waypoint == -1) {
+        // The start is the last entrance: the rest of the path is inside the goal cluster
+        localSearch(goalCluster, goalCell);
+        return stepDownhill(goalCluster, from, result);
+    }
+
+    int wx = waypoint % gridSize;
+    int wy = waypoint / gridSize;
+    if (std::abs(wx - from.x()) + std::abs(wy - from.y()) == 1) {
+        for (int d = 0; d < 4; ++d) {
+            if (from.x() + DX[d] == wx && from.y() + DY[d] == wy) {
+                *result = static_cast<Direction>(d);
+                return true;
+            }
+        }
+    }
+    localSearch(startCluster, waypoint);
+    return stepDownhill(startCluster, from, result);
+}
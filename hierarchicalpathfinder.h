@@ -0,0 +1,98 @@
+#ifndef HIERARCHICALPATHFINDER_H
+#define HIERARCHICALPATHFINDER_H
+
+#include <QPoint>
+#include <QtGlobal>
+#include <utility>
+#include <vector>
+#include "robot.h"
+
+class Terrain;
+
+/**
+ * @brief Hierarchical pathfinding (HPA*) for arenas too large for per-target distance fields.
+ *
+ * The grid is cut into square clusters. Where two clusters share an open stretch of border an
+ * entrance is placed, and the walking distances between the entrances of each cluster are
+ * precomputed. A query then searches this small abstract graph and only walks individual cells
+ * inside the clusters of the start and the target. When a wall is destroyed only its cluster and
+ * the clusters next to it are rebuilt.
+ *
+ * Like the distance fields, walls are obstacles and robots are not.
+ *
+ * @author Group 17
+ */
+class HierarchicalPathfinder {
+public:
+    /// Width and height of a cluster in cells
+    static const int DEFAULT_CLUSTER_SIZE = 8;
+
+    /// @brief Creates the pathfinder, the abstract graph is built on first use
+    /// @param terrain - the terrain of the match
+    /// @param clusterSize - width and height of a cluster in cells
+    explicit HierarchicalPathfinder(const Terrain& terrain, int clusterSize = DEFAULT_CLUSTER_SIZE);
+
+    /// @brief Rebuilds the whole abstract graph from the terrain
+    void rebuild();
+    /// @brief Forces a rebuild on the next query, for when the terrain was replaced as a whole
+    void invalidate() { built = false; }
+
+    /// @brief Rebuilds the clusters around a wall that was just destroyed
+    /// @param pos - the cell that used to be a wall
+    void wallDestroyed(const QPoint& pos);
+
+    /// @brief Finds the direction of the first step of a path to a target
+    /// @param from - the current cell
+    /// @param to - the target cell
+    /// @param result - receives the direction of the step
+    /// @return TRUE if a path was found and from is not the target, FALSE otherwise
+    bool nextStepTowards(const QPoint& from, const QPoint& to, Direction* result);
+
+    /// @return the number of entrance cells in the abstract graph
+    int getNodeCount() const;
+
+private:
+    /// Entrances between two neighbouring clusters, as pairs of facing cells
+    struct Border {
+        std::vector<std::pair<int, int>> transitions;
+    };
+
+    struct Cluster {
+        int x0 = 0, y0 = 0, x1 = 0, y1 = 0;  ///< inclusive cell bounds
+        std::vector<int> nodes;               ///< entrance cells inside this cluster
+        std::vector<quint16> distances;       ///< nodes.size() squared walking distances
+        std::vector<std::pair<int, int>> links; ///< (node slot, cell across the border)
+    };
+
+    bool isOpen(int x, int y) const;
+    int clusterIndexOf(int x, int y) const;
+    void computeBorder(int borderIndex, bool horizontal);
+    void buildCluster(int clusterIndex);
+    void localSearch(const Cluster& cluster, int sourceCell);
+    quint16 localDistance(const Cluster& cluster, int cell) const;
+    bool stepDownhill(const Cluster& cluster, const QPoint& from, Direction* result) const;
+
+    const Terrain& terrain;
+    int clusterSize;
+    int gridSize;
+    int clustersX;
+    int clustersY;
+    quint32 builtWallVersion;
+    bool built;
+
+    std::vector<Cluster> clusters;
+    std::vector<Border> horizontalBorders; ///< between (cx, cy) and (cx + 1, cy)
+    std::vector<Border> verticalBorders;   ///< between (cx, cy) and (cx, cy + 1)
+    std::vector<int> nodeSlot;             ///< per cell: index in its cluster's nodes, or -1
+
+    // Scratch buffers reused between queries
+    std::vector<quint16> localDistances;
+    std::vector<int> localQueue;
+    std::vector<int> gScore;
+    std::vector<int> parent;
+    std::vector<quint32> visitStamp;
+    quint32 searchStamp;
+    std::vector<std::pair<int, int>> openNodes;
+};
+
+#endif // HIERARCHICALPATHFINDER_H
@@ -0,0 +1,168 @@
+#include "influencemap.h"
+#include "terrain.h"
+#include "threatmap.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ROBOTARENA_INFLUENCE_SSE2
+#endif
+
+namespace {
+const quint8 PICKUP_SEED = 255;
+const quint8 PICKUP_DECAY = 16;
+const quint8 COVER_SEED = 255;
+const quint8 COVER_DECAY = 128;
+
+// Value a source cell spreads in a layer, 0 for cells that are not a source
+quint8 seedValue(InfluenceMap::Layer layer, CellType type) {
+    if (layer == InfluenceMap::Cover) {
+        return type == CellType::Wall ? COVER_SEED : 0;
+    }
+    switch (type) {
+        case CellType::HealthPickup:
+        case CellType::LaserPowerUp:
+        case CellType::MissilePowerUp:
+        case CellType::BombPowerUp:
+            return PICKUP_SEED;
+        default:
+            return 0;
+    }
+}
+
+quint8 decayOf(InfluenceMap::Layer layer) {
+    return layer == InfluenceMap::Cover ? COVER_DECAY : PICKUP_DECAY;
+}
+
+// Number of rows a source can reach before its value has faded to nothing
+int reachOf(InfluenceMap::Layer layer) {
+    int seed = (layer == InfluenceMap::Cover) ? COVER_SEED : PICKUP_SEED;
+    int decay = decayOf(layer);
+    return (seed + decay - 1) / decay;
+}
+
+// row[i] = max(row[i], from[i] - decay) for a whole row, the subtraction stops at 0
+void spreadRow(quint8* row, const quint8* from, int count, quint8 decay) {
+    int i = 0;
+#ifdef ROBOTARENA_INFLUENCE_SSE2
+    const __m128i step = _mm_set1_epi8(static_cast<char>(decay));
+    for (; i + 16 <= count; i += 16) {
+        __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+        __m128i target = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        target = _mm_max_epu8(target, _mm_subs_epu8(source, step));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), target);
+    }
+#endif
+    for (; i < count; ++i) {
+        int spread = from[i] - decay;
+        if (spread > row[i]) {
+            row[i] = static_cast<quint8>(spread);
+        }
+    }
+}
+}
+
+InfluenceMap::InfluenceMap()
+    : gridSize(0), stride(0), dirtyFirst(0), dirtyLast(-1), threatSource(nullptr), threatVersion(0) {
+}
+
+void InfluenceMap::reset(int size) {
+    gridSize = size;
+    stride = (size + 15) & ~15;
+    for (std::vector<quint8>& layer : layers) {
+        layer.assign(stride * gridSize, 0);
+    }
+    // Room for a band of every row, so rebuilding a band during play does not allocate
+    scratch.reserve(stride * gridSize);
+    dirtyFirst = 0;
+    dirtyLast = gridSize - 1;
+    threatSource = nullptr;
+}
+
+void InfluenceMap::markDirty(int row) {
+    if (row < 0 || row >= gridSize) {
+        return;
+    }
+    if (dirtyFirst > dirtyLast) {
+        dirtyFirst = dirtyLast = row;
+    } else {
+        dirtyFirst = std::min(dirtyFirst, row);
+        dirtyLast = std::max(dirtyLast, row);
+    }
+}
+
+void InfluenceMap::update(const Terrain& terrain, const ThreatMap& threats) {
+    if (terrain.getGridSize() != gridSize) {
+        reset(terrain.getGridSize());
+    }
+
+    if (dirtyFirst <= dirtyLast) {
+        rebuildBand(Pickup, terrain, dirtyFirst, dirtyLast);
+        rebuildBand(Cover, terrain, dirtyFirst, dirtyLast);
+        dirtyFirst = 0;
+        dirtyLast = -1;
+    }
+
+    if (threatSource != &threats || threatVersion != threats.getVersion()) {
+        rebuildThreat(threats);
+    }
+}
+
+void InfluenceMap::rebuildBand(Layer layer, const Terrain& terrain, int firstRow, int lastRow) {
+    // Rows within reach of a changed cell get new values, and those values can come from any
+    // source within reach of those rows
+    int reach = reachOf(layer);
+    quint8 decay = decayOf(layer);
+    int outFirst = std::max(0, firstRow - reach);
+    int outLast = std::min(gridSize - 1, lastRow + reach);
+    int inFirst = std::max(0, outFirst - reach);
+    int inLast = std::min(gridSize - 1, outLast + reach);
+    int rows = inLast - inFirst + 1;
+
+    scratch.assign(rows * stride, 0);
+
+    // Seed the sources and spread along each row
+    for (int r = 0; r < rows; ++r) {
+        quint8* row = &scratch[r * stride];
+        for (int x = 0; x < gridSize; ++x) {
+            row[x] = seedValue(layer, terrain.cellAt(x, inFirst + r));
+        }
+        for (int x = 1; x < gridSize; ++x) {
+            row[x] = static_cast<quint8>(std::max<int>(row[x], row[x - 1] - decay));
+        }
+        for (int x = gridSize - 2; x >= 0; --x) {
+            row[x] = static_cast<quint8>(std::max<int>(row[x], row[x + 1] - decay));
+        }
+    }
+
+    // Spread between rows, one whole row at a time
+    for (int r = 1; r < rows; ++r) {
+        spreadRow(&scratch[r * stride], &scratch[(r - 1) * stride], stride, decay);
+    }
+    for (int r = rows - 2; r >= 0; --r) {
+        spreadRow(&scratch[r * stride], &scratch[(r + 1) * stride], stride, decay);
+    }
+
+    std::copy(scratch.begin() + (outFirst - inFirst) * stride,
+              scratch.begin() + (outLast - inFirst + 1) * stride,
+              layers[layer].begin() + outFirst * stride);
+}
+
+void InfluenceMap::rebuildThreat(const ThreatMap& threats) {
+    threatSource = &threats;
+    threatVersion = threats.getVersion();
+
+    // 255 for cells the opponent can hit with its next move, a quarter less for every move after
+    std::vector<quint8>& threat = layers[Threat];
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            int moves = threats.movesToHit(QPoint(x, y));
+            threat[y * stride + x] = static_cast<quint8>(qBound(0, 255 - 64 * (moves - 1), 255));
+        }
+    }
+}
+
+int InfluenceMap::evaluate(const QPoint& cell, int threatWeight, int pickupWeight, int coverWeight) const {
+    return threatWeight * value(Threat, cell) + pickupWeight * value(Pickup, cell) +
+           coverWeight * value(Cover, cell);
+}
@@ -0,0 +1,75 @@
+#ifndef INFLUENCEMAP_H
+#define INFLUENCEMAP_H
+
+#include <QPoint>
+#include <QtGlobal>
+#include <vector>
+
+class Terrain;
+class ThreatMap;
+
+/**
+ * @brief Positional values of every cell, used by the AIs to weigh where to stand.
+ *
+ * Three layers are kept, each holding a value from 0 to 255 per cell:
+ *  - Threat: how soon the opponent could hit the cell, taken from its ThreatMap
+ *  - Pickup: attraction of health pickups and power-ups, fading with distance
+ *  - Cover: protection offered by nearby walls, fading with distance
+ *
+ * The pickup and cover layers spread a value from every source cell and lose a fixed amount per
+ * step, so a cell holds the strongest value reaching it. Rows are stored with a stride rounded up
+ * to 16 cells, so the spreading between rows is done a whole row at a time with SSE2 where it is
+ * available.
+ *
+ * Only rows near a changed cell are recomputed: markDirty() is called for every terrain change and
+ * update() rebuilds the band of rows the change can reach.
+ *
+ * @author Group 17
+ */
+class InfluenceMap {
+public:
+    /// The layers of the map
+    enum Layer { Threat, Pickup, Cover, LAYER_COUNT };
+
+    InfluenceMap();
+
+    /// @brief Clears the map and marks every row as out of date
+    /// @param gridSize - the width and height of the grid
+    void reset(int gridSize);
+    /// @brief Marks the row of a changed cell as out of date
+    /// @param row - the row of the cell that changed
+    void markDirty(int row);
+    /// @brief Brings the map up to date
+    /// @param terrain - the terrain of the match
+    /// @param threats - the threat map of the opponent, must already be up to date
+    void update(const Terrain& terrain, const ThreatMap& threats);
+
+    /// @param layer - the layer to read
+    /// @param cell - the cell to check, must be inside the grid
+    /// @return the value of the cell in the layer, from 0 to 255
+    quint8 value(Layer layer, const QPoint& cell) const { return layers[layer][cell.y() * stride + cell.x()]; }
+
+    /// @brief Weighted sum of the layers at a cell
+    /// @param cell - the cell to check, must be inside the grid
+    /// @param threatWeight - weight of the threat layer, usually negative
+    /// @param pickupWeight - weight of the pickup layer
+    /// @param coverWeight - weight of the cover layer
+    /// @return the combined value of the cell
+    int evaluate(const QPoint& cell, int threatWeight, int pickupWeight, int coverWeight) const;
+
+private:
+    void rebuildBand(Layer layer, const Terrain& terrain, int firstRow, int lastRow);
+    void rebuildThreat(const ThreatMap& threats);
+
+    int gridSize;
+    int stride;
+    std::vector<quint8> layers[LAYER_COUNT];
+    std::vector<quint8> scratch;
+    /// Rows changed since the last update, dirtyFirst > dirtyLast when nothing changed
+    int dirtyFirst;
+    int dirtyLast;
+    const ThreatMap* threatSource;
+    quint32 threatVersion;
+};
+
+#endif // INFLUENCEMAP_H
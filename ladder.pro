@@ -0,0 +1,19 @@
+QT += widgets concurrent
+QMAKE_CXXFLAGS += -std=c++17
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += . tools
+
+SOURCES += \
+    tools/ladder.cpp \
+    tools/tournament.cpp \
+    tools/ratings.cpp
+
+HEADERS += \
+    tools/tournament.h \
+    tools/ratings.h
+
+include(robotarena.pri)
+
+TARGET = robot_arena_ladder
\ No newline at end of file
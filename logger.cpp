@@ -1,18 +1,31 @@
 #include "logger.h"
 #include <QDateTime>
 #include <QDebug>
+#include <QMetaObject>
 
 QPlainTextEdit* Logger::logWidget = nullptr;
+std::atomic<bool> Logger::enabled(true);
 
 void Logger::setLogWidget(QPlainTextEdit* widget) {
     logWidget = widget;
 }
 
+void Logger::setEnabled(bool isEnabled) {
+    enabled.store(isEnabled, std::memory_order_relaxed);
+}
+
 void Logger::log(const QString& message) {
+    if (!isEnabled()) {
+        return;
+    }
     QString timeStamp = QDateTime::currentDateTime().toString("hh:mm:ss");
     QString logMessage = QString("[%1] %2").arg(timeStamp, message);
     if (logWidget) {
-        logWidget->appendPlainText(logMessage);
+        // AIs may log from a worker thread, the widget is only ever touched on its own thread
+        QPlainTextEdit* widget = logWidget;
+        QMetaObject::invokeMethod(widget, [widget, logMessage]() {
+            widget->appendPlainText(logMessage);
+        });
     }
     // Also output to the debug console.
     qDebug() << logMessage;
@@ -3,6 +3,7 @@
 
 #include <QPlainTextEdit>
 #include <QString>
+#include <atomic>
 
 /**
  * @brief The Logger class records all the action done by the player. Primarily used for recovery and checking game actions
@@ -12,11 +13,21 @@ class Logger {
 public:
     /// Set the text widget that will display log messages.
     static void setLogWidget(QPlainTextEdit* widget);
-    /// Log a message (with a timestamp).
+    /// Log a message (with a timestamp). Safe to call from any thread.
     static void log(const QString& message);
+    /// Enable or disable logging. Headless matches turn it off so no message is formatted at all.
+    static void setEnabled(bool enabled);
+    /// Check whether log messages are currently being recorded.
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
     
 private:
     static QPlainTextEdit* logWidget;
+    static std::atomic<bool> enabled;
 };
 
+/// Log a message only when logging is enabled. Unlike Logger::log() the message expression is
+/// not evaluated otherwise, which keeps the string formatting out of the AI decision path.
+#define AI_LOG(message) \
+    do { if (Logger::isEnabled()) Logger::log(message); } while (0)
+
 #endif // LOGGER_H
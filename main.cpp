@@ -2,10 +2,21 @@
 #include "gamegrid.h"
 #include "mainmenu.h"
 #include "gamemanager.h"
+#include "aiparameters.h"
+#include "mapanalysis.h"
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
+
+    // Use the parameter sets written by the tuner when there are any next to the program
+    AIParameterSets tuned;
+    if (tuned.load(QCoreApplication::applicationDirPath() + "/aiparameters.txt")) {
+        AIParameterSets::setDefaults(tuned);
+    }
     
+    // Few maps are played here, one at a time, so their analysis may as well be kept on disk
+    MapAnalysis::setDiskCacheEnabled(true);
+
     // Create the game manager
     GameManager* gameManager = new GameManager();
     gameManager->getMainWidget()->show();
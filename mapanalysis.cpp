@@ -0,0 +1,409 @@
+#include "mapanalysis.h"
+#include "terrain.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+const quint32 CACHE_MAGIC = 0x524D4150; // "RMAP"
+const quint32 CACHE_VERSION = 1;
+
+std::atomic<bool> diskCacheEnabled(false);
+
+QString cacheDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/maps";
+}
+
+const int DX[4] = { 0, 1, 0, -1 };
+const int DY[4] = { -1, 0, 1, 0 };
+}
+
+MapAnalysis::MapAnalysis()
+    : terrain(nullptr), gridSize(0), mapHash(0), topologyStale(false), modified(false) {
+}
+
+quint64 MapAnalysis::hashMap(const TerrainMap& map) {
+    // Only walls change the analysis, so maps that differ in their pickups share one entry
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](quint8 byte) {
+        hash ^= byte;
+        hash *= 1099511628211ULL;
+    };
+    int size = map.getGridSize();
+    for (int shift = 0; shift < 32; shift += 8) {
+        mix(static_cast<quint8>(size >> shift));
+    }
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            mix(map.cellAt(x, y) == CellType::Wall ? 1 : 0);
+        }
+    }
+    return hash;
+}
+
+QString MapAnalysis::cachePath(quint64 hash) {
+    return cacheDirectory() + QString("/%1.analysis").arg(hash, 16, 16, QChar('0'));
+}
+
+void MapAnalysis::setDiskCacheEnabled(bool enabled) {
+    diskCacheEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void MapAnalysis::loadOrAnalyse(const Terrain& newTerrain) {
+    const TerrainMap& map = *newTerrain.getBaseMap();
+    std::shared_ptr<const MapAnalysis> shared = map.getAnalysis();
+    if (!shared) {
+        auto analysis = std::make_shared<MapAnalysis>();
+        analysis->terrain = &newTerrain;
+        quint64 hash = hashMap(map);
+        bool useDisk = diskCacheEnabled.load(std::memory_order_relaxed);
+        if (!useDisk || !analysis->load(cachePath(hash), hash)) {
+            analysis->analyse(newTerrain);
+            if (useDisk && analysis->save(cachePath(hash))) {
+                pruneDiskCache(cacheDirectory());
+            }
+        }
+        // The copy kept with the map outlives this terrain
+        analysis->terrain = nullptr;
+        shared = map.setAnalysis(std::move(analysis));
+    }
+    *this = *shared;
+    terrain = &newTerrain;
+    reserve();
+}
+
+void MapAnalysis::analyse(const Terrain& newTerrain) {
+    terrain = &newTerrain;
+    gridSize = newTerrain.getGridSize();
+    mapHash = hashMap(*newTerrain.getBaseMap());
+
+    vantage.assign(gridSize * gridSize, 0);
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            computeVantage(x, y);
+        }
+    }
+    rebuildVantageCells();
+    computeTopology();
+    modified = false;
+}
+
+void MapAnalysis::wallDestroyed(const QPoint& pos) {
+    if (!terrain || gridSize != terrain->getGridSize()) {
+        return;
+    }
+
+    // Only the cells that can look through the destroyed wall see more now
+    computeVantage(pos.x(), pos.y());
+    for (int d = 0; d < 4; ++d) {
+        for (int step = 1; step <= VANTAGE_RANGE; ++step) {
+            int x = pos.x() + DX[d] * step;
+            int y = pos.y() + DY[d] * step;
+            if (x < 0 || y < 0 || x >= gridSize || y >= gridSize) break;
+            computeVantage(x, y);
+        }
+    }
+    rebuildVantageCells();
+
+    topologyStale = true;
+    modified = true;
+}
+
+bool MapAnalysis::isOpen(int x, int y) const {
+    return x >= 0 && y >= 0 && x < gridSize && y < gridSize && terrain->cellAt(x, y) != CellType::Wall;
+}
+
+void MapAnalysis::computeVantage(int x, int y) {
+    quint8& cell = vantage[y * gridSize + x];
+    cell = 0;
+    if (!isOpen(x, y)) {
+        return;
+    }
+    for (int d = 0; d < 4; ++d) {
+        for (int step = 1; step <= VANTAGE_RANGE; ++step) {
+            if (!isOpen(x + DX[d] * step, y + DY[d] * step)) break;
+            cell++;
+        }
+    }
+}
+
+void MapAnalysis::reserve() {
+    int cellCount = gridSize * gridSize;
+    vantageCells.reserve(cellCount);
+    flags.reserve(cellCount);
+    chokepoints.reserve(cellCount);
+    for (std::vector<quint16>& distance : spawnDistance) {
+        distance.reserve(cellCount);
+    }
+    searchCells.reserve(cellCount * 3);
+    searchDirections.reserve(cellCount);
+    searchStack.reserve(cellCount);
+}
+
+void MapAnalysis::rebuildVantageCells() {
+    vantageCells.clear();
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            if (vantage[y * gridSize + x] > 0) {
+                vantageCells.push_back(QPoint(x, y));
+            }
+        }
+    }
+    auto better = [this](const QPoint& a, const QPoint& b) {
+        return vantage[a.y() * gridSize + a.x()] > vantage[b.y() * gridSize + b.x()];
+    };
+    if (static_cast<int>(vantageCells.size()) > MAX_VANTAGE_CELLS) {
+        std::partial_sort(vantageCells.begin(), vantageCells.begin() + MAX_VANTAGE_CELLS,
+                          vantageCells.end(), better);
+        vantageCells.resize(MAX_VANTAGE_CELLS);
+    } else {
+        std::sort(vantageCells.begin(), vantageCells.end(), better);
+    }
+}
+
+void MapAnalysis::ensureTopology() const {
+    if (topologyStale) {
+        computeTopology();
+    }
+}
+
+void MapAnalysis::computeTopology() const {
+    flags.assign(gridSize * gridSize, 0);
+    computeChokepoints();
+    computeDeadEnds();
+    computeSpawnDistances();
+    topologyStale = false;
+}
+
+void MapAnalysis::computeChokepoints() const {
+    // Articulation points of the open cells (Tarjan), walked with an explicit stack since a
+    // corridor can be as long as the map has cells
+    int cellCount = gridSize * gridSize;
+    searchCells.assign(cellCount * 3, -1);
+    int* discovered = searchCells.data();
+    int* low = discovered + cellCount;
+    int* parent = low + cellCount;
+    searchDirections.assign(cellCount, 0);
+    quint8* nextDir = searchDirections.data();
+    std::vector<int>& stack = searchStack;
+    stack.clear();
+    int time = 0;
+
+    chokepoints.clear();
+    for (int root = 0; root < cellCount; ++root) {
+        if (discovered[root] != -1 || !isOpen(root % gridSize, root / gridSize)) continue;
+
+        int rootChildren = 0;
+        discovered[root] = low[root] = time++;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            int v = stack.back();
+            if (nextDir[v] < 4) {
+                int d = nextDir[v]++;
+                int x = v % gridSize + DX[d];
+                int y = v / gridSize + DY[d];
+                if (!isOpen(x, y)) continue;
+                int w = y * gridSize + x;
+                if (discovered[w] == -1) {
+                    parent[w] = v;
+                    discovered[w] = low[w] = time++;
+                    stack.push_back(w);
+                    if (v == root) rootChildren++;
+                } else if (w != parent[v]) {
+                    low[v] = std::min(low[v], discovered[w]);
+                }
+                continue;
+            }
+
+            stack.pop_back();
+            int p = parent[v];
+            if (p == -1) continue;
+            low[p] = std::min(low[p], low[v]);
+            if (p != root && low[v] >= discovered[p]) {
+                flags[p] |= ChokepointFlag;
+            }
+        }
+        if (rootChildren > 1) {
+            flags[root] |= ChokepointFlag;
+        }
+    }
+
+    for (int i = 0; i < cellCount; ++i) {
+        if (flags[i] & ChokepointFlag) {
+            chokepoints.push_back(QPoint(i % gridSize, i / gridSize));
+        }
+    }
+}
+
+void MapAnalysis::computeDeadEnds() const {
+    auto degree = [this](int x, int y) {
+        int count = 0;
+        for (int d = 0; d < 4; ++d) {
+            if (isOpen(x + DX[d], y + DY[d])) count++;
+        }
+        return count;
+    };
+
+    // Start at every closed end and follow the corridor until it reaches a junction
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            if (!isOpen(x, y) || degree(x, y) > 1) continue;
+
+            QPoint previous(-1, -1);
+            QPoint current(x, y);
+            while (true) {
+                quint8& cell = flags[current.y() * gridSize + current.x()];
+                if (cell & DeadEndFlag) break;
+                cell |= DeadEndFlag;
+
+                QPoint next(-1, -1);
+                for (int d = 0; d < 4; ++d) {
+                    QPoint neighbour(current.x() + DX[d], current.y() + DY[d]);
+                    if (neighbour != previous && isOpen(neighbour.x(), neighbour.y())) {
+                        next = neighbour;
+                        break;
+                    }
+                }
+                if (next.x() == -1 || degree(next.x(), next.y()) > 2) break;
+                previous = current;
+                current = next;
+            }
+        }
+    }
+}
+
+void MapAnalysis::computeSpawnDistances() const {
+    const QPoint spawns[2] = { QPoint(0, gridSize - 1), QPoint(gridSize - 1, 0) };
+    std::vector<int>& queue = searchStack;
+    queue.reserve(gridSize * gridSize);
+
+    for (int s = 0; s < 2; ++s) {
+        std::vector<quint16>& distance = spawnDistance[s];
+        distance.assign(gridSize * gridSize, UNREACHABLE);
+        if (!isOpen(spawns[s].x(), spawns[s].y())) continue;
+
+        queue.clear();
+        int start = spawns[s].y() * gridSize + spawns[s].x();
+        distance[start] = 0;
+        queue.push_back(start);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int v = queue[head];
+            for (int d = 0; d < 4; ++d) {
+                int x = v % gridSize + DX[d];
+                int y = v / gridSize + DY[d];
+                if (!isOpen(x, y)) continue;
+                int w = y * gridSize + x;
+                if (distance[w] != UNREACHABLE) continue;
+                distance[w] = distance[v] + 1;
+                queue.push_back(w);
+            }
+        }
+    }
+}
+
+bool MapAnalysis::isChokepoint(const QPoint& pos) const {
+    ensureTopology();
+    return flags[pos.y() * gridSize + pos.x()] & ChokepointFlag;
+}
+
+bool MapAnalysis::isDeadEnd(const QPoint& pos) const {
+    ensureTopology();
+    return flags[pos.y() * gridSize + pos.x()] & DeadEndFlag;
+}
+
+const std::vector<QPoint>& MapAnalysis::getChokepoints() const {
+    ensureTopology();
+    return chokepoints;
+}
+
+quint16 MapAnalysis::getSpawnDistance(int spawn, const QPoint& pos) const {
+    ensureTopology();
+    return spawnDistance[spawn][pos.y() * gridSize + pos.x()];
+}
+
+bool MapAnalysis::load(const QString& path, quint64 hash) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint64 storedHash = 0;
+    qint32 storedSize = 0;
+    in >> magic >> version >> storedHash >> storedSize;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION || storedHash != hash ||
+        storedSize != terrain->getGridSize()) {
+        return false;
+    }
+
+    int cellCount = storedSize * storedSize;
+    std::vector<quint8> storedVantage(cellCount);
+    std::vector<quint8> storedFlags(cellCount);
+    std::vector<quint16> storedDistance[2];
+    in.readRawData(reinterpret_cast<char*>(storedVantage.data()), cellCount);
+    in.readRawData(reinterpret_cast<char*>(storedFlags.data()), cellCount);
+    for (std::vector<quint16>& distance : storedDistance) {
+        distance.resize(cellCount);
+        for (quint16& value : distance) {
+            in >> value;
+        }
+    }
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    gridSize = storedSize;
+    mapHash = hash;
+    vantage = std::move(storedVantage);
+    flags = std::move(storedFlags);
+    spawnDistance[0] = std::move(storedDistance[0]);
+    spawnDistance[1] = std::move(storedDistance[1]);
+    chokepoints.clear();
+    for (int i = 0; i < cellCount; ++i) {
+        if (flags[i] & ChokepointFlag) {
+            chokepoints.push_back(QPoint(i % gridSize, i / gridSize));
+        }
+    }
+    rebuildVantageCells();
+    topologyStale = false;
+    modified = false;
+    return true;
+}
+
+bool MapAnalysis::save(const QString& path) const {
+    ensureTopology();
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) {
+        return false;
+    }
+
+    // Written to a temporary file first, so a crash never leaves half a cache entry behind
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream out(&file);
+    out << CACHE_MAGIC << CACHE_VERSION << mapHash << static_cast<qint32>(gridSize);
+    int cellCount = gridSize * gridSize;
+    out.writeRawData(reinterpret_cast<const char*>(vantage.data()), cellCount);
+    out.writeRawData(reinterpret_cast<const char*>(flags.data()), cellCount);
+    for (const std::vector<quint16>& distance : spawnDistance) {
+        for (quint16 value : distance) {
+            out << value;
+        }
+    }
+    return file.commit();
+}
+
+void MapAnalysis::pruneDiskCache(const QString& dir) {
+    // Newest first, everything past the bound goes
+    QFileInfoList files = QDir(dir).entryInfoList(QStringList() << "*.analysis", QDir::Files, QDir::Time);
+    for (int i = MAX_CACHED_MAPS; i < files.size(); ++i) {
+        QFile::remove(files[i].absoluteFilePath());
+    }
+}
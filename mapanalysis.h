@@ -0,0 +1,126 @@
+#ifndef MAPANALYSIS_H
+#define MAPANALYSIS_H
+
+#include <QPoint>
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+class Terrain;
+class TerrainMap;
+
+/**
+ * @brief Static knowledge about the layout of a map, worked out once per map.
+ *
+ * For every map the analysis finds:
+ *  - chokepoints: open cells whose loss would split the open area in two
+ *  - dead ends: corridors that lead nowhere, from their closed end up to the first junction
+ *  - vantage: how many open cells a Sniper sees from a cell, looking up to 3 cells in each direction
+ *  - spawn distances: walking distance from both starting corners to every cell, which covers
+ *    the distance to every pickup wherever it is placed
+ *
+ * The results are kept with the shared TerrainMap, so the work is only done by the first match
+ * played on a map. If the disk cache is enabled, they are also stored in a cache file next to the
+ * other cached data of the application, keyed by a hash of the wall layout, so that a map played
+ * again after a restart is not worked out again. Only the most recently stored maps are kept.
+ *
+ * When a wall is destroyed during a match, the vantage of the cells around it is updated at once,
+ * while chokepoints, dead ends and spawn distances are worked out again the next time they are
+ * asked for.
+ *
+ * @author Group 17
+ */
+class MapAnalysis {
+public:
+    /// How far a Sniper can shoot, and so how far vantage looks
+    static constexpr int VANTAGE_RANGE = 3;
+    /// Stored for cells that cannot be reached from a starting corner
+    static constexpr quint16 UNREACHABLE = 0xFFFF;
+    /// Number of cells kept in the list of best vantage cells
+    static constexpr int MAX_VANTAGE_CELLS = 16;
+    /// Number of maps kept in the disk cache
+    static constexpr int MAX_CACHED_MAPS = 64;
+
+    MapAnalysis();
+
+    /// @brief Takes the analysis kept with the terrain's map, or loads it from the disk cache or
+    /// works it out and keeps it with the map
+    /// @param terrain - the terrain to analyse, must outlive the analysis and have no changes yet
+    void loadOrAnalyse(const Terrain& terrain);
+    /// @brief Works out the analysis from scratch without using the cache
+    /// @param terrain - the terrain to analyse, must outlive the analysis
+    void analyse(const Terrain& terrain);
+    /// @brief Updates the analysis after a wall was destroyed
+    /// @param pos - the position of the destroyed wall
+    void wallDestroyed(const QPoint& pos);
+    /// @brief Sets aside the memory of the vantage cells and of the topology for every cell, so
+    /// that walls destroyed later in the match do not allocate
+    void reserve();
+    /// @brief Points a copied analysis at the terrain of the game it was copied into
+    /// @param terrain - a terrain with the same layout as the analysed one
+    void setTerrain(const Terrain& terrain) { this->terrain = &terrain; }
+
+    /// @brief Hash of the wall layout of a map, used as the key of the cache
+    /// @param map - the map to hash
+    /// @return a 64-bit FNV-1a hash of the grid size and the wall cells
+    static quint64 hashMap(const TerrainMap& map);
+    /// @param hash - the hash of a map
+    /// @return the path of the cache file holding the analysis of that map
+    static QString cachePath(quint64 hash);
+    /// @brief Turns the disk cache on or off, off by default. Worth it where few maps are played
+    /// one at a time, not for batch runs that play thousands of generated maps.
+    /// @param enabled - TRUE to load and store analyses in cache files from now on
+    static void setDiskCacheEnabled(bool enabled);
+
+    /// @return the hash of the analysed map
+    quint64 getMapHash() const { return mapHash; }
+    /// @return TRUE if the open area would be split in two without this cell, FALSE otherwise
+    bool isChokepoint(const QPoint& pos) const;
+    /// @return TRUE if the cell is part of a dead-end corridor, FALSE otherwise
+    bool isDeadEnd(const QPoint& pos) const;
+    /// @return the number of open cells a Sniper sees from the cell, 0 for walls
+    int getVantage(const QPoint& pos) const { return vantage[pos.y() * gridSize + pos.x()]; }
+    /// @return all chokepoints of the map
+    const std::vector<QPoint>& getChokepoints() const;
+    /// @return the cells with the best vantage, best first
+    const std::vector<QPoint>& getVantageCells() const { return vantageCells; }
+    /// @param spawn - 0 for the bottom-left corner, 1 for the top-right corner
+    /// @param pos - the cell to measure to
+    /// @return the walking distance from the starting corner to the cell, or UNREACHABLE
+    quint16 getSpawnDistance(int spawn, const QPoint& pos) const;
+
+private:
+    enum Flag : quint8 { ChokepointFlag = 1, DeadEndFlag = 2 };
+
+    bool load(const QString& path, quint64 hash);
+    bool save(const QString& path) const;
+    static void pruneDiskCache(const QString& dir);
+    void computeVantage(int x, int y);
+    void rebuildVantageCells();
+    void ensureTopology() const;
+    void computeTopology() const;
+    void computeChokepoints() const;
+    void computeDeadEnds() const;
+    void computeSpawnDistances() const;
+    bool isOpen(int x, int y) const;
+
+    const Terrain* terrain;
+    int gridSize;
+    quint64 mapHash;
+    std::vector<quint8> vantage;
+    std::vector<QPoint> vantageCells;
+    // Worked out again on demand once a destroyed wall made them out of date
+    mutable std::vector<quint8> flags;
+    mutable std::vector<QPoint> chokepoints;
+    mutable std::vector<quint16> spawnDistance[2];
+    mutable bool topologyStale;
+    /// Scratch memory of the topology searches, kept to reuse it: discovery time, low link and
+    /// parent of every cell, the next direction to try from every cell, and a stack or queue
+    mutable std::vector<int> searchCells;
+    mutable std::vector<quint8> searchDirections;
+    mutable std::vector<int> searchStack;
+    /// Set once a wall was destroyed, the analysis no longer matches the cached map
+    bool modified;
+};
+
+#endif // MAPANALYSIS_H
@@ -0,0 +1,109 @@
+#include "matchrunner.h"
+#include "game.h"
+#include "robotai.h"
+
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+/// Takes matches until none are left
+void playMatches(const std::vector<MatchSpec>& specs, std::atomic<int>& nextMatch,
+                 std::vector<MatchResult>& results) {
+    const int count = static_cast<int>(specs.size());
+    for (int i = nextMatch.fetch_add(1); i < count; i = nextMatch.fetch_add(1)) {
+        results[i] = MatchRunner::play(specs[i]);
+    }
+}
+
+} // namespace
+
+MatchResult MatchRunner::play(const MatchSpec& spec) {
+    auto aiSide = std::make_unique<RobotAI>();
+    if (spec.setupAi) {
+        spec.setupAi(*aiSide);
+    }
+    RobotAI playerSide;
+    if (spec.setupPlayer) {
+        spec.setupPlayer(playerSide);
+    }
+
+    // The arena is set up below, a random one would only be thrown away
+    Game game(spec.gridSize, nullptr, std::move(aiSide), false);
+    game.setAiTimeBudget(spec.decisionBudgetMs);
+    if (spec.seed != 0) {
+        game.setSeed(spec.seed);
+        game.getRobotAI()->setSeed(spec.seed);
+        playerSide.setSeed(~spec.seed);
+    }
+    if (spec.map) {
+        game.initializeArena(spec.map, spec.playerType, spec.aiType, spec.difficulty);
+    } else {
+        game.initializeArena(spec.playerType, spec.aiType, spec.difficulty, spec.mapType);
+    }
+    if (spec.swapCorners) {
+        QPoint playerStart = game.getPlayerRobot()->getPosition();
+        game.getPlayerRobot()->setPosition(game.getAiRobot()->getPosition());
+        game.getAiRobot()->setPosition(playerStart);
+    }
+
+    MatchResult result;
+    while (game.getState() != GameState::GameOver && result.commands < spec.maxCommands) {
+        if (game.getState() == GameState::AiTurn) {
+            game.executeAiTurn();
+        } else {
+            Decision decision = playerSide.decide(&game, game.getPlayerRobot(), game.getAiRobot(),
+                                                  DecisionBudget::fromNow(spec.decisionBudgetMs));
+            Command command = decision.command;
+            if (command == Command::None) {
+                MoveList moves = game.generateMoves();
+                if (!moves.isEmpty()) {
+                    command = moves[0].first();
+                }
+            }
+            game.executeCommand(command);
+        }
+        result.commands++;
+    }
+
+    if (game.getState() == GameState::GameOver) {
+        if (game.getAiRobot()->isDead()) {
+            result.outcome = MatchOutcome::PlayerWon;
+        } else if (game.getPlayerRobot()->isDead()) {
+            result.outcome = MatchOutcome::AiWon;
+        }
+    }
+    return result;
+}
+
+std::vector<MatchResult> MatchRunner::playAll(const std::vector<MatchSpec>& specs) {
+    std::vector<MatchResult> results(specs.size());
+    int tasks = std::min(std::max(1, QThreadPool::globalInstance()->maxThreadCount()),
+                         static_cast<int>(specs.size()));
+
+    // One task per thread, the calling thread included, each taking matches until none are left
+    std::atomic<int> nextMatch(0);
+    std::vector<QFuture<void>> workers;
+    for (int t = 1; t < tasks; ++t) {
+        workers.push_back(QtConcurrent::run([&]() {
+            playMatches(specs, nextMatch, results);
+        }));
+    }
+    playMatches(specs, nextMatch, results);
+    for (QFuture<void>& worker : workers) {
+        worker.waitForFinished();
+    }
+    return results;
+}
+
+std::shared_ptr<const TerrainMap> MatchRunner::generateMap(MapType mapType, int gridSize, quint32 seed) {
+    Game game(gridSize, nullptr, nullptr, false);
+    if (seed != 0) {
+        game.setSeed(seed);
+    }
+    game.initializeArena(RobotType::Tank, RobotType::Tank, GameDifficulty::Medium, mapType);
+    return game.getBaseMap();
+}
@@ -0,0 +1,84 @@
+#ifndef MATCHRUNNER_H
+#define MATCHRUNNER_H
+
+#include <QtGlobal>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "robot.h"
+#include "difficultyselector.h"
+#include "mapselector.h"
+
+class RobotAI;
+class TerrainMap;
+
+/// @brief One match between two AIs, played without a window
+/// @author Group 17
+struct MatchSpec {
+    /// Robot of the side that moves first, in the player's corner
+    RobotType playerType = RobotType::Tank;
+    /// Robot of the side that moves second, in the AI's corner with the difficulty's modifiers
+    RobotType aiType = RobotType::Tank;
+    GameDifficulty difficulty = GameDifficulty::Medium;
+    /// Map generated for the match when no map is given
+    MapType mapType = MapType::Random;
+    /// Layout to play on, from generateMap(), so that several matches can share one
+    std::shared_ptr<const TerrainMap> map;
+    /// Size of a generated map
+    int gridSize = 12;
+    /// Seeds the pickups, the AIs' random choices and a generated map, 0 for random ones. Matches
+    /// of scripted AIs with the same seed play out the same.
+    quint32 seed = 0;
+    /// Starts each side in the other's corner, the player side still moves first
+    bool swapCorners = false;
+    /// Time each decision may take, only searching strategies use it
+    int decisionBudgetMs = 50;
+    /// Commands after which the match is a draw
+    int maxCommands = 2000;
+    /// Set up the AI of each side before the match, for example with RobotAI::setParameters().
+    /// Called on the thread the match is played on.
+    std::function<void(RobotAI&)> setupPlayer;
+    std::function<void(RobotAI&)> setupAi;
+};
+
+/// @brief How a match ended
+enum class MatchOutcome { PlayerWon, AiWon, Draw };
+
+/// @brief The result of a played match
+/// @author Group 17
+struct MatchResult {
+    MatchOutcome outcome = MatchOutcome::Draw;
+    /// Commands executed by both sides
+    int commands = 0;
+};
+
+/**
+ * @brief Plays matches between AIs without a window, many at once on the global thread pool.
+ *
+ * Both sides are played by a RobotAI: the AI side by the game's own, the player side by a second
+ * one. A side whose AI has no command plays the first command it can. Matches are independent, so
+ * a batch is spread over every thread the same way AIBatch spreads decisions: one task per thread
+ * takes the next match from a shared counter until none are left. The batch tools also have the
+ * scripted strategies share their decisions between the matches (see RobotAI::setDecisionCaching()).
+ *
+ * @author Group 17
+ */
+class MatchRunner {
+public:
+    /// @brief Plays one match on the calling thread
+    /// @param spec - the match
+    /// @return How the match ended
+    static MatchResult play(const MatchSpec& spec);
+    /// @brief Plays every match, on every thread of the global pool
+    /// @param specs - the matches
+    /// @return The result of every match, in the order of the matches
+    static std::vector<MatchResult> playAll(const std::vector<MatchSpec>& specs);
+    /// @brief Generates a map with its pickups, to play several matches on the same layout
+    /// @param mapType - the kind of map
+    /// @param gridSize - cells along each side
+    /// @param seed - the seed of the layout and the pickups, 0 for a random one
+    /// @return The layout, shared by the matches played on it
+    static std::shared_ptr<const TerrainMap> generateMap(MapType mapType, int gridSize, quint32 seed = 0);
+};
+
+#endif // MATCHRUNNER_H
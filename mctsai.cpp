@@ -0,0 +1,355 @@
+#include "mctsai.h"
+#include "game.h"
+#include "robot.h"
+#include "logger.h"
+
+#include <QFuture>
+#include <QRandomGenerator>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+/// Weight of exploring rarely visited actions against exploiting good ones (UCB1)
+const double EXPLORATION = 1.41;
+/// Chance that a rollout takes an attack when one is on offer
+const int ROLLOUT_ATTACK_PERCENT = 60;
+
+bool isFinished(Game* game, int aiSlot) {
+    return game->getState() == GameState::GameOver || game->robotInSlot(aiSlot)->isDead() ||
+           game->robotInSlot(game->opponentSlot(aiSlot))->isDead();
+}
+
+// 1 for a won game, 0 for a lost one, otherwise the difference in remaining health
+double evaluate(Game* game, int aiSlot) {
+    const Robot* ai = game->robotInSlot(aiSlot);
+    const Robot* opponent = game->robotInSlot(game->opponentSlot(aiSlot));
+    if (ai->isDead()) return 0.0;
+    if (opponent->isDead()) return 1.0;
+    double aiShare = static_cast<double>(ai->getHealth()) / ai->getMaxHealth();
+    double opponentShare = static_cast<double>(opponent->getHealth()) / opponent->getMaxHealth();
+    return qBound(0.0, 0.5 + 0.5 * (aiShare - opponentShare), 1.0);
+}
+
+// Cheap policy for rollouts: usually attack when an attack can hit something, otherwise random
+const Action& pickRolloutAction(const MoveList& moves, QRandomGenerator& rng) {
+    if (static_cast<int>(rng.bounded(100)) < ROLLOUT_ATTACK_PERCENT) {
+        int attacks = 0;
+        for (const Action& action : moves) {
+            if (action.commands[action.count - 1] == Command::Attack) attacks++;
+        }
+        if (attacks > 0) {
+            int pick = static_cast<int>(rng.bounded(attacks));
+            for (const Action& action : moves) {
+                if (action.commands[action.count - 1] == Command::Attack && pick-- == 0) return action;
+            }
+        }
+    }
+    return moves[static_cast<int>(rng.bounded(moves.size()))];
+}
+
+/// One node of a search tree, children of a node are stored next to each other
+struct Node {
+    Action action;       ///< Action leading to this node
+    int parent;
+    int firstChild;
+    int childCount;      ///< -1 until the node is expanded
+    int expandedCount;   ///< Children that have been visited at least once
+    int mover;           ///< Slot of the robot that played the action
+    int visits;
+    double reward;       ///< Sum of rewards from the point of view of the mover
+};
+
+/// A search tree grown one iteration at a time, from a frozen copy of the game
+class SearchTree {
+public:
+    SearchTree(const Game& root, int aiSlot, int iterations, int rolloutDepth, quint32 seed)
+        : root(root), game(root.clone()), rng(seed), aiSlot(aiSlot), rolloutDepth(rolloutDepth) {
+        nodes.reserve(iterations > 0 ? iterations + MoveList::MAX_ACTIONS : 4096);
+        nodes.push_back(Node{ Action(), -1, 0, -1, 0, -1, 0, 0.0 });
+    }
+
+    /// Selects a node, expands it, plays a rollout from it and backs the result up to the root
+    void iterate() {
+        game->copyStateFrom(root);
+        int current = 0;
+
+        // Selection and expansion: walk down the tree until a child is visited for the first time
+        while (!isFinished(game.get(), aiSlot)) {
+            if (nodes[current].childCount < 0) {
+                MoveList moves = game->generateMoves();
+                int mover = game->slotToMove();
+                nodes[current].firstChild = static_cast<int>(nodes.size());
+                nodes[current].childCount = moves.size();
+                for (const Action& action : moves) {
+                    nodes.push_back(Node{ action, current, 0, -1, 0, mover, 0, 0.0 });
+                }
+            }
+
+            Node& node = nodes[current];
+            if (node.childCount == 0) {
+                break;
+            }
+            if (node.expandedCount < node.childCount) {
+                current = node.firstChild + node.expandedCount++;
+                game->playAction(nodes[current].action);
+                break;
+            }
+
+            // Every child was tried, descend into the one with the best upper confidence bound
+            double logVisits = std::log(static_cast<double>(node.visits));
+            int best = node.firstChild;
+            double bestValue = -1.0;
+            for (int i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+                const Node& child = nodes[i];
+                double value = child.reward / child.visits + EXPLORATION * std::sqrt(logVisits / child.visits);
+                if (value > bestValue) {
+                    bestValue = value;
+                    best = i;
+                }
+            }
+            current = best;
+            game->playAction(nodes[current].action);
+        }
+
+        // Rollout: finish the game quickly with a cheap policy, up to the depth limit
+        for (int depth = 0; depth < rolloutDepth && !isFinished(game.get(), aiSlot); ++depth) {
+            MoveList moves = game->generateMoves();
+            if (moves.isEmpty()) break;
+            game->playAction(pickRolloutAction(moves, rng));
+        }
+        double reward = evaluate(game.get(), aiSlot);
+
+        // Backpropagation, each node keeps the reward of the robot that chose it
+        for (int n = current; n != -1; n = nodes[n].parent) {
+            nodes[n].visits++;
+            nodes[n].reward += (nodes[n].mover == aiSlot) ? reward : 1.0 - reward;
+        }
+        iterations++;
+    }
+
+    int getIterations() const { return iterations; }
+
+    /// Appends the visits and rewards of the first actions, in the order of Game::generateMoves()
+    void collectRoot(std::vector<int>& visits, std::vector<double>& rewards) const {
+        const Node& rootNode = nodes[0];
+        for (int i = 0; i < std::max(0, rootNode.childCount); ++i) {
+            visits.push_back(nodes[rootNode.firstChild + i].visits);
+            rewards.push_back(nodes[rootNode.firstChild + i].reward);
+        }
+    }
+
+private:
+    const Game& root;
+    std::unique_ptr<Game> game;
+    QRandomGenerator rng;
+    std::vector<Node> nodes;
+    int aiSlot;
+    int rolloutDepth;
+    int iterations = 0;
+};
+
+// The most visited first action, ties going to the one with the higher reward
+int bestRootAction(const std::vector<int>& visits, const std::vector<double>& rewards) {
+    int best = 0;
+    for (int i = 1; i < static_cast<int>(visits.size()); ++i) {
+        if (visits[i] > visits[best] ||
+            (visits[i] == visits[best] && rewards[i] > rewards[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+}
+
+/// The state of a decision made a slice at a time, alive from begin() to result()
+struct MctsAI::SteppedSearch {
+    MoveList rootMoves;
+    /// Copy of the game the tree grows from, only made when there is a choice to search
+    std::unique_ptr<Game> root;
+    std::unique_ptr<SearchTree> tree;
+    /// The own time budget, counted from begin() and not only while stepping
+    QDeadlineTimer deadline;
+    qint64 usedNs = 0;
+};
+
+MctsAI::MctsAI(QObject* parent)
+    : QObject(parent),
+      iterationBudget(DEFAULT_ITERATIONS),
+      timeBudgetMs(DEFAULT_TIME_BUDGET_MS),
+      threadCount(0),
+      rolloutDepth(DEFAULT_ROLLOUT_DEPTH),
+      seed(QRandomGenerator::global()->generate()),
+      lastIterations(0)
+{
+}
+
+MctsAI::~MctsAI() = default;
+
+int MctsAI::getThreadCount() const
+{
+    if (threadCount > 0) {
+        return threadCount;
+    }
+    // Only the idle threads of the pool: when every match of a batch already runs on a pool
+    // thread, each search keeps to its own thread instead of competing for the same cores
+    QThreadPool* pool = QThreadPool::globalInstance();
+    return std::max(1, pool->maxThreadCount() - pool->activeThreadCount() + 1);
+}
+
+Command MctsAI::calculateMove(Game* game, Robot* ai, Robot* player)
+{
+    return decide(game, ai, player, DecisionBudget()).command;
+}
+
+Decision MctsAI::decide(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget)
+{
+    Q_UNUSED(player);
+    QElapsedTimer timer;
+    timer.start();
+    Decision decision;
+    decision.budgetNs = budget.remainingNs();
+    lastIterations = 0;
+
+    MoveList rootMoves = game->generateMoves();
+    if (rootMoves.isEmpty()) {
+        AI_LOG("MctsAI: No meaningful action. Command: Attack.");
+        decision.command = Command::Attack;
+        decision.usedNs = timer.nsecsElapsed();
+        return decision;
+    }
+    if (rootMoves.size() == 1) {
+        decision.command = rootMoves[0].first();
+        decision.usedNs = timer.nsecsElapsed();
+        return decision;
+    }
+
+    // Every thread searches from the same frozen copy, so the real game is never touched
+    std::unique_ptr<Game> root = game->clone();
+    int aiSlot = game->slotOf(ai);
+    int threads = getThreadCount();
+    int perThread = iterationBudget > 0 ? std::max(1, (iterationBudget + threads - 1) / threads) : 0;
+    QDeadlineTimer deadline = timeBudgetMs > 0 ? QDeadlineTimer(timeBudgetMs)
+                                               : QDeadlineTimer(QDeadlineTimer::Forever);
+
+    std::vector<RootStats> results(threads);
+    std::vector<QFuture<void>> workers;
+    for (int t = 1; t < threads; ++t) {
+        workers.push_back(QtConcurrent::run([&, t]() {
+            results[t] = search(*root, aiSlot, perThread, deadline, budget, seed + t);
+        }));
+    }
+    results[0] = search(*root, aiSlot, perThread, deadline, budget, seed);
+    for (QFuture<void>& worker : workers) {
+        worker.waitForFinished();
+    }
+    seed += threads;
+
+    // Add up the statistics of the first actions over all trees
+    std::vector<int> visits(rootMoves.size(), 0);
+    std::vector<double> rewards(rootMoves.size(), 0.0);
+    for (const RootStats& stats : results) {
+        lastIterations += stats.iterations;
+        decision.complete = decision.complete && !stats.cutShort;
+        for (int i = 0; i < static_cast<int>(stats.visits.size()) && i < rootMoves.size(); ++i) {
+            visits[i] += stats.visits[i];
+            rewards[i] += stats.rewards[i];
+        }
+    }
+
+    int best = bestRootAction(visits, rewards);
+
+    AI_LOG(QString("MctsAI: %1 iterations on %2 threads, best action visited %3 times, score %4")
+                .arg(lastIterations).arg(threads).arg(visits[best])
+                .arg(visits[best] > 0 ? rewards[best] / visits[best] : 0.0, 0, 'f', 2));
+    decision.command = rootMoves[best].first();
+    decision.usedNs = timer.nsecsElapsed();
+    return decision;
+}
+
+MctsAI::RootStats MctsAI::search(const Game& root, int aiSlot, int iterations,
+                                 const QDeadlineTimer& deadline, const DecisionBudget& budget,
+                                 quint32 threadSeed) const
+{
+    SearchTree tree(root, aiSlot, iterations, rolloutDepth, threadSeed);
+    RootStats stats;
+    while ((iterations == 0 || tree.getIterations() < iterations) && !deadline.hasExpired()) {
+        // Whatever has been searched so far is the answer once the caller runs out of time
+        if (budget.isExhausted()) {
+            stats.cutShort = true;
+            break;
+        }
+        tree.iterate();
+    }
+    stats.iterations = tree.getIterations();
+    tree.collectRoot(stats.visits, stats.rewards);
+    return stats;
+}
+
+void MctsAI::begin(Game* game, Robot* ai, Robot* player)
+{
+    Q_UNUSED(player);
+    stepped = std::make_unique<SteppedSearch>();
+    stepped->rootMoves = game->generateMoves();
+    stepped->deadline = timeBudgetMs > 0 ? QDeadlineTimer(timeBudgetMs)
+                                         : QDeadlineTimer(QDeadlineTimer::Forever);
+    lastIterations = 0;
+    if (stepped->rootMoves.size() > 1) {
+        stepped->root = game->clone();
+        stepped->tree = std::make_unique<SearchTree>(*stepped->root, game->slotOf(ai), iterationBudget,
+                                                     rolloutDepth, seed++);
+    }
+}
+
+bool MctsAI::step(const DecisionBudget& slice)
+{
+    if (!stepped || !stepped->tree) {
+        return true;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    SearchTree& tree = *stepped->tree;
+    bool done = false;
+    while (!slice.isExhausted()) {
+        if ((iterationBudget > 0 && tree.getIterations() >= iterationBudget) || stepped->deadline.hasExpired()) {
+            done = true;
+            break;
+        }
+        tree.iterate();
+    }
+    stepped->usedNs += timer.nsecsElapsed();
+    return done;
+}
+
+Decision MctsAI::result()
+{
+    Decision decision;
+    if (!stepped || stepped->rootMoves.isEmpty()) {
+        AI_LOG("MctsAI: No meaningful action. Command: Attack.");
+        decision.command = Command::Attack;
+        stepped.reset();
+        return decision;
+    }
+    decision.usedNs = stepped->usedNs;
+    if (!stepped->tree) {
+        decision.command = stepped->rootMoves[0].first();
+        stepped.reset();
+        return decision;
+    }
+
+    std::vector<int> visits;
+    std::vector<double> rewards;
+    stepped->tree->collectRoot(visits, rewards);
+    // A tree that was never stepped has not expanded its root yet
+    visits.resize(stepped->rootMoves.size(), 0);
+    rewards.resize(stepped->rootMoves.size(), 0.0);
+    lastIterations = stepped->tree->getIterations();
+    int best = bestRootAction(visits, rewards);
+    AI_LOG(QString("MctsAI: %1 iterations in slices, best action visited %2 times, score %3")
+                .arg(lastIterations).arg(visits[best])
+                .arg(visits[best] > 0 ? rewards[best] / visits[best] : 0.0, 0, 'f', 2));
+    decision.command = stepped->rootMoves[best].first();
+    stepped.reset();
+    return decision;
+}
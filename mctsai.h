@@ -0,0 +1,124 @@
+#ifndef MCTSAI_H
+#define MCTSAI_H
+
+#include <QDeadlineTimer>
+#include <QObject>
+#include <QtGlobal>
+#include <memory>
+#include <vector>
+#include "aiinterface.h"
+
+class Game;
+class Robot;
+enum class Command;
+
+/**
+ * @brief AI that picks its move with Monte Carlo Tree Search instead of scripted rules.
+ *
+ * From a snapshot of the game it grows a search tree over the actions of Game::generateMoves(),
+ * scoring each new position by playing a short random game (a rollout) on a headless copy. The
+ * action visited most often is played.
+ *
+ * The search runs on several threads of the global QThreadPool at once (root parallelism): every
+ * thread grows its own tree from the same snapshot and the visit counts of the first actions are
+ * added up at the end. It
+ * stops at whichever comes first of the iteration budget and the time budget, so the strength of
+ * the AI grows with the CPU time it is given.
+ *
+ * It can also search a slice at a time on the calling thread with begin(), step() and result(),
+ * growing a single tree that is kept between the slices.
+ *
+ * Can be used for any robot type through RobotAI::setStrategy(), under the name "mcts".
+ *
+ * @author Group 17
+ */
+class MctsAI final : public QObject, public AIInterface
+{
+    Q_OBJECT
+public:
+    /// Default number of iterations, summed over all threads
+    static const int DEFAULT_ITERATIONS = 4000;
+    /// Default time budget in milliseconds
+    static const int DEFAULT_TIME_BUDGET_MS = 500;
+    /// Default number of actions played in a rollout before the position is scored
+    static const int DEFAULT_ROLLOUT_DEPTH = 24;
+
+    /// @brief Creates the AI with the default budgets, using the idle threads of the pool
+    /// @param parent - QObject parent of the AI
+    explicit MctsAI(QObject* parent = nullptr);
+    /// @brief Deletes the AI together with a search left unfinished
+    ~MctsAI();
+
+    /// @brief Searches for the best command of the robot whose turn it is
+    /// @param game Pointer to the current game state, not modified
+    /// @param ai Pointer to the robot to move
+    /// @param player Pointer to the opponent robot
+    /// @return Command to execute
+    Command calculateMove(Game* game, Robot* ai, Robot* player) override;
+    /// @brief Searches within the own budgets and the given one, whichever ends first
+    /// @param game Pointer to the current game state, not modified
+    /// @param ai Pointer to the robot to move
+    /// @param player Pointer to the opponent robot
+    /// @param budget The deadline and interrupt flag of this decision
+    /// @return The most visited command so far, together with the time the search took
+    Decision decide(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget) override;
+    /// @brief Starts a single-threaded search from a copy of the game
+    /// @param game Pointer to the current game state, not modified
+    /// @param ai Pointer to the robot to move
+    /// @param player Pointer to the opponent robot
+    void begin(Game* game, Robot* ai, Robot* player) override;
+    /// @brief Grows the tree until the slice ends
+    /// @param slice The deadline and interrupt flag of this slice
+    /// @return TRUE once the iteration or time budget, counted from begin(), is used up
+    bool step(const DecisionBudget& slice) override;
+    /// @return The most visited command so far, with the time spent in step()
+    Decision result() override;
+
+    /// @brief Sets the number of iterations per move, summed over all threads
+    /// @param iterations - the budget, 0 for no limit (the time budget must then be set)
+    void setIterationBudget(int iterations) { iterationBudget = iterations; }
+    /// @brief Sets the time the search may take per move
+    /// @param milliseconds - the budget, 0 for no limit (the iteration budget must then be set)
+    void setTimeBudget(int milliseconds) { timeBudgetMs = milliseconds; }
+    /// @brief Sets the number of threads searching at once
+    /// @param threads - the thread count, 0 for the calling thread and the pool's idle threads
+    void setThreadCount(int threads) { threadCount = threads; }
+    /// @brief Sets how many actions a rollout plays before the position is scored
+    /// @param actions - the rollout depth
+    void setRolloutDepth(int actions) { rolloutDepth = actions; }
+    /// @brief Makes the search repeatable, for tests and benchmarks
+    /// @param newSeed - the seed of the random rollouts
+    void setSeed(quint32 newSeed) { seed = newSeed; }
+
+    int getIterationBudget() const { return iterationBudget; }
+    int getTimeBudget() const { return timeBudgetMs; }
+    int getThreadCount() const;
+    int getRolloutDepth() const { return rolloutDepth; }
+    /// @return the number of iterations done by the last search, summed over all threads
+    int getLastIterations() const { return lastIterations; }
+
+private:
+    /// Visit statistics of the first actions, as found by one thread
+    struct RootStats {
+        std::vector<int> visits;
+        std::vector<double> rewards;
+        int iterations = 0;
+        /// Set when the caller's deadline or interrupt stopped the search before its own budgets
+        bool cutShort = false;
+    };
+
+    RootStats search(const Game& root, int aiSlot, int iterations, const QDeadlineTimer& deadline,
+                     const DecisionBudget& budget, quint32 threadSeed) const;
+
+    struct SteppedSearch;
+
+    int iterationBudget;
+    int timeBudgetMs;
+    int threadCount;
+    int rolloutDepth;
+    quint32 seed;
+    int lastIterations;
+    std::unique_ptr<SteppedSearch> stepped;
+};
+
+#endif // MCTSAI_H
@@ -0,0 +1,329 @@
+#include "pathfinding.h"
+#include "terrain.h"
+#include "arenaallocator.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+const int DX[4] = { 0, 1, 0, -1 };  // North, East, South, West
+const int DY[4] = { -1, 0, 1, 0 };
+}
+
+PathfindingService::PathfindingService(const Terrain& terrain, ArenaAllocator& arena)
+    : terrain(terrain), arena(arena), hierarchy(terrain), matrix(terrain), useCounter(0) {
+}
+
+void PathfindingService::invalidate() {
+    for (DistanceField& field : fields) {
+        field.valid = false;
+    }
+    for (CostMap& map : costMaps) {
+        map.valid = false;
+    }
+    hierarchy.invalidate();
+    matrix.invalidate();
+}
+
+void PathfindingService::reserve() {
+    int size = terrain.getGridSize();
+    int cellCount = size * size;
+    for (DistanceField& field : fields) {
+        field.distances.reserve(cellCount);
+    }
+    for (CostMap& map : costMaps) {
+        map.costs.reserve(cellCount * 4);
+    }
+    // Every (cell, facing) state is pushed at most once from each of its three neighbours
+    openStates.reserve(cellCount * 4 * 3 + 4);
+    matrix.reserve();
+}
+
+const PathfindingService::DistanceField& PathfindingService::fieldFor(const QPoint& target) {
+    quint32 version = terrain.getWallVersion();
+    DistanceField* slot = &fields[0];
+
+    for (DistanceField& field : fields) {
+        if (field.valid && field.target == target && field.wallVersion == version) {
+            field.lastUsed = ++useCounter;
+            return field;
+        }
+        // Otherwise remember the least recently used slot to replace
+        if (!field.valid || (slot->valid && field.lastUsed < slot->lastUsed)) {
+            slot = &field;
+        }
+    }
+
+    computeField(*slot, target);
+    slot->target = target;
+    slot->wallVersion = version;
+    slot->lastUsed = ++useCounter;
+    slot->valid = true;
+    return *slot;
+}
+
+void PathfindingService::computeField(DistanceField& field, const QPoint& target) {
+    int size = terrain.getGridSize();
+    int cellCount = size * size;
+    field.distances.assign(cellCount, UNREACHABLE);
+    if (target.x() < 0 || target.y() < 0 || target.x() >= size || target.y() >= size) {
+        return;
+    }
+
+    // Every cell enters the queue at most once
+    int* queue = arena.allocateArray<int>(cellCount);
+    int head = 0;
+    int tail = 0;
+
+    int start = target.y() * size + target.x();
+    field.distances[start] = 0;
+    queue[tail++] = start;
+
+    while (head < tail) {
+        int index = queue[head++];
+        int x = index % size;
+        int y = index / size;
+        quint16 next = field.distances[index] + 1;
+
+        for (int d = 0; d < 4; ++d) {
+            int nx = x + DX[d];
+            int ny = y + DY[d];
+            if (nx < 0 || ny < 0 || nx >= size || ny >= size) continue;
+            int neighbour = ny * size + nx;
+            if (field.distances[neighbour] != UNREACHABLE) continue;
+            if (terrain.cellAt(nx, ny) == CellType::Wall) continue;
+            field.distances[neighbour] = next;
+            queue[tail++] = neighbour;
+        }
+    }
+}
+
+int PathfindingService::distance(const QPoint& from, const QPoint& to) {
+    int size = terrain.getGridSize();
+    if (from.x() < 0 || from.y() < 0 || from.x() >= size || from.y() >= size) {
+        return UNREACHABLE;
+    }
+    if (matrix.isSupported()) {
+        if (to.x() < 0 || to.y() < 0 || to.x() >= size || to.y() >= size) {
+            return UNREACHABLE;
+        }
+        quint8 dist = matrix.distance(from, to);
+        return dist == DistanceMatrix::UNREACHABLE ? UNREACHABLE : dist;
+    }
+    return fieldFor(to).distances[from.y() * size + from.x()];
+}
+
+bool PathfindingService::nextStepTowards(const QPoint& from, const QPoint& to, Direction preferred, Direction* result) {
+    int size = terrain.getGridSize();
+    if (from == to || from.x() < 0 || from.y() < 0 || from.x() >= size || from.y() >= size) {
+        return false;
+    }
+    if (size >= HIERARCHICAL_GRID_SIZE) {
+        return hierarchy.nextStepTowards(from, to, result);
+    }
+
+    const DistanceField& field = fieldFor(to);
+    quint16 best = field.distances[from.y() * size + from.x()];
+    if (best == UNREACHABLE) {
+        return false;
+    }
+
+    int bestDir = -1;
+    for (int d = 0; d < 4; ++d) {
+        int nx = from.x() + DX[d];
+        int ny = from.y() + DY[d];
+        if (nx < 0 || ny < 0 || nx >= size || ny >= size) continue;
+        quint16 dist = field.distances[ny * size + nx];
+        if (dist < best || (dist == best && bestDir != -1 && d == static_cast<int>(preferred))) {
+            best = dist;
+            bestDir = d;
+        }
+    }
+
+    if (bestDir == -1) {
+        return false;
+    }
+    *result = static_cast<Direction>(bestDir);
+    return true;
+}
+
+int PathfindingService::enterCost(int x, int y, int wallDamage) const {
+    if (terrain.cellAt(x, y) != CellType::Wall) {
+        return MOVE_COST;
+    }
+    // Break the wall, then step into the cell
+    int attacks = (terrain.wallHealthAt(x, y) + wallDamage - 1) / wallDamage;
+    return attacks * MOVE_COST + MOVE_COST;
+}
+
+PathfindingService::CostMap& PathfindingService::costMapFor(const QPoint& target, int wallDamage) {
+    wallDamage = std::max(1, wallDamage);
+    quint32 version = terrain.getWallHealthVersion();
+    CostMap* slot = &costMaps[0];
+
+    for (CostMap& map : costMaps) {
+        if (map.valid && map.target == target && map.wallDamage == wallDamage) {
+            if (map.wallHealthVersion != version) {
+                // Changed without a wallDamaged() call, rebuild it in place
+                computeCostMap(map);
+                map.wallHealthVersion = version;
+            }
+            map.lastUsed = ++useCounter;
+            return map;
+        }
+        if (!map.valid || (slot->valid && map.lastUsed < slot->lastUsed)) {
+            slot = &map;
+        }
+    }
+
+    slot->target = target;
+    slot->wallDamage = wallDamage;
+    computeCostMap(*slot);
+    slot->wallHealthVersion = version;
+    slot->lastUsed = ++useCounter;
+    slot->valid = true;
+    return *slot;
+}
+
+void PathfindingService::computeCostMap(CostMap& map) {
+    int size = terrain.getGridSize();
+    map.costs.assign(size * size * 4, NO_ROUTE);
+    if (map.target.x() < 0 || map.target.y() < 0 || map.target.x() >= size || map.target.y() >= size) {
+        return;
+    }
+
+    // The target counts as reached whatever the robot faces
+    openStates.clear();
+    int targetCell = map.target.y() * size + map.target.x();
+    for (int d = 0; d < 4; ++d) {
+        map.costs[targetCell * 4 + d] = 0;
+        openStates.emplace_back(0, targetCell * 4 + d);
+    }
+    propagateCosts(map);
+}
+
+void PathfindingService::propagateCosts(CostMap& map) {
+    // Dijkstra over reversed edges, starting from whatever is in openStates
+    int size = terrain.getGridSize();
+    auto later = std::greater<std::pair<int, int>>();
+    std::make_heap(openStates.begin(), openStates.end(), later);
+
+    while (!openStates.empty()) {
+        std::pop_heap(openStates.begin(), openStates.end(), later);
+        std::pair<int, int> top = openStates.back();
+        openStates.pop_back();
+
+        int cost = top.first;
+        int state = top.second;
+        if (cost > map.costs[state]) continue;
+
+        int cell = state / 4;
+        int facing = state % 4;
+        int x = cell % size;
+        int y = cell / size;
+
+        // A turn onto this facing, from either neighbouring facing
+        int turnedFrom[2] = { (facing + 1) % 4, (facing + 3) % 4 };
+        for (int from : turnedFrom) {
+            int prev = cell * 4 + from;
+            if (cost + TURN_COST < map.costs[prev]) {
+                map.costs[prev] = cost + TURN_COST;
+                openStates.emplace_back(cost + TURN_COST, prev);
+                std::push_heap(openStates.begin(), openStates.end(), later);
+            }
+        }
+
+        // A step into this cell, from the cell behind it
+        int px = x - DX[facing];
+        int py = y - DY[facing];
+        if (px < 0 || py < 0 || px >= size || py >= size) continue;
+        int prev = (py * size + px) * 4 + facing;
+        int stepCost = cost + enterCost(x, y, map.wallDamage);
+        if (stepCost < map.costs[prev]) {
+            map.costs[prev] = stepCost;
+            openStates.emplace_back(stepCost, prev);
+            std::push_heap(openStates.begin(), openStates.end(), later);
+        }
+    }
+}
+
+void PathfindingService::wallDamaged(const QPoint& pos) {
+    int size = terrain.getGridSize();
+    quint32 version = terrain.getWallHealthVersion();
+
+    if (terrain.cellAt(pos) != CellType::Wall) {
+        hierarchy.wallDestroyed(pos);
+        matrix.wallDestroyed(pos);
+    }
+
+    for (CostMap& map : costMaps) {
+        // Only maps that were current right before this change can be patched
+        if (!map.valid || map.wallHealthVersion + 1 != version) continue;
+        map.wallHealthVersion = version;
+
+        // Entering pos got cheaper, which can only lower the cost of the states stepping into it
+        openStates.clear();
+        int cell = pos.y() * size + pos.x();
+        int entry = enterCost(pos.x(), pos.y(), map.wallDamage);
+        for (int d = 0; d < 4; ++d) {
+            int px = pos.x() - DX[d];
+            int py = pos.y() - DY[d];
+            if (px < 0 || py < 0 || px >= size || py >= size) continue;
+            int beyond = map.costs[cell * 4 + d];
+            if (beyond == NO_ROUTE) continue;
+            int prev = (py * size + px) * 4 + d;
+            if (beyond + entry < map.costs[prev]) {
+                map.costs[prev] = beyond + entry;
+                openStates.emplace_back(beyond + entry, prev);
+            }
+        }
+        propagateCosts(map);
+    }
+}
+
+int PathfindingService::travelCost(const QPoint& from, Direction facing, const QPoint& to, int wallDamage) {
+    int size = terrain.getGridSize();
+    if (from.x() < 0 || from.y() < 0 || from.x() >= size || from.y() >= size) {
+        return NO_ROUTE;
+    }
+    const CostMap& map = costMapFor(to, wallDamage);
+    return map.costs[(from.y() * size + from.x()) * 4 + static_cast<int>(facing)];
+}
+
+bool PathfindingService::bestDirectionTowards(const QPoint& from, Direction facing, const QPoint& to,
+                                              int wallDamage, Direction* result) {
+    int size = terrain.getGridSize();
+    if (from == to || from.x() < 0 || from.y() < 0 || from.x() >= size || from.y() >= size) {
+        return false;
+    }
+    if (size >= HIERARCHICAL_GRID_SIZE) {
+        return hierarchy.nextStepTowards(from, to, result);
+    }
+
+    const CostMap& map = costMapFor(to, wallDamage);
+    int current = static_cast<int>(facing);
+    int bestCost = NO_ROUTE;
+    int bestDir = -1;
+
+    // Try the current facing first so it wins ties
+    for (int i = 0; i < 4; ++i) {
+        int d = (current + i) % 4;
+        int nx = from.x() + DX[d];
+        int ny = from.y() + DY[d];
+        if (nx < 0 || ny < 0 || nx >= size || ny >= size) continue;
+        int beyond = map.costs[(ny * size + nx) * 4 + d];
+        if (beyond == NO_ROUTE) continue;
+
+        int turns = (i == 2) ? 2 : (i == 0 ? 0 : 1);
+        int cost = turns * TURN_COST + enterCost(nx, ny, map.wallDamage) + beyond;
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestDir = d;
+        }
+    }
+
+    if (bestDir == -1) {
+        return false;
+    }
+    *result = static_cast<Direction>(bestDir);
+    return true;
+}
@@ -0,0 +1,137 @@
+#ifndef PATHFINDING_H
+#define PATHFINDING_H
+
+#include <QPoint>
+#include <QtGlobal>
+#include <vector>
+#include "robot.h"
+#include "hierarchicalpathfinder.h"
+#include "distancematrix.h"
+
+class Terrain;
+class ArenaAllocator;
+
+/**
+ * @brief Shared pathfinding for the AIs, based on breadth-first distance fields.
+ *
+ * A distance field holds, for every cell, the number of moves needed to reach one target cell
+ * when walking around walls. Fields are computed on first use and kept until the wall layout
+ * changes, so the AIs of a match share them and each query after that is a few array lookups.
+ * Robots are not treated as obstacles since they move every turn.
+ *
+ * Since walls can be destroyed, there is also a weighted cost map over (cell, facing) pairs in
+ * which a wall costs the attacks needed to break it and every turn has a small cost. It is kept
+ * up to date incrementally as walls take damage (see wallDamaged()).
+ *
+ * On arenas of up to DistanceMatrix::MAX_GRID_SIZE cells across, distance() reads from an
+ * all-pairs matrix instead.
+ *
+ * On arenas of HIERARCHICAL_GRID_SIZE and more, full fields per target get too expensive, so
+ * next-step queries are answered by a HierarchicalPathfinder instead and walls are not broken.
+ *
+ * @author Group 17
+ */
+class PathfindingService {
+public:
+    /// Distance of a cell that cannot reach the target
+    static constexpr quint16 UNREACHABLE = 0xFFFF;
+    /// Number of distance fields kept at once, enough for both robots and every pickup
+    static const int MAX_CACHED_FIELDS = 16;
+    /// Number of weighted cost maps kept at once
+    static const int MAX_CACHED_COST_MAPS = 8;
+    /// Cost of one forward move or one attack in a weighted cost map
+    static const int MOVE_COST = 4;
+    /// Cost of one turn in a weighted cost map: turning uses no moves but is still a command
+    static const int TURN_COST = 1;
+    /// Cost of a route that does not exist
+    static constexpr int NO_ROUTE = 0x3FFFFFFF;
+    /// Grid size from which next-step queries use hierarchical pathfinding
+    static const int HIERARCHICAL_GRID_SIZE = 32;
+
+    /// @brief Creates the service
+    /// @param terrain - the terrain of the match, fields follow its wall layout
+    /// @param arena - scratch memory used while a field is computed
+    PathfindingService(const Terrain& terrain, ArenaAllocator& arena);
+
+    /// @brief Number of moves from one cell to another, walking around walls
+    /// @param from - the start cell
+    /// @param to - the target cell
+    /// @return the number of moves, or UNREACHABLE
+    int distance(const QPoint& from, const QPoint& to);
+
+    /// @brief Finds the direction of the first step of a shortest path
+    /// @param from - the current cell
+    /// @param to - the target cell
+    /// @param preferred - direction chosen when several steps are equally good
+    /// @param result - receives the direction of the step
+    /// @return TRUE if the target can be reached and is not the current cell, FALSE otherwise
+    bool nextStepTowards(const QPoint& from, const QPoint& to, Direction preferred, Direction* result);
+
+    /// @brief Cost of the cheapest route to a cell when walls on the way may be broken
+    /// @param from - the start cell
+    /// @param facing - the direction the robot faces at the start
+    /// @param to - the target cell
+    /// @param wallDamage - damage the robot deals to a wall with one attack
+    /// @return the cost in MOVE_COST and TURN_COST units, or NO_ROUTE
+    int travelCost(const QPoint& from, Direction facing, const QPoint& to, int wallDamage);
+
+    /// @brief Finds the direction the cheapest route leaves the current cell in, which may lead
+    /// into a wall when breaking it is cheaper than walking around
+    /// @param from - the current cell
+    /// @param facing - the direction the robot faces
+    /// @param to - the target cell
+    /// @param wallDamage - damage the robot deals to a wall with one attack
+    /// @param result - receives the direction, facing wins ties
+    /// @return TRUE if there is a route and from is not the target, FALSE otherwise
+    bool bestDirectionTowards(const QPoint& from, Direction facing, const QPoint& to, int wallDamage, Direction* result);
+
+    /// @brief Updates the weighted cost maps, and the hierarchical graph if the wall is gone, after
+    /// the health of one wall went down or the wall was destroyed. Must be called right after the
+    /// terrain changed.
+    /// @param pos - the damaged wall
+    void wallDamaged(const QPoint& pos);
+
+    /// @brief Drops every cached field, cost map, distance matrix and abstract graph
+    void invalidate();
+    /// @brief Sets aside the memory of every field and cost map for the current grid size, so
+    /// computing them during play does not allocate. Called when an arena is set up.
+    void reserve();
+
+private:
+    struct DistanceField {
+        QPoint target;
+        quint32 wallVersion = 0;
+        quint64 lastUsed = 0;
+        bool valid = false;
+        std::vector<quint16> distances;
+    };
+
+    /// Cost to go from every (cell, facing) state to one target, indexed by cell * 4 + facing
+    struct CostMap {
+        QPoint target;
+        int wallDamage = 0;
+        quint32 wallHealthVersion = 0;
+        quint64 lastUsed = 0;
+        bool valid = false;
+        std::vector<int> costs;
+    };
+
+    const DistanceField& fieldFor(const QPoint& target);
+    void computeField(DistanceField& field, const QPoint& target);
+    CostMap& costMapFor(const QPoint& target, int wallDamage);
+    void computeCostMap(CostMap& map);
+    void propagateCosts(CostMap& map);
+    int enterCost(int x, int y, int wallDamage) const;
+
+    const Terrain& terrain;
+    ArenaAllocator& arena;
+    DistanceField fields[MAX_CACHED_FIELDS];
+    CostMap costMaps[MAX_CACHED_COST_MAPS];
+    HierarchicalPathfinder hierarchy;
+    DistanceMatrix matrix;
+    /// Min-heap of (cost, state) used by the cost map searches, kept to reuse its storage
+    std::vector<std::pair<int, int>> openStates;
+    quint64 useCounter;
+};
+
+#endif // PATHFINDING_H
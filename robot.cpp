@@ -1,13 +1,18 @@
 #include "robot.h"
 #include <QDebug>
 
-Robot::Robot(RobotType type, QObject *parent) : QObject(parent),
-    position(0, 0),
-    direction(Direction::East),
-    type(type),
-    moving(false),
-    animationFrame(0) {
-    
+Robot::Robot(RobotType type, QObject *parent) : QObject(parent) {
+    reset(type);
+}
+
+void Robot::reset(RobotType newType) {
+    position = QPoint(0, 0);
+    direction = Direction::East;
+    type = newType;
+    moving = false;
+    animationFrame = 0;
+    currentPowerUp = RobotPowerUp::None;
+
     // Set stats based on robot type
     switch (type) {
         case RobotType::Scout:
@@ -44,6 +49,20 @@ Robot::Robot(RobotType type, QObject *parent) : QObject(parent),
     movesLeft = maxMovesPerTurn;
 }
 
+void Robot::copyStateFrom(const Robot& other) {
+    position = other.position;
+    direction = other.direction;
+    type = other.type;
+    health = other.health;
+    maxHealth = other.maxHealth;
+    attackRange = other.attackRange;
+    attackDamage = other.attackDamage;
+    maxMovesPerTurn = other.maxMovesPerTurn;
+    movesLeft = other.movesLeft;
+    moving = other.moving;
+    animationFrame = other.animationFrame;
+    currentPowerUp = other.currentPowerUp;
+}
 
 RobotType Robot::getRobotType() const {
     return type;
@@ -35,6 +35,18 @@ public:
     /// @param parent - The parent QObject of this object
     explicit Robot(RobotType type = RobotType::Scout, QObject *parent = nullptr);
 
+    /// @brief Puts the robot back into the state it had right after construction.
+    ///
+    /// Lets a match reuse its robots instead of allocating new ones. Signal connections are kept
+    /// and no signals are emitted.
+    /// @param type - The type of robot the player uses
+    void reset(RobotType type);
+    /// @brief Copies the whole state of another robot into this one, no signals are emitted.
+    ///
+    /// Used for snapshots of a game that are played on without showing anything.
+    /// @param other - The robot to copy
+    void copyStateFrom(const Robot& other);
+
     /// @brief Simple method for the robot to move forward
     ///@see useMove()
     void moveForward();
@@ -1,30 +1,586 @@
 #include "robotai.h"
 #include "game.h"
-#include "sniperai.h"
-#include "scoutai.h"
-#include "tankai.h"
 #include "robot.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+
+namespace {
+
+using ExternalAI = std::unique_ptr<AIInterface>;
+using DecideFunction = Decision (AIInterface::*)(Game*, Robot*, Robot*, const DecisionBudget&);
+
+/// Whether the strategies that remember something between decisions share them in a cache
+std::atomic<bool> decisionCaching(false);
+
+/// What a strategy remembers between decisions
+template<class S>
+using MemoryOf = std::decay_t<decltype(std::declval<const S&>().getMemory())>;
+
+/// TRUE for strategies that can hand out and restore what they remember, so their decisions can
+/// be cached
+template<class S, class = void>
+struct IsCacheable : std::false_type {};
+template<class S>
+struct IsCacheable<S, std::void_t<decltype(std::declval<const S&>().hashMemory())>> : std::true_type {};
+
+/// A decision of a strategy and what the strategy remembered after it
+template<class Memory>
+struct CachedDecision {
+    Command command = Command::None;
+    Memory memory = Memory();
+};
+
+/// The cache shared by every instance of a strategy
+template<class S>
+DecisionCache<CachedDecision<MemoryOf<S>>>& sharedCache() {
+    static DecisionCache<CachedDecision<MemoryOf<S>>> cache;
+    return cache;
+}
+
+quint64 mixKey(quint64 hash, quint64 value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        hash ^= static_cast<quint8>(value >> shift);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/// Decides with the shared cache: the same position, memory and parameters always lead to the same
+/// command and the same memory after it
+template<class S>
+Decision cachedDecision(S& strategy, Game* game, Robot* ai, Robot* player, const DecisionBudget& budget) {
+    QElapsedTimer timer;
+    timer.start();
+    int side = ai == game->getPlayerRobot() ? 0 : (ai == game->getPlayer2Robot() ? 1 : 2);
+    quint64 key = mixKey(mixKey(game->positionHash(), strategy.hashMemory()), side);
+    key = mixKey(key, strategy.hashParameters());
+
+    auto& cache = sharedCache<S>();
+    CachedDecision<MemoryOf<S>> cached;
+    if (cache.find(key, cached)) {
+        strategy.setMemory(cached.memory);
+        Decision decision;
+        decision.budgetNs = budget.remainingNs();
+        decision.command = cached.command;
+        decision.cached = true;
+        decision.usedNs = timer.nsecsElapsed();
+        return decision;
+    }
+
+    Decision decision = timedDecision(strategy, game, ai, player, budget);
+    cached.command = decision.command;
+    cached.memory = strategy.getMemory();
+    cache.insert(key, cached);
+    return decision;
+}
+
+/// Decides with a strategy, resolved at compile time for the built-in ones
+template<class S>
+Decision decideWith(S& strategy, Game* game, Robot* ai, Robot* player, const DecisionBudget& budget) {
+    if constexpr (std::is_same<S, ExternalAI>::value) {
+        return strategy->decide(game, ai, player, budget);
+    } else if constexpr (std::is_same<decltype(&S::decide), DecideFunction>::value) {
+        if constexpr (IsCacheable<S>::value) {
+            if (decisionCaching.load(std::memory_order_relaxed)) {
+                return cachedDecision(strategy, game, ai, player, budget);
+            }
+        }
+        // Does not search, time calculateMove() on the final class so the call is direct
+        return timedDecision(strategy, game, ai, player, budget);
+    } else {
+        return strategy.decide(game, ai, player, budget);
+    }
+}
+
+using PlanFunction = bool (AIInterface::*)(Game*, Robot*, Robot*, const DecisionBudget&, TurnPlan&, Decision&);
+
+/// Longest plan made by asking for one command after another, in case an AI never ends its turn
+const int MAX_PLANNED_COMMANDS = 32;
+
+/// The part of a budget one command gets when the rest of the turn is planned in one go
+DecisionBudget shareOf(const DecisionBudget& budget, int movesLeft) {
+    if (budget.deadline.isForever()) {
+        return budget;
+    }
+    qint64 milliseconds = budget.deadline.remainingTime() / std::max(1, movesLeft);
+    return DecisionBudget::fromNow(std::max<qint64>(1, milliseconds), budget.interrupt);
+}
+
+/// Plans the turn by asking for one command after another on a copy of the game. A strategy that
+/// remembers something has its memory before each command put in memories, it is left as it is
+/// after the last planned command.
+template<class S, class Memories>
+Decision simulateTurn(S& strategy, Game* game, Robot* ai, Robot* player, const DecisionBudget& budget,
+                      TurnPlan& plan, Memories& memories, std::unique_ptr<Game>& line) {
+    QElapsedTimer timer;
+    timer.start();
+    Decision decision;
+    decision.budgetNs = budget.remainingNs();
+    plan.clear();
+    memories.clear();
+
+    if (line) {
+        line->copyStateFrom(*game);
+    } else {
+        line = game->clone();
+    }
+    Robot* self = line->robotInSlot(game->slotOf(ai));
+    Robot* opponent = line->robotInSlot(game->slotOf(player));
+    GameState turn = line->getState();
+    while (static_cast<int>(plan.steps.size()) < MAX_PLANNED_COMMANDS) {
+        if constexpr (IsCacheable<S>::value) {
+            memories.emplace_back(strategy.getMemory());
+        }
+        Decision step = decideWith(strategy, line.get(), self, opponent,
+                                   shareOf(budget, self->getMovesLeft()));
+        decision.complete = decision.complete && step.complete;
+        if (plan.steps.empty()) {
+            decision.cached = step.cached;
+        }
+
+        quint64 hash = line->stateHash();
+        plan.add(hash, step.command);
+        line->playCommand(step.command);
+        // The rest is planned later if the command changed nothing or the time is up
+        if (line->getState() != turn || line->stateHash() == hash || budget.isExhausted()) {
+            break;
+        }
+    }
+
+    decision.command = plan.steps.front().command;
+    decision.usedNs = timer.nsecsElapsed();
+    return decision;
+}
+
+/// Plans the turn with a strategy, from its own search if it can
+template<class S, class Memories>
+Decision planWith(S& strategy, Game* game, Robot* ai, Robot* player, const DecisionBudget& budget,
+                  TurnPlan& plan, Memories& memories, std::unique_ptr<Game>& line) {
+    Decision decision;
+    memories.clear();
+    if constexpr (std::is_same<S, ExternalAI>::value) {
+        if (strategy->planTurn(game, ai, player, budget, plan, decision)) {
+            return decision;
+        }
+    } else if constexpr (!std::is_same<decltype(&S::planTurn), PlanFunction>::value) {
+        if (strategy.planTurn(game, ai, player, budget, plan, decision)) {
+            return decision;
+        }
+    }
+    return simulateTurn(strategy, game, ai, player, budget, plan, memories, line);
+}
+
+/// Asks a strategy for a single command, without timing or planning
+Command commandWith(AIStrategy& strategy, Game* game, Robot* ai, Robot* player) {
+    return std::visit([&](auto& chosen) -> Command {
+        using S = std::decay_t<decltype(chosen)>;
+        if constexpr (std::is_same<S, ExternalAI>::value) {
+            return chosen->calculateMove(game, ai, player);
+        } else {
+            if constexpr (IsCacheable<S>::value) {
+                if (decisionCaching.load(std::memory_order_relaxed)) {
+                    return cachedDecision(chosen, game, ai, player, DecisionBudget()).command;
+                }
+            }
+            return chosen.calculateMove(game, ai, player);
+        }
+    }, strategy);
+}
+
+/// Makes a strategy remember what it remembered before a planned command
+template<class Memory>
+void restoreMemory(AIStrategy& strategy, const Memory& memory) {
+    std::visit([&memory](auto& chosen) {
+        using S = std::decay_t<decltype(chosen)>;
+        if constexpr (IsCacheable<S>::value) {
+            if (const MemoryOf<S>* remembered = std::get_if<MemoryOf<S>>(&memory)) {
+                chosen.setMemory(*remembered);
+            }
+        }
+    }, strategy);
+}
+
+/// Makes a strategy forget the current match
+void resetStrategy(AIStrategy& strategy) {
+    std::visit([](auto& chosen) {
+        if constexpr (std::is_same<std::decay_t<decltype(chosen)>, ExternalAI>::value) {
+            chosen->reset();
+        } else {
+            chosen.reset();
+        }
+    }, strategy);
+}
+
+/// The AI behind a strategy, as its own final type for the built-in ones so calls are direct
+template<class S>
+auto& aiOf(S& strategy) {
+    if constexpr (std::is_same<S, ExternalAI>::value) {
+        return *strategy;
+    } else {
+        return strategy;
+    }
+}
+
+/// TRUE for the built-in strategies that search, the only ones worth pondering with. The others
+/// decide in no time, and external ones may remember positions that never happen.
+bool searches(const AIStrategy& strategy) {
+    return std::visit([](const auto& chosen) {
+        using S = std::decay_t<decltype(chosen)>;
+        if constexpr (std::is_same<S, ExternalAI>::value) {
+            return false;
+        } else {
+            return !std::is_same<decltype(&S::decide), DecideFunction>::value;
+        }
+    }, strategy);
+}
+
+/// TRUE for the strategies worth deciding a slice at a time: the searching ones, and external
+/// ones as nothing is known about how long they take
+bool stepsThrough(const AIStrategy& strategy) {
+    return searches(strategy) || std::holds_alternative<ExternalAI>(strategy);
+}
+
+} // namespace
 
 RobotAI::RobotAI(QObject *parent) : QObject(parent) {
-    sniperAI = new SniperAI(this);
-    scoutAI = new ScoutAI(this);
-    tankAI = new TankAI(this);
+    for (RobotType type : {RobotType::Scout, RobotType::Tank, RobotType::Sniper}) {
+        setStrategy(type, defaultStrategyName(type));
+    }
+    // Planning a turn then never allocates
+    plan.steps.reserve(MAX_PLANNED_COMMANDS);
+    planMemory.reserve(MAX_PLANNED_COMMANDS);
+}
+
+RobotAI::~RobotAI() {
 }
 
 Command RobotAI::calculateMove(Game* game, Robot* ai, Robot* player) {
-    // Choose strategy based on robot type
-    switch (ai->getType()) {
+    return commandWith(strategies[slotFor(ai->getType())], game, ai, player);
+}
+
+Decision RobotAI::decide(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget) {
+    QElapsedTimer timer;
+    timer.start();
+    Decision decision;
+    quint64 hash = game->stateHash();
+    if (plan.follows(hash)) {
+        // The game went as predicted, play the next planned command
+        decision.budgetNs = budget.remainingNs();
+        decision.command = plan.steps[plan.next++].command;
+        decision.fromPlan = true;
+        decision.usedNs = timer.nsecsElapsed();
+    } else if (const PonderedTurn* answer = ponderedFor(hash)) {
+        // The opponent played one of the turns pondered on, the answer is ready
+        plan = answer->plan;
+        plan.next = 1;
+        planMemory.clear();
+        decision.budgetNs = budget.remainingNs();
+        decision.command = plan.steps.front().command;
+        decision.complete = answer->complete;
+        decision.fromPlan = true;
+        decision.pondered = true;
+        decision.usedNs = timer.nsecsElapsed();
+        pondered.clear();
+    } else {
+        AIStrategy& strategy = strategies[slotFor(ai->getType())];
+        if (plan.next > 0 && plan.next < static_cast<int>(plan.steps.size())) {
+            AI_LOG("RobotAI: The game did not go as planned, planning the turn again.");
+            // Planning went on past the commands actually played, forget what came after them
+            if (planMemory.size() == plan.steps.size()) {
+                restoreMemory(strategy, planMemory[plan.next]);
+            }
+        }
+        pondered.clear();
+        decision = std::visit([&](auto& chosen) {
+            return planWith(chosen, game, ai, player, budget, plan, planMemory, planLine);
+        }, strategy);
+        // The first planned command is the one played now
+        plan.next = 1;
+    }
+    stats.record(decision);
+    if (decision.isOverBudget()) {
+        AI_LOG(QString("RobotAI: Decision took %1 ms, over its budget of %2 ms.")
+                    .arg(decision.usedNs / 1000000).arg(decision.budgetNs / 1000000));
+    }
+    return decision;
+}
+
+void RobotAI::begin(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget) {
+    stepping = SteppedDecision();
+    stepping.slot = slotFor(ai->getType());
+    AIStrategy& strategy = strategies[stepping.slot];
+    quint64 hash = game->stateHash();
+    if (plan.follows(hash) || ponderedFor(hash) || !stepsThrough(strategy)) {
+        // Nothing to search for, decide at once
+        stepping.decision = decide(game, ai, player, budget);
+        return;
+    }
+
+    if (plan.next > 0 && plan.next < static_cast<int>(plan.steps.size())) {
+        AI_LOG("RobotAI: The game did not go as planned, deciding again.");
+    }
+    plan.clear();
+    pondered.clear();
+    stepping.budget = budget;
+    stepping.budgetNs = budget.remainingNs();
+    stepping.searching = true;
+    std::visit([&](auto& chosen) { aiOf(chosen).begin(game, ai, player); }, strategy);
+}
+
+bool RobotAI::step(const DecisionBudget& slice) {
+    if (!stepping.searching) {
+        return true;
+    }
+    DecisionBudget limited = slice;
+    if (stepping.budget.deadline < limited.deadline) {
+        limited.deadline = stepping.budget.deadline;
+    }
+    if (!limited.interrupt) {
+        limited.interrupt = stepping.budget.interrupt;
+    }
+    bool done = std::visit([&](auto& chosen) { return aiOf(chosen).step(limited); },
+                           strategies[stepping.slot]);
+    // The whole decision ran out of time, the best command so far is played
+    if (!done && stepping.budget.isExhausted()) {
+        stepping.cutShort = true;
+        done = true;
+    }
+    return done;
+}
+
+Decision RobotAI::result() {
+    if (!stepping.searching) {
+        return stepping.decision;
+    }
+    stepping.searching = false;
+    Decision decision = std::visit([](auto& chosen) { return aiOf(chosen).result(); },
+                                   strategies[stepping.slot]);
+    decision.budgetNs = stepping.budgetNs;
+    decision.complete = decision.complete && !stepping.cutShort;
+    stepping.decision = decision;
+    stats.record(decision);
+    if (decision.isOverBudget()) {
+        AI_LOG(QString("RobotAI: Decision took %1 ms, over its budget of %2 ms.")
+                    .arg(decision.usedNs / 1000000).arg(decision.budgetNs / 1000000));
+    }
+    return decision;
+}
+
+bool RobotAI::hasPlannedCommand(const Game* game) const {
+    quint64 hash = game->stateHash();
+    return plan.follows(hash) || ponderedFor(hash);
+}
+
+int RobotAI::ponder(Game* game, Robot* ai, Robot* player, qint64 turnMilliseconds,
+                    const std::atomic<bool>* interrupt) {
+    pondered.clear();
+    AIStrategy& strategy = strategies[slotFor(ai->getType())];
+    if (!searches(strategy) || game->getState() != GameState::PlayerTurn) {
+        return 0;
+    }
+
+    // The opponent is expected to play like the built-in AI of its robot type
+    AIStrategy predictor;
+    AIRegistry::create(defaultStrategyName(player->getType()), predictor);
+
+    std::unique_ptr<Game> line = game->clone();
+    std::unique_ptr<Game> scratch;
+    std::vector<PlanMemory> memories;
+    GameState opponentTurn = game->getState();
+    MoveList firstActions = game->generateMoves();
+
+    // The predicted first action is pondered on first, then every other first action followed by
+    // the predicted rest of the turn
+    Command predicted = commandWith(predictor, line.get(), line->robotInSlot(game->slotOf(player)),
+                                    line->robotInSlot(game->slotOf(ai)));
+    int order[MoveList::MAX_ACTIONS];
+    int count = 0;
+    for (int i = 0; i < firstActions.size(); ++i) {
+        if (firstActions[i].first() == predicted) {
+            order[count++] = i;
+        }
+    }
+    for (int i = 0; i < firstActions.size(); ++i) {
+        if (firstActions[i].first() != predicted) {
+            order[count++] = i;
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (interrupt && interrupt->load(std::memory_order_relaxed)) {
+            break;
+        }
+
+        line->copyStateFrom(*game);
+        Robot* lineAi = line->robotInSlot(game->slotOf(ai));
+        Robot* linePlayer = line->robotInSlot(game->slotOf(player));
+        resetStrategy(predictor);
+        const Action& first = firstActions[order[i]];
+        for (int c = 0; c < first.count; ++c) {
+            line->playCommand(first.commands[c]);
+        }
+        for (int steps = 0; line->getState() == opponentTurn && steps < MAX_PLANNED_COMMANDS; ++steps) {
+            quint64 before = line->stateHash();
+            line->playCommand(commandWith(predictor, line.get(), linePlayer, lineAi));
+            if (line->stateHash() == before) {
+                break;
+            }
+        }
+        if (line->getState() == opponentTurn || line->getState() == GameState::GameOver ||
+            ponderedFor(line->stateHash())) {
+            continue;
+        }
+
+        // Answer the turn as if it had been played, within the time a real turn gets
+        PonderedTurn answer;
+        answer.hash = line->stateHash();
+        DecisionBudget budget = DecisionBudget::fromNow(turnMilliseconds, interrupt);
+        Decision decision = std::visit([&](auto& chosen) {
+            return planWith(chosen, line.get(), lineAi, linePlayer, budget, answer.plan, memories, scratch);
+        }, strategy);
+        if (budget.isInterrupted()) {
+            break;  // Cut short, not as good as thinking at the AI's turn
+        }
+        answer.complete = decision.complete;
+        pondered.push_back(std::move(answer));
+    }
+
+    AI_LOG(QString("RobotAI: Pondered on %1 of %2 turns of the opponent.")
+                .arg(static_cast<int>(pondered.size())).arg(count));
+    return static_cast<int>(pondered.size());
+}
+
+const RobotAI::PonderedTurn* RobotAI::ponderedFor(quint64 hash) const {
+    for (const PonderedTurn& turn : pondered) {
+        if (turn.hash == hash) {
+            return &turn;
+        }
+    }
+    return nullptr;
+}
+
+int RobotAI::slotFor(RobotType type) {
+    switch (type) {
         case RobotType::Scout:
-            return scoutAI->calculateMove(game, ai, player);
-            
         case RobotType::Tank:
-            return tankAI->calculateMove(game, ai, player);
-            
         case RobotType::Sniper:
-            return sniperAI->calculateMove(game, ai, player);
-            
+            return static_cast<int>(type);
+
         default:
             // Default to Scout if an invalid type is provided
-            return scoutAI->calculateMove(game, ai, player);
+            return static_cast<int>(RobotType::Scout);
+    }
+}
+
+QString RobotAI::defaultStrategyName(RobotType type) {
+    switch (type) {
+        case RobotType::Tank:
+            return "tank";
+
+        case RobotType::Sniper:
+            return "sniper";
+
+        default:
+            return "scout";
+    }
+}
+
+void RobotAI::setDecisionCaching(bool enabled) {
+    decisionCaching.store(enabled, std::memory_order_relaxed);
+}
+
+bool RobotAI::isDecisionCaching() {
+    return decisionCaching.load(std::memory_order_relaxed);
+}
+
+DecisionCacheStats RobotAI::getDecisionCacheStats() {
+    DecisionCacheStats total;
+    for (const DecisionCacheStats& stats : { sharedCache<ScoutAI>().stats(), sharedCache<TankAI>().stats(),
+                                             sharedCache<SniperAI>().stats() }) {
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.insertions += stats.insertions;
+        total.evictions += stats.evictions;
+    }
+    return total;
+}
+
+void RobotAI::clearDecisionCache() {
+    sharedCache<ScoutAI>().clear();
+    sharedCache<TankAI>().clear();
+    sharedCache<SniperAI>().clear();
+}
+
+void RobotAI::reset() {
+    plan.clear();
+    stepping = SteppedDecision();
+    pondered.clear();
+    for (AIStrategy& strategy : strategies) {
+        resetStrategy(strategy);
+    }
+}
+
+bool RobotAI::setStrategy(RobotType type, const QString& name) {
+    int slot = slotFor(type);
+    if (!AIRegistry::create(name, strategies[slot])) {
+        AI_LOG(QString("RobotAI: Unknown AI strategy %1.").arg(name));
+        return false;
+    }
+    strategyNames[slot] = name;
+    plan.clear();
+    pondered.clear();
+    return true;
+}
+
+QString RobotAI::getStrategyName(RobotType type) const {
+    return strategyNames[slotFor(type)];
+}
+
+void RobotAI::setParameters(GameDifficulty difficulty, const AIParameterSet& parameters) {
+    for (AIStrategy& strategy : strategies) {
+        if (ScoutAI* scout = std::get_if<ScoutAI>(&strategy)) {
+            scout->setParameters(difficulty, parameters.scout);
+        } else if (TankAI* tank = std::get_if<TankAI>(&strategy)) {
+            tank->setParameters(difficulty, parameters.tank);
+        } else if (SniperAI* sniper = std::get_if<SniperAI>(&strategy)) {
+            sniper->setParameters(difficulty, parameters.sniper);
+        }
+    }
+    // Plans were made with the old thresholds
+    plan.clear();
+    pondered.clear();
+}
+
+void RobotAI::setSeed(quint32 seed) {
+    for (int slot = 0; slot < 3; ++slot) {
+        if (ScoutAI* scout = std::get_if<ScoutAI>(&strategies[slot])) {
+            scout->setSeed(seed + slot);
+        } else if (TankAI* tank = std::get_if<TankAI>(&strategies[slot])) {
+            tank->setSeed(seed + slot);
+        } else if (SniperAI* sniper = std::get_if<SniperAI>(&strategies[slot])) {
+            sniper->setSeed(seed + slot);
+        } else if (MctsAI* mcts = std::get_if<MctsAI>(&strategies[slot])) {
+            mcts->setSeed(seed + slot);
+        }
+    }
+}
+
+void RobotAI::setCustomAI(RobotType type, std::unique_ptr<AIInterface> ai) {
+    if (!ai) {
+        setStrategy(type, defaultStrategyName(type));
+        return;
     }
-} 
\ No newline at end of file
+    int slot = slotFor(type);
+    strategies[slot].emplace<ExternalAI>(std::move(ai));
+    strategyNames[slot] = "custom";
+    plan.clear();
+    pondered.clear();
+}
+
+AIInterface* RobotAI::getCustomAI(RobotType type) const {
+    const ExternalAI* custom = std::get_if<ExternalAI>(&strategies[slotFor(type)]);
+    return custom ? custom->get() : nullptr;
+}
@@ -2,23 +2,29 @@
 #define ROBOTAI_H
 
 #include <QObject>
+#include <QString>
+#include <memory>
+#include <variant>
+#include <vector>
+#include "aiinterface.h"
+#include "airegistry.h"
+#include "decisioncache.h"
 
 /// Forward declarations
 class Game;
 /// Forward declarations
 class Robot;
 /// Forward declarations
-class SniperAI;
-/// Forward declarations
-class ScoutAI;
-/// Forward declarations
-class TankAI;
-/// Forward declarations
 enum class Command;
+/// Forward declarations
+enum class RobotType;
 
 
-///@brief RobotAI - Factory/manager class that delegates AI decision making to specialized.
-/// AI classes (ScoutAI, TankAI, SniperAI) based on the robot type.
+///@brief RobotAI - Factory/manager class that delegates AI decision making to the strategy
+/// selected for each robot type, by default ScoutAI, TankAI and SniperAI.
+///
+/// Strategies are picked by name from AIRegistry with setStrategy(). The built-in ones are held
+/// by value and called without a virtual call, externally supplied ones through AIInterface.
 ///@author Group 17
 class RobotAI : public QObject {
     Q_OBJECT
@@ -26,19 +32,163 @@ public:
     /// @brief Creates a new RobotAI object
     /// @param parent - The QObject parent of the initalised object
     explicit RobotAI(QObject *parent = nullptr);
+    /// @brief Deletes the RobotAI object together with its strategies
+    ~RobotAI();
     
-    ///Main method to calculate the next AI move
+    ///Main method to calculate the next AI move, without planning the rest of the turn
     ///@param game Current game state
     ///@param ai The AI robot making the move
     ///@param player The player/opponent robot
     ///@return Command to execute
     Command calculateMove(Game* game, Robot* ai, Robot* player);
+    ///Calculates the next AI move within a time budget.
+    ///
+    /// The first call of a turn plans the whole turn, later calls replay the plan for as long as
+    /// the game is in the state it predicted and plan again once it is not.
+    ///@param game Current game state
+    ///@param ai The AI robot making the move
+    ///@param player The player/opponent robot
+    ///@param budget The deadline and interrupt flag of this decision, for the whole turn when it is planned
+    ///@return The command together with how much of the budget it used
+    Decision decide(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget);
+    ///@brief Starts a decision that is made a slice at a time on the calling thread.
+    ///
+    /// For callers that cannot spare a worker thread, such as the GUI thread between two frames.
+    /// Searching and external strategies search in step(), the others decide at once here, as does
+    /// a planned or pondered command for this state. A decision made in slices plans no further
+    /// than the command it returns.
+    ///@param game Current game state, must stay valid until result()
+    ///@param ai The AI robot making the move
+    ///@param player The player/opponent robot
+    ///@param budget The deadline and interrupt flag of the whole decision
+    void begin(Game* game, Robot* ai, Robot* player, const DecisionBudget& budget);
+    ///@brief Goes on with the decision started by begin()
+    ///@param slice The deadline of this slice, and its interrupt flag or else the one of begin()
+    ///@return TRUE once the decision is made or its whole budget is used up, FALSE if it needs more slices
+    bool step(const DecisionBudget& slice);
+    ///@brief Ends the decision started by begin(), with the best command so far if step() did not return TRUE
+    ///@return The command together with the time spent on it
+    Decision result();
+    ///@param game Current game state
+    ///@return TRUE if decide() would replay a planned command for this state, FALSE if it would think
+    bool hasPlannedCommand(const Game* game) const;
+    ///@brief Plans answers to the most likely turns of the player, while the player is thinking.
+    ///
+    /// The player is expected to play like the built-in AI of its robot type, with every other
+    /// first action tried as well. Each turn is played out on a copy of the game and the AI's turn
+    /// after it is planned. When decide() is later called for one of those states, the planned
+    /// answer is played at once. Only searching strategies ponder, the others return 0 straight away.
+    ///@param game Current game state, the player's turn
+    ///@param ai The AI robot
+    ///@param player The player's robot
+    ///@param turnMilliseconds Time for planning each answer, 0 for no limit
+    ///@param interrupt Set from any thread to stop pondering, may be null
+    ///@return The number of answers planned
+    int ponder(Game* game, Robot* ai, Robot* player, qint64 turnMilliseconds,
+               const std::atomic<bool>* interrupt);
+    ///@return Totals over every decision made through decide() since the last reset
+    const DecisionStats& getDecisionStats() const { return stats; }
+    ///@brief Starts the decision totals over, for example at the start of a batch of matches
+    void resetDecisionStats() { stats = DecisionStats(); }
+
+    ///@brief Shares the decisions of the scripted strategies between every RobotAI of the program.
+    ///
+    /// The scripted AIs decide from the position and what they remember, so once a decision is
+    /// known for both it is taken from a DecisionCache instead of being worked out again, whatever
+    /// the match or thread. Meant for batch runs on fixed maps, which keep reaching the same
+    /// positions: the tuner, the A/B test and the ladder turn it on, it is off otherwise. The random
+    /// generator of a scripted AI is part of what it remembers, so a cached decision is the one it
+    /// would make again and matches play out the same with or without the cache.
+    ///@param enabled TRUE to use the cache from now on, in every RobotAI
+    static void setDecisionCaching(bool enabled);
+    ///@return TRUE if the scripted strategies share their decisions, FALSE otherwise
+    static bool isDecisionCaching();
+    ///@return Hits, misses, insertions and evictions of the shared decisions, over every strategy
+    static DecisionCacheStats getDecisionCacheStats();
+    ///@brief Forgets every shared decision and starts the counters over
+    static void clearDecisionCache();
+
+    ///@brief Forgets everything the AIs remember about the current match, and the current plan.
+    ///
+    /// Called when a new match starts, so an instance can play any number of matches one after
+    /// the other. The selected strategies and the decision totals are kept.
+    void reset();
+
+    ///@brief Selects the strategy that plays one robot type, for example "mcts"
+    ///@param type The robot type the strategy will play
+    ///@param name A strategy name known to AIRegistry
+    ///@return TRUE if the strategy is used from now on, FALSE if the name is unknown
+    bool setStrategy(RobotType type, const QString& name);
+    ///@param type A robot type
+    ///@return The name of the strategy playing the robot type, "custom" for one set with setCustomAI()
+    QString getStrategyName(RobotType type) const;
+    ///@param type A robot type
+    ///@return The built-in strategy playing the robot type if it is a T, to configure it, nullptr otherwise
+    template<class T>
+    T* getStrategy(RobotType type) { return std::get_if<T>(&strategies[slotFor(type)]); }
+
+    ///@brief Replaces the AI of one robot type with an externally supplied one
+    ///@param type The robot type the AI will play
+    ///@param ai The AI to use from now on, nullptr goes back to the default strategy of the type
+    void setCustomAI(RobotType type, std::unique_ptr<AIInterface> ai);
+    ///@param type A robot type
+    ///@return The externally supplied AI of the robot type, nullptr if a built-in strategy is used
+    AIInterface* getCustomAI(RobotType type) const;
+
+    ///@brief Sets the thresholds the scripted strategies decide by in games of a difficulty
+    ///@param difficulty The difficulty of the games
+    ///@param parameters The thresholds of each scripted strategy, for those that are selected
+    void setParameters(GameDifficulty difficulty, const AIParameterSet& parameters);
+    ///@brief Seeds every strategy's random numbers: the scripted strategies' choices between
+    /// equally good moves and the Monte Carlo searches. Strategies selected afterwards start from
+    /// a random seed again.
+    ///@param seed The seed
+    void setSeed(quint32 seed);
     
 private:
-    /// Specialized AI instances
-    SniperAI* sniperAI;
-    ScoutAI* scoutAI;
-    TankAI* tankAI;
+    /// An answer planned while the player was thinking
+    struct PonderedTurn {
+        /// Game::stateHash() of the AI's turn the plan answers
+        quint64 hash = 0;
+        TurnPlan plan;
+        bool complete = true;
+    };
+
+    /// A decision made a slice at a time, from begin() to result()
+    struct SteppedDecision {
+        /// Slot of the strategy searching
+        int slot = 0;
+        DecisionBudget budget;
+        qint64 budgetNs = -1;
+        /// The decision once made, at once in begin() when there was nothing to search for
+        Decision decision;
+        bool searching = false;
+        /// Set when the budget of begin() ran out before the strategy was done
+        bool cutShort = false;
+    };
+
+    /// What a scripted strategy remembered before a planned command
+    using PlanMemory = std::variant<std::monostate, ScoutAI::Memory, TankAI::Memory, SniperAI::Memory>;
+
+    const PonderedTurn* ponderedFor(quint64 hash) const;
+    static int slotFor(RobotType type);
+    static QString defaultStrategyName(RobotType type);
+
+    /// Strategy playing each robot type, indexed by robot type
+    AIStrategy strategies[3];
+    /// Name each strategy was selected by
+    QString strategyNames[3];
+    /// Commands planned for the rest of the current turn
+    TurnPlan plan;
+    /// What the strategy remembered before each planned command, one per step of the plan when it
+    /// was made by asking a scripted strategy for one command after another, empty otherwise
+    std::vector<PlanMemory> planMemory;
+    /// Copy of the game the turn is planned on, reused from turn to turn
+    std::unique_ptr<Game> planLine;
+    /// Answers to the turns the player is likely to play, from the last call to ponder()
+    std::vector<PonderedTurn> pondered;
+    SteppedDecision stepping;
+    DecisionStats stats;
 };
 
-#endif // ROBOTAI_H 
\ No newline at end of file
+#endif // ROBOTAI_H 
@@ -0,0 +1,47 @@
+#include "robotaipool.h"
+#include "robotai.h"
+
+#include <QMutexLocker>
+
+RobotAIPool::RobotAIPool(Factory factory)
+    : factory(std::move(factory)), created(0) {
+}
+
+RobotAIPool::~RobotAIPool() {
+}
+
+std::unique_ptr<RobotAI> RobotAIPool::acquire() {
+    {
+        QMutexLocker locker(&mutex);
+        if (!idle.empty()) {
+            std::unique_ptr<RobotAI> ai = std::move(idle.back());
+            idle.pop_back();
+            return ai;
+        }
+        created++;
+    }
+
+    // Building an AI can take a while, other threads may use the pool meanwhile
+    return factory ? factory() : std::make_unique<RobotAI>();
+}
+
+void RobotAIPool::release(std::unique_ptr<RobotAI> ai) {
+    if (!ai) {
+        return;
+    }
+    // Reset outside the lock, the AI belongs to no one else at this point
+    ai->reset();
+
+    QMutexLocker locker(&mutex);
+    idle.push_back(std::move(ai));
+}
+
+int RobotAIPool::idleCount() const {
+    QMutexLocker locker(&mutex);
+    return static_cast<int>(idle.size());
+}
+
+int RobotAIPool::createdCount() const {
+    QMutexLocker locker(&mutex);
+    return created;
+}
@@ -0,0 +1,53 @@
+#ifndef ROBOTAIPOOL_H
+#define ROBOTAIPOOL_H
+
+#include <QMutex>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class RobotAI;
+
+/**
+ * @brief Thread-safe pool of RobotAI instances, so matches can reuse AIs instead of building them.
+ *
+ * A match takes an AI with acquire(), hands it to its Game (through the constructor or
+ * Game::setRobotAI()) and gives it back with release() when it is over. Released AIs are reset,
+ * so nothing remembered in one match reaches the next, and are handed out again by later calls
+ * to acquire() from any thread.
+ *
+ * Every AI in the pool is only ever used by one match at a time, which is what makes AIs that
+ * keep state between decisions safe to use from many threads.
+ *
+ * @author Group 17
+ */
+class RobotAIPool {
+public:
+    /// Builds a new AI when the pool is empty, for example one with a custom AI set per robot type
+    using Factory = std::function<std::unique_ptr<RobotAI>()>;
+
+    /// @brief Creates an empty pool
+    /// @param factory - builds new AIs, nullptr for plain RobotAI instances
+    explicit RobotAIPool(Factory factory = nullptr);
+    ~RobotAIPool();
+
+    /// @brief Takes an idle AI out of the pool, or builds a new one if none is idle
+    /// @return The AI, ready for a new match
+    std::unique_ptr<RobotAI> acquire();
+    /// @brief Gives an AI back to the pool once its match is over
+    /// @param ai - the AI, reset before it is stored. nullptr is ignored
+    void release(std::unique_ptr<RobotAI> ai);
+
+    /// @return the number of AIs waiting in the pool
+    int idleCount() const;
+    /// @return the number of AIs the pool has built so far
+    int createdCount() const;
+
+private:
+    Factory factory;
+    mutable QMutex mutex;
+    std::vector<std::unique_ptr<RobotAI>> idle;
+    int created;
+};
+
+#endif // ROBOTAIPOOL_H
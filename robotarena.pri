@@ -0,0 +1,80 @@
+# Sources of the game shared by the application, the tests and the tools
+
+SOURCES += \
+    gamegrid.cpp \
+    game.cpp \
+    robot.cpp \
+    robotselector.cpp \
+    multiplayerrobotselector.cpp \
+    mainmenu.cpp \
+    gamemanager.cpp \
+    tutorial.cpp \
+    difficultyselector.cpp \
+    gameoverscreen.cpp \
+    mapselector.cpp \
+    robotai.cpp \
+    projectile.cpp \
+    hitfeedback.cpp \
+    laserfeedback.cpp \
+    sniperai.cpp \
+    scoutai.cpp \
+    tankai.cpp \
+    logger.cpp \
+    terrain.cpp \
+    arenaallocator.cpp \
+    allocationcounter.cpp \
+    pathfinding.cpp \
+    hierarchicalpathfinder.cpp \
+    distancematrix.cpp \
+    threatmap.cpp \
+    influencemap.cpp \
+    mapanalysis.cpp \
+    mctsai.cpp \
+    alphabetaai.cpp \
+    robotaipool.cpp \
+    airegistry.cpp \
+    aibatch.cpp \
+    aiparameters.cpp \
+    matchrunner.cpp
+
+HEADERS += \
+    gamegrid.h \
+    game.h \
+    robot.h \
+    robotselector.h \
+    multiplayerrobotselector.h \
+    mainmenu.h \
+    gamemanager.h \
+    tutorial.h \
+    difficultyselector.h \
+    gameoverscreen.h \
+    mapselector.h \
+    robotai.h \
+    projectile.h \
+    hitfeedback.h \
+    laserfeedback.h \
+    aiinterface.h \
+    sniperai.h \
+    scoutai.h \
+    tankai.h \
+    logger.h \
+    terrain.h \
+    arenaallocator.h \
+    allocationcounter.h \
+    pathfinding.h \
+    hierarchicalpathfinder.h \
+    distancematrix.h \
+    threatmap.h \
+    influencemap.h \
+    mapanalysis.h \
+    mctsai.h \
+    alphabetaai.h \
+    robotaipool.h \
+    airegistry.h \
+    decisioncache.h \
+    aibatch.h \
+    aiparameters.h \
+    matchrunner.h
+
+RESOURCES += \
+    resources.qrc
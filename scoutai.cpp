@@ -5,20 +5,82 @@
 
 #include <QRandomGenerator>
 #include <algorithm>
+#include <climits>
 
 // Constructor
 ScoutAI::ScoutAI(QObject* parent)
-    : QObject(parent),
-      lastPlayerPosition(-1, -1),
-      lastPlayerHealth(0),
-      lastAiPosition(-1, -1),
-      samePositionCounter(0),
-      consecutiveTurnCount(0),
-      moveCounter(0),
-      turnCounter(0),
-      isCirclingClockwise(true)
+    : QObject(parent)
+    , seed(QRandomGenerator::global()->generate())
 {
-    Logger::log("ScoutAI initialized.");
+    match.random = AIRandom(seed);
+    AIParameterSets defaults = AIParameterSets::defaults();
+    for (GameDifficulty difficulty : {GameDifficulty::Easy, GameDifficulty::Medium, GameDifficulty::Hard}) {
+        parameters[static_cast<int>(difficulty)] = defaults.at(difficulty).scout;
+    }
+    updateParametersHash();
+    AI_LOG("ScoutAI initialized.");
+}
+
+void ScoutAI::setParameters(GameDifficulty difficulty, const ScoutParameters& newParameters)
+{
+    parameters[static_cast<int>(difficulty)] = newParameters;
+    updateParametersHash();
+}
+
+const ScoutParameters& ScoutAI::getParameters(GameDifficulty difficulty) const
+{
+    return parameters[static_cast<int>(difficulty)];
+}
+
+const ScoutParameters& ScoutAI::parametersFor(Game* game) const
+{
+    return parameters[static_cast<int>(game->getDifficulty())];
+}
+
+void ScoutAI::updateParametersHash()
+{
+    parametersHash = 0;
+    for (const ScoutParameters& set : parameters) {
+        parametersHash = parametersHash * 1099511628211ULL ^ ::hashParameters(set);
+    }
+}
+
+void ScoutAI::reset()
+{
+    match = MatchState();
+    match.random = AIRandom(seed);
+}
+
+void ScoutAI::setSeed(quint32 newSeed)
+{
+    seed = newSeed;
+    match.random = AIRandom(seed);
+}
+
+quint64 ScoutAI::hashMemory() const
+{
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](int value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            hash ^= static_cast<quint8>(value >> shift);
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(match.lastPlayerPosition.x());
+    mix(match.lastPlayerPosition.y());
+    mix(match.lastPlayerHealth);
+    mix(match.lastAiPosition.x());
+    mix(match.lastAiPosition.y());
+    mix(match.samePositionCounter);
+    mix(match.consecutiveTurnCount);
+    mix(match.moveCounter);
+    mix(match.turnCounter);
+    mix(match.isCirclingClockwise);
+    mix(static_cast<int>(match.lastTurnDir));
+    mix(match.justTurned);
+    mix(static_cast<int>(match.random.state));
+    mix(static_cast<int>(match.random.state >> 32));
+    return hash;
 }
 
 /**
@@ -26,32 +88,33 @@ ScoutAI::ScoutAI(QObject* parent)
  */
 Command ScoutAI::calculateMove(Game* game, Robot* ai, Robot* player)
 {
+    const ScoutParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
-    Logger::log(QString("=================================================="));
-    Logger::log(QString("ScoutAI::calculateMove: Scout at (%1, %2), moves left: %3/%4")
+    AI_LOG(QString("=================================================="));
+    AI_LOG(QString("ScoutAI::calculateMove: Scout at (%1, %2), moves left: %3/%4")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(ai->getMovesLeft()).arg(ai->getMaxMoves()));
 
     // If this is the start of a new turn (full moves), reset turnCounter
     if (ai->getMovesLeft() == ai->getMaxMoves()) {
-        turnCounter = 0;
-        Logger::log("New turn with full moves. Reset turn counter.");
+        match.turnCounter = 0;
+        AI_LOG("New turn with full moves. Reset turn counter.");
     }
 
     // Check if Scout is stuck (has not moved from lastAiPosition)
-    if (aiPos == lastAiPosition) {
-        samePositionCounter++;
-        Logger::log(QString("Scout did not move. samePositionCounter increased to %1").arg(samePositionCounter));
+    if (aiPos == match.lastAiPosition) {
+        match.samePositionCounter++;
+        AI_LOG(QString("Scout did not move. samePositionCounter increased to %1").arg(match.samePositionCounter));
     } else {
-        samePositionCounter = 0;
-        lastAiPosition = aiPos;
-        Logger::log("Scout moved. samePositionCounter reset.");
+        match.samePositionCounter = 0;
+        match.lastAiPosition = aiPos;
+        AI_LOG("Scout moved. samePositionCounter reset.");
     }
 
-    // If stuck for 5 consecutive attempts, attempt to break out:
-    if (samePositionCounter > 5) {
-        Logger::log("Scout might be stuck. Attempting aggressive break-out.");
-        samePositionCounter = 0;
+    // If stuck for too many consecutive attempts, attempt to break out:
+    if (match.samePositionCounter > params.stuckLimit) {
+        AI_LOG("Scout might be stuck. Attempting aggressive break-out.");
+        match.samePositionCounter = 0;
         
         // Get opponent reference
         Robot* opponent = game->getPlayerRobot();
@@ -61,23 +124,23 @@ Command ScoutAI::calculateMove(Game* game, Robot* ai, Robot* player)
         
         QPoint opponentPos = opponent->getPosition();
         int manhattanDistToOpponent = manhattanDistance(aiPos, opponentPos);
-        Logger::log(QString("Current distance to opponent: %1").arg(manhattanDistToOpponent));
+        AI_LOG(QString("Current distance to opponent: %1").arg(manhattanDistToOpponent));
         
         // If the opponent is adjacent and we're facing them, just attack directly
         if (manhattanDistToOpponent == 1 && 
             isInDirection(opponentPos.x() - aiPos.x(), opponentPos.y() - aiPos.y(), ai->getDirection())) {
-            Logger::log("Opponent is adjacent and we're facing them. Command: Attack.");
+            AI_LOG("Opponent is adjacent and we're facing them. Command: Attack.");
             return Command::Attack;
         }
         
         // Try all directions to find ANY valid move
-        Logger::log("Trying ANY valid direction to move...");
+        AI_LOG("Trying ANY valid direction to move...");
         for (int i = 0; i < 4; i++) {
             Direction testDir = static_cast<Direction>(i);
             QPoint newPos = getPositionInDirection(aiPos, testDir);
             
             if (game->isValidMove(newPos)) {
-                Logger::log(QString("Found valid move in direction %1. Trying that.").arg(i));
+                AI_LOG(QString("Found valid move in direction %1. Trying that.").arg(i));
                 if (ai->getDirection() != testDir) {
                     return getTurnCommand(ai->getDirection(), testDir);
                 } else {
@@ -89,16 +152,16 @@ Command ScoutAI::calculateMove(Game* game, Robot* ai, Robot* player)
         // If we can't move in any direction, try attacking in the current direction
         QPoint frontPos = getPositionInDirection(aiPos, ai->getDirection());
         if (game->isValidPosition(frontPos) && game->getCellType(frontPos) == CellType::Wall) {
-            Logger::log("Completely stuck with wall in front. Command: Attack to break wall.");
+            AI_LOG("Completely stuck with wall in front. Command: Attack to break wall.");
             return Command::Attack;
         }
         
         // As a last resort, just turn in a different random direction
-        Logger::log("Completely stuck with no valid moves. Making random turn as absolute last resort.");
+        AI_LOG("Completely stuck with no valid moves. Making random turn as absolute last resort.");
         Direction currentDir = ai->getDirection();
         Direction randomDir;
         do {
-            randomDir = static_cast<Direction>(QRandomGenerator::global()->bounded(4));
+            randomDir = static_cast<Direction>(match.random.bounded(4));
         } while (randomDir == currentDir);
         
         return getTurnCommand(currentDir, randomDir);
@@ -108,15 +171,24 @@ Command ScoutAI::calculateMove(Game* game, Robot* ai, Robot* player)
     QPoint playerPos = player->getPosition();
     int playerHealth = player->getHealth();
     
-    if (playerPos != lastPlayerPosition || playerHealth != lastPlayerHealth) {
-        if (lastPlayerPosition != QPoint(-1, -1)) {
-            Logger::log(QString("Player moved from (%1,%2) to (%3,%4) or health changed from %5 to %6")
-                        .arg(lastPlayerPosition.x()).arg(lastPlayerPosition.y())
+    if (playerPos != match.lastPlayerPosition || playerHealth != match.lastPlayerHealth) {
+        if (match.lastPlayerPosition != QPoint(-1, -1)) {
+            AI_LOG(QString("Player moved from (%1,%2) to (%3,%4) or health changed from %5 to %6")
+                        .arg(match.lastPlayerPosition.x()).arg(match.lastPlayerPosition.y())
                         .arg(playerPos.x()).arg(playerPos.y())
-                        .arg(lastPlayerHealth).arg(playerHealth));
+                        .arg(match.lastPlayerHealth).arg(playerHealth));
+        }
+        match.lastPlayerPosition = playerPos;
+        match.lastPlayerHealth = playerHealth;
+    }
+
+    // Weaker difficulties give up some moves to chance
+    if (match.random.bounded(100) < params.randomMovePercent) {
+        Command randomMove = makeRandomMove(game, ai);
+        if (randomMove != Command::None) {
+            AI_LOG("Making a random move.");
+            return randomMove;
         }
-        lastPlayerPosition = playerPos;
-        lastPlayerHealth = playerHealth;
     }
 
     // Choose strategy based on robot matchup
@@ -143,7 +215,7 @@ Command ScoutAI::calculateScoutNormal(Game* game, Robot* ai, Robot* player)
     int dy = playerPos.y() - aiPos.y();
     int distance = std::abs(dx) + std::abs(dy);
 
-    Logger::log(QString("calculateScoutNormal: Scout(%1,%2), Player(%3,%4), distance %5")
+    AI_LOG(QString("calculateScoutNormal: Scout(%1,%2), Player(%3,%4), distance %5")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(playerPos.x()).arg(playerPos.y())
                 .arg(distance));
@@ -154,16 +226,16 @@ Command ScoutAI::calculateScoutNormal(Game* game, Robot* ai, Robot* player)
     Q_UNUSED(playerInDir);
 
     // Move towards the player
-    Logger::log("Player not within range. Closing in.");
-    Direction towardDir = getDirectionTowards(dx, dy);
+    AI_LOG("Player not within range. Closing in.");
+    Direction towardDir = getDirectionTowards(game, ai, dx, dy);
     if (ai->getDirection() != towardDir) {
-        Logger::log("Not facing player. Command: Turn.");
+        AI_LOG("Not facing player. Command: Turn.");
         return getTurnCommand(ai->getDirection(), towardDir);
     }
-    return tryMoveOrBreakWall(game, ai);
+    return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
 
     // Fallback
-    Logger::log("Fallback reached in calculateSniperNormal. Command: Attack.");
+    AI_LOG("Fallback reached in calculateSniperNormal. Command: Attack.");
     return Command::Attack;
 }
 
@@ -173,6 +245,7 @@ Command ScoutAI::calculateScoutNormal(Game* game, Robot* ai, Robot* player)
  */
 Command ScoutAI::vsScout(Game* game, Robot* ai, Robot* otherScout)
 {
+    const ScoutParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint plrPos = otherScout->getPosition();
     int dx = plrPos.x() - aiPos.x();
@@ -181,7 +254,7 @@ Command ScoutAI::vsScout(Game* game, Robot* ai, Robot* otherScout)
     int totalMovesAtStartOfTurn = ai->getMaxMoves();
     int movesUsedThisTurn = totalMovesAtStartOfTurn - ai->getMovesLeft();
 
-    Logger::log(QString("vsScout: Scout(%1,%2), EnemyScout(%3,%4), distance %5, moves used: %6/%7")
+    AI_LOG(QString("vsScout: Scout(%1,%2), EnemyScout(%3,%4), distance %5, moves used: %6/%7")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(plrPos.x()).arg(plrPos.y())
                 .arg(distance)
@@ -197,15 +270,15 @@ Command ScoutAI::vsScout(Game* game, Robot* ai, Robot* otherScout)
     // Check if the other scout can be killed with one more attack
     bool canKillWithOneAttack = (otherScout->getHealth() <= ai->getAttackDamage());
     if (canKillWithOneAttack) {
-        Logger::log(QString("vsScout: Enemy Scout has %1 health and our attack is %2. Can kill with one hit!")
+        AI_LOG(QString("vsScout: Enemy Scout has %1 health and our attack is %2. Can kill with one hit!")
                    .arg(otherScout->getHealth()).arg(ai->getAttackDamage()));
     }
 
     // If we start adjacent to opponent, attack and then move away (hit and dash)
     if (distance == 1) {
         // Check if we're stuck in a turn cycle
-        if (samePositionCounter >= 3) {
-            Logger::log("vsScout: Detected potential turn cycle. Breaking out of pattern.");
+        if (match.samePositionCounter >= params.cycleLimit) {
+            AI_LOG("vsScout: Detected potential turn cycle. Breaking out of pattern.");
             
             // Try to move in ANY direction that's valid to break out
             for (int i = 0; i < 4; i++) {
@@ -214,10 +287,10 @@ Command ScoutAI::vsScout(Game* game, Robot* ai, Robot* otherScout)
                 
                 if (game->isValidMove(newPos)) {
                     if (ai->getDirection() != testDir) {
-                        Logger::log(QString("vsScout: Breaking cycle - turning to ANY valid direction %1").arg(i));
+                        AI_LOG(QString("vsScout: Breaking cycle - turning to ANY valid direction %1").arg(i));
                         return getTurnCommand(ai->getDirection(), testDir);
                     } else {
-                        Logger::log("vsScout: Breaking cycle - already facing valid direction, moving forward");
+                        AI_LOG("vsScout: Breaking cycle - already facing valid direction, moving forward");
                         return Command::MoveForward;
                     }
                 }
@@ -225,19 +298,19 @@ Command ScoutAI::vsScout(Game* game, Robot* ai, Robot* otherScout)
             
             // If no valid moves and facing opponent, attack as a last resort
             if (playerInDir) {
-                Logger::log("vsScout: Breaking cycle - no valid moves, attacking as last resort");
+                AI_LOG("vsScout: Breaking cycle - no valid moves, attacking as last resort");
                 return Command::Attack;
             } else {
                 // Turn toward scout
-                Direction towardDir = getDirectionTowards(dx, dy);
+                Direction towardDir = getDirectionTowards(game, ai, dx, dy);
                 return getTurnCommand(ai->getDirection(), towardDir);
             }
         }
         
         // First, make sure we're facing the scout
         if (!playerInDir) {
-            Logger::log("vsScout: Adjacent to scout but not facing them. Turning to attack.");
-            Direction towardDir = getDirectionTowards(dx, dy);
+            AI_LOG("vsScout: Adjacent to scout but not facing them. Turning to attack.");
+            Direction towardDir = getDirectionTowards(game, ai, dx, dy);
             return getTurnCommand(ai->getDirection(), towardDir);
         }
         
@@ -246,7 +319,7 @@ Command ScoutAI::vsScout(Game* game, Robot* ai, Robot* otherScout)
         
         // If we can kill the other scout with one attack, prioritize attacking regardless
         if (canKillWithOneAttack && playerInDir) {
-            Logger::log("vsScout: Enemy Scout can be killed with one attack! Attacking for the kill!");
+            AI_LOG("vsScout: Enemy Scout can be killed with one attack! Attacking for the kill!");
             return Command::Attack;
         }
         
@@ -254,29 +327,29 @@ Command ScoutAI::vsScout(Game* game, Robot* ai, Robot* otherScout)
         if (!hasAttackedThisTurn) {
             // If we have multiple moves, always attack
             if (ai->getMovesLeft() >= 2) {
-                Logger::log("vsScout: Adjacent to scout and facing them with multiple moves. Attacking once!");
+                AI_LOG("vsScout: Adjacent to scout and facing them with multiple moves. Attacking once!");
                 return Command::Attack;
             }
             
             // If we only have one move left, attack only if we have a health advantage or can kill
             if (ai->getMovesLeft() == 1) {
                 if (ai->getHealth() > otherScout->getHealth() || canKillWithOneAttack) {
-                    Logger::log("vsScout: Last move and have health advantage or can kill. Attacking!");
+                    AI_LOG("vsScout: Last move and have health advantage or can kill. Attacking!");
                     return Command::Attack;
                 } else {
-                    Logger::log("vsScout: Last move and no health advantage. Moving away instead.");
+                    AI_LOG("vsScout: Last move and no health advantage. Moving away instead.");
                 }
             }
         }
         
         // If we've already attacked but can still kill the opponent, do it
         if (hasAttackedThisTurn && canKillWithOneAttack && playerInDir) {
-            Logger::log("vsScout: Already attacked but can kill enemy Scout with one more attack! Finishing it off!");
+            AI_LOG("vsScout: Already attacked but can kill enemy Scout with one more attack! Finishing it off!");
             return Command::Attack;
         }
         
         // After attacking once, always try to retreat
-        Logger::log("vsScout: Already attacked or chose to retreat. Moving away.");
+        AI_LOG("vsScout: Already attacked or chose to retreat. Moving away.");
         Direction awayDir = getDirectionAway(dx, dy);
         
         // Check if we can actually move away before turning
@@ -285,10 +358,10 @@ Command ScoutAI::vsScout(Game* game, Robot* ai, Robot* otherScout)
         
         // If we can't move directly away, try alternative directions
         if (!canMoveAway) {
-            Logger::log("vsScout: Can't move directly away. Trying alternative directions.");
+            AI_LOG("vsScout: Can't move directly away. Trying alternative directions.");
             
             // Try all directions except toward the opposing scout
-            Direction towardDir = getDirectionTowards(dx, dy);
+            Direction towardDir = getDirectionTowards(game, ai, dx, dy);
             for (int i = 0; i < 4; i++) {
                 Direction testDir = static_cast<Direction>(i);
                 if (testDir == towardDir) continue; // Skip direction toward opponent
@@ -296,10 +369,10 @@ Command ScoutAI::vsScout(Game* game, Robot* ai, Robot* otherScout)
                 QPoint testPos = getPositionInDirection(aiPos, testDir);
                 if (game->isValidMove(testPos)) {
                     if (ai->getDirection() != testDir) {
-                        Logger::log(QString("vsScout: Found alternative escape direction %1. Turning.").arg(i));
+                        AI_LOG(QString("vsScout: Found alternative escape direction %1. Turning.").arg(i));
                         return getTurnCommand(ai->getDirection(), testDir);
                     } else {
-                        Logger::log("vsScout: Already facing alternative escape direction. Moving.");
+                        AI_LOG("vsScout: Already facing alternative escape direction. Moving.");
                         return Command::MoveForward;
                     }
                 }
@@ -309,48 +382,49 @@ Command ScoutAI::vsScout(Game* game, Robot* ai, Robot* otherScout)
             if (!hasAttackedThisTurn && playerInDir) {
                 // If the attack will kill, make that clear in the log
                 if (canKillWithOneAttack) {
-                    Logger::log("vsScout: No escape possible but can kill! Attacking for the kill!");
+                    AI_LOG("vsScout: No escape possible but can kill! Attacking for the kill!");
                 } else {
-                    Logger::log("vsScout: No escape possible. Attacking as last resort.");
+                    AI_LOG("vsScout: No escape possible. Attacking as last resort.");
                 }
                 return Command::Attack;
             } else if (!playerInDir) {
                 // Turn to face the scout if we can't move away
-                Direction towardDir = getDirectionTowards(dx, dy);
+                Direction towardDir = getDirectionTowards(game, ai, dx, dy);
                 return getTurnCommand(ai->getDirection(), towardDir);
             }
         }
         
         // We can move directly away, so turn if needed
         if (ai->getDirection() != awayDir) {
-            Logger::log(QString("vsScout: Turning to escape direction %1").arg(static_cast<int>(awayDir)));
+            AI_LOG(QString("vsScout: Turning to escape direction %1").arg(static_cast<int>(awayDir)));
             return getTurnCommand(ai->getDirection(), awayDir);
         }
         
         // Already facing away, so move
-        Logger::log("vsScout: Moving away from scout in escape direction");
+        AI_LOG("vsScout: Moving away from scout in escape direction");
         return Command::MoveForward;
     }
 
     // If below half health and have no advantage, try to pick up health
     // Skip healing if we can kill the opponent
-    if (ai->getHealth() < ai->getMaxHealth() / 2 && ai->getHealth() <= otherScout->getHealth() && !canKillWithOneAttack) {
-        Logger::log("vsScout: Scout below 50% HP with no advantage. Attempting health pickup.");
+    if (ai->getHealth() < ai->getMaxHealth() * params.healthSeekPercent / 100 && ai->getHealth() <= otherScout->getHealth() &&
+        !canKillWithOneAttack) {
+        AI_LOG("vsScout: Scout below 50% HP with no advantage. Attempting health pickup.");
         Command c = tryCollectPickup(game, ai, true);
         if (c != Command::None) {
             return c;
         }
-        Logger::log("vsScout: No health pickup found.");
+        AI_LOG("vsScout: No health pickup found.");
     }
 
     // If opponent can be killed and we're close, prioritize closing distance
-    if (canKillWithOneAttack && distance <= 3) {
-        Logger::log("vsScout: Enemy Scout within range and can be killed! Moving to attack position.");
-        Direction towardDir = getDirectionTowards(dx, dy);
+    if (canKillWithOneAttack && distance <= params.killRangeVsScout) {
+        AI_LOG("vsScout: Enemy Scout within range and can be killed! Moving to attack position.");
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
 
     // Find a path that doesn't end adjacent to the player
@@ -369,6 +443,7 @@ Command ScoutAI::vsScout(Game* game, Robot* ai, Robot* otherScout)
  */
 Command ScoutAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
 {
+    const ScoutParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint plrPos = sniper->getPosition();
     int dx = plrPos.x() - aiPos.x();
@@ -377,7 +452,7 @@ Command ScoutAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
     int totalMovesAtStartOfTurn = ai->getMaxMoves();
     int movesUsedThisTurn = totalMovesAtStartOfTurn - ai->getMovesLeft();
 
-    Logger::log(QString("vsSniper: Scout(%1,%2), Sniper(%3,%4), distance %5, moves used: %6/%7")
+    AI_LOG(QString("vsSniper: Scout(%1,%2), Sniper(%3,%4), distance %5, moves used: %6/%7")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(plrPos.x()).arg(plrPos.y())
                 .arg(distance)
@@ -393,15 +468,15 @@ Command ScoutAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
     // Check if the sniper can be killed with one more attack
     bool canKillWithOneAttack = (sniper->getHealth() <= ai->getAttackDamage());
     if (canKillWithOneAttack) {
-        Logger::log(QString("vsSniper: Sniper has %1 health and our attack is %2. Can kill with one hit!")
+        AI_LOG(QString("vsSniper: Sniper has %1 health and our attack is %2. Can kill with one hit!")
                    .arg(sniper->getHealth()).arg(ai->getAttackDamage()));
     }
 
     // If we start adjacent to Sniper, attack and then move away (hit and dash)
     if (distance == 1) {
         // Check if we're stuck in a turn cycle
-        if (samePositionCounter >= 3) {
-            Logger::log("vsSniper: Detected potential turn cycle. Breaking out of pattern.");
+        if (match.samePositionCounter >= params.cycleLimit) {
+            AI_LOG("vsSniper: Detected potential turn cycle. Breaking out of pattern.");
             
             // Try to move in ANY direction that's valid to break out
             for (int i = 0; i < 4; i++) {
@@ -410,10 +485,10 @@ Command ScoutAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
                 
                 if (game->isValidMove(newPos)) {
                     if (ai->getDirection() != testDir) {
-                        Logger::log(QString("vsSniper: Breaking cycle - turning to ANY valid direction %1").arg(i));
+                        AI_LOG(QString("vsSniper: Breaking cycle - turning to ANY valid direction %1").arg(i));
                         return getTurnCommand(ai->getDirection(), testDir);
                     } else {
-                        Logger::log("vsSniper: Breaking cycle - already facing valid direction, moving forward");
+                        AI_LOG("vsSniper: Breaking cycle - already facing valid direction, moving forward");
                         return Command::MoveForward;
                     }
                 }
@@ -421,19 +496,19 @@ Command ScoutAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
             
             // If no valid moves and facing sniper, attack as a last resort
             if (playerInDir) {
-                Logger::log("vsSniper: Breaking cycle - no valid moves, attacking as last resort");
+                AI_LOG("vsSniper: Breaking cycle - no valid moves, attacking as last resort");
                 return Command::Attack;
             } else {
                 // Turn toward sniper
-                Direction towardDir = getDirectionTowards(dx, dy);
+                Direction towardDir = getDirectionTowards(game, ai, dx, dy);
                 return getTurnCommand(ai->getDirection(), towardDir);
             }
         }
         
         // First, make sure we're facing the sniper
         if (!playerInDir) {
-            Logger::log("vsSniper: Adjacent to sniper but not facing them. Turning to attack.");
-            Direction towardDir = getDirectionTowards(dx, dy);
+            AI_LOG("vsSniper: Adjacent to sniper but not facing them. Turning to attack.");
+            Direction towardDir = getDirectionTowards(game, ai, dx, dy);
             return getTurnCommand(ai->getDirection(), towardDir);
         }
         
@@ -442,24 +517,24 @@ Command ScoutAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
         
         // If we can kill the sniper with one attack, always do it
         if (canKillWithOneAttack && playerInDir) {
-            Logger::log("vsSniper: Sniper can be killed with one attack! Attacking for the kill!");
+            AI_LOG("vsSniper: Sniper can be killed with one attack! Attacking for the kill!");
             return Command::Attack;
         }
         
         // Against snipers, always attack once when adjacent (they're vulnerable up close)
         if (!hasAttackedThisTurn) {
-            Logger::log("vsSniper: Adjacent to sniper and facing them. Attacking once!");
+            AI_LOG("vsSniper: Adjacent to sniper and facing them. Attacking once!");
             return Command::Attack;
         }
         
         // If we've already attacked but can kill the sniper, finish them off
         if (hasAttackedThisTurn && canKillWithOneAttack && playerInDir) {
-            Logger::log("vsSniper: Already attacked but can kill Sniper with one more attack! Finishing it off!");
+            AI_LOG("vsSniper: Already attacked but can kill Sniper with one more attack! Finishing it off!");
             return Command::Attack;
         }
         
         // After attacking once, always try to move away
-        Logger::log("vsSniper: Already attacked this turn. Moving away to reposition.");
+        AI_LOG("vsSniper: Already attacked this turn. Moving away to reposition.");
         Direction awayDir = getDirectionAway(dx, dy);
         
         // Check if we can actually move away before turning
@@ -468,10 +543,10 @@ Command ScoutAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
         
         // If we can't move directly away, try alternative directions
         if (!canMoveAway) {
-            Logger::log("vsSniper: Can't move directly away. Trying alternative directions.");
+            AI_LOG("vsSniper: Can't move directly away. Trying alternative directions.");
             
             // Try all directions except toward the sniper
-            Direction towardDir = getDirectionTowards(dx, dy);
+            Direction towardDir = getDirectionTowards(game, ai, dx, dy);
             for (int i = 0; i < 4; i++) {
                 Direction testDir = static_cast<Direction>(i);
                 if (testDir == towardDir) continue; // Skip direction toward sniper
@@ -479,10 +554,10 @@ Command ScoutAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
                 QPoint testPos = getPositionInDirection(aiPos, testDir);
                 if (game->isValidMove(testPos)) {
                     if (ai->getDirection() != testDir) {
-                        Logger::log(QString("vsSniper: Found alternative escape direction %1. Turning.").arg(i));
+                        AI_LOG(QString("vsSniper: Found alternative escape direction %1. Turning.").arg(i));
                         return getTurnCommand(ai->getDirection(), testDir);
                     } else {
-                        Logger::log("vsSniper: Already facing alternative escape direction. Moving.");
+                        AI_LOG("vsSniper: Already facing alternative escape direction. Moving.");
                         return Command::MoveForward;
                     }
                 }
@@ -492,48 +567,48 @@ Command ScoutAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
             if (!hasAttackedThisTurn && playerInDir) {
                 // If the attack will kill, make that clear in the logs
                 if (canKillWithOneAttack) {
-                    Logger::log("vsSniper: No escape possible but can kill Sniper! Attacking for the kill!");
+                    AI_LOG("vsSniper: No escape possible but can kill Sniper! Attacking for the kill!");
                 } else {
-                    Logger::log("vsSniper: No escape possible. Attacking as last resort.");
+                    AI_LOG("vsSniper: No escape possible. Attacking as last resort.");
                 }
                 return Command::Attack;
             } else if (!playerInDir) {
                 // Turn to face the sniper if we can't move away
-                Direction towardDir = getDirectionTowards(dx, dy);
+                Direction towardDir = getDirectionTowards(game, ai, dx, dy);
                 return getTurnCommand(ai->getDirection(), towardDir);
             }
         }
         
         // We can move directly away, so turn if needed
         if (ai->getDirection() != awayDir) {
-            Logger::log(QString("vsSniper: Turning to escape direction %1").arg(static_cast<int>(awayDir)));
+            AI_LOG(QString("vsSniper: Turning to escape direction %1").arg(static_cast<int>(awayDir)));
             return getTurnCommand(ai->getDirection(), awayDir);
         }
         
         // Already facing away, so move
-        Logger::log("vsSniper: Moving away from sniper in escape direction");
+        AI_LOG("vsSniper: Moving away from sniper in escape direction");
         return Command::MoveForward;
     }
 
     // If below half health, try to pick up health
     // Skip healing if we can kill the opponent
-    if (ai->getHealth() < ai->getMaxHealth() / 2 && !canKillWithOneAttack) {
-        Logger::log("vsSniper: Scout below 50% HP. Attempting health pickup.");
+    if (ai->getHealth() < ai->getMaxHealth() * params.healthSeekPercent / 100 && !canKillWithOneAttack) {
+        AI_LOG("vsSniper: Scout below 50% HP. Attempting health pickup.");
         Command c = tryCollectPickup(game, ai, true);
         if (c != Command::None) {
             return c;
         }
-        Logger::log("vsSniper: No health pickup found.");
+        AI_LOG("vsSniper: No health pickup found.");
     }
     
     // If opponent can be killed and we're relatively close, prioritize closing distance
-    if (canKillWithOneAttack && distance <= 4) {
-        Logger::log("vsSniper: Sniper within range and can be killed! Moving to attack position.");
-        Direction towardDir = getDirectionTowards(dx, dy);
+    if (canKillWithOneAttack && distance <= params.killRangeVsSniper) {
+        AI_LOG("vsSniper: Sniper within range and can be killed! Moving to attack position.");
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
 
     // Find a path that gets to the sniper but doesn't end adjacent if it's the last move
@@ -544,12 +619,12 @@ Command ScoutAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
     
     // If we can't find a safe path, be more aggressive - get closer to the sniper
     // Snipers are dangerous at range, less dangerous up close
-    Logger::log("vsSniper: No safe path found. Moving aggressively towards sniper.");
-    Direction towardDir = getDirectionTowards(dx, dy);
+    AI_LOG("vsSniper: No safe path found. Flanking towards sniper.");
+    Direction towardDir = getFlankingDirection(game, ai, sniper);
     if (ai->getDirection() != towardDir) {
         return getTurnCommand(ai->getDirection(), towardDir);
     }
-    return tryMoveOrBreakWall(game, ai);
+    return tryMoveOrBreakWall(game, ai, sniper->getPosition());
 }
 
 /**
@@ -558,6 +633,7 @@ Command ScoutAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
  */
 Command ScoutAI::vsTank(Game* game, Robot* ai, Robot* tank)
 {
+    const ScoutParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint plrPos = tank->getPosition();
     int dx = plrPos.x() - aiPos.x();
@@ -566,7 +642,7 @@ Command ScoutAI::vsTank(Game* game, Robot* ai, Robot* tank)
     int totalMovesAtStartOfTurn = ai->getMaxMoves();
     int movesUsedThisTurn = totalMovesAtStartOfTurn - ai->getMovesLeft();
 
-    Logger::log(QString("vsTank: Scout(%1,%2), Tank(%3,%4), distance %5, moves used: %6/%7")
+    AI_LOG(QString("vsTank: Scout(%1,%2), Tank(%3,%4), distance %5, moves used: %6/%7")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(plrPos.x()).arg(plrPos.y())
                 .arg(distance)
@@ -582,15 +658,15 @@ Command ScoutAI::vsTank(Game* game, Robot* ai, Robot* tank)
     // Check if the tank can be killed with one more attack
     bool canKillWithOneAttack = (tank->getHealth() <= ai->getAttackDamage());
     if (canKillWithOneAttack) {
-        Logger::log(QString("vsTank: Tank has %1 health and our attack is %2. Can kill with one hit!")
+        AI_LOG(QString("vsTank: Tank has %1 health and our attack is %2. Can kill with one hit!")
                    .arg(tank->getHealth()).arg(ai->getAttackDamage()));
     }
     
     // If we start adjacent to opponent, attack and then move away (hit and dash)
     if (distance == 1) {
         // Check if we're stuck in a turn cycle (adjacent to tank and keep turning)
-        if (samePositionCounter >= 3) {
-            Logger::log("vsTank: Detected potential turn cycle. Breaking out of pattern.");
+        if (match.samePositionCounter >= params.cycleLimit) {
+            AI_LOG("vsTank: Detected potential turn cycle. Breaking out of pattern.");
             
             // If we've been in the same position for several turns, more aggressively break out
             // Try to move in ANY direction that's valid, even if it's toward the opponent
@@ -600,10 +676,10 @@ Command ScoutAI::vsTank(Game* game, Robot* ai, Robot* tank)
                 
                 if (game->isValidMove(newPos)) {
                     if (ai->getDirection() != testDir) {
-                        Logger::log(QString("vsTank: Breaking cycle - turning to ANY valid direction %1").arg(i));
+                        AI_LOG(QString("vsTank: Breaking cycle - turning to ANY valid direction %1").arg(i));
                         return getTurnCommand(ai->getDirection(), testDir);
                     } else {
-                        Logger::log("vsTank: Breaking cycle - already facing valid direction, moving forward");
+                        AI_LOG("vsTank: Breaking cycle - already facing valid direction, moving forward");
                         return Command::MoveForward;
                     }
                 }
@@ -611,19 +687,19 @@ Command ScoutAI::vsTank(Game* game, Robot* ai, Robot* tank)
             
             // If no valid moves, attack as a last resort
             if (playerInDir) {
-                Logger::log("vsTank: Breaking cycle - no valid moves, attacking as absolute last resort");
+                AI_LOG("vsTank: Breaking cycle - no valid moves, attacking as absolute last resort");
                 return Command::Attack;
             } else {
                 // Turn toward tank
-                Direction towardDir = getDirectionTowards(dx, dy);
+                Direction towardDir = getDirectionTowards(game, ai, dx, dy);
                 return getTurnCommand(ai->getDirection(), towardDir);
             }
         }
         
         // First, make sure we're facing the tank
         if (!playerInDir) {
-            Logger::log("vsTank: Adjacent to tank but not facing them. Turning to attack.");
-            Direction towardDir = getDirectionTowards(dx, dy);
+            AI_LOG("vsTank: Adjacent to tank but not facing them. Turning to attack.");
+            Direction towardDir = getDirectionTowards(game, ai, dx, dy);
             return getTurnCommand(ai->getDirection(), towardDir);
         }
         
@@ -632,24 +708,24 @@ Command ScoutAI::vsTank(Game* game, Robot* ai, Robot* tank)
         
         // If we can kill the tank with one attack, prioritize attacking regardless of state
         if (canKillWithOneAttack && playerInDir) {
-            Logger::log("vsTank: Tank can be killed with one attack! Attacking for the kill!");
+            AI_LOG("vsTank: Tank can be killed with one attack! Attacking for the kill!");
             return Command::Attack;
         }
         
         // Against tanks, if we're adjacent and facing them, attack once and then try to move away
         if (!hasAttackedThisTurn) {
-            Logger::log("vsTank: Adjacent to tank and facing them. Attacking once!");
+            AI_LOG("vsTank: Adjacent to tank and facing them. Attacking once!");
             return Command::Attack;
         }
         
         // If we've already attacked this turn but can still kill the tank with another attack, do it
         if (hasAttackedThisTurn && canKillWithOneAttack && playerInDir) {
-            Logger::log("vsTank: Already attacked but Tank can be killed with one more attack! Finishing it off!");
+            AI_LOG("vsTank: Already attacked but Tank can be killed with one more attack! Finishing it off!");
             return Command::Attack;
         }
         
         // After attacking once, always try to escape regardless of remaining moves
-        Logger::log("vsTank: Already attacked this turn. Moving away to safety.");
+        AI_LOG("vsTank: Already attacked this turn. Moving away to safety.");
         Direction awayDir = getDirectionAway(dx, dy);
         
         // Check if we can actually move away before turning
@@ -658,10 +734,10 @@ Command ScoutAI::vsTank(Game* game, Robot* ai, Robot* tank)
         
         // If we can't move away, try any other valid direction except toward the tank
         if (!canMoveAway) {
-            Logger::log("vsTank: Can't move directly away from tank. Trying alternative directions.");
+            AI_LOG("vsTank: Can't move directly away from tank. Trying alternative directions.");
             
             // Try all directions except the one toward the tank
-            Direction towardDir = getDirectionTowards(dx, dy);
+            Direction towardDir = getDirectionTowards(game, ai, dx, dy);
             for (int i = 0; i < 4; i++) {
                 Direction testDir = static_cast<Direction>(i);
                 if (testDir == towardDir) continue; // Skip direction toward tank
@@ -669,10 +745,10 @@ Command ScoutAI::vsTank(Game* game, Robot* ai, Robot* tank)
                 QPoint testPos = getPositionInDirection(aiPos, testDir);
                 if (game->isValidMove(testPos)) {
                     if (ai->getDirection() != testDir) {
-                        Logger::log(QString("vsTank: Found alternative escape direction %1. Turning.").arg(i));
+                        AI_LOG(QString("vsTank: Found alternative escape direction %1. Turning.").arg(i));
                         return getTurnCommand(ai->getDirection(), testDir);
                     } else {
-                        Logger::log("vsTank: Already facing alternative escape direction. Moving.");
+                        AI_LOG("vsTank: Already facing alternative escape direction. Moving.");
                         return Command::MoveForward;
                     }
                 }
@@ -682,50 +758,50 @@ Command ScoutAI::vsTank(Game* game, Robot* ai, Robot* tank)
             // attack again as a last resort
             // If attack will kill the tank, make this clearer in the log
             if (canKillWithOneAttack) {
-                Logger::log("vsTank: No escape paths but can kill tank! Attacking for the kill!");
+                AI_LOG("vsTank: No escape paths but can kill tank! Attacking for the kill!");
             } else {
-                Logger::log("vsTank: Absolutely no escape paths. Attacking again as last resort.");
+                AI_LOG("vsTank: Absolutely no escape paths. Attacking again as last resort.");
             }
             return Command::Attack;
         }
         
         // We can move directly away, so turn if needed
         if (ai->getDirection() != awayDir) {
-            Logger::log(QString("vsTank: Turning to escape direction %1").arg(static_cast<int>(awayDir)));
+            AI_LOG(QString("vsTank: Turning to escape direction %1").arg(static_cast<int>(awayDir)));
             return getTurnCommand(ai->getDirection(), awayDir);
         }
         
         // Already facing away direction, so move
-        Logger::log("vsTank: Moving away from tank in escape direction");
+        AI_LOG("vsTank: Moving away from tank in escape direction");
         return Command::MoveForward;
     }
 
     // If below half health, try to pick up health
     // But if the tank can be killed, prioritize that over healing
-    if (ai->getHealth() < ai->getMaxHealth() / 2 && !canKillWithOneAttack) {
-        Logger::log("vsTank: Scout below 50% HP. Attempting health pickup.");
+    if (ai->getHealth() < ai->getMaxHealth() * params.healthSeekPercent / 100 && !canKillWithOneAttack) {
+        AI_LOG("vsTank: Scout below 50% HP. Attempting health pickup.");
         Command c = tryCollectPickup(game, ai, true);
         if (c != Command::None) {
             return c;
         }
         // Continue with normal strategy if no pickup found
-        Logger::log("vsTank: No health pickup found. Continuing with normal strategy.");
+        AI_LOG("vsTank: No health pickup found. Continuing with normal strategy.");
     }
 
     // Within striking range: attack
-    if (distance >= 2 && distance <= 5) {
+    if (distance >= params.strikeRangeMinVsTank && distance <= params.strikeRangeMaxVsTank) {
         // If we're not adjacent but close, and the tank can be killed in one hit,
         // prioritize moving closer to kill it
         if (canKillWithOneAttack && distance == 2) {
-            Logger::log("vsTank: Tank within range and can be killed! Moving to attack position.");
-            Direction towardDir = getDirectionTowards(dx, dy);
+            AI_LOG("vsTank: Tank within range and can be killed! Moving to attack position.");
+            Direction towardDir = getDirectionTowards(game, ai, dx, dy);
             if (ai->getDirection() != towardDir) {
                 return getTurnCommand(ai->getDirection(), towardDir);
             }
-            return Command::MoveForward;
+            return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
         }
         
-        Logger::log("vsTank: Within striking range. Move towards player.");
+        AI_LOG("vsTank: Within striking range. Move towards player.");
         
         // Find a path that doesn't end adjacent to the player
         Command moveCommand = findSafePath(game, ai, tank);
@@ -734,37 +810,37 @@ Command ScoutAI::vsTank(Game* game, Robot* ai, Robot* tank)
         }
         
         // If we can't find a safe path, default to standard approach
-        Direction towardDir = getDirectionTowards(dx, dy);
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
 
     // Far away: get powerup
     else {
         // If the tank can be killed in one hit, prioritize closing distance
         if (canKillWithOneAttack) {
-            Logger::log("vsTank: Tank far away but can be killed in one hit! Moving toward it.");
-            Direction towardDir = getDirectionTowards(dx, dy);
+            AI_LOG("vsTank: Tank far away but can be killed in one hit! Moving toward it.");
+            Direction towardDir = getDirectionTowards(game, ai, dx, dy);
             if (ai->getDirection() != towardDir) {
                 return getTurnCommand(ai->getDirection(), towardDir);
             }
-            return tryMoveOrBreakWall(game, ai);
+            return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
         }
         
-        Logger::log("vsTank: Tank far away. Try to get pickup.");
+        AI_LOG("vsTank: Tank far away. Try to get pickup.");
         Command c = tryCollectPickup(game, ai, false);
         if (c != Command::None) {
             return c;
         }
         // Continue with movement if no pickup found
-        Logger::log("vsTank: No powerup found. Moving towards player.");
-        Direction towardDir = getDirectionTowards(dx, dy);
+        AI_LOG("vsTank: No powerup found. Moving towards player.");
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
     
     // Default fallback - should not reach here due to the complete else-if chain above
@@ -776,24 +852,25 @@ Command ScoutAI::vsTank(Game* game, Robot* ai, Robot* tank)
  */
 Command ScoutAI::tryCollectPickup(Game* game, Robot* ai, bool preferHealthIfLow)
 {
+    const ScoutParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
-    Logger::log("tryCollectPickup: Searching for pickups.");
+    AI_LOG("tryCollectPickup: Searching for pickups.");
 
-    // Find nearest health pickup within 5 tiles
-    QPoint hpPos = findNearestHealthPickup(game, aiPos, 5);
+    // Find nearest health pickup within the search radius
+    QPoint hpPos = findNearestHealthPickup(game, aiPos, params.pickupSearchRadius);
     int distHP = 999999;
     if (hpPos.x() != -1)
-        distHP = manhattanDistance(aiPos, hpPos);
+        distHP = game->getPathfinding().distance(aiPos, hpPos);
 
-    // Find nearest powerup within 5 tiles
-    QPoint puPos = findNearestPowerUp(game, aiPos, 5);
+    // Find nearest powerup within the search radius
+    QPoint puPos = findNearestPowerUp(game, aiPos, params.pickupSearchRadius);
     int distPU = 999999;
     if (puPos.x() != -1)
-        distPU = manhattanDistance(aiPos, puPos);
+        distPU = game->getPathfinding().distance(aiPos, puPos);
 
     // If no pickups found, fallback
     if (hpPos.x() == -1 && puPos.x() == -1) {
-        Logger::log("tryCollectPickup: No pickups found. Command: None.");
+        AI_LOG("tryCollectPickup: No pickups found. Command: None.");
         return Command::None;
     }
 
@@ -808,26 +885,48 @@ Command ScoutAI::tryCollectPickup(Game* game, Robot* ai, bool preferHealthIfLow)
     QPoint targetPos = goHealth ? hpPos : puPos;
     int dx = targetPos.x() - aiPos.x();
     int dy = targetPos.y() - aiPos.y();
-    Direction targetDir = getDirectionTowards(dx, dy);
+    Direction targetDir = getDirectionTowards(game, ai, dx, dy);
 
-    Logger::log(QString("tryCollectPickup: %1 pickup selected at (%2, %3)")
+    AI_LOG(QString("tryCollectPickup: %1 pickup selected at (%2, %3)")
                 .arg(goHealth ? "Health" : "Powerup")
                 .arg(targetPos.x()).arg(targetPos.y()));
 
     if (ai->getDirection() != targetDir) {
-        Logger::log("Not facing pickup direction. Command: Turn.");
+        AI_LOG("Not facing pickup direction. Command: Turn.");
         return getTurnCommand(ai->getDirection(), targetDir);
     }
-    return tryMoveOrBreakWall(game, ai);
+    return tryMoveOrBreakWall(game, ai, targetPos);
 
-    Logger::log("tryCollectPickup: Fallback reached. Command: None.");
+    AI_LOG("tryCollectPickup: Fallback reached. Command: None.");
     return Command::None;
 }
 
 /**
  *   Movement Helpers
  */
-Command ScoutAI::tryMoveOrBreakWall(Game* game, Robot* ai)
+Command ScoutAI::makeRandomMove(Game* game, Robot* ai)
+{
+    QPoint aiPos = ai->getPosition();
+    Direction openDirs[4];
+    int openCount = 0;
+    for (int i = 0; i < 4; i++) {
+        Direction dir = static_cast<Direction>(i);
+        if (game->isValidMove(getPositionInDirection(aiPos, dir))) {
+            openDirs[openCount++] = dir;
+        }
+    }
+    if (openCount == 0) {
+        return Command::None;
+    }
+
+    Direction dir = openDirs[match.random.bounded(openCount)];
+    if (dir == ai->getDirection()) {
+        return Command::MoveForward;
+    }
+    return getTurnCommand(ai->getDirection(), dir);
+}
+
+Command ScoutAI::tryMoveOrBreakWall(Game* game, Robot* ai, const QPoint& target)
 {
     QPoint aiPos = ai->getPosition();
     Direction currentDir = ai->getDirection();
@@ -843,7 +942,7 @@ Command ScoutAI::tryMoveOrBreakWall(Game* game, Robot* ai)
     // Check if moving forward would place us adjacent to the opponent on our last move
     if (game->isValidMove(forwardPos)) {
         if (wouldEndAdjacentToOpponent(game, ai, opponent, forwardPos)) {
-            Logger::log("Would end adjacent to opponent with last move. Looking for safer option.");
+            AI_LOG("Would end adjacent to opponent with last move. Looking for safer option.");
             
             // Try to find a non-adjacent move
             Direction leftDir = static_cast<Direction>((static_cast<int>(currentDir) + 3) % 4);
@@ -854,13 +953,13 @@ Command ScoutAI::tryMoveOrBreakWall(Game* game, Robot* ai)
             
             // Check left turn
             if (game->isValidMove(leftPos) && !wouldEndAdjacentToOpponent(game, ai, opponent, leftPos)) {
-                Logger::log("Safe move found to the left. Command: TurnLeft.");
+                AI_LOG("Safe move found to the left. Command: TurnLeft.");
                 return getTurnCommand(currentDir, leftDir);
             }
             
             // Check right turn
             if (game->isValidMove(rightPos) && !wouldEndAdjacentToOpponent(game, ai, opponent, rightPos)) {
-                Logger::log("Safe move found to the right. Command: TurnRight.");
+                AI_LOG("Safe move found to the right. Command: TurnRight.");
                 return getTurnCommand(currentDir, rightDir);
             }
             
@@ -869,31 +968,41 @@ Command ScoutAI::tryMoveOrBreakWall(Game* game, Robot* ai)
                                                opponent->getPosition().y() - aiPos.y());
             
             if (awayDir != currentDir) {
-                Logger::log("No safe move found. Trying to turn away from opponent.");
+                AI_LOG("No safe move found. Trying to turn away from opponent.");
                 return getTurnCommand(currentDir, awayDir);
             }
             
             // As a last resort, if the scout has more than one move left, still move forward
             // rather than wasting the turn
             if (ai->getMovesLeft() > 1) {
-                Logger::log("No safe alternatives found, but still have moves left. Moving forward anyway.");
+                AI_LOG("No safe alternatives found, but still have moves left. Moving forward anyway.");
                 return Command::MoveForward;
             }
             
             // If it's really the last move and no good options, just end turn (return None)
-            Logger::log("Last move with no safe options. Ending turn early.");
+            AI_LOG("Last move with no safe options. Ending turn early.");
             return Command::None;
         }
         
-        Logger::log("Forward move is valid and safe. Command: MoveForward.");
+        AI_LOG("Forward move is valid and safe. Command: MoveForward.");
         return Command::MoveForward;
     }
     
-    if (game->isValidPosition(forwardPos) &&
-        game->getCellType(forwardPos) == CellType::Wall)
-    {
-        Logger::log("Wall detected directly ahead. Command: Attack.");
-        return Command::Attack;
+    // Break a wall only where the cheapest route to the target goes through it, otherwise turn the
+    // way the route leaves, unless that step would end the turn next to the opponent
+    Direction routeDir = currentDir;
+    if (game->getPathfinding().bestDirectionTowards(aiPos, currentDir, target, game->getWallDamage(ai), &routeDir)) {
+        QPoint routePos = getPositionInDirection(aiPos, routeDir);
+        bool routeIsWall = game->isValidPosition(routePos) && game->getCellType(routePos) == CellType::Wall;
+        bool routeIsSafe = game->isValidMove(routePos) && !wouldEndAdjacentToOpponent(game, ai, opponent, routePos);
+        if (routeDir == currentDir && routeIsWall) {
+            AI_LOG("Cheapest route goes through the wall ahead. Command: Attack.");
+            return Command::Attack;
+        }
+        if (routeDir != currentDir && (routeIsWall || routeIsSafe)) {
+            AI_LOG("Cheapest route leaves another way. Command: Turn.");
+            return getTurnCommand(currentDir, routeDir);
+        }
     }
 
     // Try turning left/right to find a valid path.
@@ -908,45 +1017,31 @@ Command ScoutAI::tryMoveOrBreakWall(Game* game, Robot* ai)
         bool leftSafe = game->isValidMove(leftPos) && !wouldEndAdjacentToOpponent(game, ai, opponent, leftPos);
 
         if (leftSafe && rightSafe) {
-            Logger::log("Valid move found to the left and right. Command: Random Turn.");
-            return (QRandomGenerator::global()->bounded(2) == 0)
+            AI_LOG("Valid move found to the left and right. Command: Random Turn.");
+            return (match.random.bounded(2) == 0)
                ? getTurnCommand(currentDir, leftDir)
                : getTurnCommand(currentDir, rightDir);
         }
 
         if (leftSafe) {
-            Logger::log("Valid, safe move found to the left. Command: TurnLeft.");
+            AI_LOG("Valid, safe move found to the left. Command: TurnLeft.");
             return getTurnCommand(currentDir, leftDir);
         }
         
         if (game->isValidMove(leftPos) && ai->getMovesLeft() > 1) {
             // Not last move, so okay to go there even if adjacent
-            Logger::log("Valid move found to the left (not last move). Command: TurnLeft.");
-            return getTurnCommand(currentDir, leftDir);
-        }
-
-        if (game->isValidPosition(leftPos) &&
-            game->getCellType(leftPos) == CellType::Wall)
-        {
-            Logger::log("Wall detected on the left. Command: TurnLeft.");
+            AI_LOG("Valid move found to the left (not last move). Command: TurnLeft.");
             return getTurnCommand(currentDir, leftDir);
         }
 
         if (rightSafe) {
-            Logger::log("Valid, safe move found to the right. Command: TurnRight.");
+            AI_LOG("Valid, safe move found to the right. Command: TurnRight.");
             return getTurnCommand(currentDir, rightDir);
         }
         
         if (game->isValidMove(rightPos) && ai->getMovesLeft() > 1) {
             // Not last move, so okay to go there even if adjacent
-            Logger::log("Valid move found to the right (not last move). Command: TurnRight.");
-            return getTurnCommand(currentDir, rightDir);
-        }
-
-        if (game->isValidPosition(rightPos) &&
-            game->getCellType(rightPos) == CellType::Wall)
-        {
-            Logger::log("Wall detected on the right. Command: TurnRight.");
+            AI_LOG("Valid move found to the right (not last move). Command: TurnRight.");
             return getTurnCommand(currentDir, rightDir);
         }
 
@@ -955,25 +1050,25 @@ Command ScoutAI::tryMoveOrBreakWall(Game* game, Robot* ai)
 
     // If it's the last move and we couldn't find a safe option, end turn
     if (ai->getMovesLeft() == 1) {
-        Logger::log("Last move with no safe paths found. Ending turn early.");
+        AI_LOG("Last move with no safe paths found. Ending turn early.");
         return Command::None;
     }
 
-    Logger::log("tryMoveOrBreakWall: No valid moves found. Fallback: Attack.");
+    AI_LOG("tryMoveOrBreakWall: No valid moves found. Fallback: Attack.");
     return Command::Attack;
 }
 
 Command ScoutAI::huntPlayerPosition(Game* game, Robot* ai, int dx, int dy)
 {
-    Direction desiredDir = getDirectionTowards(dx, dy);
+    Direction desiredDir = getDirectionTowards(game, ai, dx, dy);
     Direction currentDir = ai->getDirection();
-    Logger::log("huntPlayerPosition: Hunting enemy based on last known position.");
+    AI_LOG("huntPlayerPosition: Hunting enemy based on last known position.");
     if (currentDir != desiredDir) {
-        Logger::log("Not facing desired direction. Command: Turning.");
+        AI_LOG("Not facing desired direction. Command: Turning.");
         return getTurnCommand(currentDir, desiredDir);
     }
-    Logger::log("Facing desired direction. Attempting to move or break wall.");
-    return tryMoveOrBreakWall(game, ai);
+    AI_LOG("Facing desired direction. Attempting to move or break wall.");
+    return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
 }
 
 /**
@@ -1012,6 +1107,56 @@ Direction ScoutAI::getDirectionTowards(int dx, int dy)
         return (dy > 0) ? Direction::South : Direction::North;
 }
 
+Direction ScoutAI::getDirectionTowards(Game* game, Robot* ai, int dx, int dy)
+{
+    // Follow the cheapest route, which may go through a wall when breaking it is quicker than
+    // walking around. tryMoveOrBreakWall() then attacks the wall once facing it.
+    Direction greedyDir = getDirectionTowards(dx, dy);
+    Direction routeDir = greedyDir;
+    QPoint from = ai->getPosition();
+    if (game->getPathfinding().bestDirectionTowards(from, ai->getDirection(), from + QPoint(dx, dy),
+                                                    game->getWallDamage(ai), &routeDir))
+        return routeDir;
+    return greedyDir;
+}
+
+Direction ScoutAI::getFlankingDirection(Game* game, Robot* ai, Robot* opponent)
+{
+    // Among the steps that bring us closer to the opponent, take the one it threatens least, so
+    // the approach comes round its line of fire instead of through it
+    QPoint aiPos = ai->getPosition();
+    QPoint opponentPos = opponent->getPosition();
+    Direction routeDir = getDirectionTowards(game, ai, opponentPos.x() - aiPos.x(), opponentPos.y() - aiPos.y());
+
+    PathfindingService& pathfinding = game->getPathfinding();
+    int currentDist = pathfinding.distance(aiPos, opponentPos);
+    if (currentDist == PathfindingService::UNREACHABLE) {
+        return routeDir;
+    }
+
+    const InfluenceMap& influence = game->getInfluenceMap(opponent);
+    Direction bestDir = routeDir;
+    int bestThreat = INT_MAX;
+    QPoint routePos = getPositionInDirection(aiPos, routeDir);
+    if (game->isValidMove(routePos) && pathfinding.distance(routePos, opponentPos) < currentDist) {
+        bestThreat = influence.value(InfluenceMap::Threat, routePos);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        Direction dir = static_cast<Direction>(i);
+        QPoint newPos = getPositionInDirection(aiPos, dir);
+        if (!game->isValidMove(newPos) || pathfinding.distance(newPos, opponentPos) >= currentDist) {
+            continue;
+        }
+        int threat = influence.value(InfluenceMap::Threat, newPos);
+        if (threat < bestThreat) {
+            bestThreat = threat;
+            bestDir = dir;
+        }
+    }
+    return bestDir;
+}
+
 Direction ScoutAI::getDirectionAway(int dx, int dy)
 {
     if (std::abs(dx) > std::abs(dy))
@@ -1059,52 +1204,19 @@ QPoint ScoutAI::getPositionInDirection(const QPoint& pos, Direction dir, int ste
  */
 QPoint ScoutAI::findNearestHealthPickup(Game* game, const QPoint& pos, int searchRadius)
 {
-    QPoint best(-1, -1);
-    int minDist = 999999;
-    int size = game->getGridSize();
-
-    for (int y = std::max(0, pos.y() - searchRadius); y <= std::min(size - 1, pos.y() + searchRadius); ++y) {
-        for (int x = std::max(0, pos.x() - searchRadius); x <= std::min(size - 1, pos.x() + searchRadius); ++x) {
-            QPoint check(x, y);
-            if (game->getCellType(check) == CellType::HealthPickup) {
-                int d = manhattanDistance(pos, check);
-                if (d < minDist) {
-                    minDist = d;
-                    best = check;
-                }
-            }
-        }
-    }
-    return best;
+    // The game keeps an index of pickups, so only actual pickups are looked at
+    return game->findNearestPickup(pos, CellType::HealthPickup, searchRadius);
 }
 
 QPoint ScoutAI::findNearestPowerUp(Game* game, const QPoint& pos, int searchRadius)
 {
-    QPoint best(-1, -1);
-    int minDist = 999999;
-    int size = game->getGridSize();
-
-    for (int y = std::max(0, pos.y() - searchRadius); y <= std::min(size - 1, pos.y() + searchRadius); ++y) {
-        for (int x = std::max(0, pos.x() - searchRadius); x <= std::min(size - 1, pos.x() + searchRadius); ++x) {
-            QPoint check(x, y);
-            CellType ctype = game->getCellType(check);
-            if (ctype == CellType::LaserPowerUp ||
-                ctype == CellType::MissilePowerUp ||
-                ctype == CellType::BombPowerUp)
-            {
-                int d = manhattanDistance(pos, check);
-                if (d < minDist) {
-                    minDist = d;
-                    best = check;
-                }
-            }
-        }
-    }
-    return best;
+    // The game keeps an index of pickups, so only actual pickups are looked at
+    return game->findNearestPowerUp(pos, searchRadius);
 }
 
 Command ScoutAI::directLineAttack(Game* game, Robot* ai, Robot* player)
 {
+    const ScoutParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint playerPos = player->getPosition();
     int dx = playerPos.x() - aiPos.x();
@@ -1113,24 +1225,24 @@ Command ScoutAI::directLineAttack(Game* game, Robot* ai, Robot* player)
 
     if (distance <= 1 && (aiPos.x() == playerPos.x() || aiPos.y() == playerPos.y())) {
         Direction desiredDir = getDirectionTowards(dx, dy);
-        if (ai->getHealth() < static_cast<int>(ai->getMaxHealth() * 0.4)) {
-            // Check if health pickup is available within 5 tiles
-            QPoint hpPos = findNearestHealthPickup(game, aiPos, 5);
+        if (ai->getHealth() < ai->getMaxHealth() * params.criticalHealthPercent / 100) {
+            // Check if health pickup is available within the search radius
+            QPoint hpPos = findNearestHealthPickup(game, aiPos, params.pickupSearchRadius);
             if (hpPos.x() != -1) {
-                Logger::log("directLineAttack: Very low health and health pickup available. Try to collect health.");
+                AI_LOG("directLineAttack: Very low health and health pickup available. Try to collect health.");
                 return tryCollectPickup(game, ai, true);
             }
         }
         if (ai->getDirection() != desiredDir) {
-            Logger::log("directLineAttack: Not facing player. Command: Turn.");
+            AI_LOG("directLineAttack: Not facing player. Command: Turn.");
             return getTurnCommand(ai->getDirection(), desiredDir);
         }
         if (player->getHealth() < ai->getAttackDamage()) {
-            Logger::log("directLineAttack: Sure kill. Command: Attack.");
+            AI_LOG("directLineAttack: Sure kill. Command: Attack.");
             return Command::Attack;
         }
 
-        Logger::log("directLineAttack: Conditions met. Command: Attack.");
+        AI_LOG("directLineAttack: Conditions met. Command: Attack.");
         return Command::Attack;
     }
     
@@ -1147,13 +1259,13 @@ bool ScoutAI::wouldEndAdjacentToOpponent(Game* game, Robot* ai, Robot* opponent,
         return false;
     }
     
-    QPoint opponentPos = opponent->getPosition();
-    int newDistance = manhattanDistance(newPos, opponentPos);
+    // The threat map knows about walls, the Sniper's range and any power-up the opponent holds
+    int movesToHit = game->getThreatMap(opponent).movesToHit(newPos);
     
-    Logger::log(QString("Checking if move would end adjacent to opponent: distance=%1").arg(newDistance));
+    AI_LOG(QString("Checking if move would end in the opponent's line of fire: movesToHit=%1").arg(movesToHit));
     
-    // Check if this would place us adjacent (distance=1) to the opponent
-    return (newDistance == 1);
+    // Check if the opponent could hit us there without moving first
+    return (movesToHit <= 1);
 }
 
 /**
@@ -1161,41 +1273,38 @@ bool ScoutAI::wouldEndAdjacentToOpponent(Game* game, Robot* ai, Robot* opponent,
  * Returns a command to execute or Command::None if no safe path found
  */
 Command ScoutAI::findSafePath(Game* game, Robot* ai, Robot* opponent) {
+    const ScoutParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint opponentPos = opponent->getPosition();
     Direction currentDir = ai->getDirection();
     int movesLeft = ai->getMovesLeft();
     
-    // Track if we've tried to turn recently but need to move forward now
-    static Direction lastTurnDir = Direction::North;  // Initial value doesn't matter
-    static bool justTurned = false;
-    
     // If we just turned last time, we should move forward now
-    if (justTurned && currentDir == lastTurnDir) {
-        Logger::log("findSafePath: Just turned last time, now moving forward to avoid loop.");
-        justTurned = false;  // Reset the flag
+    if (match.justTurned && currentDir == match.lastTurnDir) {
+        AI_LOG("findSafePath: Just turned last time, now moving forward to avoid loop.");
+        match.justTurned = false;  // Reset the flag
         
         // Check if moving forward is valid
         QPoint forwardPos = getPositionInDirection(aiPos, currentDir);
         if (game->isValidMove(forwardPos)) {
             // Reset turn counter since we're moving
-            turnCounter = 0;
+            match.turnCounter = 0;
             return Command::MoveForward;
         }
     }
     
     // Increase turn counter to detect infinite turning
-    turnCounter++;
+    match.turnCounter++;
     
     // If we've been turning too much without moving, force forward movement
-    if (turnCounter > 3) {  // Reduced from 5 to be more aggressive about breaking loops
-        Logger::log(QString("findSafePath: Detected excessive turning (%1 turns). Forcing movement.").arg(turnCounter));
-        turnCounter = 0;
+    if (match.turnCounter > params.turnLimit) {
+        AI_LOG(QString("findSafePath: Detected excessive turning (%1 turns). Forcing movement.").arg(match.turnCounter));
+        match.turnCounter = 0;
         
         // Try starting with the current direction
         QPoint forwardPos = getPositionInDirection(aiPos, currentDir);
         if (game->isValidMove(forwardPos)) {
-            Logger::log("findSafePath: Can move forward in current direction. Moving forward.");
+            AI_LOG("findSafePath: Can move forward in current direction. Moving forward.");
             return Command::MoveForward;
         }
         
@@ -1207,15 +1316,15 @@ Command ScoutAI::findSafePath(Game* game, Robot* ai, Robot* opponent) {
             QPoint newPos = getPositionInDirection(aiPos, testDir);
             
             if (game->isValidMove(newPos)) {
-                Logger::log(QString("findSafePath: Forcing turn to direction %1 to break loop.").arg(i));
-                lastTurnDir = testDir;
-                justTurned = true;  // Mark that we just turned
+                AI_LOG(QString("findSafePath: Forcing turn to direction %1 to break loop.").arg(i));
+                match.lastTurnDir = testDir;
+                match.justTurned = true;  // Mark that we just turned
                 return getTurnCommand(currentDir, testDir);
             }
         }
         
         // If absolutely no valid move exists, try to attack
-        Logger::log("findSafePath: No valid move found. Trying to attack if there's a wall.");
+        AI_LOG("findSafePath: No valid move found. Trying to attack if there's a wall.");
         QPoint frontPos = getPositionInDirection(aiPos, currentDir);
         if (game->isValidPosition(frontPos) && 
             game->getCellType(frontPos) == CellType::Wall) {
@@ -1223,32 +1332,32 @@ Command ScoutAI::findSafePath(Game* game, Robot* ai, Robot* opponent) {
         }
     }
     
-    Logger::log(QString("findSafePath: Scout has %1 moves left").arg(movesLeft));
+    AI_LOG(QString("findSafePath: Scout has %1 moves left").arg(movesLeft));
     
     // Only worry about adjacency on the last move
     if (movesLeft > 1) {
         // If we have multiple moves, we can move directly towards the opponent
-        Direction towardDir = getDirectionTowards(opponentPos.x() - aiPos.x(), 
-                                                 opponentPos.y() - aiPos.y());
+        Direction towardDir = getDirectionTowards(game, ai, opponentPos.x() - aiPos.x(),
+                                                  opponentPos.y() - aiPos.y());
                                                  
         // If we need to turn, do that first
         if (currentDir != towardDir) {
-            Logger::log(QString("findSafePath: Multiple moves left, turning towards opponent from dir %1 to %2.")
+            AI_LOG(QString("findSafePath: Multiple moves left, turning towards opponent from dir %1 to %2.")
                        .arg(static_cast<int>(currentDir))
                        .arg(static_cast<int>(towardDir)));
             
-            lastTurnDir = towardDir;
-            justTurned = true;  // Mark that we just turned
+            match.lastTurnDir = towardDir;
+            match.justTurned = true;  // Mark that we just turned
             return getTurnCommand(currentDir, towardDir);
         }
         
         // Already facing the right direction, so move forward
         QPoint forwardPos = getPositionInDirection(aiPos, currentDir);
         if (game->isValidMove(forwardPos)) {
-            Logger::log("findSafePath: Multiple moves left, moving forward.");
-            justTurned = false;  // Reset the flag since we're moving
+            AI_LOG("findSafePath: Multiple moves left, moving forward.");
+            match.justTurned = false;  // Reset the flag since we're moving
             // Reset turn counter since we're moving
-            turnCounter = 0;
+            match.turnCounter = 0;
             return Command::MoveForward;
         }
     }
@@ -1260,17 +1369,18 @@ Command ScoutAI::findSafePath(Game* game, Robot* ai, Robot* opponent) {
     
     // Get the distance to the opponent
     int currentDistance = manhattanDistance(aiPos, opponentPos);
-    Logger::log(QString("findSafePath: Current distance to opponent = %1").arg(currentDistance));
+    AI_LOG(QString("findSafePath: Current distance to opponent = %1").arg(currentDistance));
     
     // If we're already at distance 2, we want to stay there (ideal attack position)
     if (currentDistance == 2) {
         // First try to move forward if we're already facing correctly
         QPoint forwardPos = getPositionInDirection(aiPos, currentDir);
-        if (game->isValidMove(forwardPos) && manhattanDistance(forwardPos, opponentPos) == 2) {
-            Logger::log("findSafePath: Already facing direction that maintains distance 2. Moving forward.");
+        if (game->isValidMove(forwardPos) && manhattanDistance(forwardPos, opponentPos) == 2 &&
+            !wouldEndAdjacentToOpponent(game, ai, opponent, forwardPos)) {
+            AI_LOG("findSafePath: Already facing direction that maintains distance 2. Moving forward.");
             // Reset turn counter since we're moving
-            turnCounter = 0;
-            justTurned = false;  // Reset the flag since we're moving
+            match.turnCounter = 0;
+            match.justTurned = false;  // Reset the flag since we're moving
             return Command::MoveForward;
         }
         
@@ -1281,10 +1391,11 @@ Command ScoutAI::findSafePath(Game* game, Robot* ai, Robot* opponent) {
             
             QPoint newPos = getPositionInDirection(aiPos, testDir);
             
-            if (game->isValidMove(newPos) && manhattanDistance(newPos, opponentPos) == 2) {
-                Logger::log(QString("findSafePath: Found direction %1 that maintains distance 2. Turning.").arg(i));
-                lastTurnDir = testDir;
-                justTurned = true;  // Mark that we just turned
+            if (game->isValidMove(newPos) && manhattanDistance(newPos, opponentPos) == 2 &&
+                !wouldEndAdjacentToOpponent(game, ai, opponent, newPos)) {
+                AI_LOG(QString("findSafePath: Found direction %1 that maintains distance 2. Turning.").arg(i));
+                match.lastTurnDir = testDir;
+                match.justTurned = true;  // Mark that we just turned
                 return getTurnCommand(currentDir, testDir);
             }
         }
@@ -1296,11 +1407,12 @@ Command ScoutAI::findSafePath(Game* game, Robot* ai, Robot* opponent) {
         QPoint forwardPos = getPositionInDirection(aiPos, currentDir);
         if (game->isValidMove(forwardPos)) {
             int forwardDist = manhattanDistance(forwardPos, opponentPos);
-            if ((forwardDist == 2) || (forwardDist < currentDistance && forwardDist > 1)) {
-                Logger::log("findSafePath: Moving forward reduces distance appropriately. Moving forward.");
+            if (((forwardDist == 2) || (forwardDist < currentDistance && forwardDist > 1)) &&
+                !wouldEndAdjacentToOpponent(game, ai, opponent, forwardPos)) {
+                AI_LOG("findSafePath: Moving forward reduces distance appropriately. Moving forward.");
                 // Reset turn counter since we're moving
-                turnCounter = 0;
-                justTurned = false;  // Reset the flag since we're moving
+                match.turnCounter = 0;
+                match.justTurned = false;  // Reset the flag since we're moving
                 return Command::MoveForward;
             }
         }
@@ -1316,7 +1428,7 @@ Command ScoutAI::findSafePath(Game* game, Robot* ai, Robot* opponent) {
             
             QPoint newPos = getPositionInDirection(aiPos, testDir);
             
-            if (game->isValidMove(newPos)) {
+            if (game->isValidMove(newPos) && !wouldEndAdjacentToOpponent(game, ai, opponent, newPos)) {
                 int newDist = manhattanDistance(newPos, opponentPos);
                 
                 // Prefer distance of 2 over anything else
@@ -1338,11 +1450,11 @@ Command ScoutAI::findSafePath(Game* game, Robot* ai, Robot* opponent) {
         
         if (foundBetter) {
             // We found a better direction, so turn that way
-            Logger::log(QString("findSafePath: Found better direction %1 with distance %2. Turning.")
+            AI_LOG(QString("findSafePath: Found better direction %1 with distance %2. Turning.")
                        .arg(static_cast<int>(bestDir))
                        .arg(bestDist));
-            lastTurnDir = bestDir;
-            justTurned = true;  // Mark that we just turned
+            match.lastTurnDir = bestDir;
+            match.justTurned = true;  // Mark that we just turned
             return getTurnCommand(currentDir, bestDir);
         }
     }
@@ -1356,17 +1468,17 @@ Command ScoutAI::findSafePath(Game* game, Robot* ai, Robot* opponent) {
         if (currentDir == awayDir) {
             QPoint awayPos = getPositionInDirection(aiPos, awayDir);
             if (game->isValidMove(awayPos)) {
-                Logger::log("findSafePath: Already facing away from opponent. Moving forward.");
+                AI_LOG("findSafePath: Already facing away from opponent. Moving forward.");
                 // Reset turn counter since we're moving
-                turnCounter = 0;
-                justTurned = false;  // Reset the flag since we're moving
+                match.turnCounter = 0;
+                match.justTurned = false;  // Reset the flag since we're moving
                 return Command::MoveForward;
             }
         } else {
             // Need to turn away
-            Logger::log("findSafePath: Too close. Turning away from opponent.");
-            lastTurnDir = awayDir;
-            justTurned = true;  // Mark that we just turned
+            AI_LOG("findSafePath: Too close. Turning away from opponent.");
+            match.lastTurnDir = awayDir;
+            match.justTurned = true;  // Mark that we just turned
             return getTurnCommand(currentDir, awayDir);
         }
     }
@@ -1376,9 +1488,9 @@ Command ScoutAI::findSafePath(Game* game, Robot* ai, Robot* opponent) {
     // First, try moving forward if possible
     QPoint forwardPos = getPositionInDirection(aiPos, currentDir);
     if (game->isValidMove(forwardPos)) {
-        Logger::log("findSafePath: Fallback - already facing a valid direction. Moving forward.");
-        turnCounter = 0;
-        justTurned = false;  // Reset the flag since we're moving
+        AI_LOG("findSafePath: Fallback - already facing a valid direction. Moving forward.");
+        match.turnCounter = 0;
+        match.justTurned = false;  // Reset the flag since we're moving
         return Command::MoveForward;
     }
     
@@ -1390,17 +1502,17 @@ Command ScoutAI::findSafePath(Game* game, Robot* ai, Robot* opponent) {
         QPoint newPos = getPositionInDirection(aiPos, testDir);
         
         if (game->isValidMove(newPos)) {
-            Logger::log(QString("findSafePath: Fallback - turning to valid direction %1.").arg(i));
-            lastTurnDir = testDir;
-            justTurned = true;  // Mark that we just turned
+            AI_LOG(QString("findSafePath: Fallback - turning to valid direction %1.").arg(i));
+            match.lastTurnDir = testDir;
+            match.justTurned = true;  // Mark that we just turned
             return getTurnCommand(currentDir, testDir);
         }
     }
     
     // If we can't find a good path, indicate failure
-    Logger::log("findSafePath: No path found at all.");
+    AI_LOG("findSafePath: No path found at all.");
     // Reset turn counter since we're giving up
-    turnCounter = 0;
-    justTurned = false;  // Reset the flag since we're giving up
+    match.turnCounter = 0;
+    match.justTurned = false;  // Reset the flag since we're giving up
     return Command::None;
 }
\ No newline at end of file
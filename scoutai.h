@@ -3,6 +3,8 @@
 
 #include <QObject>
 #include <QPoint>
+#include "aiinterface.h"
+#include "aiparameters.h"
 
 // Forward declarations
 class Game;
@@ -22,7 +24,7 @@ enum class GameDifficulty;
  * 
  * @author Group 17
  */
-class ScoutAI : public QObject
+class ScoutAI final : public QObject, public AIInterface
 {
     Q_OBJECT
 public:
@@ -42,21 +44,73 @@ public:
      * @param player Pointer to the opponent robot
      * @return Command to execute
      */
-    Command calculateMove(Game* game, Robot* ai, Robot* player);
+    Command calculateMove(Game* game, Robot* ai, Robot* player) override;
+
+    /**
+     * @brief Forgets everything remembered about the current match
+     *
+     * Called before the instance plays another match, so nothing carries over from one match
+     * to the next.
+     */
+    void reset() override;
+
+    /// @brief Seeds the choices between equally good moves, the current match starts drawing again
+    /// @param seed - the seed, the same seed gives the same choices
+    void setSeed(quint32 seed);
+
+    /**
+     * @brief Sets the thresholds the Scout decides by in games of a difficulty
+     * @param difficulty The difficulty of the games
+     * @param parameters The thresholds, AIParameterSets::defaults() until set
+     */
+    void setParameters(GameDifficulty difficulty, const ScoutParameters& parameters);
+    /**
+     * @param difficulty A difficulty
+     * @return The thresholds the Scout decides by in games of the difficulty
+     */
+    const ScoutParameters& getParameters(GameDifficulty difficulty) const;
+    /// @return a 64-bit hash of the thresholds of every difficulty, part of the key of cached decisions
+    quint64 hashParameters() const { return parametersHash; }
 
 private:
-    QPoint lastPlayerPosition;  ///< Last known position of the opponent
-    int    lastPlayerHealth;    ///< Last known health of the opponent
+    /// Everything the Scout remembers during a match, one copy per instance
+    struct MatchState {
+        QPoint lastPlayerPosition = QPoint(-1, -1); ///< Last known position of the opponent
+        int    lastPlayerHealth = 0;                ///< Last known health of the opponent
+
+        QPoint lastAiPosition = QPoint(-1, -1);     ///< Last position of the AI
+        int    samePositionCounter = 0;             ///< Counter for how many turns the AI has been in the same position
 
-    QPoint lastAiPosition;      ///< Last position of the AI
-    int    samePositionCounter; ///< Counter for how many turns the AI has been in the same position
+        int consecutiveTurnCount = 0;               ///< Counter for consecutive turns
+        int moveCounter = 0;                        ///< Counter for movement tracking
+        int turnCounter = 0;                        ///< Counter to detect excessive turning without movement
+        bool isCirclingClockwise = true;            ///< Flag for circling direction
 
-    int consecutiveTurnCount;   ///< Counter for consecutive turns
-    int moveCounter;            ///< Counter for movement tracking
-    int turnCounter;            ///< Counter to detect excessive turning without movement
-    bool isCirclingClockwise;   ///< Flag for circling direction
+        Direction lastTurnDir = Direction();        ///< Direction of the last turn made by findSafePath
+        bool justTurned = false;                    ///< TRUE if findSafePath turned and should now move forward
+        AIRandom random;                            ///< Draws the choices between equally good moves
+    };
+    MatchState match;
+    /// Seed of the random choices, every match starts from it
+    quint32 seed;
+    /// Thresholds per difficulty, indexed by GameDifficulty
+    ScoutParameters parameters[3];
+    quint64 parametersHash;
+
+public:
+    /// What the Scout remembers about the current match
+    using Memory = MatchState;
+    /// @return what the Scout remembers, cached together with its decisions by RobotAI
+    const MatchState& getMemory() const { return match; }
+    /// @brief Restores what the Scout remembered after a decision taken from the cache
+    void setMemory(const MatchState& memory) { match = memory; }
+    /// @return a 64-bit hash of what the Scout remembers, part of the key of cached decisions
+    quint64 hashMemory() const;
 
 private:
+    const ScoutParameters& parametersFor(Game* game) const;
+    void updateParametersHash();
+
     /**
      * @brief Default strategy when no specialized strategy is available
      * @param game Pointer to the current game state
@@ -144,6 +198,25 @@ private:
      * @return Direction towards the target
      */
     Direction getDirectionTowards(int dx, int dy);
+
+    /**
+     * @brief Get the direction the cheapest route to a target starts in, possibly through a wall
+     * @param game Pointer to the game
+     * @param ai Pointer to the AI robot
+     * @param dx X-coordinate difference to the target
+     * @param dy Y-coordinate difference to the target
+     * @return Direction along the path, or towards the target if it cannot be reached
+     */
+    Direction getDirectionTowards(Game* game, Robot* ai, int dx, int dy);
+
+    /**
+     * @brief Get the direction of the least threatened step that still closes in on the opponent
+     * @param game Pointer to the game
+     * @param ai Pointer to the AI robot
+     * @param opponent Pointer to the opponent robot
+     * @return Direction to step in, or along the cheapest route if no step gets closer
+     */
+    Direction getFlankingDirection(Game* game, Robot* ai, Robot* opponent);
     
     /**
      * @brief Get the direction away from a target
@@ -171,12 +244,22 @@ private:
     QPoint    getPositionInDirection(const QPoint& pos, Direction dir, int steps = 1);
 
     /**
-     * @brief Try to move forward or break a wall if movement is blocked
+     * @brief Try to move forward, or if movement is blocked break the wall ahead when the
+     * cheapest route to the target goes through it
      * @param game Pointer to the current game state
      * @param ai Pointer to the Scout robot
+     * @param target The cell the Scout is heading for
      * @return Command to execute
      */
-    Command tryMoveOrBreakWall(Game* game, Robot* ai);
+    Command tryMoveOrBreakWall(Game* game, Robot* ai, const QPoint& target);
+
+    /**
+     * @brief Step or turn towards a random open neighbour
+     * @param game Pointer to the current game state
+     * @param ai Pointer to the Scout robot
+     * @return Command to execute, Command::None if the Scout is walled in
+     */
+    Command makeRandomMove(Game* game, Robot* ai);
 
     /**
      * @brief Hunt the player based on their last known position
@@ -226,7 +309,7 @@ private:
      * @param ai Pointer to the Scout robot
      * @param opponent Pointer to the opponent robot
      * @param newPos The potential new position
-     * @return true if the new position would be adjacent to the opponent, false otherwise
+     * @return true if the opponent could attack the new position without moving, false otherwise
      */
     bool wouldEndAdjacentToOpponent(Game* game, Robot* ai, Robot* opponent, const QPoint& newPos);
     
@@ -5,20 +5,91 @@
 
 #include <QRandomGenerator>
 #include <algorithm>
+#include <climits>
+
+namespace {
+// Weights of the positional score used against a Scout
+const int THREAT_WEIGHT = 4;
+const int PICKUP_WEIGHT = 1;
+const int COVER_WEIGHT = 1;
+const int LANE_BONUS = 256;
+const int DISTANCE_PENALTY = 64;
+const int VANTAGE_WEIGHT = 16;
+const int DEAD_END_PENALTY = 128;
+}
 
 // Constructor
 SniperAI::SniperAI(QObject* parent)
-    : QObject(parent),
-      lastPlayerPosition(-1, -1),
-      lastPlayerHealth(0),
-      lastAiPosition(-1, -1),
-      samePositionCounter(0),
-      consecutiveTurnCount(0),
-      moveCounter(0),
-      turnCounter(0),
-      isCirclingClockwise(true)
+    : QObject(parent)
+    , seed(QRandomGenerator::global()->generate())
+{
+    match.random = AIRandom(seed);
+    AIParameterSets defaults = AIParameterSets::defaults();
+    for (GameDifficulty difficulty : {GameDifficulty::Easy, GameDifficulty::Medium, GameDifficulty::Hard}) {
+        parameters[static_cast<int>(difficulty)] = defaults.at(difficulty).sniper;
+    }
+    updateParametersHash();
+    AI_LOG("SniperAI initialized.");
+}
+
+void SniperAI::setParameters(GameDifficulty difficulty, const SniperParameters& newParameters)
+{
+    parameters[static_cast<int>(difficulty)] = newParameters;
+    updateParametersHash();
+}
+
+const SniperParameters& SniperAI::getParameters(GameDifficulty difficulty) const
+{
+    return parameters[static_cast<int>(difficulty)];
+}
+
+const SniperParameters& SniperAI::parametersFor(Game* game) const
 {
-    Logger::log("SniperAI initialized.");
+    return parameters[static_cast<int>(game->getDifficulty())];
+}
+
+void SniperAI::updateParametersHash()
+{
+    parametersHash = 0;
+    for (const SniperParameters& set : parameters) {
+        parametersHash = parametersHash * 1099511628211ULL ^ ::hashParameters(set);
+    }
+}
+
+void SniperAI::reset()
+{
+    match = MatchState();
+    match.random = AIRandom(seed);
+}
+
+void SniperAI::setSeed(quint32 newSeed)
+{
+    seed = newSeed;
+    match.random = AIRandom(seed);
+}
+
+quint64 SniperAI::hashMemory() const
+{
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](int value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            hash ^= static_cast<quint8>(value >> shift);
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(match.lastPlayerPosition.x());
+    mix(match.lastPlayerPosition.y());
+    mix(match.lastPlayerHealth);
+    mix(match.lastAiPosition.x());
+    mix(match.lastAiPosition.y());
+    mix(match.samePositionCounter);
+    mix(match.consecutiveTurnCount);
+    mix(match.moveCounter);
+    mix(match.turnCounter);
+    mix(match.isCirclingClockwise);
+    mix(static_cast<int>(match.random.state));
+    mix(static_cast<int>(match.random.state >> 32));
+    return hash;
 }
 
 /**
@@ -26,29 +97,30 @@ SniperAI::SniperAI(QObject* parent)
  */
 Command SniperAI::calculateMove(Game* game, Robot* ai, Robot* player)
 {
+    const SniperParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
-    Logger::log(QString("=================================================="));
-    Logger::log(QString("SniperAI::calculateMove: Sniper at (%1, %2)").arg(aiPos.x()).arg(aiPos.y()));
+    AI_LOG(QString("=================================================="));
+    AI_LOG(QString("SniperAI::calculateMove: Sniper at (%1, %2)").arg(aiPos.x()).arg(aiPos.y()));
 
     // Check if Sniper is stuck (has not moved from lastAiPosition)
-    if (aiPos == lastAiPosition) {
-        samePositionCounter++;
-        Logger::log(QString("Sniper did not move. samePositionCounter increased to %1").arg(samePositionCounter));
+    if (aiPos == match.lastAiPosition) {
+        match.samePositionCounter++;
+        AI_LOG(QString("Sniper did not move. samePositionCounter increased to %1").arg(match.samePositionCounter));
     } else {
-        samePositionCounter = 0;
-        lastAiPosition = aiPos;
-        Logger::log("Sniper moved. samePositionCounter reset.");
+        match.samePositionCounter = 0;
+        match.lastAiPosition = aiPos;
+        AI_LOG("Sniper moved. samePositionCounter reset.");
     }
 
-    // If stuck for 5 consecutive attempts, attempt to break out:
-    if (samePositionCounter > 5) {
-        Logger::log("Sniper might be stuck. Attempting break-out.");
-        samePositionCounter = 0;
+    // If stuck for too many consecutive attempts, attempt to break out:
+    if (match.samePositionCounter > params.stuckLimit) {
+        AI_LOG("Sniper might be stuck. Attempting break-out.");
+        match.samePositionCounter = 0;
 
         // Check if  wall ahead
         QPoint frontPos = getPositionInDirection(aiPos, ai->getDirection());
         if (game->isValidPosition(frontPos) && (game->getCellType(frontPos) == CellType::Wall)) {
-            Logger::log("Wall in front while stuck. Command: Attack.");
+            AI_LOG("Wall in front while stuck. Command: Attack.");
             return Command::Attack;
         }
 
@@ -60,30 +132,39 @@ Command SniperAI::calculateMove(Game* game, Robot* ai, Robot* player)
         int distance = std::abs(dx) + std::abs(dy);
         bool canSee = hasLineOfSight(game, aiPos, plrPos);
         bool playerInDir = isInDirection(dx, dy, ai->getDirection());
-        if (canSee && playerInDir && distance <= 3) {
-            Logger::log("Player in front while stuck. Command: Attack.");
+        if (canSee && playerInDir && distance <= params.stuckAttackRange) {
+            AI_LOG("Player in front while stuck. Command: Attack.");
             return Command::Attack;
         }
 
         // If nothing in front, try to move forward if valid
         if (game->isValidMove(frontPos)) {
-            Logger::log("Path clear while stuck. Command: MoveForward.");
+            AI_LOG("Path clear while stuck. Command: MoveForward.");
             return Command::MoveForward;
         }
 
         // Otherwise, attack randomly (fallback)
-        Logger::log("No valid move while stuck. Command: Attack.");
+        AI_LOG("No valid move while stuck. Command: Attack.");
         return Command::Attack;
     }
 
     // Track player's position and health
-    lastPlayerPosition = player->getPosition();
-    lastPlayerHealth   = player->getHealth();
-    Logger::log(QString("Player at (%1, %2) with health %3")
-                .arg(lastPlayerPosition.x()).arg(lastPlayerPosition.y()).arg(lastPlayerHealth));
+    match.lastPlayerPosition = player->getPosition();
+    match.lastPlayerHealth   = player->getHealth();
+    AI_LOG(QString("Player at (%1, %2) with health %3")
+                .arg(match.lastPlayerPosition.x()).arg(match.lastPlayerPosition.y()).arg(match.lastPlayerHealth));
+
+    // Weaker difficulties give up some moves to chance
+    if (match.random.bounded(100) < params.randomMovePercent) {
+        Command randomMove = makeRandomMove(game, ai);
+        if (randomMove != Command::None) {
+            AI_LOG("Making a random move.");
+            return randomMove;
+        }
+    }
 
     // Check for a direct line attack
-    Logger::log("Checking for direct line attack opportunity.");
+    AI_LOG("Checking for direct line attack opportunity.");
     Command directAttackCmd = directLineAttack(game, ai, player);
     if (directAttackCmd != Command::None) {
         return directAttackCmd;
@@ -94,7 +175,7 @@ Command SniperAI::calculateMove(Game* game, Robot* ai, Robot* player)
 
     // If Easy, do simpler logic
     if (diff == GameDifficulty::Easy) {
-        Logger::log("Using normal Sniper logic for Easy difficulty.");
+        AI_LOG("Using normal Sniper logic for Easy difficulty.");
         return calculateSniperNormal(game, ai, player);
     }
 
@@ -103,16 +184,16 @@ Command SniperAI::calculateMove(Game* game, Robot* ai, Robot* player)
     switch (enemyType)
     {
     case RobotType::Scout:
-        Logger::log("Using specialized logic: vsScout.");
+        AI_LOG("Using specialized logic: vsScout.");
         return vsScout(game, ai, player);
     case RobotType::Tank:
-        Logger::log("Using specialized logic: vsTank.");
+        AI_LOG("Using specialized logic: vsTank.");
         return vsTank(game, ai, player);
     case RobotType::Sniper:
-        Logger::log("Using specialized logic: vsSniper.");
+        AI_LOG("Using specialized logic: vsSniper.");
         return vsSniper(game, ai, player);
     default:
-        Logger::log("Unknown enemy type. Defaulting to vsScout.");
+        AI_LOG("Unknown enemy type. Defaulting to vsScout.");
         return vsScout(game, ai, player);
     }
 }
@@ -128,7 +209,7 @@ Command SniperAI::calculateSniperNormal(Game* game, Robot* ai, Robot* player)
     int dy = plrPos.y() - aiPos.y();
     int distance = std::abs(dx) + std::abs(dy);
 
-    Logger::log(QString("calculateSniperNormal: AI(%1,%2), Player(%3,%4), distance %5")
+    AI_LOG(QString("calculateSniperNormal: AI(%1,%2), Player(%3,%4), distance %5")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(plrPos.x()).arg(plrPos.y())
                 .arg(distance));
@@ -139,16 +220,16 @@ Command SniperAI::calculateSniperNormal(Game* game, Robot* ai, Robot* player)
     Q_UNUSED(playerInDir);
 
     // Move towards the player
-    Logger::log("Player not within range. Closing in.");
-    Direction towardDir = getDirectionTowards(dx, dy);
+    AI_LOG("Player not within range. Closing in.");
+    Direction towardDir = getDirectionTowards(game, ai, dx, dy);
     if (ai->getDirection() != towardDir) {
-        Logger::log("Not facing player. Command: Turn.");
+        AI_LOG("Not facing player. Command: Turn.");
         return getTurnCommand(ai->getDirection(), towardDir);
     }
-    return tryMoveOrBreakWall(game, ai);
+    return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
 
     // Fallback
-    Logger::log("Fallback reached in calculateSniperNormal. Command: Attack.");
+    AI_LOG("Fallback reached in calculateSniperNormal. Command: Attack.");
     return Command::Attack;
 }
 
@@ -158,13 +239,14 @@ Command SniperAI::calculateSniperNormal(Game* game, Robot* ai, Robot* player)
  */
 Command SniperAI::vsScout(Game* game, Robot* ai, Robot* scout)
 {
+    const SniperParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint plrPos = scout->getPosition();
     int dx = plrPos.x() - aiPos.x();
     int dy = plrPos.y() - aiPos.y();
     int distance = std::abs(dx) + std::abs(dy);
 
-    Logger::log(QString("vsScout: AI(%1,%2), Scout(%3,%4), distance %5")
+    AI_LOG(QString("vsScout: AI(%1,%2), Scout(%3,%4), distance %5")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(plrPos.x()).arg(plrPos.y())
                 .arg(distance));
@@ -177,54 +259,67 @@ Command SniperAI::vsScout(Game* game, Robot* ai, Robot* scout)
     Q_UNUSED(diff);
 
     // If below half health, try to pick up health
-    if (ai->getHealth() < ai->getMaxHealth() / 2) {
-        Logger::log("vsScout: Sniper below 50% HP. Trying to pick up health.");
+    if (ai->getHealth() < ai->getMaxHealth() * params.healthSeekPercent / 100) {
+        AI_LOG("vsScout: Sniper below 50% HP. Trying to pick up health.");
         Command c = tryCollectPickup(game, ai, true);
         if (c != Command::None) {
             return c;
         }
         // Continue with normal strategy if no pickup found
-        Logger::log("vsScout: No health pickup found. Continuing with normal strategy.");
+        AI_LOG("vsScout: No health pickup found. Continuing with normal strategy.");
     }
 
-    // Manage distance: scouts are fast, so try to keep at least distance=3
-    if (distance <= 3) {
-        Logger::log("vsScout: Too close. Retreating.");
-        Direction awayDir = getDirectionAway(dx, dy);
-        if (ai->getDirection() != awayDir) {
-            return getTurnCommand(ai->getDirection(), awayDir);
+    // Pick the cell with the best positional value among the current one and its neighbours:
+    // out of the Scout's reach, in a clear lane towards it, near cover and pickups
+    QPoint bestPos = aiPos;
+    int bestScore = scorePosition(game, scout, aiPos);
+    Direction bestDir = getDirectionTowards(dx, dy);
+    bool holdPosition = true;
+    int bestMoveScore = INT_MIN;
+    Direction bestMoveDir = bestDir;
+
+    for (int i = 0; i < 4; ++i) {
+        Direction dir = static_cast<Direction>(i);
+        QPoint newPos = getPositionInDirection(aiPos, dir);
+        if (!game->isValidMove(newPos)) {
+            continue;
+        }
+        int score = scorePosition(game, scout, newPos);
+        if (score > bestMoveScore) {
+            bestMoveScore = score;
+            bestMoveDir = dir;
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            bestPos = newPos;
+            bestDir = dir;
+            holdPosition = false;
         }
-        return tryMoveOrBreakWall(game, ai);
     }
 
-    // Within striking range: move towards player
-    else if (distance >= 4 && distance <= 7) {
-        Logger::log("vsScout: Within striking range. Move towards player.");
+    AI_LOG(QString("vsScout: Best position (%1,%2) with score %3")
+                .arg(bestPos.x()).arg(bestPos.y()).arg(bestScore));
+
+    if (holdPosition) {
+        // Face the Scout so the next shot is ready, turning is free
         Direction towardDir = getDirectionTowards(dx, dy);
         if (ai->getDirection() != towardDir) {
+            AI_LOG("vsScout: Holding position. Facing the Scout.");
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        if (bestMoveScore == INT_MIN) {
+            AI_LOG("vsScout: Boxed in. Command: Attack.");
+            return Command::Attack;
+        }
+        // A move has to be made, take the best neighbouring cell
+        AI_LOG("vsScout: Holding position is not possible. Taking the best neighbouring cell.");
+        bestDir = bestMoveDir;
     }
 
-    // Far away: get powerup
-    else {
-        Logger::log("vsScout: Scout far away. Try to get pickup.");
-        Command c = tryCollectPickup(game, ai, false);
-        if (c != Command::None) {
-            return c;
-        }
-        // Continue with movement if no pickup found
-        Logger::log("vsScout: No powerup found. Moving towards player.");
-        Direction towardDir = getDirectionTowards(dx, dy);
-        if (ai->getDirection() != towardDir) {
-            return getTurnCommand(ai->getDirection(), towardDir);
-        }
-        return tryMoveOrBreakWall(game, ai);
+    if (ai->getDirection() != bestDir) {
+        return getTurnCommand(ai->getDirection(), bestDir);
     }
-    
-    // Default fallback - should not reach here due to the complete else-if chain above
-    return Command::None;
+    return tryMoveOrBreakWall(game, ai, getPositionInDirection(ai->getPosition(), bestDir));
 }
 
 /**
@@ -233,13 +328,14 @@ Command SniperAI::vsScout(Game* game, Robot* ai, Robot* scout)
  */
 Command SniperAI::vsTank(Game* game, Robot* ai, Robot* tank)
 {
+    const SniperParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint plrPos = tank->getPosition();
     int dx = plrPos.x() - aiPos.x();
     int dy = plrPos.y() - aiPos.y();
     int distance = std::abs(dx) + std::abs(dy);
 
-    Logger::log(QString("vsTank: AI(%1,%2), Tank(%3,%4), distance %5")
+    AI_LOG(QString("vsTank: AI(%1,%2), Tank(%3,%4), distance %5")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(plrPos.x()).arg(plrPos.y())
                 .arg(distance));
@@ -252,50 +348,50 @@ Command SniperAI::vsTank(Game* game, Robot* ai, Robot* tank)
     Q_UNUSED(diff);
 
     // If below half health, try to pick up health
-    if (ai->getHealth() < ai->getMaxHealth() / 2) {
-        Logger::log("vsTank: Sniper below 50% HP. Trying to pick up health.");
+    if (ai->getHealth() < ai->getMaxHealth() * params.healthSeekPercent / 100) {
+        AI_LOG("vsTank: Sniper below 50% HP. Trying to pick up health.");
         Command c = tryCollectPickup(game, ai, true);
         if (c != Command::None) {
             return c;
         }
         // Continue with normal strategy if no pickup found
-        Logger::log("vsTank: No health pickup found. Continuing with normal strategy.");
+        AI_LOG("vsTank: No health pickup found. Continuing with normal strategy.");
     }
 
-    // Manage distance: try to keep at least distance=3
-    if (distance <= 3) {
-        Logger::log("vsTank: Too close. Retreating.");
-        Direction awayDir = getDirectionAway(dx, dy);
+    // Manage distance: retreat whenever the tank could reach and hit us on its next turn
+    if (game->getThreatMap(tank).canHit(aiPos, tank->getMaxMoves())) {
+        AI_LOG("vsTank: Too close. Retreating.");
+        Direction awayDir = getSafestDirection(game, ai, tank, dx, dy);
         if (ai->getDirection() != awayDir) {
             return getTurnCommand(ai->getDirection(), awayDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, getPositionInDirection(ai->getPosition(), awayDir));
     }
 
     // Within striking range: move towards player
-    else if (distance >= 4 && distance <= 7) {
-        Logger::log("vsTank: Within striking range. Move towards player.");
-        Direction towardDir = getDirectionTowards(dx, dy);
+    else if (distance <= params.strikeRangeVsTank) {
+        AI_LOG("vsTank: Within striking range. Move towards player.");
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
 
     // Far away: get powerup
     else {
-        Logger::log("vsTank: Tank far away. Try to get pickup.");
+        AI_LOG("vsTank: Tank far away. Try to get pickup.");
         Command c = tryCollectPickup(game, ai, false);
         if (c != Command::None) {
             return c;
         }
         // Continue with movement if no pickup found
-        Logger::log("vsTank: No powerup found. Moving towards player.");
-        Direction towardDir = getDirectionTowards(dx, dy);
+        AI_LOG("vsTank: No powerup found. Moving towards player.");
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
     
     // Default fallback - should not reach here due to the complete else-if chain above
@@ -308,13 +404,14 @@ Command SniperAI::vsTank(Game* game, Robot* ai, Robot* tank)
  */
 Command SniperAI::vsSniper(Game* game, Robot* ai, Robot* enemySniper)
 {
+    const SniperParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint plrPos = enemySniper->getPosition();
     int dx = plrPos.x() - aiPos.x();
     int dy = plrPos.y() - aiPos.y();
     int distance = std::abs(dx) + std::abs(dy);
 
-    Logger::log(QString("vsSniper: AI(%1,%2), EnemySniper(%3,%4), distance %5")
+    AI_LOG(QString("vsSniper: AI(%1,%2), EnemySniper(%3,%4), distance %5")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(plrPos.x()).arg(plrPos.y())
                 .arg(distance));
@@ -327,40 +424,40 @@ Command SniperAI::vsSniper(Game* game, Robot* ai, Robot* enemySniper)
     Q_UNUSED(diff);
 
     // If below half health, try to pick up health
-    if (ai->getHealth() < ai->getMaxHealth() / 2) {
-        Logger::log("vsSniper: Sniper below 50% HP. Attempting health pickup.");
+    if (ai->getHealth() < ai->getMaxHealth() * params.healthSeekPercent / 100) {
+        AI_LOG("vsSniper: Sniper below 50% HP. Attempting health pickup.");
         Command c = tryCollectPickup(game, ai, true);
         if (c != Command::None) {
             return c;
         }
         // Continue with normal strategy if no pickup found
-        Logger::log("vsSniper: No health pickup found. Continuing with normal strategy.");
+        AI_LOG("vsSniper: No health pickup found. Continuing with normal strategy.");
     }
 
     // Within striking range: move towards player
-    if (distance >= 4 && distance <= 7) {
-        Logger::log("vsSniper: Within striking range. Move towards player.");
-        Direction towardDir = getDirectionTowards(dx, dy);
+    if (distance >= params.strikeRangeMinVsSniper && distance <= params.strikeRangeMaxVsSniper) {
+        AI_LOG("vsSniper: Within striking range. Move towards player.");
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
 
     // Far away: get powerup
     else {
-        Logger::log("vsSniper: Sniper far away. Try to get pickup.");
+        AI_LOG("vsSniper: Sniper far away. Try to get pickup.");
         Command c = tryCollectPickup(game, ai, false);
         if (c != Command::None) {
             return c;
         }
         // Continue with movement if no pickup found
-        Logger::log("vsSniper: No powerup found. Moving towards player.");
-        Direction towardDir = getDirectionTowards(dx, dy);
+        AI_LOG("vsSniper: No powerup found. Moving towards player.");
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
     
     // Default fallback - should not reach here due to the complete else-if chain above
@@ -372,24 +469,25 @@ Command SniperAI::vsSniper(Game* game, Robot* ai, Robot* enemySniper)
  */
 Command SniperAI::tryCollectPickup(Game* game, Robot* ai, bool preferHealthIfLow)
 {
+    const SniperParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
-    Logger::log("tryCollectPickup: Searching for pickups.");
+    AI_LOG("tryCollectPickup: Searching for pickups.");
 
-    // Find nearest health pickup within 5 tiles
-    QPoint hpPos = findNearestHealthPickup(game, aiPos, 6);
+    // Find nearest health pickup within the search radius
+    QPoint hpPos = findNearestHealthPickup(game, aiPos, params.pickupSearchRadius);
     int distHP = 999999;
     if (hpPos.x() != -1)
-        distHP = manhattanDistance(aiPos, hpPos);
+        distHP = game->getPathfinding().distance(aiPos, hpPos);
 
-    // Find nearest powerup within 5 tiles
-    QPoint puPos = findNearestPowerUp(game, aiPos, 6);
+    // Find nearest powerup within the search radius
+    QPoint puPos = findNearestPowerUp(game, aiPos, params.pickupSearchRadius);
     int distPU = 999999;
     if (puPos.x() != -1)
-        distPU = manhattanDistance(aiPos, puPos);
+        distPU = game->getPathfinding().distance(aiPos, puPos);
 
     // If no pickups found, fallback
     if (hpPos.x() == -1 && puPos.x() == -1) {
-        Logger::log("tryCollectPickup: No pickups found. Command: None.");
+        AI_LOG("tryCollectPickup: No pickups found. Command: None.");
         return Command::None;
     }
 
@@ -404,40 +502,72 @@ Command SniperAI::tryCollectPickup(Game* game, Robot* ai, bool preferHealthIfLow
     QPoint targetPos = goHealth ? hpPos : puPos;
     int dx = targetPos.x() - aiPos.x();
     int dy = targetPos.y() - aiPos.y();
-    Direction targetDir = getDirectionTowards(dx, dy);
+    Direction targetDir = getDirectionTowards(game, ai, dx, dy);
 
-    Logger::log(QString("tryCollectPickup: %1 pickup selected at (%2, %3)")
+    AI_LOG(QString("tryCollectPickup: %1 pickup selected at (%2, %3)")
                 .arg(goHealth ? "Health" : "Powerup")
                 .arg(targetPos.x()).arg(targetPos.y()));
 
     if (ai->getDirection() != targetDir) {
-        Logger::log("Not facing pickup direction. Command: Turn.");
+        AI_LOG("Not facing pickup direction. Command: Turn.");
         return getTurnCommand(ai->getDirection(), targetDir);
     }
-    return tryMoveOrBreakWall(game, ai);
+    return tryMoveOrBreakWall(game, ai, targetPos);
 
-    Logger::log("tryCollectPickup: Fallback reached. Command: None.");
+    AI_LOG("tryCollectPickup: Fallback reached. Command: None.");
     return Command::None;
 }
 
 /**
  *   Movement Helpers
  */
-Command SniperAI::tryMoveOrBreakWall(Game* game, Robot* ai)
+Command SniperAI::makeRandomMove(Game* game, Robot* ai)
+{
+    QPoint aiPos = ai->getPosition();
+    Direction openDirs[4];
+    int openCount = 0;
+    for (int i = 0; i < 4; i++) {
+        Direction dir = static_cast<Direction>(i);
+        if (game->isValidMove(getPositionInDirection(aiPos, dir))) {
+            openDirs[openCount++] = dir;
+        }
+    }
+    if (openCount == 0) {
+        return Command::None;
+    }
+
+    Direction dir = openDirs[match.random.bounded(openCount)];
+    if (dir == ai->getDirection()) {
+        return Command::MoveForward;
+    }
+    return getTurnCommand(ai->getDirection(), dir);
+}
+
+Command SniperAI::tryMoveOrBreakWall(Game* game, Robot* ai, const QPoint& target)
 {
     QPoint aiPos = ai->getPosition();
     Direction currentDir = ai->getDirection();
 
     QPoint forwardPos = getPositionInDirection(aiPos, currentDir);
     if (game->isValidMove(forwardPos)) {
-        Logger::log("Forward move valid. Command: MoveForward.");
+        AI_LOG("Forward move valid. Command: MoveForward.");
         return Command::MoveForward;
     }
-    if (game->isValidPosition(forwardPos) &&
-        game->getCellType(forwardPos) == CellType::Wall)
-    {
-        Logger::log("Wall directly ahead. Command: Attack.");
-        return Command::Attack;
+
+    // Break a wall only where the cheapest route to the target goes through it, otherwise turn the
+    // way the route leaves
+    Direction routeDir = currentDir;
+    if (game->getPathfinding().bestDirectionTowards(aiPos, currentDir, target, game->getWallDamage(ai), &routeDir)) {
+        QPoint routePos = getPositionInDirection(aiPos, routeDir);
+        bool routeIsWall = game->isValidPosition(routePos) && game->getCellType(routePos) == CellType::Wall;
+        if (routeDir == currentDir && routeIsWall) {
+            AI_LOG("Cheapest route goes through the wall ahead. Command: Attack.");
+            return Command::Attack;
+        }
+        if (routeDir != currentDir && (routeIsWall || game->isValidMove(routePos))) {
+            AI_LOG("Cheapest route leaves another way. Command: Turn.");
+            return getTurnCommand(currentDir, routeDir);
+        }
     }
 
     // Try turning left/right to find a valid path.
@@ -449,52 +579,40 @@ Command SniperAI::tryMoveOrBreakWall(Game* game, Robot* ai)
         QPoint leftPos = getPositionInDirection(aiPos, leftDir);
 
         if (game->isValidMove(leftPos) && game->isValidMove(rightPos)) {
-            Logger::log("Valid move found to the left and right. Command: Random Turn.");
-            return (QRandomGenerator::global()->bounded(2) == 0)
+            AI_LOG("Valid move found to the left and right. Command: Random Turn.");
+            return (match.random.bounded(2) == 0)
                ? getTurnCommand(currentDir, leftDir)
                : getTurnCommand(currentDir, rightDir);
         }
 
         if (game->isValidMove(leftPos)) {
-            Logger::log("Valid move found to the left. Command: TurnLeft.");
-            return getTurnCommand(currentDir, leftDir);
-        }
-        if (game->isValidPosition(leftPos) &&
-            game->getCellType(leftPos) == CellType::Wall)
-        {
-            Logger::log("Wall detected on the left. Command: TurnLeft.");
+            AI_LOG("Valid move found to the left. Command: TurnLeft.");
             return getTurnCommand(currentDir, leftDir);
         }
 
         if (game->isValidMove(rightPos)) {
-            Logger::log("Valid move found to the right. Command: TurnRight.");
-            return getTurnCommand(currentDir, rightDir);
-        }
-        if (game->isValidPosition(rightPos) &&
-            game->getCellType(rightPos) == CellType::Wall)
-        {
-            Logger::log("Wall detected on the right. Command: TurnRight.");
+            AI_LOG("Valid move found to the right. Command: TurnRight.");
             return getTurnCommand(currentDir, rightDir);
         }
 
         currentDir = static_cast<Direction>((static_cast<int>(currentDir) + 1) % 4);
     }
 
-    Logger::log("tryMoveOrBreakWall: No valid moves found. Fallback: Attack.");
+    AI_LOG("tryMoveOrBreakWall: No valid moves found. Fallback: Attack.");
     return Command::Attack;
 }
 
 Command SniperAI::huntPlayerPosition(Game* game, Robot* ai, int dx, int dy)
 {
-    Direction desiredDir = getDirectionTowards(dx, dy);
+    Direction desiredDir = getDirectionTowards(game, ai, dx, dy);
     Direction currentDir = ai->getDirection();
-    Logger::log("huntPlayerPosition: Hunting last known player position.");
+    AI_LOG("huntPlayerPosition: Hunting last known player position.");
     if (currentDir != desiredDir) {
-        Logger::log("Not facing desired direction. Command: Turn.");
+        AI_LOG("Not facing desired direction. Command: Turn.");
         return getTurnCommand(currentDir, desiredDir);
     }
-    Command attemptMove = tryMoveOrBreakWall(game, ai);
-    Logger::log("huntPlayerPosition: Forwarding movement command.");
+    Command attemptMove = tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
+    AI_LOG("huntPlayerPosition: Forwarding movement command.");
     return attemptMove; 
 }
 
@@ -535,6 +653,20 @@ Direction SniperAI::getDirectionTowards(int dx, int dy)
     }
 }
 
+Direction SniperAI::getDirectionTowards(Game* game, Robot* ai, int dx, int dy)
+{
+    // Follow the cheapest route, which may go through a wall when breaking it is quicker than
+    // walking around. tryMoveOrBreakWall() then attacks the wall once facing it.
+    Direction greedyDir = getDirectionTowards(dx, dy);
+    Direction routeDir = greedyDir;
+    QPoint from = ai->getPosition();
+    if (game->getPathfinding().bestDirectionTowards(from, ai->getDirection(), from + QPoint(dx, dy),
+                                                    game->getWallDamage(ai), &routeDir)) {
+        return routeDir;
+    }
+    return greedyDir;
+}
+
 Direction SniperAI::getDirectionAway(int dx, int dy)
 {
     if (std::abs(dx) > std::abs(dy)) {
@@ -544,6 +676,66 @@ Direction SniperAI::getDirectionAway(int dx, int dy)
     }
 }
 
+Direction SniperAI::getSafestDirection(Game* game, Robot* ai, Robot* opponent, int dx, int dy)
+{
+    // Prefer the neighbouring cell the opponent needs the most moves to hit, and fall back to
+    // simply moving away when no neighbour is any safer
+    Direction bestDir = getDirectionAway(dx, dy);
+    QPoint aiPos = ai->getPosition();
+    const ThreatMap& threats = game->getThreatMap(opponent);
+
+    QPoint awayPos = getPositionInDirection(aiPos, bestDir);
+    int bestMoves = game->isValidMove(awayPos) ? threats.movesToHit(awayPos) : -1;
+
+    for (int i = 0; i < 4; ++i) {
+        Direction dir = static_cast<Direction>(i);
+        QPoint newPos = getPositionInDirection(aiPos, dir);
+        if (!game->isValidMove(newPos)) {
+            continue;
+        }
+        int moves = threats.movesToHit(newPos);
+        if (moves > bestMoves) {
+            bestMoves = moves;
+            bestDir = dir;
+        }
+    }
+
+    AI_LOG(QString("Safest direction: %1, opponent needs %2 moves to hit it")
+                .arg(static_cast<int>(bestDir)).arg(bestMoves));
+    return bestDir;
+}
+
+int SniperAI::scorePosition(Game* game, Robot* opponent, const QPoint& pos)
+{
+    const SniperParameters& params = parametersFor(game);
+    const InfluenceMap& influence = game->getInfluenceMap(opponent);
+    QPoint opponentPos = opponent->getPosition();
+
+    int score = influence.evaluate(pos, -THREAT_WEIGHT, PICKUP_WEIGHT, COVER_WEIGHT);
+
+    // Cells overlooking long lanes are good perches, dead ends are traps against a fast Scout
+    const MapAnalysis& analysis = game->getMapAnalysis();
+    score += VANTAGE_WEIGHT * analysis.getVantage(pos);
+    if (analysis.isDeadEnd(pos)) {
+        score -= DEAD_END_PENALTY;
+    }
+
+    // A clear lane towards the opponent lets us shoot as soon as it steps into range
+    bool inLane = (pos.x() == opponentPos.x() || pos.y() == opponentPos.y());
+    if (inLane && hasLineOfSight(game, pos, opponentPos)) {
+        score += LANE_BONUS;
+    }
+
+    // Don't drift away from the fight, every step beyond the preferred range costs
+    int walk = game->getPathfinding().distance(pos, opponentPos);
+    if (walk == PathfindingService::UNREACHABLE) {
+        walk = manhattanDistance(pos, opponentPos);
+    }
+    score -= DISTANCE_PENALTY * std::max(0, walk - params.preferredRangeVsScout);
+
+    return score;
+}
+
 Command SniperAI::getTurnCommand(Direction currentDir, Direction targetDir)
 {
     int c = static_cast<int>(currentDir);
@@ -584,48 +776,14 @@ QPoint SniperAI::getPositionInDirection(const QPoint& pos, Direction dir, int st
  */
 QPoint SniperAI::findNearestHealthPickup(Game* game, const QPoint& pos, int searchRadius)
 {
-    QPoint best(-1, -1);
-    int minDist = 999999;
-    int size = game->getGridSize();
-
-    for (int y = std::max(0, pos.y() - searchRadius); y <= std::min(size - 1, pos.y() + searchRadius); ++y) {
-        for (int x = std::max(0, pos.x() - searchRadius); x <= std::min(size - 1, pos.x() + searchRadius); ++x) {
-            QPoint check(x, y);
-            if (game->getCellType(check) == CellType::HealthPickup) {
-                int d = manhattanDistance(pos, check);
-                if (d < minDist) {
-                    minDist = d;
-                    best = check;
-                }
-            }
-        }
-    }
-    return best;
+    // The game keeps an index of pickups, so only actual pickups are looked at
+    return game->findNearestPickup(pos, CellType::HealthPickup, searchRadius);
 }
 
 QPoint SniperAI::findNearestPowerUp(Game* game, const QPoint& pos, int searchRadius)
 {
-    QPoint best(-1, -1);
-    int minDist = 999999;
-    int size = game->getGridSize();
-
-    for (int y = std::max(0, pos.y() - searchRadius); y <= std::min(size - 1, pos.y() + searchRadius); ++y) {
-        for (int x = std::max(0, pos.x() - searchRadius); x <= std::min(size - 1, pos.x() + searchRadius); ++x) {
-            QPoint check(x, y);
-            CellType ctype = game->getCellType(check);
-            if (ctype == CellType::LaserPowerUp ||
-                ctype == CellType::MissilePowerUp ||
-                ctype == CellType::BombPowerUp)
-            {
-                int d = manhattanDistance(pos, check);
-                if (d < minDist) {
-                    minDist = d;
-                    best = check;
-                }
-            }
-        }
-    }
-    return best;
+    // The game keeps an index of pickups, so only actual pickups are looked at
+    return game->findNearestPowerUp(pos, searchRadius);
 }
 
 /**
@@ -633,32 +791,33 @@ QPoint SniperAI::findNearestPowerUp(Game* game, const QPoint& pos, int searchRad
  */
 Command SniperAI::directLineAttack(Game* game, Robot* ai, Robot* player)
 {
+    const SniperParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint playerPos = player->getPosition();
     int dx = playerPos.x() - aiPos.x();
     int dy = playerPos.y() - aiPos.y();
     int distance = std::abs(dx) + std::abs(dy);
 
-    if (distance <= 3 && (aiPos.x() == playerPos.x() || aiPos.y() == playerPos.y())) {
+    if (distance <= params.directAttackRange && (aiPos.x() == playerPos.x() || aiPos.y() == playerPos.y())) {
         Direction desiredDir = getDirectionTowards(dx, dy);
-        if (ai->getHealth() < static_cast<int>(ai->getMaxHealth() * 0.5)) {
-            // Check if health pickup is available within 5 tiles
-            QPoint hpPos = findNearestHealthPickup(game, aiPos, 5);
+        if (ai->getHealth() < ai->getMaxHealth() * params.criticalHealthPercent / 100) {
+            // Check if health pickup is available within the critical radius
+            QPoint hpPos = findNearestHealthPickup(game, aiPos, params.criticalPickupRadius);
             if (hpPos.x() != -1) {
-                Logger::log("directLineAttack: Very low health and health pickup available. Try to collect health.");
+                AI_LOG("directLineAttack: Very low health and health pickup available. Try to collect health.");
                 return tryCollectPickup(game, ai, true);
             }
         }
         if (ai->getDirection() != desiredDir) {
-            Logger::log("directLineAttack: Not facing player. Command: Turn.");
+            AI_LOG("directLineAttack: Not facing player. Command: Turn.");
             return getTurnCommand(ai->getDirection(), desiredDir);
         }
         if (player->getHealth() < ai->getAttackDamage()) {
-            Logger::log("directLineAttack: Sure kill. Command: Attack.");
+            AI_LOG("directLineAttack: Sure kill. Command: Attack.");
             return Command::Attack;
         }
 
-        Logger::log("directLineAttack: Conditions met. Command: Attack.");
+        AI_LOG("directLineAttack: Conditions met. Command: Attack.");
         return Command::Attack;
     }
     
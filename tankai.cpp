@@ -5,20 +5,80 @@
 
 #include <QRandomGenerator>
 #include <algorithm>
+#include <climits>
 
 // Constructor
 TankAI::TankAI(QObject* parent)
-    : QObject(parent),
-      lastPlayerPosition(-1, -1),
-      lastPlayerHealth(0),
-      lastAiPosition(-1, -1),
-      samePositionCounter(0),
-      consecutiveTurnCount(0),
-      moveCounter(0),
-      turnCounter(0),
-      isCirclingClockwise(true)
+    : QObject(parent)
+    , seed(QRandomGenerator::global()->generate())
 {
-    Logger::log("TankAI initialized.");
+    match.random = AIRandom(seed);
+    AIParameterSets defaults = AIParameterSets::defaults();
+    for (GameDifficulty difficulty : {GameDifficulty::Easy, GameDifficulty::Medium, GameDifficulty::Hard}) {
+        parameters[static_cast<int>(difficulty)] = defaults.at(difficulty).tank;
+    }
+    updateParametersHash();
+    AI_LOG("TankAI initialized.");
+}
+
+void TankAI::setParameters(GameDifficulty difficulty, const TankParameters& newParameters)
+{
+    parameters[static_cast<int>(difficulty)] = newParameters;
+    updateParametersHash();
+}
+
+const TankParameters& TankAI::getParameters(GameDifficulty difficulty) const
+{
+    return parameters[static_cast<int>(difficulty)];
+}
+
+const TankParameters& TankAI::parametersFor(Game* game) const
+{
+    return parameters[static_cast<int>(game->getDifficulty())];
+}
+
+void TankAI::updateParametersHash()
+{
+    parametersHash = 0;
+    for (const TankParameters& set : parameters) {
+        parametersHash = parametersHash * 1099511628211ULL ^ ::hashParameters(set);
+    }
+}
+
+void TankAI::reset()
+{
+    match = MatchState();
+    match.random = AIRandom(seed);
+}
+
+void TankAI::setSeed(quint32 newSeed)
+{
+    seed = newSeed;
+    match.random = AIRandom(seed);
+}
+
+quint64 TankAI::hashMemory() const
+{
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](int value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            hash ^= static_cast<quint8>(value >> shift);
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(match.lastPlayerPosition.x());
+    mix(match.lastPlayerPosition.y());
+    mix(match.lastPlayerHealth);
+    mix(match.lastAiPosition.x());
+    mix(match.lastAiPosition.y());
+    mix(match.samePositionCounter);
+    mix(match.consecutiveTurnCount);
+    mix(match.moveCounter);
+    mix(match.turnCounter);
+    mix(match.isCirclingClockwise);
+    mix(static_cast<int>(match.random.state));
+    mix(static_cast<int>(match.random.state >> 32));
+    return hash;
 }
 
 /**
@@ -26,29 +86,30 @@ TankAI::TankAI(QObject* parent)
  */
 Command TankAI::calculateMove(Game* game, Robot* ai, Robot* player)
 {
+    const TankParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
-    Logger::log(QString("=================================================="));
-    Logger::log(QString("TankAI::calculateMove: Tank at (%1, %2)").arg(aiPos.x()).arg(aiPos.y()));
+    AI_LOG(QString("=================================================="));
+    AI_LOG(QString("TankAI::calculateMove: Tank at (%1, %2)").arg(aiPos.x()).arg(aiPos.y()));
 
     // Check if Tank is stuck (has not moved from lastAiPosition)
-    if (aiPos == lastAiPosition) {
-        samePositionCounter++;
-        Logger::log(QString("Tank did not move. samePositionCounter increased to %1").arg(samePositionCounter));
+    if (aiPos == match.lastAiPosition) {
+        match.samePositionCounter++;
+        AI_LOG(QString("Tank did not move. samePositionCounter increased to %1").arg(match.samePositionCounter));
     } else {
-        samePositionCounter = 0;
-        lastAiPosition = aiPos;
-        Logger::log("Tank moved. samePositionCounter reset.");
+        match.samePositionCounter = 0;
+        match.lastAiPosition = aiPos;
+        AI_LOG("Tank moved. samePositionCounter reset.");
     }
 
-    // If stuck for 5 consecutive attempts, attempt to break out:
-    if (samePositionCounter > 5) {
-        Logger::log("Tank might be stuck. Attempting break-out.");
-        samePositionCounter = 0;
+    // If stuck for too many consecutive attempts, attempt to break out:
+    if (match.samePositionCounter > params.stuckLimit) {
+        AI_LOG("Tank might be stuck. Attempting break-out.");
+        match.samePositionCounter = 0;
 
         // Check if wall ahead
         QPoint frontPos = getPositionInDirection(aiPos, ai->getDirection());
         if (game->isValidPosition(frontPos) && (game->getCellType(frontPos) == CellType::Wall)) {
-            Logger::log("Wall in front while stuck. Command: Attack.");
+            AI_LOG("Wall in front while stuck. Command: Attack.");
             return Command::Attack;
         }
 
@@ -60,30 +121,39 @@ Command TankAI::calculateMove(Game* game, Robot* ai, Robot* player)
         int distance = std::abs(dx) + std::abs(dy);
         bool canSee = hasLineOfSight(game, aiPos, plrPos);
         bool playerInDir = isInDirection(dx, dy, ai->getDirection());
-        if (canSee && playerInDir && distance <= 3) {
-            Logger::log("Player in front while stuck. Command: Attack.");
+        if (canSee && playerInDir && distance <= params.stuckAttackRange) {
+            AI_LOG("Player in front while stuck. Command: Attack.");
             return Command::Attack;
         }
 
         // If nothing in front, try to move forward if valid
         if (game->isValidMove(frontPos)) {
-            Logger::log("Path clear while stuck. Command: MoveForward.");
+            AI_LOG("Path clear while stuck. Command: MoveForward.");
             return Command::MoveForward;
         }
 
         // Otherwise, attack randomly (fallback)
-        Logger::log("No valid move while stuck. Command: Attack.");
+        AI_LOG("No valid move while stuck. Command: Attack.");
         return Command::Attack;
     }
 
     // Track player's position and health
-    lastPlayerPosition = player->getPosition();
-    lastPlayerHealth   = player->getHealth();
-    Logger::log(QString("Player at (%1, %2) with health %3")
-                .arg(lastPlayerPosition.x()).arg(lastPlayerPosition.y()).arg(lastPlayerHealth));
+    match.lastPlayerPosition = player->getPosition();
+    match.lastPlayerHealth   = player->getHealth();
+    AI_LOG(QString("Player at (%1, %2) with health %3")
+                .arg(match.lastPlayerPosition.x()).arg(match.lastPlayerPosition.y()).arg(match.lastPlayerHealth));
+
+    // Weaker difficulties give up some moves to chance
+    if (match.random.bounded(100) < params.randomMovePercent) {
+        Command randomMove = makeRandomMove(game, ai);
+        if (randomMove != Command::None) {
+            AI_LOG("Making a random move.");
+            return randomMove;
+        }
+    }
 
     // Check for a direct line attack
-    Logger::log("Checking for direct line attack opportunity.");
+    AI_LOG("Checking for direct line attack opportunity.");
     Command directAttackCmd = directLineAttack(game, ai, player);
     if (directAttackCmd != Command::None) {
         return directAttackCmd;
@@ -94,7 +164,7 @@ Command TankAI::calculateMove(Game* game, Robot* ai, Robot* player)
 
     // If Easy, do simpler logic
     if (diff == GameDifficulty::Easy) {
-        Logger::log("Using normal Tank logic for Easy difficulty.");
+        AI_LOG("Using normal Tank logic for Easy difficulty.");
         return calculateTankNormal(game, ai, player);
     }
 
@@ -103,16 +173,16 @@ Command TankAI::calculateMove(Game* game, Robot* ai, Robot* player)
     switch (enemyType)
     {
     case RobotType::Scout:
-        Logger::log("Using specialized logic: vsScout.");
+        AI_LOG("Using specialized logic: vsScout.");
         return vsScout(game, ai, player);
     case RobotType::Sniper:
-        Logger::log("Using specialized logic: vsSniper.");
+        AI_LOG("Using specialized logic: vsSniper.");
         return vsSniper(game, ai, player);
     case RobotType::Tank:
-        Logger::log("Using specialized logic: vsTank.");
+        AI_LOG("Using specialized logic: vsTank.");
         return vsTank(game, ai, player);
     default:
-        Logger::log("Unknown enemy type. Defaulting to vsScout.");
+        AI_LOG("Unknown enemy type. Defaulting to vsScout.");
         return vsScout(game, ai, player);
     }
 }
@@ -128,7 +198,7 @@ Command TankAI::calculateTankNormal(Game* game, Robot* ai, Robot* player)
     int dy = plrPos.y() - aiPos.y();
     int distance = std::abs(dx) + std::abs(dy);
 
-    Logger::log(QString("calculateTankNormal: Tank(%1,%2), Player(%3,%4), distance %5")
+    AI_LOG(QString("calculateTankNormal: Tank(%1,%2), Player(%3,%4), distance %5")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(plrPos.x()).arg(plrPos.y())
                 .arg(distance));
@@ -139,16 +209,16 @@ Command TankAI::calculateTankNormal(Game* game, Robot* ai, Robot* player)
     Q_UNUSED(playerInDir);
 
     // Move towards the player
-    Logger::log("Player not within range. Closing in.");
-    Direction towardDir = getDirectionTowards(dx, dy);
+    AI_LOG("Player not within range. Closing in.");
+    Direction towardDir = getDirectionTowards(game, ai, dx, dy);
     if (ai->getDirection() != towardDir) {
-        Logger::log("Not facing player. Command: Turn.");
+        AI_LOG("Not facing player. Command: Turn.");
         return getTurnCommand(ai->getDirection(), towardDir);
     }
-    return tryMoveOrBreakWall(game, ai);
+    return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
 
     // Fallback
-    Logger::log("Fallback reached in calculateSniperNormal. Command: Attack.");
+    AI_LOG("Fallback reached in calculateSniperNormal. Command: Attack.");
     return Command::Attack;
 }
 
@@ -158,6 +228,7 @@ Command TankAI::calculateTankNormal(Game* game, Robot* ai, Robot* player)
  */
 Command TankAI::vsScout(Game* game, Robot* ai, Robot* scout)
 {
+    const TankParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint plrPos = scout->getPosition();
     int dx = plrPos.x() - aiPos.x();
@@ -166,7 +237,7 @@ Command TankAI::vsScout(Game* game, Robot* ai, Robot* scout)
     int enemyHP = scout->getHealth();
     Q_UNUSED(enemyHP);
 
-    Logger::log(QString("vsScout: Tank(%1,%2), Scout(%3,%4), distance %5")
+    AI_LOG(QString("vsScout: Tank(%1,%2), Scout(%3,%4), distance %5")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(plrPos.x()).arg(plrPos.y())
                 .arg(distance));
@@ -179,40 +250,40 @@ Command TankAI::vsScout(Game* game, Robot* ai, Robot* scout)
     Q_UNUSED(diff);
 
     // If below half health, try to pick up health
-    if (ai->getHealth() < ai->getMaxHealth() / 2) {
-        Logger::log("vsScout: Tank below 50% HP. Trying to pick up health.");
+    if (ai->getHealth() < ai->getMaxHealth() * params.healthSeekPercent / 100) {
+        AI_LOG("vsScout: Tank below 50% HP. Trying to pick up health.");
         Command c = tryCollectPickup(game, ai, true);
         if (c != Command::None) {
             return c;
         }
         // Continue with normal strategy if no pickup found
-        Logger::log("vsScout: No health pickup found. Continuing with normal strategy.");
+        AI_LOG("vsScout: No health pickup found. Continuing with normal strategy.");
     }
 
     // Within striking range: attack
-    if (distance >= 2 && distance <= 5) {
-        Logger::log("vsScout: Within striking range. Move towards player.");
-        Direction towardDir = getDirectionTowards(dx, dy);
+    if (distance >= params.strikeRangeMin && distance <= params.strikeRangeMax) {
+        AI_LOG("vsScout: Within striking range. Move towards player.");
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
 
     // Far away: get powerup
     else {
-        Logger::log("vsScout: Scout far away. Try to get pickup.");
+        AI_LOG("vsScout: Scout far away. Try to get pickup.");
         Command c = tryCollectPickup(game, ai, false);
         if (c != Command::None) {
             return c;
         }
         // Continue with movement if no pickup found
-        Logger::log("vsScout: No powerup found. Moving towards player.");
-        Direction towardDir = getDirectionTowards(dx, dy);
+        AI_LOG("vsScout: No powerup found. Moving towards player.");
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
     
     // Default fallback - should not reach here due to the complete else-if chain above
@@ -225,6 +296,7 @@ Command TankAI::vsScout(Game* game, Robot* ai, Robot* scout)
  */
 Command TankAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
 {
+    const TankParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint plrPos = sniper->getPosition();
     int dx = plrPos.x() - aiPos.x();
@@ -233,7 +305,7 @@ Command TankAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
     int enemyHP = sniper->getHealth();
     Q_UNUSED(enemyHP);
 
-    Logger::log(QString("vsSniper: Tank(%1,%2), Sniper(%3,%4), distance %5")
+    AI_LOG(QString("vsSniper: Tank(%1,%2), Sniper(%3,%4), distance %5")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(plrPos.x()).arg(plrPos.y())
                 .arg(distance));
@@ -246,24 +318,24 @@ Command TankAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
     Q_UNUSED(diff);
 
     // If below half health, try to pick up health
-    if (ai->getHealth() < ai->getMaxHealth() / 2) {
-        Logger::log("vsSniper: Tank below 50% HP. Trying to pick up health.");
+    if (ai->getHealth() < ai->getMaxHealth() * params.healthSeekPercent / 100) {
+        AI_LOG("vsSniper: Tank below 50% HP. Trying to pick up health.");
         Command c = tryCollectPickup(game, ai, true);
         if (c != Command::None) {
             return c;
         }
         // Continue with normal strategy if no pickup found
-        Logger::log("vsSniper: No health pickup found. Continuing with normal strategy.");
+        AI_LOG("vsSniper: No health pickup found. Continuing with normal strategy.");
     }
 
     // Far away: move towards player
     // Changed from 'else' to always execute this if the health pickup wasn't found or wasn't low health
-    Logger::log("vsSniper: Sniper far away. Move towards player.");
-    Direction towardDir = getDirectionTowards(dx, dy);
+    AI_LOG("vsSniper: Sniper far away. Flanking towards player.");
+    Direction towardDir = getFlankingDirection(game, ai, sniper);
     if (ai->getDirection() != towardDir) {
         return getTurnCommand(ai->getDirection(), towardDir);
     }
-    return tryMoveOrBreakWall(game, ai);
+    return tryMoveOrBreakWall(game, ai, sniper->getPosition());
     
     // Default fallback - should not reach here due to the complete else-if chain above
     return Command::None;
@@ -275,6 +347,7 @@ Command TankAI::vsSniper(Game* game, Robot* ai, Robot* sniper)
  */
 Command TankAI::vsTank(Game* game, Robot* ai, Robot* otherTank)
 {
+    const TankParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint plrPos = otherTank->getPosition();
     int dx = plrPos.x() - aiPos.x();
@@ -283,7 +356,7 @@ Command TankAI::vsTank(Game* game, Robot* ai, Robot* otherTank)
     int enemyHP = otherTank->getHealth();
     Q_UNUSED(enemyHP);
 
-    Logger::log(QString("vsTank: Tank(%1,%2), EnemyTank(%3,%4), distance %5")
+    AI_LOG(QString("vsTank: Tank(%1,%2), EnemyTank(%3,%4), distance %5")
                 .arg(aiPos.x()).arg(aiPos.y())
                 .arg(plrPos.x()).arg(plrPos.y())
                 .arg(distance));
@@ -296,40 +369,40 @@ Command TankAI::vsTank(Game* game, Robot* ai, Robot* otherTank)
     Q_UNUSED(diff);
 
     // If below half health, try to pick up health
-    if (ai->getHealth() < ai->getMaxHealth() / 2) {
-        Logger::log("vsTank: Tank below 50% HP. Attempting health pickup.");
+    if (ai->getHealth() < ai->getMaxHealth() * params.healthSeekPercent / 100) {
+        AI_LOG("vsTank: Tank below 50% HP. Attempting health pickup.");
         Command c = tryCollectPickup(game, ai, true);
         if (c != Command::None) {
             return c;
         }
         // Continue with normal strategy if no pickup found
-        Logger::log("vsTank: No health pickup found. Continuing with normal strategy.");
+        AI_LOG("vsTank: No health pickup found. Continuing with normal strategy.");
     }
 
     // Within striking range: attack
-    if (distance >= 2 && distance <= 5) {
-        Logger::log("vsTank: Within striking range. Move towards player.");
-        Direction towardDir = getDirectionTowards(dx, dy);
+    if (distance >= params.strikeRangeMin && distance <= params.strikeRangeMax) {
+        AI_LOG("vsTank: Within striking range. Move towards player.");
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
 
     // Far away: get powerup
     else {
-        Logger::log("vsTank: Other tank far away. Try to get pickup.");
+        AI_LOG("vsTank: Other tank far away. Try to get pickup.");
         Command c = tryCollectPickup(game, ai, false);
         if (c != Command::None) {
             return c;
         }
         // Continue with movement if no pickup found
-        Logger::log("vsTank: No powerup found. Moving towards player.");
-        Direction towardDir = getDirectionTowards(dx, dy);
+        AI_LOG("vsTank: No powerup found. Moving towards player.");
+        Direction towardDir = getDirectionTowards(game, ai, dx, dy);
         if (ai->getDirection() != towardDir) {
             return getTurnCommand(ai->getDirection(), towardDir);
         }
-        return tryMoveOrBreakWall(game, ai);
+        return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
     }
     
     // Default fallback - should not reach here due to the complete else-if chain above
@@ -341,24 +414,25 @@ Command TankAI::vsTank(Game* game, Robot* ai, Robot* otherTank)
  */
 Command TankAI::tryCollectPickup(Game* game, Robot* ai, bool preferHealthIfLow)
 {
+    const TankParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
-    Logger::log("tryCollectPickup: Searching for pickups.");
+    AI_LOG("tryCollectPickup: Searching for pickups.");
 
-    // Find nearest health pickup within 5 tiles
-    QPoint hpPos = findNearestHealthPickup(game, aiPos, 5);
+    // Find nearest health pickup within the search radius
+    QPoint hpPos = findNearestHealthPickup(game, aiPos, params.pickupSearchRadius);
     int distHP = 999999;
     if (hpPos.x() != -1)
-        distHP = manhattanDistance(aiPos, hpPos);
+        distHP = game->getPathfinding().distance(aiPos, hpPos);
 
-    // Find nearest powerup within 5 tiles
-    QPoint puPos = findNearestPowerUp(game, aiPos, 5);
+    // Find nearest powerup within the search radius
+    QPoint puPos = findNearestPowerUp(game, aiPos, params.pickupSearchRadius);
     int distPU = 999999;
     if (puPos.x() != -1)
-        distPU = manhattanDistance(aiPos, puPos);
+        distPU = game->getPathfinding().distance(aiPos, puPos);
 
     // If no pickups found, fallback
     if (hpPos.x() == -1 && puPos.x() == -1) {
-        Logger::log("tryCollectPickup: No pickups found. Command: None.");
+        AI_LOG("tryCollectPickup: No pickups found. Command: None.");
         return Command::None;
     }
 
@@ -373,40 +447,72 @@ Command TankAI::tryCollectPickup(Game* game, Robot* ai, bool preferHealthIfLow)
     QPoint targetPos = goHealth ? hpPos : puPos;
     int dx = targetPos.x() - aiPos.x();
     int dy = targetPos.y() - aiPos.y();
-    Direction targetDir = getDirectionTowards(dx, dy);
+    Direction targetDir = getDirectionTowards(game, ai, dx, dy);
 
-    Logger::log(QString("tryCollectPickup: %1 pickup selected at (%2, %3)")
+    AI_LOG(QString("tryCollectPickup: %1 pickup selected at (%2, %3)")
                 .arg(goHealth ? "Health" : "Powerup")
                 .arg(targetPos.x()).arg(targetPos.y()));
 
     if (ai->getDirection() != targetDir) {
-        Logger::log("Not facing pickup direction. Command: Turn.");
+        AI_LOG("Not facing pickup direction. Command: Turn.");
         return getTurnCommand(ai->getDirection(), targetDir);
     }
-    return tryMoveOrBreakWall(game, ai);
+    return tryMoveOrBreakWall(game, ai, targetPos);
 
-    Logger::log("tryCollectPickup: Fallback reached. Command: None.");
+    AI_LOG("tryCollectPickup: Fallback reached. Command: None.");
     return Command::None;
 }
 
 /**
  *   Movement Helpers
  */
-Command TankAI::tryMoveOrBreakWall(Game* game, Robot* ai)
+Command TankAI::makeRandomMove(Game* game, Robot* ai)
+{
+    QPoint aiPos = ai->getPosition();
+    Direction openDirs[4];
+    int openCount = 0;
+    for (int i = 0; i < 4; i++) {
+        Direction dir = static_cast<Direction>(i);
+        if (game->isValidMove(getPositionInDirection(aiPos, dir))) {
+            openDirs[openCount++] = dir;
+        }
+    }
+    if (openCount == 0) {
+        return Command::None;
+    }
+
+    Direction dir = openDirs[match.random.bounded(openCount)];
+    if (dir == ai->getDirection()) {
+        return Command::MoveForward;
+    }
+    return getTurnCommand(ai->getDirection(), dir);
+}
+
+Command TankAI::tryMoveOrBreakWall(Game* game, Robot* ai, const QPoint& target)
 {
     QPoint aiPos = ai->getPosition();
     Direction currentDir = ai->getDirection();
 
     QPoint forwardPos = getPositionInDirection(aiPos, currentDir);
     if (game->isValidMove(forwardPos)) {
-        Logger::log("Forward move valid. Command: MoveForward.");
+        AI_LOG("Forward move valid. Command: MoveForward.");
         return Command::MoveForward;
     }
-    if (game->isValidPosition(forwardPos) &&
-        game->getCellType(forwardPos) == CellType::Wall)
-    {
-        Logger::log("Wall directly ahead. Command: Attack.");
-        return Command::Attack;
+
+    // Break a wall only where the cheapest route to the target goes through it, otherwise turn the
+    // way the route leaves
+    Direction routeDir = currentDir;
+    if (game->getPathfinding().bestDirectionTowards(aiPos, currentDir, target, game->getWallDamage(ai), &routeDir)) {
+        QPoint routePos = getPositionInDirection(aiPos, routeDir);
+        bool routeIsWall = game->isValidPosition(routePos) && game->getCellType(routePos) == CellType::Wall;
+        if (routeDir == currentDir && routeIsWall) {
+            AI_LOG("Cheapest route goes through the wall ahead. Command: Attack.");
+            return Command::Attack;
+        }
+        if (routeDir != currentDir && (routeIsWall || game->isValidMove(routePos))) {
+            AI_LOG("Cheapest route leaves another way. Command: Turn.");
+            return getTurnCommand(currentDir, routeDir);
+        }
     }
 
     // Try turning left/right up to 4 times.
@@ -418,52 +524,40 @@ Command TankAI::tryMoveOrBreakWall(Game* game, Robot* ai)
         QPoint leftPos = getPositionInDirection(aiPos, leftDir);
 
         if (game->isValidMove(leftPos) && game->isValidMove(rightPos)) {
-            Logger::log("Valid move found to the left and right. Command: Random Turn.");
-            return (QRandomGenerator::global()->bounded(2) == 0)
+            AI_LOG("Valid move found to the left and right. Command: Random Turn.");
+            return (match.random.bounded(2) == 0)
                ? getTurnCommand(currentDir, leftDir)
                : getTurnCommand(currentDir, rightDir);
         }
 
         if (game->isValidMove(leftPos)) {
-            Logger::log("Valid move found to the left. Command: TurnLeft.");
-            return getTurnCommand(currentDir, leftDir);
-        }
-        if (game->isValidPosition(leftPos) &&
-            game->getCellType(leftPos) == CellType::Wall)
-        {
-            Logger::log("Wall detected on the left. Command: TurnLeft.");
+            AI_LOG("Valid move found to the left. Command: TurnLeft.");
             return getTurnCommand(currentDir, leftDir);
         }
 
         if (game->isValidMove(rightPos)) {
-            Logger::log("Valid move found to the right. Command: TurnRight.");
-            return getTurnCommand(currentDir, rightDir);
-        }
-        if (game->isValidPosition(rightPos) &&
-            game->getCellType(rightPos) == CellType::Wall)
-        {
-            Logger::log("Wall detected on the right. Command: TurnRight.");
+            AI_LOG("Valid move found to the right. Command: TurnRight.");
             return getTurnCommand(currentDir, rightDir);
         }
 
         currentDir = static_cast<Direction>((static_cast<int>(currentDir) + 1) % 4);
     }
 
-    Logger::log("tryMoveOrBreakWall: No valid moves found. Fallback: Attack.");
+    AI_LOG("tryMoveOrBreakWall: No valid moves found. Fallback: Attack.");
     return Command::Attack;
 }
 
 Command TankAI::huntPlayerPosition(Game* game, Robot* ai, int dx, int dy)
 {
-    Direction desiredDir = getDirectionTowards(dx, dy);
+    Direction desiredDir = getDirectionTowards(game, ai, dx, dy);
     Direction currentDir = ai->getDirection();
-    Logger::log("huntPlayerPosition: Hunting enemy based on last known position.");
+    AI_LOG("huntPlayerPosition: Hunting enemy based on last known position.");
     if (currentDir != desiredDir) {
-        Logger::log("Not facing desired direction. Command: Turn.");
+        AI_LOG("Not facing desired direction. Command: Turn.");
         return getTurnCommand(currentDir, desiredDir);
     }
-    Logger::log("Facing desired direction. Attempting to move or break wall.");
-    return tryMoveOrBreakWall(game, ai);
+    AI_LOG("Facing desired direction. Attempting to move or break wall.");
+    return tryMoveOrBreakWall(game, ai, ai->getPosition() + QPoint(dx, dy));
 }
 
 /**
@@ -502,6 +596,56 @@ Direction TankAI::getDirectionTowards(int dx, int dy)
         return (dy > 0) ? Direction::South : Direction::North;
 }
 
+Direction TankAI::getDirectionTowards(Game* game, Robot* ai, int dx, int dy)
+{
+    // Follow the cheapest route, which may go through a wall when breaking it is quicker than
+    // walking around. tryMoveOrBreakWall() then attacks the wall once facing it.
+    Direction greedyDir = getDirectionTowards(dx, dy);
+    Direction routeDir = greedyDir;
+    QPoint from = ai->getPosition();
+    if (game->getPathfinding().bestDirectionTowards(from, ai->getDirection(), from + QPoint(dx, dy),
+                                                    game->getWallDamage(ai), &routeDir))
+        return routeDir;
+    return greedyDir;
+}
+
+Direction TankAI::getFlankingDirection(Game* game, Robot* ai, Robot* opponent)
+{
+    // Among the steps that bring us closer to the opponent, take the one it threatens least, so
+    // the approach comes round its line of fire instead of through it
+    QPoint aiPos = ai->getPosition();
+    QPoint opponentPos = opponent->getPosition();
+    Direction routeDir = getDirectionTowards(game, ai, opponentPos.x() - aiPos.x(), opponentPos.y() - aiPos.y());
+
+    PathfindingService& pathfinding = game->getPathfinding();
+    int currentDist = pathfinding.distance(aiPos, opponentPos);
+    if (currentDist == PathfindingService::UNREACHABLE) {
+        return routeDir;
+    }
+
+    const InfluenceMap& influence = game->getInfluenceMap(opponent);
+    Direction bestDir = routeDir;
+    int bestThreat = INT_MAX;
+    QPoint routePos = getPositionInDirection(aiPos, routeDir);
+    if (game->isValidMove(routePos) && pathfinding.distance(routePos, opponentPos) < currentDist) {
+        bestThreat = influence.value(InfluenceMap::Threat, routePos);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        Direction dir = static_cast<Direction>(i);
+        QPoint newPos = getPositionInDirection(aiPos, dir);
+        if (!game->isValidMove(newPos) || pathfinding.distance(newPos, opponentPos) >= currentDist) {
+            continue;
+        }
+        int threat = influence.value(InfluenceMap::Threat, newPos);
+        if (threat < bestThreat) {
+            bestThreat = threat;
+            bestDir = dir;
+        }
+    }
+    return bestDir;
+}
+
 Direction TankAI::getDirectionAway(int dx, int dy)
 {
     if (std::abs(dx) > std::abs(dy))
@@ -548,50 +692,19 @@ QPoint TankAI::getPositionInDirection(const QPoint& pos, Direction dir, int step
  */
 QPoint TankAI::findNearestHealthPickup(Game* game, const QPoint& pos, int searchRadius)
 {
-    QPoint best(-1, -1);
-    int minDist = 999999;
-    int size = game->getGridSize();
-    for (int y = std::max(0, pos.y() - searchRadius); y <= std::min(size - 1, pos.y() + searchRadius); ++y) {
-        for (int x = std::max(0, pos.x() - searchRadius); x <= std::min(size - 1, pos.x() + searchRadius); ++x) {
-            QPoint check(x, y);
-            if (game->getCellType(check) == CellType::HealthPickup) {
-                int d = manhattanDistance(pos, check);
-                if (d < minDist) {
-                    minDist = d;
-                    best = check;
-                }
-            }
-        }
-    }
-    return best;
+    // The game keeps an index of pickups, so only actual pickups are looked at
+    return game->findNearestPickup(pos, CellType::HealthPickup, searchRadius);
 }
 
 QPoint TankAI::findNearestPowerUp(Game* game, const QPoint& pos, int searchRadius)
 {
-    QPoint best(-1, -1);
-    int minDist = 999999;
-    int size = game->getGridSize();
-    for (int y = std::max(0, pos.y() - searchRadius); y <= std::min(size - 1, pos.y() + searchRadius); ++y) {
-        for (int x = std::max(0, pos.x() - searchRadius); x <= std::min(size - 1, pos.x() + searchRadius); ++x) {
-            QPoint check(x, y);
-            CellType ctype = game->getCellType(check);
-            if (ctype == CellType::LaserPowerUp ||
-                ctype == CellType::MissilePowerUp ||
-                ctype == CellType::BombPowerUp)
-            {
-                int d = manhattanDistance(pos, check);
-                if (d < minDist) {
-                    minDist = d;
-                    best = check;
-                }
-            }
-        }
-    }
-    return best;
+    // The game keeps an index of pickups, so only actual pickups are looked at
+    return game->findNearestPowerUp(pos, searchRadius);
 }
 
 Command TankAI::directLineAttack(Game* game, Robot* ai, Robot* player)
 {
+    const TankParameters& params = parametersFor(game);
     QPoint aiPos = ai->getPosition();
     QPoint playerPos = player->getPosition();
     int dx = playerPos.x() - aiPos.x();
@@ -600,24 +713,24 @@ Command TankAI::directLineAttack(Game* game, Robot* ai, Robot* player)
 
     if (distance <= 1 && (aiPos.x() == playerPos.x() || aiPos.y() == playerPos.y())) {
         Direction desiredDir = getDirectionTowards(dx, dy);
-        if (ai->getHealth() < static_cast<int>(ai->getMaxHealth() * 0.3)) {
-            // Check if health pickup is available within 5 tiles
-            QPoint hpPos = findNearestHealthPickup(game, aiPos, 5);
+        if (ai->getHealth() < ai->getMaxHealth() * params.criticalHealthPercent / 100) {
+            // Check if health pickup is available within the search radius
+            QPoint hpPos = findNearestHealthPickup(game, aiPos, params.pickupSearchRadius);
             if (hpPos.x() != -1) {
-                Logger::log("directLineAttack: Very low health and health pickup available. Try to collect health.");
+                AI_LOG("directLineAttack: Very low health and health pickup available. Try to collect health.");
                 return tryCollectPickup(game, ai, true);
             }
         }
         if (ai->getDirection() != desiredDir) {
-            Logger::log("directLineAttack: Not facing player. Command: Turn.");
+            AI_LOG("directLineAttack: Not facing player. Command: Turn.");
             return getTurnCommand(ai->getDirection(), desiredDir);
         }
         if (player->getHealth() < ai->getAttackDamage()) {
-            Logger::log("directLineAttack: Sure kill. Command: Attack.");
+            AI_LOG("directLineAttack: Sure kill. Command: Attack.");
             return Command::Attack;
         }
 
-        Logger::log("directLineAttack: Conditions met. Command: Attack.");
+        AI_LOG("directLineAttack: Conditions met. Command: Attack.");
         return Command::Attack;
     }
     
@@ -3,6 +3,8 @@
 
 #include <QObject>
 #include <QPoint>
+#include "aiinterface.h"
+#include "aiparameters.h"
 
 // Forward declarations
 class Game;
@@ -21,7 +23,7 @@ enum class GameDifficulty;
  * 
  *  @author Group 17
  */
-class TankAI : public QObject
+class TankAI final : public QObject, public AIInterface
 {
     Q_OBJECT
 public:
@@ -34,21 +36,62 @@ public:
     /// @param ai Pointer to the Scout robot
     /// @param player Pointer to the opponent robot
     /// @return Command to execute
-    Command calculateMove(Game* game, Robot* ai, Robot* player);
+    Command calculateMove(Game* game, Robot* ai, Robot* player) override;
 
-private:
-    QPoint lastPlayerPosition;
-    int    lastPlayerHealth;
+    /// @brief Forgets everything remembered about the current match, called before another match
+    void reset() override;
+
+    /// @brief Seeds the choices between equally good moves, the current match starts drawing again
+    /// @param seed - the seed, the same seed gives the same choices
+    void setSeed(quint32 seed);
 
-    QPoint lastAiPosition;
-    int    samePositionCounter;
+    /// @brief Sets the thresholds the Tank decides by in games of a difficulty
+    /// @param difficulty - the difficulty of the games
+    /// @param parameters - the thresholds, AIParameterSets::defaults() until set
+    void setParameters(GameDifficulty difficulty, const TankParameters& parameters);
+    /// @param difficulty - a difficulty
+    /// @return the thresholds the Tank decides by in games of the difficulty
+    const TankParameters& getParameters(GameDifficulty difficulty) const;
+    /// @return a 64-bit hash of the thresholds of every difficulty, part of the key of cached decisions
+    quint64 hashParameters() const { return parametersHash; }
 
-    int consecutiveTurnCount;
-    int moveCounter;
-    int turnCounter;
-    bool isCirclingClockwise;
+private:
+    /// Everything the Tank remembers during a match, one copy per instance
+    struct MatchState {
+        QPoint lastPlayerPosition = QPoint(-1, -1);
+        int    lastPlayerHealth = 0;
+
+        QPoint lastAiPosition = QPoint(-1, -1);
+        int    samePositionCounter = 0;
+
+        int consecutiveTurnCount = 0;
+        int moveCounter = 0;
+        int turnCounter = 0;
+        bool isCirclingClockwise = true;
+        /// Draws the choices between equally good moves
+        AIRandom random;
+    };
+    MatchState match;
+    /// Seed of the random choices, every match starts from it
+    quint32 seed;
+    /// Thresholds per difficulty, indexed by GameDifficulty
+    TankParameters parameters[3];
+    quint64 parametersHash;
+
+public:
+    /// What the Tank remembers about the current match
+    using Memory = MatchState;
+    /// @return what the Tank remembers, cached together with its decisions by RobotAI
+    const MatchState& getMemory() const { return match; }
+    /// @brief Restores what the Tank remembered after a decision taken from the cache
+    void setMemory(const MatchState& memory) { match = memory; }
+    /// @return a 64-bit hash of what the Tank remembers, part of the key of cached decisions
+    quint64 hashMemory() const;
 
 private:
+    const TankParameters& parametersFor(Game* game) const;
+    void updateParametersHash();
+
     Command calculateTankNormal(Game* game, Robot* ai, Robot* player);
 
     Command vsScout(Game* game, Robot* ai, Robot* scout);
@@ -65,13 +108,19 @@ private:
 
     Direction getDirectionTowards(int dx, int dy);
 
+    Direction getDirectionTowards(Game* game, Robot* ai, int dx, int dy);
+
+    Direction getFlankingDirection(Game* game, Robot* ai, Robot* opponent);
+
     Direction getDirectionAway(int dx, int dy);
 
     Command getTurnCommand(Direction currentDir, Direction targetDir);
 
     QPoint getPositionInDirection(const QPoint& pos, Direction dir, int steps = 1);
 
-    Command tryMoveOrBreakWall(Game* game, Robot* ai);
+    Command tryMoveOrBreakWall(Game* game, Robot* ai, const QPoint& target);
+
+    Command makeRandomMove(Game* game, Robot* ai);
 
     Command huntPlayerPosition(Game* game, Robot* ai, int dx, int dy);
 
@@ -0,0 +1,172 @@
+#include "terrain.h"
+#include <algorithm>
+
+TerrainMap::TerrainMap(int size)
+    : gridSize(size),
+      cells(size * size, static_cast<quint8>(CellType::Empty)),
+      wallHealth(size * size, 0) {
+    updateHash();
+}
+
+TerrainMap::TerrainMap(const TerrainMap& other)
+    : gridSize(other.gridSize), cells(other.cells), wallHealth(other.wallHealth), hash(other.hash),
+      changeableCells(other.changeableCells) {
+}
+
+std::shared_ptr<const MapAnalysis> TerrainMap::getAnalysis() const {
+    QMutexLocker locker(&analysisMutex);
+    return analysis;
+}
+
+std::shared_ptr<const MapAnalysis> TerrainMap::setAnalysis(std::shared_ptr<const MapAnalysis> newAnalysis) const {
+    QMutexLocker locker(&analysisMutex);
+    if (!analysis) {
+        analysis = std::move(newAnalysis);
+    }
+    return analysis;
+}
+
+void TerrainMap::updateHash() {
+    hash = 14695981039346656037ULL;
+    auto mix = [this](quint8 byte) {
+        hash ^= byte;
+        hash *= 1099511628211ULL;
+    };
+    mix(static_cast<quint8>(gridSize));
+    changeableCells = 0;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        mix(cells[i]);
+        mix(wallHealth[i]);
+        if (cells[i] != static_cast<quint8>(CellType::Empty)) changeableCells++;
+    }
+}
+
+Terrain::Terrain() : gridSize(0), wallVersion(0), wallHealthVersion(0) {
+}
+
+Terrain& Terrain::operator=(const Terrain& other) {
+    baseMap = other.baseMap;
+    gridSize = other.gridSize;
+    wallVersion = other.wallVersion;
+    wallHealthVersion = other.wallHealthVersion;
+    // Keep the room reset() sets aside, a copy fitted to the changes so far would be outgrown by the
+    // next one. Past that, grow like insertions do.
+    size_t room = std::max(other.overlay.size(), static_cast<size_t>(baseMap ? baseMap->getChangeableCells() : 0));
+    if (overlay.capacity() < room) {
+        overlay.reserve(std::max(room, 2 * overlay.capacity()));
+    }
+    overlay = other.overlay;
+    return *this;
+}
+
+void Terrain::reset(int size) {
+    gridSize = size;
+    baseMap = std::make_shared<const TerrainMap>(size);
+    overlay.clear();
+    wallVersion++;
+    wallHealthVersion++;
+}
+
+void Terrain::reset(std::shared_ptr<const TerrainMap> map) {
+    baseMap = std::move(map);
+    gridSize = baseMap->getGridSize();
+    overlay.clear();
+    overlay.reserve(baseMap->getChangeableCells());
+    wallVersion++;
+    wallHealthVersion++;
+}
+
+void Terrain::freeze() {
+    if (overlay.empty()) {
+        return;
+    }
+
+    auto baked = std::make_shared<TerrainMap>(*baseMap);
+    for (const OverlayEntry& entry : overlay) {
+        baked->cells[entry.index] = entry.type;
+        baked->wallHealth[entry.index] = entry.wallHealth;
+    }
+    baked->updateHash();
+    baseMap = std::move(baked);
+    overlay.clear();
+    overlay.reserve(baseMap->getChangeableCells());
+}
+
+const Terrain::OverlayEntry* Terrain::findOverlay(int index) const {
+    // Most matches only change a handful of cells, so skip the search entirely when untouched
+    if (overlay.empty()) {
+        return nullptr;
+    }
+    auto it = std::lower_bound(overlay.begin(), overlay.end(), index,
+                               [](const OverlayEntry& entry, int i) { return entry.index < i; });
+    if (it != overlay.end() && it->index == index) {
+        return &*it;
+    }
+    return nullptr;
+}
+
+CellType Terrain::cellAt(int x, int y) const {
+    if (const OverlayEntry* entry = findOverlay(y * gridSize + x)) {
+        return static_cast<CellType>(entry->type);
+    }
+    return baseMap->cellAt(x, y);
+}
+
+int Terrain::wallHealthAt(int x, int y) const {
+    if (const OverlayEntry* entry = findOverlay(y * gridSize + x)) {
+        return entry->wallHealth;
+    }
+    return baseMap->wallHealthAt(x, y);
+}
+
+void Terrain::setCell(int x, int y, CellType type, int health) {
+    int index = y * gridSize + x;
+    quint8 newType = static_cast<quint8>(type);
+    quint8 newHealth = static_cast<quint8>(qBound(0, health, 255));
+
+    auto it = std::lower_bound(overlay.begin(), overlay.end(), index,
+                               [](const OverlayEntry& entry, int i) { return entry.index < i; });
+    bool hasEntry = (it != overlay.end() && it->index == index);
+
+    quint8 oldType = hasEntry ? it->type : baseMap->cells[index];
+    quint8 oldHealth = hasEntry ? it->wallHealth : baseMap->wallHealth[index];
+    quint8 wall = static_cast<quint8>(CellType::Wall);
+    if ((oldType == wall) != (newType == wall)) {
+        wallVersion++;
+        wallHealthVersion++;
+    } else if (newType == wall && oldHealth != newHealth) {
+        wallHealthVersion++;
+    }
+
+    // A cell restored to its base value no longer needs an overlay entry
+    if (baseMap->cells[index] == newType && baseMap->wallHealth[index] == newHealth) {
+        if (hasEntry) {
+            overlay.erase(it);
+        }
+        return;
+    }
+
+    if (hasEntry) {
+        it->type = newType;
+        it->wallHealth = newHealth;
+    } else {
+        overlay.insert(it, OverlayEntry{index, newType, newHealth});
+    }
+}
+
+quint64 Terrain::hashOverlay() const {
+    // The overlay is kept sorted, so equal changes always hash the same
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](quint8 byte) {
+        hash ^= byte;
+        hash *= 1099511628211ULL;
+    };
+    for (const OverlayEntry& entry : overlay) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            mix(static_cast<quint8>(entry.index >> shift));
+        }
+        mix(entry.type);
+        mix(entry.wallHealth);
+    }
+    return hash;
+}
@@ -0,0 +1,146 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include <QMutex>
+#include <QPoint>
+#include <QtGlobal>
+#include <memory>
+#include <vector>
+
+class MapAnalysis;
+
+///@brief The kind of content a single arena cell holds
+enum class CellType { Empty, Wall, HealthPickup, LaserPowerUp, MissilePowerUp, BombPowerUp };
+
+/**
+ * @brief Immutable base layout of an arena: walls, wall health and pickups as generated.
+ *
+ * A TerrainMap is never modified once built, so a single instance can be shared (through
+ * std::shared_ptr) by every match that is played on the same map.
+ *
+ * @author Group 17
+ */
+class TerrainMap {
+public:
+    /// @brief Creates an empty map
+    /// @param gridSize - the width and height of the map
+    explicit TerrainMap(int gridSize);
+    /// @brief Copies the layout of another map, but not the analysis kept with it
+    TerrainMap(const TerrainMap& other);
+    TerrainMap& operator=(const TerrainMap&) = delete;
+
+    /// @return the width and height of the map
+    int getGridSize() const { return gridSize; }
+    /// @return the cell type at (x, y), the position must be inside the map
+    CellType cellAt(int x, int y) const { return static_cast<CellType>(cells[y * gridSize + x]); }
+    /// @return the wall health at (x, y), the position must be inside the map
+    int wallHealthAt(int x, int y) const { return wallHealth[y * gridSize + x]; }
+    /// @return a 64-bit FNV-1a hash of the whole layout, equal for maps with the same cells
+    quint64 getHash() const { return hash; }
+    /// @return the number of walls and pickups, the only cells a match changes unless it spawns
+    /// new pickups
+    int getChangeableCells() const { return changeableCells; }
+
+    /// @return the analysis of the layout kept with the map, nullptr until one was set
+    std::shared_ptr<const MapAnalysis> getAnalysis() const;
+    /// @brief Keeps an analysis of the layout with the map, so that every match played on it
+    /// shares it. Safe to call from any thread, when two threads set one the first is kept.
+    /// @param analysis - the analysis, worked out for this map
+    /// @return the analysis kept with the map
+    std::shared_ptr<const MapAnalysis> setAnalysis(std::shared_ptr<const MapAnalysis> analysis) const;
+
+private:
+    friend class Terrain;
+
+    void updateHash();
+
+    int gridSize;
+    std::vector<quint8> cells;
+    std::vector<quint8> wallHealth;
+    quint64 hash;
+    int changeableCells;
+    // Worked out from the layout by the first match on the map, then only read
+    mutable QMutex analysisMutex;
+    mutable std::shared_ptr<const MapAnalysis> analysis;
+};
+
+/**
+ * @brief The terrain of a single match: a shared TerrainMap plus a sparse overlay of changes.
+ *
+ * Destroyed or damaged walls, collected pickups and pickups spawned during the match are kept
+ * in a small sorted overlay, so the memory used by a match grows with the number of changes
+ * rather than with the size of the map. Room for an entry per wall and pickup of the base map is
+ * set aside up front, so a match that only breaks walls and collects pickups never grows it.
+ *
+ * @author Group 17
+ */
+class Terrain {
+public:
+    /// @brief Creates a terrain with no cells, call reset() before use
+    Terrain();
+    Terrain(const Terrain&) = default;
+    /// @brief Copies another terrain, keeping room for an entry per wall and pickup of the base map
+    Terrain& operator=(const Terrain& other);
+
+    /// @brief Replaces the terrain with a new, completely empty map
+    /// @param gridSize - the width and height of the map
+    void reset(int gridSize);
+    /// @brief Replaces the terrain with a shared base map and clears the overlay
+    /// @param baseMap - the map to play on, must not be null
+    void reset(std::shared_ptr<const TerrainMap> baseMap);
+    /// @brief Bakes the overlay into a new immutable base map and clears the overlay.
+    /// Used once map generation is done so that the generated layout can be shared.
+    void freeze();
+
+    /// @return the width and height of the terrain
+    int getGridSize() const { return gridSize; }
+    /// @return the shared base map this terrain is built on
+    std::shared_ptr<const TerrainMap> getBaseMap() const { return baseMap; }
+    /// @return the number of cells that differ from the base map
+    int getOverlaySize() const { return static_cast<int>(overlay.size()); }
+    /// @return a counter that changes whenever a wall appears or disappears, so anything derived
+    /// from the wall layout can tell that it is out of date
+    quint32 getWallVersion() const { return wallVersion; }
+    /// @return a counter that changes whenever the health of any wall changes, including walls
+    /// being created or destroyed
+    quint32 getWallHealthVersion() const { return wallHealthVersion; }
+    /// @return a 64-bit FNV-1a hash of the cells that differ from the base map, equal for two
+    /// terrains on the same base map exactly when they hold the same changes
+    quint64 hashOverlay() const;
+
+    /// @return the cell type at (x, y), the position must be inside the map
+    CellType cellAt(int x, int y) const;
+    /// @return the cell type at pos, the position must be inside the map
+    CellType cellAt(const QPoint& pos) const { return cellAt(pos.x(), pos.y()); }
+    /// @return the wall health at (x, y), the position must be inside the map
+    int wallHealthAt(int x, int y) const;
+    /// @return the wall health at pos, the position must be inside the map
+    int wallHealthAt(const QPoint& pos) const { return wallHealthAt(pos.x(), pos.y()); }
+
+    /// @brief Changes a cell for this match only
+    /// @param x - column of the cell
+    /// @param y - row of the cell
+    /// @param type - new content of the cell
+    /// @param health - remaining health if the cell is a wall, 0 otherwise
+    void setCell(int x, int y, CellType type, int health = 0);
+    /// @brief Changes a cell for this match only
+    void setCell(const QPoint& pos, CellType type, int health = 0) { setCell(pos.x(), pos.y(), type, health); }
+
+private:
+    /// A single changed cell, ordered by its index in the map
+    struct OverlayEntry {
+        int index;
+        quint8 type;
+        quint8 wallHealth;
+    };
+
+    const OverlayEntry* findOverlay(int index) const;
+
+    std::shared_ptr<const TerrainMap> baseMap;
+    std::vector<OverlayEntry> overlay;
+    int gridSize;
+    quint32 wallVersion;
+    quint32 wallHealthVersion;
+};
+
+#endif // TERRAIN_H
@@ -1,5 +1,5 @@
 QT += testlib
-QT += widgets
+QT += widgets concurrent
 QMAKE_CXXFLAGS += -std=c++17
 CONFIG += console
 CONFIG -= app_bundle
@@ -24,50 +24,6 @@ HEADERS += \
     tests/test_powerups_environment.h \
     tests/test_robot_selection.h
 
-SOURCES += \
-    gamegrid.cpp \
-    game.cpp \
-    robot.cpp \
-    robotselector.cpp \
-    multiplayerrobotselector.cpp \
-    mainmenu.cpp \
-    gamemanager.cpp \
-    tutorial.cpp \
-    difficultyselector.cpp \
-    gameoverscreen.cpp \
-    mapselector.cpp \
-    robotai.cpp \
-    projectile.cpp \
-    hitfeedback.cpp \
-    laserfeedback.cpp \
-    sniperai.cpp \
-    scoutai.cpp \
-    tankai.cpp \
-    logger.cpp
-
-HEADERS += \
-    gamegrid.h \
-    game.h \
-    robot.h \
-    robotselector.h \
-    multiplayerrobotselector.h \
-    mainmenu.h \
-    gamemanager.h \
-    tutorial.h \
-    difficultyselector.h \
-    gameoverscreen.h \
-    mapselector.h \
-    robotai.h \
-    projectile.h \
-    hitfeedback.h \
-    laserfeedback.h \
-    aiinterface.h \
-    sniperai.h \
-    scoutai.h \
-    tankai.h \
-    logger.h
-
-RESOURCES += \
-    resources.qrc
+include(robotarena.pri)
 
-TARGET = robot_arena_tests
\ No newline at end of file
+TARGET = robot_arena_tests
@@ -0,0 +1,30 @@
+#include <QCoreApplication>
+#include <QtTest>
+#include "logger.h"
+#include "test_allocations.h"
+#include "test_distancematrix.h"
+#include "test_pathfinding.h"
+#include "test_ratings.h"
+#include "test_sprt.h"
+
+/**
+ * Runs the tests of the game engine, the AIs and the tools that measure them, which need no window.
+ * Returns 0 when every test passed.
+ */
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    Logger::setEnabled(false);
+
+    int failed = 0;
+    TestAllocations allocations;
+    failed += QTest::qExec(&allocations, argc, argv);
+    TestDistanceMatrix distanceMatrix;
+    failed += QTest::qExec(&distanceMatrix, argc, argv);
+    TestPathfinding pathfinding;
+    failed += QTest::qExec(&pathfinding, argc, argv);
+    TestRatings ratings;
+    failed += QTest::qExec(&ratings, argc, argv);
+    TestSprt sprt;
+    failed += QTest::qExec(&sprt, argc, argv);
+    return failed == 0 ? 0 : 1;
+}
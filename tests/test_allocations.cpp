@@ -0,0 +1,84 @@
+#include "test_allocations.h"
+
+#include <QtTest>
+#include "allocationcounter.h"
+#include "game.h"
+#include "matchrunner.h"
+#include "robot.h"
+#include "robotai.h"
+#include "testmaps.h"
+
+namespace {
+
+const int GRID_SIZE = 12;
+/// Commands played per match at most
+const int MAX_COMMANDS = 300;
+
+const RobotType ROBOT_TYPES[] = {RobotType::Scout, RobotType::Tank, RobotType::Sniper};
+const char* const ROBOT_NAMES[] = {"scout", "tank", "sniper"};
+
+} // namespace
+
+void TestAllocations::steadyCommandsDoNotAllocate_data() {
+    QTest::addColumn<int>("mapType");
+    QTest::addColumn<int>("playerType");
+    QTest::addColumn<int>("aiType");
+    QTest::addColumn<bool>("caching");
+    for (int map = 0; map < TEST_MAP_COUNT; ++map) {
+        for (int player = 0; player < 3; ++player) {
+            for (int ai = 0; ai < 3; ++ai) {
+                for (bool caching : {false, true}) {
+                    QTest::newRow(qPrintable(QString("%1 %2 vs %3%4").arg(TEST_MAP_NAMES[map], ROBOT_NAMES[player], ROBOT_NAMES[ai])
+                                                                      .arg(caching ? " cached" : "")))
+                        << map << player << ai << caching;
+                }
+            }
+        }
+    }
+}
+
+void TestAllocations::steadyCommandsDoNotAllocate() {
+    if (!AllocationCounter::isEnabled()) {
+        QSKIP("Allocations are only counted with ROBOTARENA_COUNT_ALLOCATIONS");
+    }
+    QFETCH(int, mapType);
+    QFETCH(int, playerType);
+    QFETCH(int, aiType);
+    QFETCH(bool, caching);
+    RobotAI::setDecisionCaching(caching);
+    const quint32 seed = static_cast<quint32>(mapType * 9 + playerType * 3 + aiType + 1);
+
+    std::shared_ptr<const TerrainMap> map = MatchRunner::generateMap(TEST_MAP_TYPES[mapType], GRID_SIZE, seed);
+    RobotAI playerSide;
+    playerSide.setSeed(seed);
+    Game game(GRID_SIZE, nullptr, nullptr, false);
+    game.setSeed(seed);
+    game.getRobotAI()->setSeed(seed + 1);
+    game.initializeArena(map, ROBOT_TYPES[playerType], ROBOT_TYPES[aiType], GameDifficulty::Medium);
+
+    // The first turn of each side sets up its planning copy of the game, from the second turn of
+    // the player on nothing may allocate
+    bool aiHasPlayed = false;
+    bool warm = false;
+    for (int command = 0; command < MAX_COMMANDS && game.getState() != GameState::GameOver; ++command) {
+        bool aiTurn = game.getState() == GameState::AiTurn;
+        quint64 before = AllocationCounter::getAllocations();
+        if (aiTurn) {
+            game.executeAiTurn();
+        } else {
+            Decision decision = playerSide.decide(&game, game.getPlayerRobot(), game.getAiRobot(), DecisionBudget());
+            game.executeCommand(decision.command);
+        }
+        quint64 allocations = AllocationCounter::getAllocations() - before;
+
+        if (warm && allocations != 0) {
+            QFAIL(qPrintable(QString("Command %1 made %2 allocations").arg(command).arg(allocations)));
+        }
+        aiHasPlayed = aiHasPlayed || aiTurn;
+        warm = warm || (aiHasPlayed && game.getState() == GameState::PlayerTurn);
+    }
+}
+
+void TestAllocations::cleanup() {
+    RobotAI::setDecisionCaching(false);
+}
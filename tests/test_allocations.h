@@ -0,0 +1,26 @@
+#ifndef TEST_ALLOCATIONS_H
+#define TEST_ALLOCATIONS_H
+
+#include <QObject>
+
+/**
+ * @brief Checks that playing a match stops touching the heap once every cache is warm.
+ *
+ * Only meaningful in a build with ROBOTARENA_COUNT_ALLOCATIONS (see enginetests.pro), skipped
+ * otherwise.
+ *
+ * @author Group 17
+ */
+class TestAllocations : public QObject {
+    Q_OBJECT
+
+private slots:
+    /// Scripted AIs on both sides, every pairing on every kind of map, with and without sharing
+    /// their decisions
+    void steadyCommandsDoNotAllocate_data();
+    void steadyCommandsDoNotAllocate();
+    /// Leaves decision caching off, as the other tests expect
+    void cleanup();
+};
+
+#endif // TEST_ALLOCATIONS_H
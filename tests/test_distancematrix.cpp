@@ -0,0 +1,69 @@
+#include "test_distancematrix.h"
+
+#include <QRandomGenerator>
+#include <QtTest>
+#include <vector>
+#include "distancematrix.h"
+#include "matchrunner.h"
+#include "terrain.h"
+#include "testmaps.h"
+
+namespace {
+
+/// The largest grid a matrix is kept for
+const int GRID_SIZE = DistanceMatrix::MAX_GRID_SIZE;
+/// Walls destroyed per map
+const int DESTROYED_WALLS = 40;
+
+/// Compares every distance of two matrices, returns a description of the first difference
+QString compareMatrices(DistanceMatrix& patched, DistanceMatrix& rebuilt) {
+    for (int from = 0; from < GRID_SIZE * GRID_SIZE; ++from) {
+        for (int to = 0; to < GRID_SIZE * GRID_SIZE; ++to) {
+            QPoint fromCell(from % GRID_SIZE, from / GRID_SIZE);
+            QPoint toCell(to % GRID_SIZE, to / GRID_SIZE);
+            int patchedDistance = patched.distance(fromCell, toCell);
+            int rebuiltDistance = rebuilt.distance(fromCell, toCell);
+            if (patchedDistance != rebuiltDistance) {
+                return QString("From (%1, %2) to (%3, %4): %5 instead of %6")
+                    .arg(fromCell.x()).arg(fromCell.y()).arg(toCell.x()).arg(toCell.y())
+                    .arg(patchedDistance).arg(rebuiltDistance);
+            }
+        }
+    }
+    return QString();
+}
+
+} // namespace
+
+void TestDistanceMatrix::patchedMatrixMatchesRebuild_data() {
+    addTestMapRows();
+}
+
+void TestDistanceMatrix::patchedMatrixMatchesRebuild() {
+    QFETCH(int, mapType);
+    QFETCH(quint32, seed);
+
+    Terrain terrain;
+    terrain.reset(MatchRunner::generateMap(TEST_MAP_TYPES[mapType], GRID_SIZE, seed));
+    DistanceMatrix patched(terrain);
+    DistanceMatrix rebuilt(terrain);
+    QVERIFY(patched.isSupported());
+    QString difference = compareMatrices(patched, rebuilt);
+    QVERIFY2(difference.isEmpty(), qPrintable(difference));
+
+    QRandomGenerator random(seed);
+    std::vector<QPoint> walls;
+    for (int destroyed = 0; destroyed < DESTROYED_WALLS; ++destroyed) {
+        findWalls(terrain, GRID_SIZE, walls);
+        if (walls.empty()) break;
+
+        QPoint pos = walls[random.bounded(static_cast<int>(walls.size()))];
+        terrain.setCell(pos, CellType::Empty);
+        patched.wallDestroyed(pos);
+
+        rebuilt.rebuild();
+        difference = compareMatrices(patched, rebuilt);
+        QVERIFY2(difference.isEmpty(), qPrintable(QString("After destroying (%1, %2): %3")
+                                                      .arg(pos.x()).arg(pos.y()).arg(difference)));
+    }
+}
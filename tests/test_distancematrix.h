@@ -0,0 +1,21 @@
+#ifndef TEST_DISTANCEMATRIX_H
+#define TEST_DISTANCEMATRIX_H
+
+#include <QObject>
+
+/**
+ * @brief Checks that the all-pairs distances DistanceMatrix patches as walls are destroyed match
+ * the ones it would compute from scratch.
+ *
+ * @author Group 17
+ */
+class TestDistanceMatrix : public QObject {
+    Q_OBJECT
+
+private slots:
+    /// Walls of every kind of map destroyed one at a time in a random order
+    void patchedMatrixMatchesRebuild_data();
+    void patchedMatrixMatchesRebuild();
+};
+
+#endif // TEST_DISTANCEMATRIX_H
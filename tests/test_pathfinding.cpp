@@ -0,0 +1,91 @@
+#include "test_pathfinding.h"
+
+#include <QRandomGenerator>
+#include <QtTest>
+#include <vector>
+#include "arenaallocator.h"
+#include "matchrunner.h"
+#include "pathfinding.h"
+#include "terrain.h"
+#include "testmaps.h"
+
+namespace {
+
+const int GRID_SIZE = 12;
+/// Walls hit per map
+const int HITS = 60;
+/// Targets and wall damages the cost maps are kept for, together no more than the service caches
+const QPoint TARGETS[] = {QPoint(0, 0), QPoint(11, 11), QPoint(5, 6), QPoint(11, 0)};
+const int WALL_DAMAGES[] = {1, 3};
+
+/// Compares every cost and first step of two services, returns a description of the first difference
+QString compareCostMaps(PathfindingService& patched, PathfindingService& rebuilt) {
+    for (const QPoint& target : TARGETS) {
+        for (int damage : WALL_DAMAGES) {
+            for (int y = 0; y < GRID_SIZE; ++y) {
+                for (int x = 0; x < GRID_SIZE; ++x) {
+                    for (int facing = 0; facing < 4; ++facing) {
+                        QPoint from(x, y);
+                        Direction dir = static_cast<Direction>(facing);
+                        int patchedCost = patched.travelCost(from, dir, target, damage);
+                        int rebuiltCost = rebuilt.travelCost(from, dir, target, damage);
+                        Direction patchedStep = Direction::North;
+                        Direction rebuiltStep = Direction::North;
+                        bool patchedFound = patched.bestDirectionTowards(from, dir, target, damage, &patchedStep);
+                        bool rebuiltFound = rebuilt.bestDirectionTowards(from, dir, target, damage, &rebuiltStep);
+                        if (patchedCost != rebuiltCost || patchedFound != rebuiltFound || patchedStep != rebuiltStep) {
+                            return QString("From (%1, %2) facing %3 to (%4, %5) with damage %6: cost %7 and step %8 "
+                                           "instead of %9 and %10")
+                                .arg(x).arg(y).arg(facing).arg(target.x()).arg(target.y()).arg(damage)
+                                .arg(patchedCost).arg(patchedFound ? static_cast<int>(patchedStep) : -1)
+                                .arg(rebuiltCost).arg(rebuiltFound ? static_cast<int>(rebuiltStep) : -1);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return QString();
+}
+
+} // namespace
+
+void TestPathfinding::patchedCostMapsMatchRebuild_data() {
+    addTestMapRows();
+}
+
+void TestPathfinding::patchedCostMapsMatchRebuild() {
+    QFETCH(int, mapType);
+    QFETCH(quint32, seed);
+
+    Terrain terrain;
+    terrain.reset(MatchRunner::generateMap(TEST_MAP_TYPES[mapType], GRID_SIZE, seed));
+    ArenaAllocator patchedArena;
+    ArenaAllocator rebuiltArena;
+    PathfindingService patched(terrain, patchedArena);
+    PathfindingService rebuilt(terrain, rebuiltArena);
+    QString difference = compareCostMaps(patched, rebuilt);
+    QVERIFY2(difference.isEmpty(), qPrintable(difference));
+
+    QRandomGenerator random(seed);
+    std::vector<QPoint> walls;
+    for (int hit = 0; hit < HITS; ++hit) {
+        findWalls(terrain, GRID_SIZE, walls);
+        if (walls.empty()) break;
+
+        // Hit the wall as Game::attackWall() does
+        QPoint pos = walls[random.bounded(static_cast<int>(walls.size()))];
+        int remainingHealth = terrain.wallHealthAt(pos) - (1 + random.bounded(3));
+        if (remainingHealth <= 0) {
+            terrain.setCell(pos, CellType::Empty);
+        } else {
+            terrain.setCell(pos, CellType::Wall, remainingHealth);
+        }
+        patched.wallDamaged(pos);
+
+        rebuilt.invalidate();
+        difference = compareCostMaps(patched, rebuilt);
+        QVERIFY2(difference.isEmpty(), qPrintable(QString("After hit %1 on (%2, %3): %4")
+                                                      .arg(hit).arg(pos.x()).arg(pos.y()).arg(difference)));
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef TEST_PATHFINDING_H
+#define TEST_PATHFINDING_H
+
+#include <QObject>
+
+/**
+ * @brief Checks that the weighted cost maps PathfindingService patches as walls take damage match
+ * the ones it would compute from scratch.
+ *
+ * @author Group 17
+ */
+class TestPathfinding : public QObject {
+    Q_OBJECT
+
+private slots:
+    /// Random hits on the walls of every kind of map
+    void patchedCostMapsMatchRebuild_data();
+    void patchedCostMapsMatchRebuild();
+};
+
+#endif // TEST_PATHFINDING_H
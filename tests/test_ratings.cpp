@@ -0,0 +1,197 @@
+#include "test_ratings.h"
+
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtTest>
+#include <cmath>
+#include "ratings.h"
+#include "tournament.h"
+
+namespace {
+
+const double TOLERANCE = 1e-9;
+
+bool isClose(double value, double expected, double tolerance = TOLERANCE) {
+    return std::fabs(value - expected) < tolerance;
+}
+
+/// Two scripted entrants on one map type, so a round is a single pairing played both ways
+Tournament makeTournament(quint32 seed) {
+    Entrant scout;
+    scout.strategy = "default";
+    scout.type = RobotType::Scout;
+    Entrant tank;
+    tank.strategy = "default";
+    tank.type = RobotType::Tank;
+    return Tournament({scout, tank}, Tournament::Format::RoundRobin, {MapType::Open}, {GameDifficulty::Medium}, seed);
+}
+
+QStringList readLines(const QString& path) {
+    QStringList lines;
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream in(&file);
+        while (!in.atEnd()) lines.append(in.readLine());
+    }
+    return lines;
+}
+
+} // namespace
+
+void TestRatings::entrantsStartEven() {
+    RatingTable table(3);
+    QCOMPARE(table.size(), 3);
+    for (int i = 0; i < table.size(); ++i) {
+        QCOMPARE(table.at(i).elo, RatingTable::INITIAL_RATING);
+        QCOMPARE(table.at(i).glicko, RatingTable::INITIAL_RATING);
+        QCOMPARE(table.at(i).deviation, RatingTable::INITIAL_DEVIATION);
+        QCOMPARE(table.at(i).games(), 0);
+        QCOMPARE(table.at(i).score(), 0.5);
+    }
+}
+
+void TestRatings::eloMovesAfterEveryGame() {
+    RatingTable table(3, 16.0);
+    // Between even entrants the expected score is a half
+    table.addGame(0, 1, 1.0);
+    QVERIFY(isClose(table.at(0).elo, 1508.0));
+    QVERIFY(isClose(table.at(1).elo, 1492.0));
+    QCOMPARE(table.at(2).elo, RatingTable::INITIAL_RATING);
+
+    // The favourite gains less by winning again than it loses by a draw
+    table.addGame(0, 1, 1.0);
+    double gain = table.at(0).elo - 1508.0;
+    QVERIFY(gain > 0.0 && gain < 8.0);
+    double before = table.at(0).elo;
+    table.addGame(1, 0, 0.5);
+    QVERIFY(table.at(0).elo < before);
+    QVERIFY(isClose(table.at(0).elo + table.at(1).elo + table.at(2).elo, 3 * RatingTable::INITIAL_RATING));
+}
+
+void TestRatings::resultsAreCounted() {
+    RatingTable table(2);
+    table.addGame(0, 1, 1.0);
+    table.addGame(1, 0, 1.0);
+    table.addGame(1, 0, 0.5);
+    table.addGame(0, 1, 0.0);
+    QCOMPARE(table.at(0).wins, 1);
+    QCOMPARE(table.at(0).draws, 1);
+    QCOMPARE(table.at(0).losses, 2);
+    QCOMPARE(table.at(1).wins, 2);
+    QCOMPARE(table.at(1).draws, 1);
+    QCOMPARE(table.at(1).losses, 1);
+    QCOMPARE(table.at(0).games(), 4);
+    QVERIFY(isClose(table.at(0).score(), 1.5 / 4.0));
+    QVERIFY(isClose(table.at(1).score(), 2.5 / 4.0));
+}
+
+void TestRatings::glickoMovesPerPeriod() {
+    RatingTable table(2);
+    table.addGame(0, 1, 1.0);
+    // Nothing moves until the period ends
+    QCOMPARE(table.at(0).glicko, RatingTable::INITIAL_RATING);
+    QCOMPARE(table.at(0).deviation, RatingTable::INITIAL_DEVIATION);
+
+    table.endPeriod();
+    QVERIFY(isClose(table.at(0).glicko, 1662.21, 0.01));
+    QVERIFY(isClose(table.at(1).glicko, 1337.79, 0.01));
+    QVERIFY(isClose(table.at(0).deviation, 290.23, 0.01));
+    QVERIFY(isClose(table.at(1).deviation, table.at(0).deviation));
+}
+
+void TestRatings::glickoIgnoresOrderInPeriod() {
+    RatingTable forward(3);
+    forward.addGame(0, 1, 1.0);
+    forward.addGame(1, 2, 0.5);
+    forward.addGame(2, 0, 1.0);
+    forward.endPeriod();
+    RatingTable backward(3);
+    backward.addGame(2, 0, 1.0);
+    backward.addGame(1, 2, 0.5);
+    backward.addGame(0, 1, 1.0);
+    backward.endPeriod();
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(isClose(forward.at(i).glicko, backward.at(i).glicko));
+        QVERIFY(isClose(forward.at(i).deviation, backward.at(i).deviation));
+    }
+}
+
+void TestRatings::deviationGrowsWhenSittingOut() {
+    RatingTable table(3, 16.0, 30.0);
+    for (int period = 0; period < 5; ++period) {
+        table.addGame(0, 1, 0.5);
+        table.addGame(0, 2, 0.5);
+        table.addGame(1, 2, 0.5);
+        table.endPeriod();
+    }
+    double deviation = table.at(2).deviation;
+    QVERIFY(deviation < RatingTable::INITIAL_DEVIATION);
+
+    // Entrant 2 sits the next period out
+    table.addGame(0, 1, 0.5);
+    table.endPeriod();
+    QVERIFY(isClose(table.at(2).deviation, std::sqrt(deviation * deviation + 30.0 * 30.0)));
+    QVERIFY(table.at(0).deviation < table.at(2).deviation);
+
+    for (int period = 0; period < 200; ++period) {
+        table.endPeriod();
+    }
+    QCOMPARE(table.at(2).deviation, RatingTable::INITIAL_DEVIATION);
+}
+
+void TestRatings::tournamentResumesFromLog() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("tournament.log");
+    QString error;
+
+    Tournament played = makeTournament(7);
+    QVERIFY2(played.open(path, &error), qPrintable(error));
+    QCOMPARE(played.firstUnfinishedRound(), 0);
+    QVERIFY(played.playRound(0, 1));
+    QVERIFY(played.playRound(1, 1));
+    QCOMPARE(played.firstUnfinishedRound(), 2);
+    const QString standings = played.standings();
+    // The header, then both games of both rounds
+    QStringList lines = readLines(path);
+    QCOMPARE(static_cast<int>(lines.size()), 5);
+
+    Tournament reopened = makeTournament(7);
+    QVERIFY2(reopened.open(path, &error), qPrintable(error));
+    QCOMPARE(reopened.firstUnfinishedRound(), 2);
+    QCOMPARE(reopened.standings(), standings);
+
+    // Cut the last result short, as a crash while writing it would
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+        QString last = lines.takeLast();
+        lines.append(last.left(last.size() / 2));
+        QTextStream(&file) << lines.join("\n");
+    }
+    Tournament resumed = makeTournament(7);
+    QVERIFY2(resumed.open(path, &error), qPrintable(error));
+    QCOMPARE(resumed.firstUnfinishedRound(), 1);
+    QVERIFY(resumed.playRound(1, 1));
+    QCOMPARE(resumed.firstUnfinishedRound(), 2);
+    // Only the missing game was played again, after the cut line, and it ended the same way
+    QCOMPARE(static_cast<int>(readLines(path).size()), 6);
+    QCOMPARE(resumed.standings(), standings);
+}
+
+void TestRatings::tournamentRefusesOtherLog() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("tournament.log");
+    QString error;
+
+    Tournament first = makeTournament(7);
+    QVERIFY2(first.open(path, &error), qPrintable(error));
+    QVERIFY(first.playRound(0, 1));
+
+    Tournament other = makeTournament(8);
+    QVERIFY(!other.open(path, &error));
+    QVERIFY(!error.isEmpty());
+}
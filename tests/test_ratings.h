@@ -0,0 +1,34 @@
+#ifndef TEST_RATINGS_H
+#define TEST_RATINGS_H
+
+#include <QObject>
+
+/**
+ * @brief Checks the Elo and Glicko ratings of the ladder tool (see RatingTable) and that a
+ * Tournament picks up where its results log ends.
+ *
+ * @author Group 17
+ */
+class TestRatings : public QObject {
+    Q_OBJECT
+
+private slots:
+    /// Every entrant starts at the initial rating without games
+    void entrantsStartEven();
+    /// Elo moves by K times the surprise of a game, and what one side gains the other loses
+    void eloMovesAfterEveryGame();
+    /// Results are counted from the side of each entrant
+    void resultsAreCounted();
+    /// Glicko moves once per period, by the textbook amount for one game between new entrants
+    void glickoMovesPerPeriod();
+    /// The order of the games in a period does not matter to Glicko
+    void glickoIgnoresOrderInPeriod();
+    /// Deviation grows while an entrant sits out, up to the initial deviation
+    void deviationGrowsWhenSittingOut();
+    /// A tournament reopened on its log, even one cut short, only plays the games missing from it
+    void tournamentResumesFromLog();
+    /// A log of a tournament with other settings is refused
+    void tournamentRefusesOtherLog();
+};
+
+#endif // TEST_RATINGS_H
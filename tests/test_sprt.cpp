@@ -0,0 +1,123 @@
+#include "test_sprt.h"
+
+#include <QtTest>
+#include <cmath>
+#include "sprt.h"
+
+namespace {
+
+const double TOLERANCE = 1e-9;
+/// Pairs fed to a test before it has to decide, an even match takes about 7000 to tell from 5 Elo
+const int MAX_PAIRS = 20000;
+
+bool isClose(double value, double expected) {
+    return std::fabs(value - expected) < TOLERANCE;
+}
+
+} // namespace
+
+void TestSprt::scoreAndEloConvert() {
+    QVERIFY(isClose(Sprt::scoreOf(0.0), 0.5));
+    QVERIFY(isClose(Sprt::scoreOf(400.0), 10.0 / 11.0));
+    QVERIFY(isClose(Sprt::scoreOf(-400.0), 1.0 / 11.0));
+    for (double elo : {-300.0, -20.0, 0.0, 5.0, 150.0}) {
+        QVERIFY(isClose(Sprt::eloOf(Sprt::scoreOf(elo)), elo));
+    }
+    // Certain results are kept to a finite difference
+    QVERIFY(std::isfinite(Sprt::eloOf(0.0)));
+    QVERIFY(std::isfinite(Sprt::eloOf(1.0)));
+    QVERIFY(Sprt::eloOf(0.0) < 0.0);
+    QVERIFY(Sprt::eloOf(1.0) > 0.0);
+}
+
+void TestSprt::pairsAreCountedByPoints() {
+    Sprt sprt(0.0, 5.0, 0.05, 0.05);
+    for (double points : {0.0, 0.5, 1.0, 1.0, 1.5, 2.0, 2.0, 2.0, 3.0, -1.0}) {
+        sprt.addPair(points);
+    }
+    QCOMPARE(sprt.getPairs(), 10);
+    QCOMPARE(sprt.getPairsScoring(0.0), 2);
+    QCOMPARE(sprt.getPairsScoring(0.5), 1);
+    QCOMPARE(sprt.getPairsScoring(1.0), 2);
+    QCOMPARE(sprt.getPairsScoring(1.5), 1);
+    QCOMPARE(sprt.getPairsScoring(2.0), 4);
+    QCOMPARE(sprt.getPairsScoring(2.5), 0);
+    QCOMPARE(sprt.getPairsScoring(-0.5), 0);
+}
+
+void TestSprt::boundsFollowErrorRates() {
+    Sprt symmetric(0.0, 5.0, 0.05, 0.05);
+    QVERIFY(isClose(symmetric.lowerBound(), std::log(0.05 / 0.95)));
+    QVERIFY(isClose(symmetric.upperBound(), std::log(0.95 / 0.05)));
+    QVERIFY(isClose(symmetric.lowerBound(), -symmetric.upperBound()));
+
+    Sprt skewed(0.0, 5.0, 0.01, 0.1);
+    QVERIFY(isClose(skewed.lowerBound(), std::log(0.1 / 0.99)));
+    QVERIFY(isClose(skewed.upperBound(), std::log(0.9 / 0.01)));
+}
+
+void TestSprt::llrMatchesNormalApproximation() {
+    Sprt sprt(0.0, 5.0, 0.05, 0.05);
+    for (double points : {2.0, 1.5, 1.0, 1.5, 0.5, 2.0}) {
+        sprt.addPair(points);
+    }
+    // Mean pair score 17/24 with variance 41/576, worked out by hand
+    const double score0 = 0.5;
+    const double score1 = Sprt::scoreOf(5.0);
+    const double expected = 6 * (score1 - score0) * (2.0 * 17.0 / 24.0 - score0 - score1) / (2.0 * 41.0 / 576.0);
+    QVERIFY(isClose(sprt.llr(), expected));
+    QVERIFY(isClose(sprt.llr(), 0.12417077198865153));
+    QVERIFY(sprt.verdict() == Sprt::Verdict::Continue);
+}
+
+void TestSprt::llrIsZeroWithoutVariance() {
+    Sprt sprt(0.0, 5.0, 0.05, 0.05);
+    QCOMPARE(sprt.llr(), 0.0);
+    QVERIFY(sprt.verdict() == Sprt::Verdict::Continue);
+    for (int i = 0; i < 100; ++i) {
+        sprt.addPair(2.0);
+    }
+    QCOMPARE(sprt.llr(), 0.0);
+    QVERIFY(sprt.verdict() == Sprt::Verdict::Continue);
+}
+
+void TestSprt::verdictFollowsResults_data() {
+    QTest::addColumn<double>("firstPoints");
+    QTest::addColumn<double>("secondPoints");
+    QTest::addColumn<int>("verdict");
+    QTest::newRow("A stronger") << 2.0 << 1.0 << static_cast<int>(Sprt::Verdict::AcceptH1);
+    QTest::newRow("A weaker") << 0.0 << 1.0 << static_cast<int>(Sprt::Verdict::AcceptH0);
+    QTest::newRow("even") << 0.5 << 1.5 << static_cast<int>(Sprt::Verdict::AcceptH0);
+}
+
+void TestSprt::verdictFollowsResults() {
+    QFETCH(double, firstPoints);
+    QFETCH(double, secondPoints);
+    QFETCH(int, verdict);
+
+    // Pairs alternate between two scores until the test stops
+    Sprt sprt(0.0, 5.0, 0.05, 0.05);
+    while (sprt.verdict() == Sprt::Verdict::Continue && sprt.getPairs() < MAX_PAIRS) {
+        sprt.addPair(sprt.getPairs() % 2 == 0 ? firstPoints : secondPoints);
+    }
+    QCOMPARE(static_cast<int>(sprt.verdict()), verdict);
+    if (verdict == static_cast<int>(Sprt::Verdict::AcceptH1)) {
+        QVERIFY(sprt.llr() >= sprt.upperBound());
+    } else {
+        QVERIFY(sprt.llr() <= sprt.lowerBound());
+    }
+}
+
+void TestSprt::eloIntervalContainsEstimate() {
+    Sprt sprt(0.0, 5.0, 0.05, 0.05);
+    QVERIFY(sprt.eloLower() < sprt.eloUpper());
+    for (double points : {2.0, 1.5, 1.0, 1.5, 0.5, 2.0}) {
+        sprt.addPair(points);
+    }
+    QVERIFY(isClose(sprt.eloDifference(), Sprt::eloOf(17.0 / 24.0)));
+    QVERIFY(sprt.eloLower() < sprt.eloDifference());
+    QVERIFY(sprt.eloDifference() < sprt.eloUpper());
+    // A wider interval holds the narrower one
+    QVERIFY(sprt.eloLower(2.58) < sprt.eloLower(1.96));
+    QVERIFY(sprt.eloUpper(2.58) > sprt.eloUpper(1.96));
+}
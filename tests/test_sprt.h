@@ -0,0 +1,32 @@
+#ifndef TEST_SPRT_H
+#define TEST_SPRT_H
+
+#include <QObject>
+
+/**
+ * @brief Checks the sequential probability ratio test the A/B tool stops on (see Sprt).
+ *
+ * @author Group 17
+ */
+class TestSprt : public QObject {
+    Q_OBJECT
+
+private slots:
+    /// Elo differences and expected scores convert into each other
+    void scoreAndEloConvert();
+    /// Pair scores are counted by points, out of range ones at the nearest end
+    void pairsAreCountedByPoints();
+    /// The bounds follow from the error rates
+    void boundsFollowErrorRates();
+    /// The ratio is the normal approximation over the pair scores
+    void llrMatchesNormalApproximation();
+    /// Pairs that all score the same give nothing to measure the noise by
+    void llrIsZeroWithoutVariance();
+    /// A clearly stronger A is accepted as H1, a clearly weaker one as H0
+    void verdictFollowsResults_data();
+    void verdictFollowsResults();
+    /// The estimate lies inside its confidence interval
+    void eloIntervalContainsEstimate();
+};
+
+#endif // TEST_SPRT_H
@@ -0,0 +1,45 @@
+#ifndef TESTMAPS_H
+#define TESTMAPS_H
+
+#include <QPoint>
+#include <QString>
+#include <QtTest>
+#include <vector>
+#include "mapselector.h"
+#include "terrain.h"
+
+// Maps the engine tests are run on: every kind of map, each generated from a few seeds
+
+/// Number of kinds of maps
+const int TEST_MAP_COUNT = 4;
+const MapType TEST_MAP_TYPES[TEST_MAP_COUNT] = {MapType::Random, MapType::Open, MapType::Maze, MapType::Fortress};
+const char* const TEST_MAP_NAMES[TEST_MAP_COUNT] = {"random", "open", "maze", "fortress"};
+/// Seeds 1 up to this one are used for every kind of map
+const quint32 TEST_MAP_SEEDS = 3;
+
+/// @brief Adds the columns "mapType", an index into TEST_MAP_TYPES, and "seed", with a row for
+/// every kind of map and seed
+inline void addTestMapRows() {
+    QTest::addColumn<int>("mapType");
+    QTest::addColumn<quint32>("seed");
+    for (int map = 0; map < TEST_MAP_COUNT; ++map) {
+        for (quint32 seed = 1; seed <= TEST_MAP_SEEDS; ++seed) {
+            QTest::newRow(qPrintable(QString("%1 %2").arg(TEST_MAP_NAMES[map]).arg(seed))) << map << seed;
+        }
+    }
+}
+
+/// @brief Lists the cells of the terrain that are walls
+/// @param terrain - the terrain
+/// @param gridSize - the width and height of the terrain
+/// @param walls - cleared and filled with the walls, row by row
+inline void findWalls(const Terrain& terrain, int gridSize, std::vector<QPoint>& walls) {
+    walls.clear();
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            if (terrain.cellAt(x, y) == CellType::Wall) walls.push_back(QPoint(x, y));
+        }
+    }
+}
+
+#endif // TESTMAPS_H
@@ -0,0 +1,102 @@
+#include "threatmap.h"
+#include "terrain.h"
+#include "pathfinding.h"
+#include <algorithm>
+
+namespace {
+const int DX[4] = { 0, 1, 0, -1 };
+const int DY[4] = { -1, 0, 1, 0 };
+}
+
+ThreatMap::ThreatMap()
+    : gridSize(0), valid(false), type(RobotType::Scout), powerUp(RobotPowerUp::None), wallVersion(0), version(0) {
+}
+
+void ThreatMap::update(const Robot& attacker, const Terrain& terrain, PathfindingService& pathfinding) {
+    if (valid && gridSize == terrain.getGridSize() && position == attacker.getPosition() &&
+        type == attacker.getType() && powerUp == attacker.getPowerUp() &&
+        wallVersion == terrain.getWallVersion()) {
+        return;
+    }
+    recompute(attacker, terrain, pathfinding);
+}
+
+void ThreatMap::recompute(const Robot& attacker, const Terrain& terrain, PathfindingService& pathfinding) {
+    gridSize = terrain.getGridSize();
+    position = attacker.getPosition();
+    type = attacker.getType();
+    powerUp = attacker.getPowerUp();
+    wallVersion = terrain.getWallVersion();
+    valid = true;
+    version++;
+
+    cells.assign(gridSize * gridSize, NO_THREAT);
+
+    // Every open cell the attacker can walk to is a place it could shoot from
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            if (terrain.cellAt(x, y) == CellType::Wall) continue;
+            // Distances are symmetric, asking towards the attacker reuses a single field
+            int walk = pathfinding.distance(QPoint(x, y), position);
+            if (walk >= NO_THREAT - 1) continue;
+            quint8 cost = static_cast<quint8>(walk + 1);
+            for (int d = 0; d < 4; ++d) {
+                castAttack(terrain, QPoint(x, y), d, cost);
+            }
+        }
+    }
+}
+
+void ThreatMap::mark(int x, int y, quint8 cost) {
+    quint8& cell = cells[y * gridSize + x];
+    cell = std::min(cell, cost);
+}
+
+void ThreatMap::castAttack(const Terrain& terrain, const QPoint& from, int dir, quint8 cost) {
+    auto inside = [this](int x, int y) { return x >= 0 && y >= 0 && x < gridSize && y < gridSize; };
+    int x = from.x();
+    int y = from.y();
+
+    switch (powerUp) {
+        case RobotPowerUp::None: {
+            int range = (type == RobotType::Sniper) ? 3 : 1;
+            for (int step = 0; step < range; ++step) {
+                x += DX[dir];
+                y += DY[dir];
+                if (!inside(x, y)) break;
+                mark(x, y, cost);
+                if (terrain.cellAt(x, y) == CellType::Wall) break;
+            }
+            break;
+        }
+        case RobotPowerUp::Laser:
+            // Passes through walls
+            for (x += DX[dir], y += DY[dir]; inside(x, y); x += DX[dir], y += DY[dir]) {
+                mark(x, y, cost);
+            }
+            break;
+        case RobotPowerUp::Missile:
+            for (x += DX[dir], y += DY[dir]; inside(x, y); x += DX[dir], y += DY[dir]) {
+                mark(x, y, cost);
+                if (terrain.cellAt(x, y) == CellType::Wall) break;
+            }
+            break;
+        case RobotPowerUp::Bomb: {
+            // A robot on the line stops the bomb, so every cell up to the impact is hit directly
+            int impactX = x;
+            int impactY = y;
+            for (x += DX[dir], y += DY[dir]; inside(x, y); x += DX[dir], y += DY[dir]) {
+                mark(x, y, cost);
+                impactX = x;
+                impactY = y;
+                if (terrain.cellAt(x, y) == CellType::Wall) break;
+            }
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (inside(impactX + dx, impactY + dy)) mark(impactX + dx, impactY + dy, cost);
+                }
+            }
+            break;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef THREATMAP_H
+#define THREATMAP_H
+
+#include <QPoint>
+#include <QtGlobal>
+#include <vector>
+#include "robot.h"
+
+class Terrain;
+class PathfindingService;
+
+/**
+ * @brief For every cell, how many moves a robot needs before its attack could reach that cell.
+ *
+ * Walking is measured around walls, turning is free and the attack itself counts as one move.
+ * The reach of the attack follows the game rules: one cell (three for the Sniper) up to the
+ * first wall, the whole line for a laser, up to the first wall for a missile, and for a bomb the
+ * line plus the 3x3 area where it detonates.
+ *
+ * The map is only recomputed when the robot moved, turned into a different type, gained or used
+ * a power-up, or the wall layout changed; otherwise update() returns at once.
+ *
+ * @author Group 17
+ */
+class ThreatMap {
+public:
+    /// Stored for cells the robot cannot hit at all
+    static constexpr quint8 NO_THREAT = 0xFF;
+
+    ThreatMap();
+
+    /// @brief Brings the map up to date for a robot
+    /// @param attacker - the robot whose attacks are mapped
+    /// @param terrain - the terrain of the match
+    /// @param pathfinding - used for the walking distances of the attacker
+    void update(const Robot& attacker, const Terrain& terrain, PathfindingService& pathfinding);
+    /// @brief Forces the next update() to recompute the map
+    void invalidate() { valid = false; }
+    /// @brief Sets aside the memory of a map of the given size, so that update() does not allocate
+    /// @param size - the width and height of the grid
+    void reserve(int size) { cells.reserve(size * size); }
+
+    /// @param cell - the cell to check, must be inside the grid
+    /// @return the number of moves (attack included) the robot needs to hit the cell, or NO_THREAT
+    quint8 movesToHit(const QPoint& cell) const { return cells[cell.y() * gridSize + cell.x()]; }
+
+    /// @param cell - the cell to check, must be inside the grid
+    /// @param moves - the number of moves the robot has
+    /// @return TRUE if the robot can hit the cell with that many moves, FALSE otherwise
+    bool canHit(const QPoint& cell, int moves) const { return movesToHit(cell) <= moves; }
+
+    /// @return a counter that changes every time the map is recomputed
+    quint32 getVersion() const { return version; }
+
+private:
+    void recompute(const Robot& attacker, const Terrain& terrain, PathfindingService& pathfinding);
+    void castAttack(const Terrain& terrain, const QPoint& from, int dir, quint8 cost);
+    void mark(int x, int y, quint8 cost);
+
+    std::vector<quint8> cells;
+    int gridSize;
+    bool valid;
+    QPoint position;
+    RobotType type;
+    RobotPowerUp powerUp;
+    quint32 wallVersion;
+    quint32 version;
+};
+
+#endif // THREATMAP_H
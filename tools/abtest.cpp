@@ -0,0 +1,226 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include <QThreadPool>
+#include <memory>
+#include <vector>
+
+#include "aiparameters.h"
+#include "airegistry.h"
+#include "logger.h"
+#include "matchrunner.h"
+#include "robotai.h"
+#include "sprt.h"
+
+/**
+ * Pits two AI versions against each other until a sequential probability ratio test (see Sprt)
+ * decides which hypothesis holds, then reports the Elo difference with its confidence interval.
+ *
+ * A version is a strategy name from AIRegistry, or "default" for the scripted AI of each robot,
+ * with optional parameter sets written by the tuner. Matches are played in pairs on the same map
+ * and seed: in the first A moves first from the player's corner, in the second B does. Every
+ * other pair swaps the corners as well, and the robot types cycle through every pairing of the
+ * types asked for. Pairs are played a batch at a time on every thread, and the test is checked
+ * after every pair in order, so the verdict does not depend on how many threads there are.
+ */
+
+namespace {
+
+const RobotType ROBOT_TYPES[] = {RobotType::Scout, RobotType::Tank, RobotType::Sniper};
+const char* const ROBOT_NAMES[] = {"scout", "tank", "sniper"};
+const MapType MAP_TYPES[] = {MapType::Random, MapType::Open, MapType::Maze, MapType::Fortress};
+const GameDifficulty DIFFICULTIES[] = {GameDifficulty::Easy, GameDifficulty::Medium, GameDifficulty::Hard};
+const char* const DIFFICULTY_NAMES[] = {"easy", "medium", "hard"};
+const int GRID_SIZE = 12;
+
+/// One side of the test
+struct Version {
+    /// Strategy of every robot type, "default" for the scripted ones
+    QString strategy = "default";
+    AIParameterSets parameters = AIParameterSets::defaults();
+};
+
+std::function<void(RobotAI&)> setupWith(const Version& version, GameDifficulty difficulty) {
+    return [version, difficulty](RobotAI& ai) {
+        if (version.strategy != "default") {
+            for (RobotType type : ROBOT_TYPES) {
+                ai.setStrategy(type, version.strategy);
+            }
+        }
+        ai.setParameters(difficulty, version.parameters.at(difficulty));
+    };
+}
+
+/// Points of the side that moved first: 1 for a win, 0.5 for a draw and 0 for a loss
+double pointsOfPlayer(const MatchResult& result) {
+    switch (result.outcome) {
+        case MatchOutcome::PlayerWon: return 1.0;
+        case MatchOutcome::AiWon:     return 0.0;
+        default:                      return 0.5;
+    }
+}
+
+/// Reads one version from the options, FALSE with a message if it is not valid
+bool readVersion(const QCommandLineParser& parser, const QCommandLineOption& strategyOption,
+                 const QCommandLineOption& parametersOption, Version& version, QTextStream& out) {
+    version.strategy = parser.value(strategyOption);
+    if (version.strategy != "default" && !AIRegistry::contains(version.strategy)) {
+        out << "Unknown strategy " << version.strategy << ", known are default";
+        for (const QString& name : AIRegistry::names()) out << ", " << name;
+        out << '\n';
+        return false;
+    }
+    if (parser.isSet(parametersOption) && !version.parameters.load(parser.value(parametersOption))) {
+        out << "Could not read " << parser.value(parametersOption) << '\n';
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("robot_arena_abtest");
+    Logger::setEnabled(false);
+    // Batches of matches on the same maps keep reaching the same positions, and a cached decision is
+    // the one the strategy would make again
+    RobotAI::setDecisionCaching(true);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Tests whether AI version A is stronger than version B.");
+    parser.addHelpOption();
+    QCommandLineOption aOption("a", "Strategy of version A, default for the scripted AIs.", "name", "default");
+    QCommandLineOption bOption("b", "Strategy of version B, default for the scripted AIs.", "name", "default");
+    QCommandLineOption aParametersOption("a-parameters", "Parameter sets of version A.", "file");
+    QCommandLineOption bParametersOption("b-parameters", "Parameter sets of version B.", "file");
+    QCommandLineOption elo0Option("elo0", "Elo difference of H0.", "elo", "0");
+    QCommandLineOption elo1Option("elo1", "Elo difference of H1.", "elo", "10");
+    QCommandLineOption alphaOption("alpha", "Chance of accepting H1 when H0 holds.", "rate", "0.05");
+    QCommandLineOption betaOption("beta", "Chance of accepting H0 when H1 holds.", "rate", "0.05");
+    QCommandLineOption maxGamesOption("max-games", "Matches after which the test stops undecided.", "count", "20000");
+    QCommandLineOption difficultyOption("difficulty", "easy, medium or hard.", "name", "medium");
+    QCommandLineOption robotsOption("robots", "Robot types to play with, separated by commas.", "names", "scout,tank,sniper");
+    QCommandLineOption budgetOption("budget", "Milliseconds each decision of a searching AI may take.", "ms", "50");
+    QCommandLineOption mapsOption("maps", "Maps in the pool matches are played on.", "count", "64");
+    QCommandLineOption seedOption("seed", "Seed of the first pair, the following pairs count up from it.", "number", "1");
+    for (const QCommandLineOption& option : {aOption, bOption, aParametersOption, bParametersOption, elo0Option,
+                                             elo1Option, alphaOption, betaOption, maxGamesOption, difficultyOption,
+                                             robotsOption, budgetOption, mapsOption, seedOption}) {
+        parser.addOption(option);
+    }
+    parser.process(app);
+
+    QTextStream out(stdout);
+    Version a;
+    Version b;
+    if (!readVersion(parser, aOption, aParametersOption, a, out) ||
+        !readVersion(parser, bOption, bParametersOption, b, out)) {
+        return 1;
+    }
+
+    double elo0 = parser.value(elo0Option).toDouble();
+    double elo1 = parser.value(elo1Option).toDouble();
+    double alpha = parser.value(alphaOption).toDouble();
+    double beta = parser.value(betaOption).toDouble();
+    if (elo1 <= elo0 || alpha <= 0.0 || alpha >= 1.0 || beta <= 0.0 || beta >= 1.0) {
+        out << "elo1 must be above elo0, alpha and beta between 0 and 1\n";
+        return 1;
+    }
+
+    int difficultyIndex = -1;
+    for (int i = 0; i < 3; ++i) {
+        if (parser.value(difficultyOption) == DIFFICULTY_NAMES[i]) difficultyIndex = i;
+    }
+    std::vector<RobotType> robots;
+    for (const QString& name : parser.value(robotsOption).split(',', Qt::SkipEmptyParts)) {
+        for (int i = 0; i < 3; ++i) {
+            if (name.trimmed() == ROBOT_NAMES[i]) robots.push_back(ROBOT_TYPES[i]);
+        }
+    }
+    if (difficultyIndex < 0 || robots.empty()) {
+        out << "Unknown difficulty or robot type\n";
+        return 1;
+    }
+    const GameDifficulty difficulty = DIFFICULTIES[difficultyIndex];
+    const int budgetMs = parser.value(budgetOption).toInt();
+    const int maxPairs = qMax(1, parser.value(maxGamesOption).toInt() / 2);
+    const quint32 firstSeed = parser.value(seedOption).toUInt();
+
+    std::vector<std::shared_ptr<const TerrainMap>> maps;
+    for (int i = 0; i < qMax(1, parser.value(mapsOption).toInt()); ++i) {
+        maps.push_back(MatchRunner::generateMap(MAP_TYPES[i % 4], GRID_SIZE, firstSeed + i + 1));
+    }
+
+    const std::function<void(RobotAI&)> setupA = setupWith(a, difficulty);
+    const std::function<void(RobotAI&)> setupB = setupWith(b, difficulty);
+    const int typeCount = static_cast<int>(robots.size());
+    const int batchPairs = 2 * QThreadPool::globalInstance()->maxThreadCount();
+
+    Sprt sprt(elo0, elo1, alpha, beta);
+    int wins = 0, draws = 0, losses = 0;
+    while (sprt.verdict() == Sprt::Verdict::Continue && sprt.getPairs() < maxPairs) {
+        // Pair k: A moves first in match 2k, B in match 2k + 1, both on the same map and seed
+        int firstPair = sprt.getPairs();
+        int pairs = qMin(batchPairs, maxPairs - firstPair);
+        std::vector<MatchSpec> specs;
+        for (int k = firstPair; k < firstPair + pairs; ++k) {
+            MatchSpec spec;
+            spec.difficulty = difficulty;
+            spec.map = maps[(k / 2) % maps.size()];
+            spec.seed = firstSeed + static_cast<quint32>(k) + 1;
+            spec.swapCorners = k % 2 == 1;
+            spec.decisionBudgetMs = budgetMs;
+            RobotType typeOfA = robots[(k / 2) % typeCount];
+            RobotType typeOfB = robots[(k / 2 / typeCount) % typeCount];
+
+            spec.playerType = typeOfA;
+            spec.aiType = typeOfB;
+            spec.setupPlayer = setupA;
+            spec.setupAi = setupB;
+            specs.push_back(spec);
+
+            spec.playerType = typeOfB;
+            spec.aiType = typeOfA;
+            spec.setupPlayer = setupB;
+            spec.setupAi = setupA;
+            specs.push_back(spec);
+        }
+
+        std::vector<MatchResult> results = MatchRunner::playAll(specs);
+        for (int i = 0; i < pairs && sprt.verdict() == Sprt::Verdict::Continue; ++i) {
+            double first = pointsOfPlayer(results[2 * i]);
+            double second = 1.0 - pointsOfPlayer(results[2 * i + 1]);
+            for (double points : {first, second}) {
+                if (points == 1.0) wins++;
+                else if (points == 0.0) losses++;
+                else draws++;
+            }
+            sprt.addPair(first + second);
+        }
+
+        out << "Games " << 2 * sprt.getPairs() << "  W/D/L " << wins << '/' << draws << '/' << losses
+            << "  LLR " << QString::number(sprt.llr(), 'f', 2)
+            << " (" << QString::number(sprt.lowerBound(), 'f', 2) << ", " << QString::number(sprt.upperBound(), 'f', 2) << ")\n";
+        out.flush();
+    }
+
+    out << "\nPairs by points of A (0, 0.5, 1, 1.5, 2):";
+    for (double points : {0.0, 0.5, 1.0, 1.5, 2.0}) out << ' ' << sprt.getPairsScoring(points);
+    out << "\nElo difference of A: " << QString::number(sprt.eloDifference(), 'f', 1)
+        << " [" << QString::number(sprt.eloLower(), 'f', 1) << ", " << QString::number(sprt.eloUpper(), 'f', 1)
+        << "] at 95 %\n";
+    switch (sprt.verdict()) {
+        case Sprt::Verdict::AcceptH1:
+            out << "H1 accepted: A is stronger than B by at least " << elo1 << " Elo\n";
+            break;
+        case Sprt::Verdict::AcceptH0:
+            out << "H0 accepted: A is not " << elo1 << " Elo stronger than B\n";
+            break;
+        case Sprt::Verdict::Continue:
+            out << "No verdict after " << 2 * sprt.getPairs() << " games\n";
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QSaveFile>
+#include <QStringList>
+#include <QTextStream>
+#include <vector>
+
+#include "airegistry.h"
+#include "logger.h"
+#include "robotai.h"
+#include "tournament.h"
+
+/**
+ * Runs a tournament between AI entrants round after round and keeps an Elo and Glicko ladder of
+ * them (see Tournament). An entrant is a strategy playing one robot type, every strategy asked for
+ * enters with every robot type asked for.
+ *
+ * Results go to a log as they come in. Started again with the same options, the tournament picks
+ * up where the log ends, so it can be stopped at any time. The standings are printed and written
+ * to a file after every round.
+ */
+
+namespace {
+
+const RobotType ROBOT_TYPES[] = {RobotType::Scout, RobotType::Tank, RobotType::Sniper};
+const char* const ROBOT_NAMES[] = {"scout", "tank", "sniper"};
+const MapType MAP_TYPES[] = {MapType::Random, MapType::Open, MapType::Maze, MapType::Fortress};
+const char* const MAP_NAMES[] = {"random", "open", "maze", "fortress"};
+const GameDifficulty DIFFICULTIES[] = {GameDifficulty::Easy, GameDifficulty::Medium, GameDifficulty::Hard};
+const char* const DIFFICULTY_NAMES[] = {"easy", "medium", "hard"};
+
+/// Picks the values named in a comma separated list, FALSE if a name is unknown
+template<class T, int N>
+bool readList(const QString& list, const T (&values)[N], const char* const (&names)[N], std::vector<T>& picked) {
+    for (const QString& name : list.split(',', Qt::SkipEmptyParts)) {
+        int found = -1;
+        for (int i = 0; i < N; ++i) {
+            if (name.trimmed() == names[i]) found = i;
+        }
+        if (found < 0) return false;
+        picked.push_back(values[found]);
+    }
+    return !picked.empty();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("robot_arena_ladder");
+    Logger::setEnabled(false);
+    // Batches of matches on the same maps keep reaching the same positions, and a cached decision is
+    // the one the strategy would make again
+    RobotAI::setDecisionCaching(true);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs a tournament between AI strategies and keeps their ratings.");
+    parser.addHelpOption();
+    QCommandLineOption resultsOption("results", "Log of the results, read when it exists.", "file", "tournament.log");
+    QCommandLineOption standingsOption("standings", "File the standings are written to after every round.", "file", "standings.txt");
+    QCommandLineOption formatOption("format", "round-robin or swiss.", "name", "round-robin");
+    QCommandLineOption strategiesOption("strategies", "Strategies that enter, default for the scripted AIs.", "names", "default,alphabeta,mcts");
+    QCommandLineOption robotsOption("robots", "Robot types every strategy enters with.", "names", "scout,tank,sniper");
+    QCommandLineOption mapsOption("maps", "Map types every pairing is played on.", "names", "random,open,maze,fortress");
+    QCommandLineOption difficultiesOption("difficulties", "Difficulties every pairing is played on.", "names", "medium");
+    QCommandLineOption roundsOption("rounds", "Rounds to play, 0 to play until stopped.", "count", "0");
+    QCommandLineOption budgetOption("budget", "Milliseconds each decision of a searching AI may take.", "ms", "50");
+    QCommandLineOption seedOption("seed", "Seed of the maps and games.", "number", "1");
+    for (const QCommandLineOption& option : {resultsOption, standingsOption, formatOption, strategiesOption, robotsOption,
+                                             mapsOption, difficultiesOption, roundsOption, budgetOption, seedOption}) {
+        parser.addOption(option);
+    }
+    parser.process(app);
+
+    QTextStream out(stdout);
+    std::vector<RobotType> robots;
+    std::vector<MapType> mapTypes;
+    std::vector<GameDifficulty> difficulties;
+    if (!readList(parser.value(robotsOption), ROBOT_TYPES, ROBOT_NAMES, robots) ||
+        !readList(parser.value(mapsOption), MAP_TYPES, MAP_NAMES, mapTypes) ||
+        !readList(parser.value(difficultiesOption), DIFFICULTIES, DIFFICULTY_NAMES, difficulties)) {
+        out << "Unknown robot type, map type or difficulty\n";
+        return 1;
+    }
+    std::vector<Entrant> entrants;
+    for (const QString& strategy : parser.value(strategiesOption).split(',', Qt::SkipEmptyParts)) {
+        if (strategy != "default" && !AIRegistry::contains(strategy)) {
+            out << "Unknown strategy " << strategy << '\n';
+            return 1;
+        }
+        for (RobotType type : robots) {
+            Entrant entrant;
+            entrant.strategy = strategy;
+            entrant.type = type;
+            entrants.push_back(entrant);
+        }
+    }
+    if (entrants.size() < 2) {
+        out << "A tournament needs at least two entrants\n";
+        return 1;
+    }
+    QString formatName = parser.value(formatOption);
+    if (formatName != "round-robin" && formatName != "swiss") {
+        out << "Unknown format " << formatName << '\n';
+        return 1;
+    }
+
+    Tournament tournament(entrants, formatName == "swiss" ? Tournament::Format::Swiss : Tournament::Format::RoundRobin,
+                          mapTypes, difficulties, parser.value(seedOption).toUInt());
+    QString error;
+    if (!tournament.open(parser.value(resultsOption), &error)) {
+        out << error << '\n';
+        return 1;
+    }
+
+    const int rounds = parser.value(roundsOption).toInt();
+    const int budgetMs = parser.value(budgetOption).toInt();
+    for (int round = tournament.firstUnfinishedRound(); rounds <= 0 || round < rounds; ++round) {
+        bool written = tournament.playRound(round, budgetMs, [&out](int round, int played, int scheduled) {
+            out << "Round " << round + 1 << ": " << played << '/' << scheduled << " games\n";
+            out.flush();
+        });
+        if (!written) {
+            out << "Could not write " << parser.value(resultsOption) << '\n';
+            return 1;
+        }
+
+        QString standings = tournament.standings();
+        out << '\n' << standings << '\n';
+        out.flush();
+        QSaveFile file(parser.value(standingsOption));
+        if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            QTextStream(&file) << QString("After round %1\n").arg(round + 1) << standings;
+            file.commit();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "ratings.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+// Scale between Glicko ratings and the natural logarithm
+const double Q = std::log(10.0) / 400.0;
+
+/// Weight of a game against an opponent whose rating is uncertain
+double attenuation(double deviation) {
+    return 1.0 / std::sqrt(1.0 + 3.0 * Q * Q * deviation * deviation / (PI * PI));
+}
+
+double expectedScore(double rating, double opponentRating, double opponentDeviation) {
+    return 1.0 / (1.0 + std::pow(10.0, -attenuation(opponentDeviation) * (rating - opponentRating) / 400.0));
+}
+
+} // namespace
+
+RatingTable::RatingTable(int entrants, double eloK, double deviationGrowth)
+    : ratings(entrants), eloK(eloK), deviationGrowth(deviationGrowth) {
+}
+
+void RatingTable::addGame(int first, int second, double scoreOfFirst) {
+    Rating& a = ratings[first];
+    Rating& b = ratings[second];
+    double expected = 1.0 / (1.0 + std::pow(10.0, (b.elo - a.elo) / 400.0));
+    a.elo += eloK * (scoreOfFirst - expected);
+    b.elo -= eloK * (scoreOfFirst - expected);
+
+    if (scoreOfFirst > 0.5) {
+        a.wins++;
+        b.losses++;
+    } else if (scoreOfFirst < 0.5) {
+        a.losses++;
+        b.wins++;
+    } else {
+        a.draws++;
+        b.draws++;
+    }
+    period.push_back({first, second, scoreOfFirst});
+}
+
+void RatingTable::endPeriod() {
+    // Every update of the period is made from the ratings the period started with
+    std::vector<double> sumWeights(ratings.size(), 0.0);
+    std::vector<double> sumSurprise(ratings.size(), 0.0);
+    auto account = [&](int player, int opponent, double score) {
+        const Rating& self = ratings[player];
+        const Rating& other = ratings[opponent];
+        double weight = attenuation(other.deviation);
+        double expected = expectedScore(self.glicko, other.glicko, other.deviation);
+        sumWeights[player] += weight * weight * expected * (1.0 - expected);
+        sumSurprise[player] += weight * (score - expected);
+    };
+    for (const PeriodGame& game : period) {
+        account(game.first, game.second, game.scoreOfFirst);
+        account(game.second, game.first, 1.0 - game.scoreOfFirst);
+    }
+
+    for (size_t i = 0; i < ratings.size(); ++i) {
+        Rating& rating = ratings[i];
+        double deviation = std::min(INITIAL_DEVIATION,
+                                    std::sqrt(rating.deviation * rating.deviation + deviationGrowth * deviationGrowth));
+        if (sumWeights[i] > 0.0) {
+            double precision = 1.0 / (deviation * deviation) + Q * Q * sumWeights[i];
+            rating.glicko += Q / precision * sumSurprise[i];
+            deviation = std::sqrt(1.0 / precision);
+        }
+        rating.deviation = deviation;
+    }
+    period.clear();
+}
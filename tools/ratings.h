@@ -0,0 +1,72 @@
+#ifndef RATINGS_H
+#define RATINGS_H
+
+#include <vector>
+
+/// @brief Ratings and results of one entrant
+/// @author Group 17
+struct Rating {
+    /// Elo rating, updated after every game
+    double elo = 1500.0;
+    /// Glicko rating and its deviation, updated after every rating period
+    double glicko = 1500.0;
+    double deviation = 350.0;
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+
+    /// @return the games played
+    int games() const { return wins + draws + losses; }
+    /// @return the points per game, 0.5 before any game
+    double score() const { return games() == 0 ? 0.5 : (wins + 0.5 * draws) / games(); }
+};
+
+/**
+ * @brief Elo and Glicko ratings of the entrants of a tournament.
+ *
+ * Elo ratings move after every game by K times the difference between the result and the expected
+ * result. Glicko ratings move once per rating period, a tournament round, by all the games of the
+ * period together. Their deviation tells how sure the rating is: it shrinks with every game and
+ * grows again with every period an entrant sits out.
+ *
+ * @author Group 17
+ */
+class RatingTable {
+public:
+    /// Rating and deviation every entrant starts with
+    static constexpr double INITIAL_RATING = 1500.0;
+    static constexpr double INITIAL_DEVIATION = 350.0;
+
+    /// @param entrants - the number of entrants
+    /// @param eloK - how far an Elo rating moves after a game
+    /// @param deviationGrowth - how much uncertainty a Glicko rating gains per period
+    explicit RatingTable(int entrants, double eloK = 16.0, double deviationGrowth = 30.0);
+
+    /// @brief Adds a game to the current rating period
+    /// @param first - the entrant of one side
+    /// @param second - the entrant of the other side
+    /// @param scoreOfFirst - 1 if the first won, 0.5 for a draw, 0 if the second won
+    void addGame(int first, int second, double scoreOfFirst);
+    /// @brief Updates the Glicko ratings by the games of the current period and starts the next
+    void endPeriod();
+
+    /// @param entrant - an entrant
+    /// @return its ratings and results
+    const Rating& at(int entrant) const { return ratings[entrant]; }
+    /// @return the number of entrants
+    int size() const { return static_cast<int>(ratings.size()); }
+
+private:
+    struct PeriodGame {
+        int first;
+        int second;
+        double scoreOfFirst;
+    };
+
+    std::vector<Rating> ratings;
+    std::vector<PeriodGame> period;
+    double eloK;
+    double deviationGrowth;
+};
+
+#endif // RATINGS_H
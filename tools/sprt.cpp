@@ -0,0 +1,92 @@
+#include "sprt.h"
+
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Scores are kept off 0 and 1, where the Elo difference is infinite
+const double SCORE_EPSILON = 1e-6;
+
+} // namespace
+
+Sprt::Sprt(double elo0, double elo1, double alpha, double beta)
+    : score0(scoreOf(elo0)), score1(scoreOf(elo1)), alpha(alpha), beta(beta) {
+}
+
+void Sprt::addPair(double pointsOfA) {
+    int index = qBound(0, static_cast<int>(std::lround(pointsOfA * 2.0)), 4);
+    pentanomial[index]++;
+    pairs++;
+}
+
+int Sprt::getPairsScoring(double points) const {
+    int index = static_cast<int>(std::lround(points * 2.0));
+    return index >= 0 && index < 5 ? pentanomial[index] : 0;
+}
+
+double Sprt::meanScore() const {
+    if (pairs == 0) return 0.5;
+    double sum = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        sum += pentanomial[i] * (i / 4.0);
+    }
+    return sum / pairs;
+}
+
+double Sprt::scoreVariance() const {
+    if (pairs == 0) return 0.0;
+    double mean = meanScore();
+    double sum = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        double deviation = i / 4.0 - mean;
+        sum += pentanomial[i] * deviation * deviation;
+    }
+    return sum / pairs;
+}
+
+double Sprt::llr() const {
+    double variance = scoreVariance();
+    // Until the pairs differ there is nothing to measure the noise by
+    if (variance <= 0.0) return 0.0;
+    return pairs * (score1 - score0) * (2.0 * meanScore() - score0 - score1) / (2.0 * variance);
+}
+
+double Sprt::lowerBound() const {
+    return std::log(beta / (1.0 - alpha));
+}
+
+double Sprt::upperBound() const {
+    return std::log((1.0 - beta) / alpha);
+}
+
+Sprt::Verdict Sprt::verdict() const {
+    double ratio = llr();
+    if (ratio >= upperBound()) return Verdict::AcceptH1;
+    if (ratio <= lowerBound()) return Verdict::AcceptH0;
+    return Verdict::Continue;
+}
+
+double Sprt::eloDifference() const {
+    return eloOf(meanScore());
+}
+
+double Sprt::eloLower(double z) const {
+    if (pairs == 0) return eloOf(0.0);
+    return eloOf(meanScore() - z * std::sqrt(scoreVariance() / pairs));
+}
+
+double Sprt::eloUpper(double z) const {
+    if (pairs == 0) return eloOf(1.0);
+    return eloOf(meanScore() + z * std::sqrt(scoreVariance() / pairs));
+}
+
+double Sprt::scoreOf(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+double Sprt::eloOf(double score) {
+    score = std::min(1.0 - SCORE_EPSILON, std::max(SCORE_EPSILON, score));
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
@@ -0,0 +1,77 @@
+#ifndef SPRT_H
+#define SPRT_H
+
+/**
+ * @brief Sequential probability ratio test between two AI versions, A and B.
+ *
+ * Decides between H0, A is at most elo0 stronger than B, and H1, A is at least elo1 stronger,
+ * after every pair of matches instead of after a fixed number. It stops as soon as the
+ * log-likelihood ratio leaves the bounds given by the error rates, which for clear differences
+ * takes a small share of the matches a fixed test needs.
+ *
+ * Matches are counted in pairs played on the same map and seed with the sides swapped, which
+ * cancels most of the luck of the map. The log-likelihood ratio is the usual normal approximation
+ * over the pair scores (the pentanomial model), with the variance measured from the pairs.
+ *
+ * @author Group 17
+ */
+class Sprt {
+public:
+    /// @brief Outcome of the test so far
+    enum class Verdict { Continue, AcceptH0, AcceptH1 };
+
+    /// @param elo0 - the Elo difference of H0
+    /// @param elo1 - the Elo difference of H1, larger than elo0
+    /// @param alpha - the chance of accepting H1 when H0 is true
+    /// @param beta - the chance of accepting H0 when H1 is true
+    Sprt(double elo0, double elo1, double alpha, double beta);
+
+    /// @brief Adds a pair of matches
+    /// @param pointsOfA - points of A over both matches: 1 per win, 0.5 per draw
+    void addPair(double pointsOfA);
+
+    /// @return the log-likelihood ratio of H1 against H0
+    double llr() const;
+    /// @return the ratio below which H0 is accepted
+    double lowerBound() const;
+    /// @return the ratio above which H1 is accepted
+    double upperBound() const;
+    /// @return whether the test is over, and which hypothesis it accepted
+    Verdict verdict() const;
+
+    /// @return the pairs added
+    int getPairs() const { return pairs; }
+    /// @param points - points of A over a pair, 0, 0.5, 1, 1.5 or 2
+    /// @return the pairs A scored that many points in
+    int getPairsScoring(double points) const;
+
+    /// @return the estimated Elo difference of A over B
+    double eloDifference() const;
+    /// @param z - the width of the interval in standard deviations, 1.96 for 95 %
+    /// @return the lower end of the confidence interval of the Elo difference
+    double eloLower(double z = 1.96) const;
+    /// @param z - the width of the interval in standard deviations, 1.96 for 95 %
+    /// @return the upper end of the confidence interval of the Elo difference
+    double eloUpper(double z = 1.96) const;
+
+    /// @param elo - an Elo difference
+    /// @return the expected score per match of the stronger side, between 0 and 1
+    static double scoreOf(double elo);
+    /// @param score - a score per match between 0 and 1
+    /// @return the Elo difference it corresponds to
+    static double eloOf(double score);
+
+private:
+    double meanScore() const;
+    double scoreVariance() const;
+
+    double score0;
+    double score1;
+    double alpha;
+    double beta;
+    int pairs = 0;
+    /// Pairs by points of A: 0, 0.5, 1, 1.5 and 2
+    int pentanomial[5] = {0, 0, 0, 0, 0};
+};
+
+#endif // SPRT_H
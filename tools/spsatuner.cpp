@@ -0,0 +1,56 @@
+#include "spsatuner.h"
+
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+SpsaTuner::SpsaTuner(std::vector<int> minimum, std::vector<int> maximum, const SpsaSettings& settings)
+    : minimum(std::move(minimum)), maximum(std::move(maximum)), settings(settings) {
+}
+
+std::vector<int> SpsaTuner::rounded(const std::vector<double>& values) const {
+    std::vector<int> result(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        result[i] = qBound(minimum[i], static_cast<int>(std::lround(values[i])), maximum[i]);
+    }
+    return result;
+}
+
+std::vector<int> SpsaTuner::tune(const std::vector<int>& start, const Evaluation& evaluate,
+                                 const Progress& progress) const {
+    QRandomGenerator random(settings.seed);
+    std::vector<double> values(start.begin(), start.end());
+    const size_t count = values.size();
+    // Keeps the first steps from being much larger than the later ones
+    const double stability = settings.iterations / 10.0;
+
+    for (int k = 0; k < settings.iterations; ++k) {
+        double stepSize = settings.learningRate / std::pow(k + 1 + stability, settings.learningDecay);
+        double perturbationSize = settings.perturbation / std::pow(k + 1, settings.perturbationDecay);
+
+        std::vector<int> current = rounded(values);
+        std::vector<int> direction(count);
+        std::vector<int> plus(count);
+        std::vector<int> minus(count);
+        for (size_t i = 0; i < count; ++i) {
+            direction[i] = random.bounded(2) == 0 ? -1 : 1;
+            int range = maximum[i] - minimum[i];
+            int offset = std::max(1, static_cast<int>(std::lround(perturbationSize * range)));
+            plus[i] = qBound(minimum[i], current[i] + direction[i] * offset, maximum[i]);
+            minus[i] = qBound(minimum[i], current[i] - direction[i] * offset, maximum[i]);
+        }
+
+        double score = evaluate(plus, minus);
+        for (size_t i = 0; i < count; ++i) {
+            double range = maximum[i] - minimum[i];
+            values[i] += stepSize * score * direction[i] * range / (2.0 * perturbationSize);
+            values[i] = std::min<double>(maximum[i], std::max<double>(minimum[i], values[i]));
+        }
+
+        if (progress) {
+            progress(k, score, rounded(values));
+        }
+    }
+    return rounded(values);
+}
@@ -0,0 +1,68 @@
+#ifndef SPSATUNER_H
+#define SPSATUNER_H
+
+#include <QtGlobal>
+#include <functional>
+#include <vector>
+
+/// @brief How an SpsaTuner steps through the parameter space
+/// @author Group 17
+struct SpsaSettings {
+    /// Candidate pairs evaluated
+    int iterations = 200;
+    /// Size of the first steps, in shares of a parameter's range per unit of score
+    double learningRate = 0.1;
+    /// Size of the first perturbations, in shares of a parameter's range
+    double perturbation = 0.1;
+    /// How fast the steps and the perturbations shrink
+    double learningDecay = 0.602;
+    double perturbationDecay = 0.101;
+    /// Seed of the random perturbation directions
+    quint32 seed = 1;
+};
+
+/**
+ * @brief Tunes integer parameters with simultaneous perturbation stochastic approximation (SPSA).
+ *
+ * Every iteration perturbs all parameters at once in a random direction, once forwards and once
+ * backwards, and lets the two candidates play each other. The score of the forward candidate
+ * estimates the slope along the direction, and the parameters take a step along it. Matches are
+ * noisy, so the steps shrink over the iterations while the estimates average out.
+ *
+ * Parameters are kept as reals within their ranges and rounded for the candidates. A candidate
+ * differs from the current values by at least one in every parameter, so rounding never hides a
+ * perturbation.
+ *
+ * @author Group 17
+ */
+class SpsaTuner {
+public:
+    /// @brief Plays two candidates against each other
+    /// @return The score of the first candidate, from -1 when it lost every match to 1 when it won
+    /// every match
+    using Evaluation = std::function<double(const std::vector<int>& plus, const std::vector<int>& minus)>;
+    /// @brief Reports an iteration
+    using Progress = std::function<void(int iteration, double score, const std::vector<int>& values)>;
+
+    /// @param minimum - the lowest value of each parameter
+    /// @param maximum - the highest value of each parameter
+    /// @param settings - how to step through the parameter space
+    SpsaTuner(std::vector<int> minimum, std::vector<int> maximum, const SpsaSettings& settings = SpsaSettings());
+
+    /// @brief Tunes the parameters
+    /// @param start - the values to start from
+    /// @param evaluate - plays two candidates against each other, called once per iteration
+    /// @param progress - optional, called after every iteration
+    /// @return The tuned values
+    std::vector<int> tune(const std::vector<int>& start, const Evaluation& evaluate,
+                          const Progress& progress = Progress()) const;
+
+private:
+    std::vector<int> rounded(const std::vector<double>& values) const;
+
+    std::vector<int> minimum;
+    std::vector<int> maximum;
+    SpsaSettings settings;
+};
+
+#endif // SPSATUNER_H
@@ -0,0 +1,376 @@
+#include "tournament.h"
+#include "robotai.h"
+
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+#include <QThreadPool>
+#include <algorithm>
+#include <memory>
+#include <set>
+
+namespace {
+
+const int GRID_SIZE = 12;
+
+const char* const ROBOT_NAMES[] = {"scout", "tank", "sniper"};
+const char* const DIFFICULTY_NAMES[] = {"easy", "medium", "hard"};
+
+const char* mapName(MapType type) {
+    switch (type) {
+        case MapType::Open:     return "open";
+        case MapType::Maze:     return "maze";
+        case MapType::Fortress: return "fortress";
+        default:                return "random";
+    }
+}
+
+const char* outcomeName(MatchOutcome outcome) {
+    switch (outcome) {
+        case MatchOutcome::PlayerWon: return "player";
+        case MatchOutcome::AiWon:     return "ai";
+        default:                      return "draw";
+    }
+}
+
+/// Points of the side that moved first: 1 for a win, 0.5 for a draw and 0 for a loss
+double pointsOfPlayer(MatchOutcome outcome) {
+    switch (outcome) {
+        case MatchOutcome::PlayerWon: return 1.0;
+        case MatchOutcome::AiWon:     return 0.0;
+        default:                      return 0.5;
+    }
+}
+
+std::function<void(RobotAI&)> setupFor(const Entrant& entrant) {
+    return [entrant](RobotAI& ai) {
+        if (entrant.strategy != "default") {
+            ai.setStrategy(entrant.type, entrant.strategy);
+        }
+    };
+}
+
+} // namespace
+
+QString Entrant::name() const {
+    return strategy + ":" + ROBOT_NAMES[static_cast<int>(type)];
+}
+
+Tournament::Tournament(std::vector<Entrant> entrants, Format format, std::vector<MapType> mapTypes,
+                       std::vector<GameDifficulty> difficulties, quint32 seed)
+    : entrants(std::move(entrants)), format(format), mapTypes(std::move(mapTypes)),
+      difficulties(std::move(difficulties)), seed(seed) {
+}
+
+QString Tournament::header() const {
+    QStringList names;
+    for (const Entrant& entrant : entrants) names.append(entrant.name());
+    QStringList maps;
+    for (MapType type : mapTypes) maps.append(mapName(type));
+    QStringList levels;
+    for (GameDifficulty difficulty : difficulties) levels.append(DIFFICULTY_NAMES[static_cast<int>(difficulty)]);
+    return QString("# tournament %1 seed %2 entrants %3 maps %4 difficulties %5")
+        .arg(format == Format::Swiss ? "swiss" : "round-robin")
+        .arg(seed)
+        .arg(names.join(","))
+        .arg(maps.join(","))
+        .arg(levels.join(","));
+}
+
+QString Tournament::resultLine(const Result& result) const {
+    const TournamentGame& game = result.game;
+    return QString("%1 %2 %3 %4 %5 %6 %7 %8")
+        .arg(game.round)
+        .arg(game.index)
+        .arg(entrants[game.player].name())
+        .arg(entrants[game.ai].name())
+        .arg(mapName(game.mapType))
+        .arg(DIFFICULTY_NAMES[static_cast<int>(game.difficulty)])
+        .arg(outcomeName(result.outcome))
+        .arg(result.commands);
+}
+
+bool Tournament::readResult(const QString& line, Result& result) const {
+    QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+    if (parts.size() != 8) {
+        return false;
+    }
+    bool roundOk = false;
+    bool indexOk = false;
+    bool commandsOk = false;
+    result.game.round = parts[0].toInt(&roundOk);
+    result.game.index = parts[1].toInt(&indexOk);
+    result.commands = parts[7].toInt(&commandsOk);
+    if (!roundOk || !indexOk || !commandsOk) {
+        return false;
+    }
+
+    result.game.player = -1;
+    result.game.ai = -1;
+    for (int i = 0; i < static_cast<int>(entrants.size()); ++i) {
+        if (entrants[i].name() == parts[2]) result.game.player = i;
+        if (entrants[i].name() == parts[3]) result.game.ai = i;
+    }
+    for (MatchOutcome outcome : {MatchOutcome::PlayerWon, MatchOutcome::AiWon, MatchOutcome::Draw}) {
+        if (parts[6] == outcomeName(outcome)) {
+            result.outcome = outcome;
+            return result.game.player >= 0 && result.game.ai >= 0;
+        }
+    }
+    return false;
+}
+
+bool Tournament::open(const QString& path, QString* error) {
+    logPath = path;
+    results.clear();
+
+    QFile file(path);
+    if (!QFile::exists(path)) {
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            *error = "Could not create " + path;
+            return false;
+        }
+        // Results are written at the start of a line each, see playRound()
+        QTextStream out(&file);
+        out << header();
+        return true;
+    }
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *error = "Could not read " + path;
+        return false;
+    }
+    QTextStream in(&file);
+    if (in.readLine() != header()) {
+        *error = path + " was written by a tournament with other entrants or settings";
+        return false;
+    }
+    // A line cut short by a crash is skipped, its game is played again
+    while (!in.atEnd()) {
+        Result result;
+        if (readResult(in.readLine(), result)) {
+            results[{result.game.round, result.game.index}] = result;
+        }
+    }
+    return true;
+}
+
+quint32 Tournament::seedFor(int round, int slot) const {
+    quint64 hash = seed;
+    for (quint64 value : {static_cast<quint64>(round), static_cast<quint64>(static_cast<quint32>(slot))}) {
+        hash = (hash ^ value) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 31;
+    }
+    quint32 result = static_cast<quint32>(hash ^ (hash >> 32));
+    return result != 0 ? result : 1;
+}
+
+std::vector<std::pair<int, int>> Tournament::pairings(int round) const {
+    const int count = static_cast<int>(entrants.size());
+    std::vector<std::pair<int, int>> pairs;
+    if (format == Format::RoundRobin) {
+        for (int a = 0; a < count; ++a) {
+            for (int b = a + 1; b < count; ++b) {
+                pairs.push_back({a, b});
+            }
+        }
+        return pairs;
+    }
+
+    // Swiss: entrants by points in the earlier rounds, each paired with the next one below it
+    // that it has not met yet
+    std::vector<double> points(count, 0.0);
+    std::set<std::pair<int, int>> met;
+    std::set<std::pair<int, int>> playedIn;
+    for (const auto& entry : results) {
+        const Result& result = entry.second;
+        if (result.game.round >= round) break;
+        double playerPoints = pointsOfPlayer(result.outcome);
+        points[result.game.player] += playerPoints;
+        points[result.game.ai] += 1.0 - playerPoints;
+        met.insert({std::min(result.game.player, result.game.ai), std::max(result.game.player, result.game.ai)});
+        playedIn.insert({result.game.round, result.game.player});
+        playedIn.insert({result.game.round, result.game.ai});
+    }
+    std::vector<int> order(count);
+    for (int i = 0; i < count; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&points](int a, int b) { return points[a] > points[b]; });
+
+    // With an odd number of entrants the lowest placed one that sat out the fewest rounds sits
+    // this one out
+    if (count % 2 == 1) {
+        int bye = -1;
+        int fewestByes = round + 1;
+        for (int i = count - 1; i >= 0; --i) {
+            int byes = 0;
+            for (int earlier = 0; earlier < round; ++earlier) {
+                byes += playedIn.count({earlier, order[i]}) == 0 ? 1 : 0;
+            }
+            if (byes < fewestByes) {
+                fewestByes = byes;
+                bye = i;
+            }
+        }
+        order.erase(order.begin() + bye);
+    }
+
+    std::vector<bool> paired(count, false);
+    for (size_t i = 0; i < order.size(); ++i) {
+        int a = order[i];
+        if (paired[a]) continue;
+        int partner = -1;
+        for (size_t j = i + 1; j < order.size(); ++j) {
+            int b = order[j];
+            if (paired[b]) continue;
+            if (partner < 0) partner = b;
+            if (met.count({std::min(a, b), std::max(a, b)}) == 0) {
+                partner = b;
+                break;
+            }
+        }
+        if (partner < 0) break;
+        paired[a] = true;
+        paired[partner] = true;
+        pairs.push_back({a, partner});
+    }
+    return pairs;
+}
+
+std::vector<TournamentGame> Tournament::schedule(int round) const {
+    std::vector<TournamentGame> games;
+    int slot = 0;
+    for (const std::pair<int, int>& pair : pairings(round)) {
+        for (GameDifficulty difficulty : difficulties) {
+            for (MapType mapType : mapTypes) {
+                TournamentGame game;
+                game.round = round;
+                game.mapType = mapType;
+                game.difficulty = difficulty;
+                game.seed = seedFor(round, slot++);
+
+                game.index = static_cast<int>(games.size());
+                game.player = pair.first;
+                game.ai = pair.second;
+                games.push_back(game);
+
+                game.index = static_cast<int>(games.size());
+                game.player = pair.second;
+                game.ai = pair.first;
+                games.push_back(game);
+            }
+        }
+    }
+    return games;
+}
+
+int Tournament::firstUnfinishedRound() const {
+    for (int round = 0;; ++round) {
+        for (const TournamentGame& game : schedule(round)) {
+            if (results.count({round, game.index}) == 0) {
+                return round;
+            }
+        }
+    }
+}
+
+bool Tournament::playRound(int round, int decisionBudgetMs, const Progress& progress) {
+    std::vector<TournamentGame> games = schedule(round);
+    std::vector<TournamentGame> missing;
+    for (const TournamentGame& game : games) {
+        if (results.count({round, game.index}) == 0) {
+            missing.push_back(game);
+        }
+    }
+    if (missing.empty()) {
+        return true;
+    }
+
+    // One layout per map type and round, shared by every game of the round on that type
+    std::vector<std::shared_ptr<const TerrainMap>> maps;
+    for (size_t m = 0; m < mapTypes.size(); ++m) {
+        maps.push_back(MatchRunner::generateMap(mapTypes[m], GRID_SIZE, seedFor(round, -1 - static_cast<int>(m))));
+    }
+
+    // Small batches, so little is lost when the tournament is stopped
+    const size_t batchSize = 4 * std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+    for (size_t start = 0; start < missing.size(); start += batchSize) {
+        size_t end = std::min(missing.size(), start + batchSize);
+        std::vector<MatchSpec> specs;
+        for (size_t i = start; i < end; ++i) {
+            const TournamentGame& game = missing[i];
+            MatchSpec spec;
+            spec.playerType = entrants[game.player].type;
+            spec.aiType = entrants[game.ai].type;
+            spec.difficulty = game.difficulty;
+            spec.map = maps[std::find(mapTypes.begin(), mapTypes.end(), game.mapType) - mapTypes.begin()];
+            spec.seed = game.seed;
+            spec.decisionBudgetMs = decisionBudgetMs;
+            spec.setupPlayer = setupFor(entrants[game.player]);
+            spec.setupAi = setupFor(entrants[game.ai]);
+            specs.push_back(spec);
+        }
+        std::vector<MatchResult> played = MatchRunner::playAll(specs);
+
+        QFile log(logPath);
+        if (!log.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            return false;
+        }
+        QTextStream out(&log);
+        for (size_t i = start; i < end; ++i) {
+            Result result;
+            result.game = missing[i];
+            result.outcome = played[i - start].outcome;
+            result.commands = played[i - start].commands;
+            // Starts on a line of its own even after a line cut short by a crash
+            out << '\n' << resultLine(result);
+            results[{round, result.game.index}] = result;
+        }
+        out.flush();
+        log.close();
+
+        if (progress) {
+            progress(round, static_cast<int>(games.size() - missing.size() + end), static_cast<int>(games.size()));
+        }
+    }
+    return true;
+}
+
+RatingTable Tournament::ratings() const {
+    RatingTable table(static_cast<int>(entrants.size()));
+    int round = results.empty() ? 0 : results.begin()->first.first;
+    for (const auto& entry : results) {
+        const Result& result = entry.second;
+        // One rating period per round
+        for (; round < result.game.round; ++round) {
+            table.endPeriod();
+        }
+        table.addGame(result.game.player, result.game.ai, pointsOfPlayer(result.outcome));
+    }
+    table.endPeriod();
+    return table;
+}
+
+QString Tournament::standings() const {
+    RatingTable table = ratings();
+    std::vector<int> order(entrants.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+    std::stable_sort(order.begin(), order.end(), [&table](int a, int b) {
+        return table.at(a).glicko > table.at(b).glicko;
+    });
+
+    QString text = QString("%1 %2 %3 %4 %5 %6 %7\n")
+        .arg("#", 3).arg("entrant", -20).arg("games", 6).arg("W-D-L", 16).arg("score", 6)
+        .arg("Elo", 6).arg("Glicko", 12);
+    for (size_t rank = 0; rank < order.size(); ++rank) {
+        const Rating& rating = table.at(order[rank]);
+        text += QString("%1 %2 %3 %4 %5 %6 %7\n")
+            .arg(static_cast<int>(rank + 1), 3)
+            .arg(entrants[order[rank]].name(), -20)
+            .arg(rating.games(), 6)
+            .arg(QString("%1-%2-%3").arg(rating.wins).arg(rating.draws).arg(rating.losses), 16)
+            .arg(QString::number(100.0 * rating.score(), 'f', 1) + "%", 6)
+            .arg(QString::number(rating.elo, 'f', 0), 6)
+            .arg(QString::number(rating.glicko, 'f', 0) + " +-" + QString::number(2.0 * rating.deviation, 'f', 0), 12);
+    }
+    return text;
+}
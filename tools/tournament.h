@@ -0,0 +1,121 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <QString>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "matchrunner.h"
+#include "ratings.h"
+
+/// @brief One entrant of a tournament: a strategy playing one robot type
+/// @author Group 17
+struct Entrant {
+    /// Strategy name from AIRegistry, "default" for the scripted AI of the robot type
+    QString strategy;
+    RobotType type = RobotType::Tank;
+
+    /// @return the name the entrant is listed under, for example "mcts:tank"
+    QString name() const;
+};
+
+/// @brief One scheduled game of a tournament
+/// @author Group 17
+struct TournamentGame {
+    int round = 0;
+    /// Position of the game in the round's schedule
+    int index = 0;
+    /// Entrants of the side that moves first and of the side that moves second
+    int player = 0;
+    int ai = 0;
+    MapType mapType = MapType::Random;
+    GameDifficulty difficulty = GameDifficulty::Medium;
+    /// Shared by the two games of a pairing, which are played with the sides swapped
+    quint32 seed = 0;
+};
+
+/**
+ * @brief A round-robin or Swiss tournament between AI entrants that can be stopped and resumed.
+ *
+ * A round-robin round pairs every entrant with every other one. A Swiss round pairs entrants with
+ * similar points so far, avoiding pairs that have already met where it can; with an odd number
+ * of entrants one sits the round out, in turn. Every pairing is played on every map type and
+ * difficulty of the tournament, twice with the sides swapped on the same map and seed. The games
+ * of a round are played a batch at a time on every thread.
+ *
+ * Results are appended to a log file as soon as a batch is done. The schedule of a round only
+ * depends on the tournament's settings and on the results of earlier rounds, so a tournament
+ * restarted on the same log schedules the same games again and only plays those missing from it.
+ * Ratings (see RatingTable) are recomputed from the log, one rating period per round.
+ *
+ * @author Group 17
+ */
+class Tournament {
+public:
+    enum class Format { RoundRobin, Swiss };
+
+    /// @brief Reports a finished batch
+    using Progress = std::function<void(int round, int played, int scheduled)>;
+
+    /// @param entrants - the entrants, at least two
+    /// @param format - how entrants are paired
+    /// @param mapTypes - the map types every pairing is played on
+    /// @param difficulties - the difficulties every pairing is played on
+    /// @param seed - the seed of the maps and games
+    Tournament(std::vector<Entrant> entrants, Format format, std::vector<MapType> mapTypes,
+               std::vector<GameDifficulty> difficulties, quint32 seed);
+
+    /// @brief Opens the results log, reading the results already in it, or starts a new one
+    /// @param path - the log file
+    /// @param error - set to the reason if the log can not be used
+    /// @return TRUE if the tournament can continue on the log, FALSE if it was written by a
+    /// tournament with other settings or can not be read or written
+    bool open(const QString& path, QString* error);
+
+    /// @param round - a round
+    /// @return the games of the round, needs the results of every earlier round
+    std::vector<TournamentGame> schedule(int round) const;
+    /// @brief Plays the games of a round missing from the log, appending each batch to it
+    /// @param round - the round, every earlier round must be finished
+    /// @param decisionBudgetMs - the time each decision of a searching AI may take
+    /// @param progress - optional, called after every batch
+    /// @return TRUE once the whole round is in the log, FALSE if the log could not be written
+    bool playRound(int round, int decisionBudgetMs, const Progress& progress = Progress());
+    /// @return the first round with games missing from the log
+    int firstUnfinishedRound() const;
+
+    /// @return the ratings after every result in the log
+    RatingTable ratings() const;
+    /// @return a table of the entrants by Glicko rating, with their Elo ratings and results
+    QString standings() const;
+
+    /// @return the entrants
+    const std::vector<Entrant>& getEntrants() const { return entrants; }
+
+private:
+    struct Result {
+        TournamentGame game;
+        MatchOutcome outcome = MatchOutcome::Draw;
+        int commands = 0;
+    };
+
+    QString header() const;
+    QString resultLine(const Result& result) const;
+    bool readResult(const QString& line, Result& result) const;
+    /// Pairs of entrants of a round, the first of each moves first in the first game
+    std::vector<std::pair<int, int>> pairings(int round) const;
+    quint32 seedFor(int round, int slot) const;
+
+    std::vector<Entrant> entrants;
+    Format format;
+    std::vector<MapType> mapTypes;
+    std::vector<GameDifficulty> difficulties;
+    quint32 seed;
+    QString logPath;
+    /// Results in the log, by round and index
+    std::map<std::pair<int, int>, Result> results;
+};
+
+#endif // TOURNAMENT_H
@@ -0,0 +1,225 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QThreadPool>
+#include <memory>
+#include <vector>
+
+#include "aiparameters.h"
+#include "logger.h"
+#include "matchrunner.h"
+#include "robotai.h"
+#include "spsatuner.h"
+
+/**
+ * Tunes the thresholds of the scripted AIs by self-play and writes the tuned sets for every
+ * difficulty to a file the game loads at start-up (see AIParameterSets).
+ *
+ * Each robot type is tuned on its own with SPSA. Both candidates of an iteration play the same
+ * matches against the current sets: every opponent type, from both corners, on a fixed pool of
+ * maps and with the same seeds. Matches of an iteration are played at once on every thread. A
+ * tuned set is only kept if it beats the set it started from in a final run of matches.
+ */
+
+namespace {
+
+const RobotType ROBOT_TYPES[] = {RobotType::Scout, RobotType::Tank, RobotType::Sniper};
+const MapType MAP_TYPES[] = {MapType::Random, MapType::Open, MapType::Maze, MapType::Fortress};
+const GameDifficulty DIFFICULTIES[] = {GameDifficulty::Easy, GameDifficulty::Medium, GameDifficulty::Hard};
+const char* const DIFFICULTY_NAMES[] = {"easy", "medium", "hard"};
+const int GRID_SIZE = 12;
+
+/// What to tune and how many matches to play for it
+struct TunerOptions {
+    int iterations = 200;
+    /// Maps both candidates play on per iteration, each from both corners
+    int pairsPerIteration = 0;
+    int verifyPairs = 0;
+    int mapCount = 32;
+    quint32 seed = 1;
+    bool difficulties[3] = {true, true, true};
+    bool robots[3] = {true, true, true};
+};
+
+std::function<void(RobotAI&)> setupWith(const AIParameterSet& set, GameDifficulty difficulty) {
+    return [set, difficulty](RobotAI& ai) { ai.setParameters(difficulty, set); };
+}
+
+/// Points of the tuned side in a match: 1 for a win, 0.5 for a draw and 0 for a loss
+double pointsFor(const MatchResult& result, bool tunedPlaysAi) {
+    if (result.outcome == MatchOutcome::Draw) return 0.5;
+    bool aiWon = result.outcome == MatchOutcome::AiWon;
+    return aiWon == tunedPlaysAi ? 1.0 : 0.0;
+}
+
+/// Plays two values of one robot's parameters on the same matches against the current sets
+/// @return The points of the first minus the points of the second, per match
+template<class P>
+double playCandidates(RobotType type, P AIParameterSet::* member, GameDifficulty difficulty,
+                      const AIParameterSet& current, const std::vector<int>& first,
+                      const std::vector<int>& second, int pairs, int firstPair,
+                      const std::vector<std::shared_ptr<const TerrainMap>>& maps) {
+    AIParameterSet firstSet = current;
+    setParameterValues(firstSet.*member, first);
+    AIParameterSet secondSet = current;
+    setParameterValues(secondSet.*member, second);
+
+    // Each pair is one opponent, corner, map and seed, played once by each candidate
+    std::vector<MatchSpec> specs;
+    std::vector<bool> tunedPlaysAi;
+    for (int i = 0; i < pairs; ++i) {
+        int n = firstPair + i;
+        bool playsAi = (n / 3) % 2 == 1;
+        for (const AIParameterSet* candidate : {&firstSet, &secondSet}) {
+            MatchSpec spec;
+            spec.difficulty = difficulty;
+            spec.map = maps[(n / 6) % maps.size()];
+            spec.seed = static_cast<quint32>(n) + 1;
+            spec.playerType = playsAi ? ROBOT_TYPES[n % 3] : type;
+            spec.aiType = playsAi ? type : ROBOT_TYPES[n % 3];
+            spec.setupPlayer = setupWith(playsAi ? current : *candidate, difficulty);
+            spec.setupAi = setupWith(playsAi ? *candidate : current, difficulty);
+            specs.push_back(spec);
+        }
+        tunedPlaysAi.push_back(playsAi);
+    }
+
+    std::vector<MatchResult> results = MatchRunner::playAll(specs);
+    double score = 0.0;
+    for (int i = 0; i < pairs; ++i) {
+        score += pointsFor(results[2 * i], tunedPlaysAi[i]) - pointsFor(results[2 * i + 1], tunedPlaysAi[i]);
+    }
+    return score / pairs;
+}
+
+/// Tunes one robot's parameters at one difficulty, starting from the sets given
+template<class P>
+void tuneRobot(RobotType type, P AIParameterSet::* member, GameDifficulty difficulty,
+               AIParameterSet& sets, const TunerOptions& options,
+               const std::vector<std::shared_ptr<const TerrainMap>>& maps, QTextStream& out) {
+    const AIParameterSet current = sets;
+    std::vector<int> minimum;
+    std::vector<int> maximum;
+    for (const ParameterField<P>& field : P::fields()) {
+        minimum.push_back(field.minimum);
+        maximum.push_back(field.maximum);
+    }
+
+    SpsaSettings settings;
+    settings.iterations = options.iterations;
+    settings.seed = options.seed;
+    SpsaTuner tuner(minimum, maximum, settings);
+
+    std::vector<int> start = parameterValues(current.*member);
+    int iteration = 0;
+    std::vector<int> tuned = tuner.tune(start,
+        [&](const std::vector<int>& plus, const std::vector<int>& minus) {
+            return playCandidates(type, member, difficulty, current, plus, minus,
+                                  options.pairsPerIteration, options.pairsPerIteration * iteration++, maps);
+        },
+        [&](int k, double score, const std::vector<int>& values) {
+            out << "  iteration " << k + 1 << " score " << score << " values";
+            for (int value : values) out << ' ' << value;
+            out << '\n';
+            out.flush();
+        });
+
+    // SPSA only follows noisy estimates, keep the start unless the tuned values beat it
+    double score = playCandidates(type, member, difficulty, current, tuned, start,
+                                  options.verifyPairs, 0, maps);
+    out << "  tuned against start: " << score << (score > 0.0 ? ", kept\n" : ", discarded\n");
+    if (score > 0.0) {
+        setParameterValues(sets.*member, tuned);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("robot_arena_tuner");
+    Logger::setEnabled(false);
+    // Batches of matches on the same maps keep reaching the same positions, and a cached decision is
+    // the one the strategy would make again
+    RobotAI::setDecisionCaching(true);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Tunes the thresholds of the scripted AIs by self-play.");
+    parser.addHelpOption();
+    QCommandLineOption outputOption({"o", "output"}, "File the tuned sets are written to.", "file", "aiparameters.txt");
+    QCommandLineOption inputOption({"i", "input"}, "Sets to start from instead of the built-in ones.", "file");
+    QCommandLineOption iterationsOption("iterations", "SPSA iterations per robot and difficulty.", "count", "200");
+    QCommandLineOption pairsOption("pairs", "Maps played by both candidates per iteration, 0 for twice the threads.", "count", "0");
+    QCommandLineOption verifyOption("verify", "Maps played to check a tuned set, 0 for ten iterations' worth.", "count", "0");
+    QCommandLineOption mapsOption("maps", "Maps in the pool matches are played on.", "count", "32");
+    QCommandLineOption difficultyOption("difficulty", "easy, medium, hard or all.", "name", "all");
+    QCommandLineOption robotOption("robot", "scout, tank, sniper or all.", "name", "all");
+    QCommandLineOption seedOption("seed", "Seed of the maps and the perturbations.", "number", "1");
+    for (const QCommandLineOption& option : {outputOption, inputOption, iterationsOption, pairsOption, verifyOption,
+                                             mapsOption, difficultyOption, robotOption, seedOption}) {
+        parser.addOption(option);
+    }
+    parser.process(app);
+
+    QTextStream out(stdout);
+    TunerOptions options;
+    options.iterations = qMax(1, parser.value(iterationsOption).toInt());
+    options.pairsPerIteration = parser.value(pairsOption).toInt();
+    if (options.pairsPerIteration <= 0) {
+        options.pairsPerIteration = 2 * QThreadPool::globalInstance()->maxThreadCount();
+    }
+    options.verifyPairs = parser.value(verifyOption).toInt();
+    if (options.verifyPairs <= 0) {
+        options.verifyPairs = 10 * options.pairsPerIteration;
+    }
+    options.mapCount = qMax(1, parser.value(mapsOption).toInt());
+    options.seed = parser.value(seedOption).toUInt();
+    const char* const robotNames[] = {"scout", "tank", "sniper"};
+    QString difficulty = parser.value(difficultyOption);
+    QString robot = parser.value(robotOption);
+    for (int i = 0; i < 3; ++i) {
+        options.difficulties[i] = difficulty == "all" || difficulty == DIFFICULTY_NAMES[i];
+        options.robots[i] = robot == "all" || robot == robotNames[i];
+    }
+
+    AIParameterSets sets;
+    if (parser.isSet(inputOption) && !sets.load(parser.value(inputOption))) {
+        out << "Could not read " << parser.value(inputOption) << '\n';
+        return 1;
+    }
+
+    std::vector<std::shared_ptr<const TerrainMap>> maps;
+    for (int i = 0; i < options.mapCount; ++i) {
+        maps.push_back(MatchRunner::generateMap(MAP_TYPES[i % 4], GRID_SIZE, options.seed + i + 1));
+    }
+
+    QString output = parser.value(outputOption);
+    for (int d = 0; d < 3; ++d) {
+        for (int r = 0; r < 3; ++r) {
+            if (!options.difficulties[d] || !options.robots[r]) {
+                continue;
+            }
+            out << "Tuning " << robotNames[r] << " on " << DIFFICULTY_NAMES[d] << '\n';
+            AIParameterSet& set = sets.at(DIFFICULTIES[d]);
+            switch (ROBOT_TYPES[r]) {
+                case RobotType::Scout:
+                    tuneRobot(RobotType::Scout, &AIParameterSet::scout, DIFFICULTIES[d], set, options, maps, out);
+                    break;
+                case RobotType::Tank:
+                    tuneRobot(RobotType::Tank, &AIParameterSet::tank, DIFFICULTIES[d], set, options, maps, out);
+                    break;
+                case RobotType::Sniper:
+                    tuneRobot(RobotType::Sniper, &AIParameterSet::sniper, DIFFICULTIES[d], set, options, maps, out);
+                    break;
+            }
+
+            // Written after every robot, so an interrupted run keeps what it has tuned
+            if (!sets.save(output)) {
+                out << "Could not write " << output << '\n';
+                return 1;
+            }
+        }
+    }
+    out << "Tuned sets written to " << output << '\n';
+    return 0;
+}
@@ -0,0 +1,17 @@
+QT += widgets concurrent
+QMAKE_CXXFLAGS += -std=c++17
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += . tools
+
+SOURCES += \
+    tools/tuner.cpp \
+    tools/spsatuner.cpp
+
+HEADERS += \
+    tools/spsatuner.h
+
+include(robotarena.pri)
+
+TARGET = robot_arena_tuner
\ No newline at end of file